@@ -3,12 +3,17 @@
 #include <iostream>
 #include <thread>
 #include <atomic>
+#include <vector>
 
 namespace core
 {
     class VideoEngine;
     class AudioEngine;
     class RTSPEngine;
+    class MuxScheduler;
+    class VideoEncodeChannel;
+    class RateController;
+    struct RTSPConfig;
 }
 
 namespace app
@@ -27,10 +32,19 @@ namespace app
 
     private:
         AppController();
+        struct SubStreamSession;
+        int initSubStreams(const core::RTSPConfig &base_config);
+        // 等编码通道缓存到参数集后写RTSP头（SDP携带参数集），超时则不带参数集
+        int openRtsp(core::RTSPEngine *rtsp, core::RTSPConfig &config, core::VideoEncodeChannel &channel);
+
         static AppController *instance_;
         core::VideoEngine *video_engine_;
         core::AudioEngine *audio_engine_;
         core::RTSPEngine *rtsps_engine_;
+        core::RTSPConfig *rtsp_config_ = nullptr; // 主码流推流配置（在 run() 中参数集就绪后写头）
+        core::MuxScheduler *mux_scheduler_ = nullptr; // 音视频交织调度
+        core::RateController *rate_controller_ = nullptr; // 主码流码率自适应（按推流写包耗时/队列占用调整编码器）
+        std::vector<SubStreamSession *> sub_sessions_; // 子码流推流会话（各自的RTSP路径和调度线程）
         bool running_ = false;
         bool initialized_ = false;
     };
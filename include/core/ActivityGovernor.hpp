@@ -0,0 +1,132 @@
+#pragma once
+#include "core/VideoEncodeChannel.hpp"
+#include "driver/RcProfile.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace core
+{
+    struct ActivityGovernorConfig
+    {
+        int idle_fps = 5;               // 空闲配置的输出帧率
+        int idle_bitrate_kbps = 0;      // 空闲配置的目标码率，0 取活动配置码率的 idle_bitrate_percent
+        int idle_bitrate_percent = 15;
+        int idle_after_ms = 10000;      // 持续无活动超过该时长切到空闲配置
+        int diff_threshold = 20;        // 采样点与上一帧/背景的亮度差超过该值视为变化
+        int active_permille = 4;        // 变化采样点占比达到该值（千分比）视为有活动
+        int size_jump_percent = 300;    // P帧平均大小超过当前配置下基线的该比例视为有活动，0 不使用
+        bool idr_on_switch = true;      // 切换配置时请求IDR（新码率/帧率从干净的参考开始）
+    };
+
+    /**
+     * 从 "key=value" 列表（逗号分隔）解析，未出现的项保持原值
+     *   fps=5  bitrate=512  percent=15  after=10（秒）  threshold=20  permille=4  size=300  idr=0|1
+     * 例：CAMERA_IDLE="fps=5,bitrate=384,after=30"
+     * @return 0成功，-1有无法识别的项
+     */
+    int parseActivityGovernorConfig(const std::string &text, ActivityGovernorConfig &config);
+
+    struct ActivityGovernorStats
+    {
+        bool idle = false;           // 当前是否为空闲配置
+        uint64_t to_idle = 0;        // 切到空闲配置的次数
+        uint64_t to_active = 0;      // 切回活动配置的次数
+        uint64_t luma_triggers = 0;  // 空闲时由亮度变化唤醒的次数
+        uint64_t size_triggers = 0;  // 空闲时由帧大小突增唤醒的次数
+        uint64_t failures = 0;       // 切换失败次数
+        uint64_t active_ms = 0;      // 各配置下的累计时长
+        uint64_t idle_ms = 0;
+        uint64_t active_bytes = 0;   // 各配置下的码流字节数
+        uint64_t idle_bytes = 0;
+        uint64_t saved_bytes = 0;    // 估算节省：空闲时长按活动配置下静止画面的码率折算，减去实际字节数
+        double check_us_avg = 0;     // 每帧活动判定耗时（亮度采样 + 帧大小趋势）
+        uint64_t check_us_max = 0;
+    };
+
+    // 配置切换通知：idle 为切换后的状态，bitrate_kbps/fps 为切换后生效的标称值（如交给码率自适应作为新的标称值）
+    typedef std::function<void(bool idle, int bitrate_kbps, int fps)> ActivitySwitchCallback;
+
+    /**
+     * 按画面活动在活动/空闲两套编码配置间切换（夜间空走廊不必 30fps 满码率推流），通道不重建
+     *  - 活动信号由自己计算，不依赖运动检测通道：送帧前在该帧亮度平面上稀疏采样（约 64x36 点），
+     *    与上一帧和背景比较（motionDiffRow）；再加上VENC输出的P帧平均大小相对当前配置基线的突增
+     *  - 活动配置为启动时的码率控制配置与帧率；空闲配置为同一配置降低码率、帧率降到 idle_fps
+     *    （VENC 按比例丢帧，送帧仍是满帧率，因此空闲时每帧都能判定）
+     *  - 空闲中检测到活动时在送这一帧之前切回活动配置，这一帧即按活动配置编码；持续 idle_after_ms 无活动才切到空闲
+     *  - 绑定模式下帧不经过用户态，只有帧大小信号，唤醒滞后一个空闲帧间隔
+     * observe() 只能由一个线程调用（通道的 FrameObserver），统计可在任意线程读取
+     */
+    class ActivityGovernor
+    {
+    public:
+        ActivityGovernor(VideoEncodeChannel &channel, const ActivityGovernorConfig &config = ActivityGovernorConfig());
+
+        ActivityGovernor(const ActivityGovernor &) = delete;
+        ActivityGovernor &operator=(const ActivityGovernor &) = delete;
+
+        /**
+         * 设置切换回调（可在任意线程调用）：返回时正在执行的旧回调已结束，
+         * 回调引用的对象析构前先设为 nullptr 即可安全释放
+         */
+        void setSwitchCallback(ActivitySwitchCallback callback);
+
+        // 送帧线程：frame 为即将送VENC的帧（nullptr 表示只有码流统计，绑定模式）
+        void observe(const VIDEO_FRAME_INFO_S *frame);
+
+        /**
+         * 运行中替换活动配置（VideoEngine::setRcProfile），空闲配置随之重新推导
+         * 当前为活动配置时立即下发，空闲时在切回活动时生效
+         */
+        int setActiveProfile(const driver::RcProfile &profile);
+
+        bool isIdle() const { return idle_.load(std::memory_order_relaxed); }
+
+        ActivityGovernorStats getStats() const;
+        void printStats() const;
+
+    private:
+        bool lumaActivity(const VIDEO_FRAME_INFO_S &frame);
+        bool sizeActivity(uint64_t frames, uint64_t bytes, uint64_t key_frames);
+        int switchTo(bool idle, const char *reason);
+        void buildIdleProfile();
+
+        VideoEncodeChannel &channel_;
+        ActivityGovernorConfig config_;
+        std::mutex callback_mutex_;        // 串行化回调的替换与调用
+        ActivitySwitchCallback callback_;
+
+        mutable std::mutex profile_mutex_; // 保护两套配置，与切换互斥
+        driver::RcProfile active_profile_;
+        driver::RcProfile idle_profile_;
+        int active_fps_ = 0;
+        std::atomic<bool> idle_{false};
+
+        // 以下仅送帧线程访问
+        std::vector<uint8_t> sample_;  // 本帧一行采样点
+        std::vector<uint8_t> prev_;    // 上一帧采样点
+        std::vector<uint16_t> bg_;     // 背景（Q8定点）
+        std::vector<uint8_t> acc_;     // 每列变化采样点计数
+        int sample_w_ = 0;             // 采样网格对应的帧尺寸，变化时重新建立背景
+        int sample_h_ = 0;
+        uint64_t last_us_ = 0;         // 上一次判定的时刻
+        uint64_t last_activity_us_ = 0;
+        uint64_t last_frames_ = 0;     // 上一次判定时通道的累计编码帧数/字节数/关键帧数
+        uint64_t last_bytes_ = 0;
+        uint64_t last_key_frames_ = 0;
+        double size_baseline_ = 0;     // 当前配置下P帧平均大小的滑动平均
+        int baseline_frames_ = 0;
+        int jump_frames_ = 0;          // 连续突增的帧数（持续突增时重建基线）
+
+        mutable std::mutex stats_mutex_;
+        ActivityGovernorStats stats_;
+        uint64_t quiet_us_ = 0;        // 活动配置下静止画面的累计时长与字节数（估算节省的基准）
+        uint64_t quiet_bytes_ = 0;
+        uint64_t checks_ = 0;
+        uint64_t check_us_total_ = 0;
+    };
+
+} // namespace core
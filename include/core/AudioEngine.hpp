@@ -53,6 +53,9 @@ namespace core
             return stream_processor_->getQueueFrontPts(pts,timeout_ms = 20);
         }
 
+        // 编码包队列（供复用调度器直接等待/出队）
+        infra::SPSCRing<AVPacket> &packetRing() { return stream_processor_->packetRing(); }
+
         // 工作主循环
         void workerLoop();
 
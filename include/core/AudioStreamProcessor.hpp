@@ -1,9 +1,9 @@
 #pragma once
+#include "infra/queue/SPSCRing.hpp"
+#include <atomic>
 #include <memory>
-#include <queue>
-#include <mutex>
 #include <cstdio>
-#include <condition_variable>
+#include <string>
 extern "C"
 {
 #include <libavcodec/avcodec.h>
@@ -17,6 +17,7 @@ namespace core
         int sample_rate = 48000;     // 采样率
         int channels = 1;            // 声道数
         size_t buffer_size = 30;     // 缓冲区大小
+        infra::DropPolicy drop_policy = infra::DropPolicy::DropOldest; // 队列满时的丢弃策略
     };
 
     class AudioStreamProcessor
@@ -40,6 +41,9 @@ namespace core
 
         bool getQueueFrontPts(int64_t &pts, int timeout_ms);
 
+        // 数据包队列（init() 之后有效）
+        infra::SPSCRing<AVPacket> &packetRing() { return *packet_ring_; }
+
         // 清空缓冲区
         void flush();
 
@@ -58,14 +62,12 @@ namespace core
         static constexpr int ADTS_HEADER_SIZE = 7;        // ADTS头大小（字节）
         static constexpr int MAX_PACKET_SIZE = 2048;      // 最大包大小（字节）
 
-        AudioStreamConfig config_;          // 配置参数
-        std::queue<AVPacket> packet_queue_; // 数据包队列
-        size_t buffer_size_;                // 缓冲区大小 队列
-        bool is_running_;                   // 运行状态
-        int64_t last_pts_;                  // 上一个时间戳
-        FILE *output_file_ = nullptr;       // 输出文件句柄
-        std::mutex queue_mutex_;
-        std::condition_variable queue_cv_; // 队列条件变量
+        AudioStreamConfig config_;                             // 配置参数
+        std::unique_ptr<infra::SPSCRing<AVPacket>> packet_ring_; // 数据包队列（init时按配置创建）
+        size_t buffer_size_;                                   // 缓冲区大小 队列
+        std::atomic<bool> is_running_;                         // 运行状态
+        int64_t last_pts_;                                     // 上一个时间戳
+        FILE *output_file_ = nullptr;                          // 输出文件句柄
     };
 
 } // namespace core
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+}
+
+namespace core
+{
+    // 主码流GOP缓存预算：5Mbps × 2s GOP ≈ 1.25MB，留出余量（64MB内存的板子上主+子码流合计约2.5MB）
+    constexpr size_t kMainGopCacheBytes = 2 * 1024 * 1024;
+    // 子码流GOP缓存预算（512kbps × 2s ≈ 128KB）
+    constexpr size_t kSubGopCacheBytes = 512 * 1024;
+
+    struct GopCacheStats
+    {
+        uint64_t gops = 0;      // 已缓存过的GOP数
+        uint64_t overflows = 0; // 超出预算被整组丢弃的GOP数
+        size_t packets = 0;     // 当前缓存的包数
+        size_t bytes = 0;       // 当前缓存的字节数
+    };
+
+    /**
+     * 最近一个GOP的编码包缓存：新的消费者（推流客户端、录像、抓拍）接入时先取这组包，
+     * 从关键帧开始即可解码，不必等下一个关键帧。
+     * 缓存的包是各自独立的数据拷贝：引用VENC码流会让一整个GOP的包占住码流缓冲
+     * （u32StreamBufCnt 个 u32BufSize 大小的块，按GOP长度配置在64MB内存的板子上放不下）。
+     * 代价是每个包多一次 memcpy（按码率计，5Mbps 约 0.6MB/s），且缓存的包没有 VencPacketWrapper 的分段信息，
+     * 使用方需按起始码解析；送入队列的原包不受影响，仍是零拷贝引用。
+     * 取出时只增加引用计数，不再拷贝数据。
+     * 超出字节预算时丢弃整组（半个GOP无法独立解码），直到下一个关键帧重新开始缓存。
+     */
+    class GopCache
+    {
+    public:
+        explicit GopCache(size_t byte_budget);
+        ~GopCache();
+
+        GopCache(const GopCache &) = delete;
+        GopCache &operator=(const GopCache &) = delete;
+
+        /**
+         * 缓存一个编码包的拷贝：关键帧开始新的GOP。pkt 本身不被修改（仍引用VENC码流，分段信息保留）
+         * @return 0已缓存，-1未缓存（尚未遇到关键帧、超出预算或分配失败）
+         */
+        int append(const AVPacket *pkt);
+
+        /**
+         * 取出当前缓存的GOP（av_packet_ref 引用，调用方用 av_packet_free 释放）
+         * @return 包数，0 表示当前没有完整可用的GOP
+         */
+        int snapshot(std::vector<AVPacket *> &out) const;
+
+        void clear();
+        size_t byteBudget() const { return byte_budget_; }
+        GopCacheStats getStats() const;
+
+    private:
+        void clearLocked();
+
+        size_t byte_budget_;
+        mutable std::mutex mutex_;
+        std::deque<AVPacket *> packets_;
+        size_t bytes_ = 0;
+        bool collecting_ = false; // 当前GOP是否在缓存中（超预算后等待下一个关键帧）
+        GopCacheStats stats_;
+    };
+
+} // namespace core
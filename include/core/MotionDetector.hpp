@@ -0,0 +1,131 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace core
+{
+    // 运动检测块大小（像素），与SIMD向量宽度一致
+    constexpr int kMotionBlockSize = 16;
+
+    struct MotionDetectorConfig
+    {
+        int width = 320;                // 检测平面分辨率（输入更大时按整数倍抽样缩小）
+        int height = 180;
+        int diff_threshold = 20;        // 像素与上一帧/背景的亮度差超过该值视为变化
+        int bg_shift = 5;               // 背景更新速率：每帧向当前帧靠近 1/2^bg_shift（1~8）
+        int block_active_percent = 20;  // 块内变化像素占比达到该值视为活动块
+        int min_active_blocks = 2;      // 活动块数达到该值视为本帧有运动
+        int trigger_frames = 2;         // 连续有运动的帧数达到该值才进入运动状态（滤除单帧噪声）
+        int release_ms = 2000;          // 持续无运动超过该时长退出运动状态
+        int global_change_percent = 70; // 活动块占比超过该值视为整体光照变化（开灯/日夜切换），重置背景
+        int publish_interval_ms = 200;  // 活动网格发布周期，0 每帧发布，<0 只在状态变化时发布
+    };
+
+    // 运动事件：状态变化时立即发布，其余按 publish_interval_ms 周期发布
+    struct MotionEvent
+    {
+        uint64_t pts_us = 0;
+        bool motion = false;      // 当前是否处于运动状态
+        bool changed = false;     // 本次发布是否为状态变化（开始/结束）
+        int active_blocks = 0;    // 本帧活动块数
+        int activity_permille = 0; // 本帧变化像素占比（千分比）
+        int grid_cols = 0;        // 活动网格：每块变化像素占比（0~100），按行存放
+        int grid_rows = 0;
+        std::vector<uint8_t> grid;
+        int box_x = 0;            // 活动块的外接矩形（检测平面坐标，无活动块时宽高为0）
+        int box_y = 0;
+        int box_w = 0;
+        int box_h = 0;
+    };
+
+    typedef std::function<void(const MotionEvent &event)> MotionCallback;
+
+    struct MotionStats
+    {
+        uint64_t frames = 0;          // 已处理帧数
+        uint64_t motion_frames = 0;   // 处于运动状态的帧数
+        uint64_t events = 0;          // 运动开始次数
+        uint64_t published = 0;       // 发布次数
+        uint64_t global_changes = 0;  // 光照整体变化（背景重置）次数
+        double process_us_avg = 0;    // 每帧处理耗时（含抽样缩小）
+        uint64_t process_us_max = 0;
+    };
+
+    /**
+     * 低分辨率亮度平面上的运动检测（供码率/帧率调度、ROI、事件录像等使用）
+     * 每个像素同时与上一帧（帧差）和背景（指数滑动平均，Q8定点）比较，任一差值超过阈值即为变化像素；
+     * 按 16x16 块统计变化像素占比得到活动网格，活动块数经连续帧触发/延时释放得到运动状态。
+     * 逐像素内核在 ARM 上使用 NEON、x86 上使用 SSE2，其他平台为标量实现，三者结果按位一致。
+     * process() 只能由一个线程调用（通常是专用VPSS通道的消费线程），回调在该线程中执行。
+     */
+    class MotionDetector
+    {
+    public:
+        explicit MotionDetector(const MotionDetectorConfig &config = MotionDetectorConfig());
+
+        MotionDetector(const MotionDetector &) = delete;
+        MotionDetector &operator=(const MotionDetector &) = delete;
+
+        void setCallback(MotionCallback callback) { callback_ = std::move(callback); }
+
+        /**
+         * 处理一帧亮度平面（NV12 的Y平面即可）
+         * 尺寸与配置一致时直接处理，为配置的整数倍时先抽样缩小（2x2平均）
+         * @return 0成功，-1尺寸不支持
+         */
+        int process(const uint8_t *y, int stride, int width, int height, uint64_t pts_us);
+
+        // 丢弃背景与上一帧，下一帧重新建立（场景切换、PTZ转动后调用）
+        void reset();
+
+        // 任意线程可查询
+        bool inMotion() const { return motion_.load(std::memory_order_relaxed); }
+        const MotionDetectorConfig &config() const { return config_; }
+        int gridCols() const { return cols_; }
+        int gridRows() const { return rows_; }
+
+        MotionStats getStats() const;
+        void printStats() const;
+
+        // 强制使用标量内核（主机上与SIMD结果对比用），对所有实例生效
+        static void setForceScalar(bool force);
+
+    private:
+        void decimate(const uint8_t *y, int stride, int fx, int fy);
+        void analyze(const uint8_t *plane, int stride, uint64_t pts_us);
+
+        MotionDetectorConfig config_;
+        MotionCallback callback_;
+        int cols_ = 0;
+        int rows_ = 0;
+
+        std::vector<uint8_t> small_;  // 抽样缩小后的平面（输入尺寸与配置一致时不用）
+        std::vector<uint8_t> prev_;   // 上一帧
+        std::vector<uint16_t> bg_;    // 背景（Q8定点）
+        std::vector<uint8_t> acc_;    // 当前块行内每列的变化像素计数
+        std::vector<uint8_t> grid_;   // 每块变化像素占比（0~100）
+        bool primed_ = false;         // 背景已建立
+
+        std::atomic<bool> motion_{false};
+        int hit_frames_ = 0;
+        uint64_t last_active_us_ = 0;
+        uint64_t last_publish_us_ = 0;
+
+        mutable std::mutex stats_mutex_;
+        MotionStats stats_;
+        uint64_t process_us_total_ = 0;
+    };
+
+    /**
+     * 一行像素的变化检测与背景更新（16像素对齐部分走SIMD，余数走标量）：
+     *   acc[i] += max(|cur-prev|, |cur-bg>>8|) > threshold
+     *   prev[i] = cur[i]
+     *   bg[i] = bg[i] - (bg[i] >> shift) + (cur[i] << (8 - shift))
+     * SIMD 与标量实现按位一致
+     */
+    void motionDiffRow(const uint8_t *cur, uint8_t *prev, uint16_t *bg, uint8_t *acc, int n, int threshold, int shift);
+
+} // namespace core
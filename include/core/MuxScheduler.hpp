@@ -0,0 +1,98 @@
+#pragma once
+#include "infra/queue/SPSCRing.hpp"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+}
+
+namespace core
+{
+    // 复用调度器参数
+    struct MuxSchedulerConfig
+    {
+        int64_t max_lateness_us = 100000;   // 队头包为等待其他流最多滞留的时间（微秒）
+        int64_t idle_threshold_us = 500000; // 某路超过该时间没有数据即视为空闲，其他流不再等待它
+        int stats_interval_s = 10;          // 统计日志输出周期（秒），0 表示不输出
+    };
+
+    // 单路流的调度统计
+    struct MuxStreamStats
+    {
+        uint64_t packets = 0;             // 已输出包数
+        uint64_t lone_packets = 0;        // 其他流空闲时直接转发的包数
+        uint64_t late_packets = 0;        // PTS 早于已输出的其他流（迟到、乱序输出）的包数
+        uint64_t wait_us_total = 0;       // 队头等待时间累计（从成为队头到被输出，微秒）
+        uint64_t wait_us_max = 0;         // 队头等待时间最大值
+        uint64_t reorder_depth_total = 0; // 输出时本路队列中积压的包数累计
+        size_t reorder_depth_max = 0;     // 输出时本路队列中积压的最大包数
+    };
+
+    /**
+     * 音视频复用调度器（取代 AppController::run 中的轮询）
+     * 同时等待所有输入队列（poll 各队列的 eventfd），按 PTS 顺序交给各自的输出回调：
+     *  - 某路暂无数据时，其他流的队头最多等待 max_lateness_us，超时后直接输出（计为 late）
+     *  - 某路超过 idle_threshold_us 无数据时视为空闲，其他流不再等待（计为 lone）
+     * 所有统计只由调度线程写入，getStats() 可在任意线程读取。
+     */
+    class MuxScheduler
+    {
+    public:
+        // 输出回调：pkt 的时间戳以 time_base 为单位，内容在回调返回后由调度器释放
+        typedef std::function<int(AVPacket *pkt, AVRational time_base)> PacketSink;
+
+        explicit MuxScheduler(const MuxSchedulerConfig &config = MuxSchedulerConfig());
+        ~MuxScheduler();
+
+        MuxScheduler(const MuxScheduler &) = delete;
+        MuxScheduler &operator=(const MuxScheduler &) = delete;
+
+        /**
+         * 注册一路输入（需在 run() 之前调用），pts 时间基取自 ring->timeBase()
+         * @return 流序号
+         */
+        int addStream(const char *name, infra::SPSCRing<AVPacket> *ring, PacketSink sink);
+
+        // 调度循环：阻塞直到 quit_flag 置位或所有输入队列都已关闭
+        int run(const std::atomic<bool> &quit_flag);
+
+        MuxStreamStats getStats(int index) const;
+        void printStats() const;
+
+    private:
+        struct Stream
+        {
+            std::string name;
+            infra::SPSCRing<AVPacket> *ring;
+            AVRational time_base;
+            PacketSink sink;
+
+            bool has_head = false;
+            int64_t head_pts = 0;
+            int64_t head_since_us = 0; // 当前队头第一次被看到的时刻
+            int64_t last_data_us = 0;  // 最近一次看到数据的时刻（0 表示从未有数据）
+            MuxStreamStats stats;
+        };
+
+        // 输出 index 路的队头包
+        void emit(int index, int64_t now, bool lone);
+
+        // 在 streams 的 eventfd 上等待，timeout_us < 0 表示按默认周期等待
+        void waitFor(const std::vector<int> &streams, int64_t timeout_us);
+
+        MuxSchedulerConfig config_;
+        std::vector<Stream> streams_;
+        AVPacket *pkt_ = nullptr; // 出队暂存包
+
+        // 已输出的最大 PTS（统一换算为微秒），用于判定迟到包
+        int64_t last_emit_us_ = AV_NOPTS_VALUE;
+
+        mutable std::mutex stats_mutex_;
+    };
+
+} // namespace core
@@ -0,0 +1,125 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace core
+{
+    // OSD区域参数
+    struct OsdRegionConfig
+    {
+        int x = 40;                      // 左上角坐标（NV12下对齐到偶数）
+        int y = 16;
+        int max_width = 512;             // tile 尺寸上限（超出部分裁掉）
+        int max_height = 128;
+        double font_scale = 1.0;         // 字号（HERSHEY_SIMPLEX）
+        int thickness = 2;               // 笔画粗细
+        int line_spacing = 8;            // 多行文本的行间距（像素）
+        uint32_t color = 0xFF00FF00;     // 文字颜色 ARGB
+        uint32_t background = 0x00000000; // 背景颜色 ARGB（默认全透明）
+    };
+
+    /**
+     * 单个OSD区域：文本只在内容变化时渲染一次，缓存为 ARGB8888 tile，
+     * 同时预先换算出 NV12 叠加所需的 Y/UV 分量和 alpha，逐帧叠加时只做 alpha 混合。
+     */
+    class OsdRegion
+    {
+    public:
+        explicit OsdRegion(const OsdRegionConfig &config) : config_(config) {}
+
+        // 更新文本（支持 '\n' 换行），内容不变时直接返回 false
+        bool setText(const std::string &text);
+
+        /**
+         * 直接使用调用方给出的 ARGB8888 tile（图标、台标等），超出 max_width/max_height 或奇数的部分裁掉
+         * @param argb 行优先，width*height 个像素（非预乘alpha）
+         * @return 0成功，-1参数错误
+         */
+        int setTile(const uint32_t *argb, int width, int height);
+
+        /**
+         * 将缓存的 tile 原地叠加到 NV12 帧
+         * @param y Y平面，uv 交织的UV平面，stride 两个平面的行跨度（字节）
+         */
+        void blendNV12(uint8_t *y, uint8_t *uv, int stride, int width, int height) const;
+
+        const std::string &text() const { return text_; }
+        int tileWidth() const { return tile_w_; }
+        int tileHeight() const { return tile_h_; }
+
+        // ARGB8888 tile（行优先，tileWidth()*tileHeight() 个像素）
+        const std::vector<uint32_t> &argb() const { return argb_; }
+
+    private:
+        void render();
+        void buildYUVA();
+
+        OsdRegionConfig config_;
+        std::string text_;
+        bool custom_tile_ = false; // 当前 tile 来自 setTile 而不是文本
+        int tile_w_ = 0;
+        int tile_h_ = 0;
+
+        std::vector<uint32_t> argb_;   // ARGB8888（非预乘alpha）
+        std::vector<uint8_t> y_;       // tile_w*tile_h 亮度
+        std::vector<uint8_t> y_alpha_; // tile_w*tile_h alpha
+        std::vector<uint8_t> uv_;      // tile_w*tile_h/2 交织的U/V（与NV12 UV平面同布局）
+        std::vector<uint8_t> uv_alpha_; // 与 uv_ 同布局，每个2x2块的平均alpha（U/V各一份）
+        std::vector<uint8_t> row_used_; // 每行是否存在非透明像素（全透明行直接跳过）
+    };
+
+    /**
+     * OSD叠加器（取代在整帧BGR上逐帧 cv::putText）
+     * 各区域的文本只在变化时重新渲染，逐帧只做小块 NV12 原地 alpha 混合，
+     * 因此 VPSS/VENC 可直接使用 NV12，不再需要整帧 RGB888。
+     * 混合内核在 ARM 上使用 NEON，x86 上使用 SSE2，其他平台为标量实现（各实现结果按位一致，可在主机上验证）。
+     */
+    class OsdRenderer
+    {
+    public:
+        OsdRenderer() = default;
+
+        OsdRenderer(const OsdRenderer &) = delete;
+        OsdRenderer &operator=(const OsdRenderer &) = delete;
+
+        // 添加区域，返回区域id
+        int addRegion(const OsdRegionConfig &config);
+
+        // 更新区域文本，返回 true 表示发生了重新渲染
+        bool setText(int id, const std::string &text);
+
+        // 用 ARGB8888 图像替换区域内容（见 OsdRegion::setTile），0成功，-1参数错误
+        int setTile(int id, const uint32_t *argb, int width, int height);
+
+        /**
+         * 将所有区域叠加到 NV12 帧（原地修改）
+         * @return 0=成功，-1=参数错误
+         */
+        int drawNV12(uint8_t *y, uint8_t *uv, int stride, int width, int height);
+
+        // 区域数
+        int regionCount() const { return (int)regions_.size(); }
+
+        // 累计重新渲染次数
+        uint64_t renderCount() const { return render_count_; }
+
+        // 最近一次 drawNV12 的耗时（微秒）
+        int64_t lastBlendUs() const { return last_blend_us_; }
+
+        // 强制使用标量内核（与 NEON/SSE2 结果对比用），对所有实例生效
+        static void setForceScalar(bool force);
+
+    private:
+        std::vector<OsdRegion> regions_;
+        uint64_t render_count_ = 0;
+        int64_t last_blend_us_ = 0;
+    };
+
+    /**
+     * alpha 混合一行：dst = (src*a + dst*(255-a)) / 255（四舍五入）
+     * NEON / SSE2 与标量实现按位一致
+     */
+    void osdBlendRow(uint8_t *dst, const uint8_t *src, const uint8_t *alpha, int n);
+
+} // namespace core
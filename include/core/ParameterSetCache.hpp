@@ -0,0 +1,71 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+extern "C"
+{
+#include "rk_comm_venc.h"
+#include <libavcodec/avcodec.h>
+}
+
+namespace core
+{
+    /**
+     * H.264/H.265 参数集缓存：检查编码通道输出的关键帧，缓存其中的 VPS/SPS/PPS
+     *  - extradata()：Annex-B 格式的参数集，供推流在写头前填入 codecpar->extradata（SDP 带上 sprop-*）
+     *  - prepend()：关键帧缺少参数集时在其前面补上，客户端从任一关键帧都能直接起播
+     * 由VENC码流封装的包按包（即NAL）分段检查，只读到第一个slice为止，不扫描slice数据。
+     * inspect 由编码通道的取流线程调用，其余接口可在任意线程调用。
+     */
+    class ParameterSetCache
+    {
+    public:
+        explicit ParameterSetCache(RK_CODEC_ID_E codec);
+
+        ParameterSetCache(const ParameterSetCache &) = delete;
+        ParameterSetCache &operator=(const ParameterSetCache &) = delete;
+
+        /**
+         * 检查一个关键帧，缓存其中的参数集（参数集变化时更新）
+         * @return 该帧是否带齐参数集（MJPEG 等无参数集的格式恒为 true）
+         */
+        bool inspect(const AVPacket *pkt);
+
+        // 参数集是否已齐（H.265: VPS+SPS+PPS，H.264: SPS+PPS）
+        bool ready() const;
+        // 等待参数集就绪，超时返回 false
+        bool waitReady(int timeout_ms) const;
+
+        // Annex-B 格式的参数集（依次带起始码），未就绪时为空
+        std::vector<uint8_t> extradata() const;
+
+        /**
+         * 把参数集补到 pkt 前面，结果写入 out（新分配的缓冲，拷贝一次，时间戳/标志沿用 pkt）
+         * @return 0成功，-1参数集未就绪或分配失败
+         */
+        int prepend(const AVPacket *pkt, AVPacket *out) const;
+
+    private:
+        enum ParamType
+        {
+            kVps = 0,
+            kSps,
+            kPps,
+            kParamTypes
+        };
+        // NAL头 → 参数集类型，slice 返回 -2，其余 NAL 返回 -1
+        int classify(uint8_t header) const;
+        // 处理一个NAL（不含起始码），遇到slice返回 false 停止检查
+        bool visit(const uint8_t *nal, size_t len, bool found[kParamTypes]);
+        bool readyLocked() const;
+
+        RK_CODEC_ID_E codec_;
+        bool has_param_sets_; // 编码格式是否有参数集
+        mutable std::mutex mutex_;
+        mutable std::condition_variable cv_;
+        std::vector<uint8_t> sets_[kParamTypes]; // 各参数集（不含起始码）
+    };
+
+} // namespace core
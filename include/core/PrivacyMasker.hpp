@@ -0,0 +1,154 @@
+#pragma once
+#include "infra/imgproc/ImageKernels.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace core
+{
+    const int kMaxPrivacyMasks = 8;     // 每路编码流的遮挡区域上限
+    const int kMaxPrivacyVertices = 32; // 多边形顶点上限
+
+    enum class PrivacyMaskMode
+    {
+        kSolid,    // 纯色填充
+        kPixelate, // 马赛克（block x block 块平均）
+        kBlur,     // 模糊（按 block 降采样后双线性放大，没有块边界）
+    };
+
+    struct PrivacyPoint
+    {
+        int x = 0;
+        int y = 0;
+    };
+
+    struct PrivacyMask
+    {
+        PrivacyMaskMode mode = PrivacyMaskMode::kSolid;
+        std::vector<PrivacyPoint> polygon; // 顶点（至少3个，奇偶规则填充），矩形为4个顶点
+        int block = 16;                    // 马赛克块大小 / 模糊半径（偶数，2~256）
+        uint8_t y = 16;                    // 纯色填充的 YUV（默认黑色）
+        uint8_t u = 128;
+        uint8_t v = 128;
+
+        static PrivacyMask rect(int x, int y, int width, int height, PrivacyMaskMode mode = PrivacyMaskMode::kSolid);
+    };
+
+    /**
+     * 从 "key=value" 列表解析遮挡区域，区域之间以 ';' 分隔，区域内各项以 ',' 分隔，追加到 masks
+     *   rect=x:y:w:h  poly=x0:y0:x1:y1:x2:y2...  mode=solid|pixelate|blur  block=16  color=RRGGBB
+     * 例：CAMERA_PRIVACY_MASK="rect=1500:0:420:300,mode=pixelate;poly=0:600:300:500:300:1080:0:1080,mode=blur,block=32"
+     * @return 0成功，-1有无法识别的项或区域没有形状
+     */
+    int parsePrivacyMasks(const std::string &text, std::vector<PrivacyMask> &masks);
+
+    struct PrivacyMaskStats
+    {
+        int masks = 0;              // 当前生效的区域数
+        uint64_t frames = 0;        // 处理的帧数（有区域生效的帧）
+        uint64_t rebuilds = 0;      // 重新生成扫描线列表的次数（区域更新或分辨率变化）
+        uint64_t masked_pixels = 0; // 当前区域在当前分辨率下覆盖的像素数（重叠处重复计）
+        uint64_t frame_pixels = 0;  // 当前分辨率的整帧像素数
+        double apply_us_avg = 0;    // 每帧遮挡耗时
+        uint64_t apply_us_max = 0;
+        uint64_t last_apply_us = 0;
+    };
+
+    /**
+     * 隐私遮挡：在送编码前原地修改 NV12 帧，遮住邻居的窗户、门口等区域
+     *  - 区域在调用方的坐标系（ref 分辨率）中给出，按帧分辨率缩放后预先光栅化为扫描线列表
+     *    （每两行一条，端点向外取偶，与NV12色度的2x2块对齐），区域或分辨率变化时才重新生成，
+     *    逐帧只处理列表覆盖的像素，开销与遮挡面积成正比，与整帧大小无关
+     *  - 马赛克/模糊先在区域外接矩形内求块平均（模糊再双线性放大），再按扫描线写回，
+     *    多边形边缘外的像素不被修改；矩形马赛克直接使用 imgproc::mosaicNV12
+     *  - 没有区域时 maskNV12 只读一个原子变量
+     * setMasks 可在任意线程调用，在下一次 maskNV12 时生效；maskNV12 只能由一个线程调用
+     */
+    class PrivacyMasker
+    {
+    public:
+        explicit PrivacyMasker(const std::string &name) : name_(name) {}
+
+        PrivacyMasker(const PrivacyMasker &) = delete;
+        PrivacyMasker &operator=(const PrivacyMasker &) = delete;
+
+        /**
+         * 整体替换遮挡区域（空列表表示清除）
+         * @param ref_width/ref_height 区域坐标所在的分辨率，0 表示与帧分辨率相同
+         * @return 0成功，-1区域数超过 kMaxPrivacyMasks 或区域无效（原有区域保持不变）
+         */
+        int setMasks(const std::vector<PrivacyMask> &masks, int ref_width = 0, int ref_height = 0);
+
+        /**
+         * 对 NV12 帧原地遮挡
+         * @param y Y平面，uv 交织的UV平面，stride 两个平面的行跨度（字节）
+         * @return 0=成功，-1=参数错误
+         */
+        int maskNV12(uint8_t *y, uint8_t *uv, int stride, int width, int height);
+
+        bool active() const { return count_.load(std::memory_order_relaxed) > 0; }
+
+        PrivacyMaskStats getStats() const;
+        void printStats() const;
+
+    private:
+        // 一条扫描线：Y平面 row、row+1 两行与UV平面 row/2 行的 [x0, x1)，端点为偶数
+        struct Span
+        {
+            int row;
+            int x0;
+            int x1;
+        };
+
+        // 一个区域按当前帧分辨率生成的扫描线与工作缓冲
+        struct Region
+        {
+            PrivacyMaskMode mode = PrivacyMaskMode::kSolid;
+            int block = 16;
+            bool is_rect = false;        // 每条扫描线都等于外接矩形
+            int x = 0;                   // 外接矩形（偶数对齐）
+            int y = 0;
+            int width = 0;
+            int height = 0;
+            std::vector<Span> spans;
+            std::vector<uint8_t> fill_uv; // 纯色：一行交织的UV
+            uint8_t fill_y = 16;
+            int cells_w = 0;             // 块网格（外接矩形内 block x block 一格）
+            int cells_h = 0;
+            std::vector<uint32_t> sums;  // 每格 Y/U/V 累加
+            std::vector<uint32_t> counts; // 每格在遮挡范围内的Y像素数
+            std::vector<uint8_t> cells;  // 每格 Y/U/V 平均值
+            std::vector<uint8_t> small;  // 模糊：块网格放大2倍的 NV12 图像
+            std::vector<uint8_t> blurred; // 模糊：外接矩形大小的 NV12 图像
+            infra::imgproc::BilinearScaler scaler;
+        };
+
+        static bool validMask(const PrivacyMask &mask);
+        void rebuild(int width, int height);
+        static void rasterize(const std::vector<PrivacyPoint> &polygon, double scale_x, double scale_y, int width, int height,
+                              std::vector<Span> &spans);
+        static void averageCells(const infra::imgproc::NV12Image &frame, Region &region);
+        static void fillSolid(const infra::imgproc::NV12Image &frame, const Region &region);
+        static void fillCells(const infra::imgproc::NV12Image &frame, const Region &region);
+        static void fillBlurred(const infra::imgproc::NV12Image &frame, Region &region);
+
+        std::string name_;
+
+        mutable std::mutex mutex_; // 保护 pending_ / ref_* / stats_
+        std::vector<PrivacyMask> pending_;
+        int ref_width_ = 0;
+        int ref_height_ = 0;
+        PrivacyMaskStats stats_;
+        uint64_t apply_us_total_ = 0;
+        std::atomic<bool> dirty_{false};
+        std::atomic<int> count_{0};
+
+        // 以下仅 maskNV12 的调用线程访问
+        std::vector<Region> regions_;
+        int width_ = 0;  // 扫描线列表对应的帧分辨率
+        int height_ = 0;
+    };
+
+} // namespace core
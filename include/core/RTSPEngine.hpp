@@ -3,6 +3,7 @@
 #include <string>
 #include <atomic>
 #include <thread>
+#include <vector>
 
 // FFmpeg 头文件
 extern "C"
@@ -25,6 +26,7 @@ namespace core
         int video_bitrate = 10 * 1024 * 1024; // 10 Mbps
         int video_framerate = 30;
         AVCodecID video_codec_id = AV_CODEC_ID_H265; // 与 RK_VIDEO_ID_HEVC 对应
+        std::vector<uint8_t> video_extradata;         // 参数集（Annex-B VPS/SPS/PPS），写头前填入 extradata，SDP 据此带上 sprop-*
 
         // 音频流参数 (硬编码)
         int audio_sample_rate = 48000;
@@ -55,8 +57,9 @@ namespace core
 
         
 
-        int pushAudioFrame(AVPacket *pkt);
-        int pushVideoFrame(AVPacket *pkt);
+        // 写入一个包，src_time_base 为 pkt 时间戳的时间基（写入前换算到输出流时间基）
+        int pushAudioFrame(AVPacket *pkt, AVRational src_time_base);
+        int pushVideoFrame(AVPacket *pkt, AVRational src_time_base);
         // int pushVideoData(uint8_t *data, int data_size, int64_t pts, int64_t dts);
 
         static RTSPEngine &instance()
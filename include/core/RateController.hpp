@@ -0,0 +1,110 @@
+#pragma once
+#include "core/VideoEncodeChannel.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace core
+{
+    // 码率自适应参数：拥塞判定与恢复判定使用不同阈值，并要求恢复持续多个周期（迟滞）
+    struct RateControllerConfig
+    {
+        int interval_ms = 1000;            // 评估周期
+        int min_bitrate_percent = 20;      // 码率下限（标称码率的百分比）
+        int decrease_percent = 25;         // 拥塞时每次降低当前码率的比例
+        int increase_percent = 10;         // 畅通时每次回升标称码率的比例
+        int min_fps = 10;                  // 码率降到下限仍拥塞时降帧率，不低于该值
+        int64_t congested_write_us = 30000; // 视频包平均写耗时超过该值视为拥塞
+        int64_t clear_write_us = 8000;      // 平均写耗时低于该值（且队列低水位、无丢包）视为畅通
+        int congested_queue_percent = 50;  // 周期内队列最大占用超过容量的该比例视为拥塞
+        int clear_queue_percent = 25;      // 低于该比例视为畅通
+        int recover_periods = 5;           // 连续畅通的周期数，达到后才上调一级
+        int settle_periods = 1;            // 下调后忽略的周期数（等待队列积压排空）
+        int min_qp = 10;                   // 正常QP范围（编码通道的码率控制配置未指定 qp 时使用）
+        int max_qp = 48;
+        int degraded_min_qp_boost = 6;     // 降级期间抬高QP下限，压住静止画面I帧的码率尖峰
+        int degraded_max_qp = 51;          // 降级期间放开QP上限，保证降低后的目标码率能达到
+        int stats_interval_s = 10;         // 统计日志输出周期（秒），0 表示不输出
+    };
+
+    struct RateControlStats
+    {
+        int bitrate_kbps = 0;         // 当前目标码率
+        int nominal_bitrate_kbps = 0; // 标称码率（启动时的配置）
+        int fps = 0;                  // 当前输出帧率
+        int nominal_fps = 0;
+        bool degraded = false;        // 是否处于降级状态（码率或帧率低于标称值）
+        uint64_t periods = 0;         // 已评估的周期数
+        uint64_t congested_periods = 0;
+        uint64_t decreases = 0;       // 下调次数（码率或帧率）
+        uint64_t increases = 0;       // 上调次数
+        double write_avg_ms = 0;      // 最近一个周期的写包耗时
+        double write_max_ms = 0;
+        size_t queue_max = 0;         // 最近一个周期的队列最大占用
+        uint64_t dropped = 0;         // 最近一个周期的丢包数
+    };
+
+    /**
+     * 闭环码率自适应：按推流端的实际情况调整编码器，而不是等队列满了再丢帧
+     *  - 输入：复用线程每写一个视频包调用 noteWrite()（av_interleaved_write_frame 耗时），
+     *          以及编码包队列的占用和丢包数
+     *  - 输出：VENC 目标码率（SetChnAttr）、QP上下限（SetRcParam）、输出帧率
+     * 拥塞时先按比例降码率，到下限后再降帧率；畅通持续 recover_periods 个周期后先恢复帧率再逐级回升码率。
+     * 评估在独立线程中进行，写包线程卡住（网络完全阻塞）时同样能下调。
+     */
+    class RateController
+    {
+    public:
+        explicit RateController(VideoEncodeChannel &channel, const RateControllerConfig &config = RateControllerConfig());
+        ~RateController();
+
+        RateController(const RateController &) = delete;
+        RateController &operator=(const RateController &) = delete;
+
+        int start();
+        void stop();
+
+        // 复用线程：写完一个视频包后调用，write_us 为写包耗时
+        void noteWrite(uint64_t write_us);
+
+        /**
+         * 编码配置被整体切换（如活动/空闲配置切换）后更新标称码率/帧率，之后按新的标称值升降；
+         * 任意线程调用，下一个评估周期生效
+         */
+        void setNominal(int bitrate_kbps, int fps);
+
+        RateControlStats getStats() const;
+        void printStats() const;
+
+    private:
+        void controlLoop();
+        void evaluate();
+        // 码率/帧率变化后按是否降级更新QP范围
+        void applyQp(bool degraded);
+
+        VideoEncodeChannel &channel_;
+        RateControllerConfig config_;
+
+        // 本周期的写包统计（复用线程写，控制线程取走清零）
+        std::atomic<uint64_t> writes_{0};
+        std::atomic<uint64_t> write_us_total_{0};
+        std::atomic<uint64_t> write_us_max_{0};
+        std::atomic<size_t> queue_max_{0};
+
+        // 以下仅控制线程访问
+        uint64_t last_dropped_ = 0;
+        int clear_periods_ = 0;
+        int settle_left_ = 0;
+        int min_bitrate_kbps_ = 0;
+
+        mutable std::mutex mutex_; // 保护 stats_，并配合 cv_ 停止控制线程
+        std::condition_variable cv_;
+        RateControlStats stats_;
+        bool running_ = false;
+        std::thread thread_;
+    };
+
+} // namespace core
@@ -0,0 +1,80 @@
+#pragma once
+#include "driver/VideoEncoderDriver.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace core
+{
+    struct RoiStats
+    {
+        uint64_t updates = 0;   // 来源提交的次数
+        uint64_t applies = 0;   // 下发到VENC的次数（区域有变化才下发）
+        uint64_t expired = 0;   // 来源超时未刷新、区域被撤销的次数
+        uint64_t truncated = 0; // 合并后超过 kMaxRoiRegions 被舍弃的区域数
+        uint64_t failures = 0;  // 下发失败次数
+        int active = 0;         // 当前生效的区域数
+    };
+
+    /**
+     * 感兴趣区域的汇集与下发：运动检测、人脸/车牌检测等分析模块在各自线程中提交区域（生产者），
+     * 编码通道送帧前调用 apply()，有变化时合并各来源并通过 VideoEncoderDriver::setRoiRegions 下发，
+     * 因此区域按帧生效、不阻塞分析线程，多次提交只下发最新的一组。
+     *  - 每个来源有优先级，合并时高优先级的区域先占用名额（最多 kMaxRoiRegions 个），
+     *    并放在更大的索引上，重叠处以高优先级的QP为准
+     *  - 来源可以使用自己的坐标系（分析通常跑在子码流/CV通道的分辨率上），合并时缩放到编码分辨率
+     *  - 提交时指定保持时间，超时未刷新的区域自动撤销，分析模块停止或卡住时不会一直占用码率
+     */
+    class RoiController
+    {
+    public:
+        RoiController(driver::VideoEncoderDriver *venc_driver, int width, int height);
+
+        RoiController(const RoiController &) = delete;
+        RoiController &operator=(const RoiController &) = delete;
+
+        /**
+         * 注册一个区域来源，返回来源ID（update/clear 使用）
+         * @param priority 越大越优先
+         * @param width/height 来源坐标系的分辨率，0 表示与编码分辨率相同
+         */
+        int addSource(const std::string &name, int priority, int width = 0, int height = 0);
+
+        // 任意线程：整体替换该来源的区域，hold_ms 内未再次提交则撤销（<=0 表示一直保持）
+        void update(int source, const std::vector<driver::RoiRegion> &regions, int hold_ms = 1000);
+        void clear(int source);
+
+        // 送帧线程：区域有变化（提交或超时）时合并并下发，无变化时只读两个原子变量
+        void apply(uint64_t now_us);
+
+        RoiStats getStats() const;
+
+    private:
+        struct Source
+        {
+            std::string name;
+            int priority = 0;
+            int width = 0;
+            int height = 0;
+            std::vector<driver::RoiRegion> regions;
+            uint64_t expire_us = 0; // 0 表示不过期
+        };
+
+        void merge(uint64_t now_us, std::vector<driver::RoiRegion> &out);
+
+        driver::VideoEncoderDriver *venc_driver_;
+        int width_;
+        int height_;
+
+        std::atomic<bool> dirty_{false};
+        std::atomic<uint64_t> next_expire_us_{0}; // 最早的过期时刻，0 表示没有会过期的区域
+
+        mutable std::mutex mutex_; // 保护 sources_ / applied_ / stats_
+        std::vector<Source> sources_;
+        std::vector<driver::RoiRegion> applied_; // 上一次下发的区域（相同则不重复下发）
+        RoiStats stats_;
+    };
+
+} // namespace core
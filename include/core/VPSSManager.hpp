@@ -1,8 +1,17 @@
 #ifndef VPSS_DRIVER_H
 #define VPSS_DRIVER_H
 
+#include <atomic>
 #include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
+#include "core/VideoFormat.hpp"
+#include "infra/queue/SPSCRing.hpp"
 
 extern "C"
 {
@@ -10,8 +19,58 @@ extern "C"
 #include "rk_comm_video.h"
 }
 
+namespace driver
+{
+    class MPIBackend;
+}
+
 namespace core
 {
+    class VPSSManager;
+
+    /**
+     * VPSS输出帧的独占句柄（move-only），析构/reset 时归还给对应的VPSS通道
+     * 句柄不能比产出它的 VPSSManager 活得更久
+     */
+    class VPSSFrame
+    {
+    public:
+        VPSSFrame() = default;
+        VPSSFrame(VPSSManager *owner, int chn_id, const VIDEO_FRAME_INFO_S &frame)
+            : owner_(owner), chn_id_(chn_id), frame_(frame) {}
+        ~VPSSFrame() { reset(); }
+
+        VPSSFrame(VPSSFrame &&other) noexcept { *this = std::move(other); }
+        VPSSFrame &operator=(VPSSFrame &&other) noexcept;
+
+        VPSSFrame(const VPSSFrame &) = delete;
+        VPSSFrame &operator=(const VPSSFrame &) = delete;
+
+        // 归还帧给VPSS
+        void reset();
+
+        bool valid() const { return owner_ != nullptr; }
+        int chnId() const { return chn_id_; }
+        const VIDEO_FRAME_INFO_S &info() const { return frame_; }
+        void *virAddr() const;
+
+    private:
+        VPSSManager *owner_ = nullptr;
+        int chn_id_ = -1;
+        VIDEO_FRAME_INFO_S frame_{};
+    };
+
+    // 通道消费回调：在该通道专属的消费线程中调用，frame 在回调返回后归还VPSS（也可 move 走延后归还）
+    typedef std::function<void(VPSSFrame &frame)> VPSSFrameConsumer;
+
+    // 单个输出通道的收发统计
+    struct VPSSChnStats
+    {
+        uint64_t fetched = 0;  // 从VPSS取到的帧数
+        uint64_t dropped = 0;  // 队列满被丢弃（消费跟不上）的帧数
+        uint64_t consumed = 0; // 交给消费者的帧数
+    };
+
     class VPSSManager
     {
     public:
@@ -22,10 +81,26 @@ namespace core
         VPSSManager(const VPSSManager &) = delete;
         VPSSManager &operator=(const VPSSManager &) = delete;
 
+        // 设置主通道（送编码器）的输出参数，需在 init() 之前调用
+        void setMainChannel(const VPSSChnConfig &config) { main_chn_ = config; }
+
         // 初始化VPSS通道（封装RK_MPI_VPSS_CreateChn）
         int init();
 
-        int bindViToVpss();
+        // 按需启用/关闭附加输出通道（如CV旁路），可在运行中调用
+        int enableChannel(const VPSSChnConfig &config);
+        int disableChannel(int chn_id);
+        bool isChannelEnabled(int chn_id) const;
+
+        /**
+         * 硬件绑定（RK_MPI_SYS_Bind）：VI 通道 → VPSS 组，VPSS 通道 → VENC 通道
+         * 绑定后帧在模块间自动流转，被绑定的VPSS通道不能再由用户态取帧；其他通道仍可作为旁路使用
+         */
+        int bindViToVpss(int vi_dev = 0, int vi_chn = 0);
+        int bindToVenc(int chn_id, int venc_chn);
+        // 解除所有绑定（析构时也会调用）
+        void unbindAll();
+        bool isBound() const { return !bindings_.empty(); }
 
         // 发送帧到VPSS（封装RK_MPI_VPSS_SendFrame）
         int sendFrame(const VIDEO_FRAME_INFO_S &frame, int timeout = -1);
@@ -36,21 +111,66 @@ namespace core
         // 释放VPSS返回的帧（封装RK_MPI_VPSS_ReleaseFrame）
         int releaseFrame(const VIDEO_FRAME_INFO_S &frame);
 
+        // 从指定通道获取/释放帧
+        int getChnFrame(int chn_id, VIDEO_FRAME_INFO_S &frame, int timeout = -1);
+        int releaseChnFrame(int chn_id, const VIDEO_FRAME_INFO_S &frame);
+
+        const VPSSChnConfig &mainChannel() const { return main_chn_; }
+
+        /**
+         * 为附加通道启动取帧线程和帧队列（多路扇出：主码流/子码流/分析帧各自独立消费）
+         * 取帧线程从VPSS取帧放入深度为 queue_depth 的队列，满时丢弃最旧帧，
+         * 消费者通过 popChannelFrame() 在自己的线程取帧，或用 setChannelConsumer() 交给专属消费线程
+         */
+        int startChannel(int chn_id, size_t queue_depth = 2);
+        void stopChannel(int chn_id);
+
+        // 从通道队列取一帧（0成功，-1超时，-2通道已停止）
+        int popChannelFrame(int chn_id, VPSSFrame &frame, int timeout_ms);
+
+        // 启动该通道的专属消费线程，每帧调用一次 consumer（需先 startChannel）
+        int setChannelConsumer(int chn_id, VPSSFrameConsumer consumer);
+
+        VPSSChnStats getChannelStats(int chn_id) const;
+
     private:
         int createGroup();
         int startVPSS();
-        int setVPSSChnAttr();
-        int enableVPSSChn();
+        int setVPSSChnAttr(const VPSSChnConfig &config);
+        int enableVPSSChn(int chn_id);
         int enableBackupFrame();
         int disableBackupFrame();
-        int disableVPSSChn();
+        int disableVPSSChn(int chn_id);
         int stopVPSS();
         int destroyGroup();
+        int bind(const MPP_CHN_S &src, const MPP_CHN_S &dst);
+
+        // 附加通道的取帧线程 + 帧队列 + 可选的消费线程
+        struct ChannelWorker
+        {
+            int chn_id = -1;
+            std::unique_ptr<infra::SPSCRing<VPSSFrame>> queue;
+            std::atomic<bool> running{false};
+            std::thread fetch_thread;
+            std::thread consumer_thread;
+            VPSSFrameConsumer consumer;
+            std::atomic<uint64_t> fetched{0};
+            std::atomic<uint64_t> consumed{0};
+        };
+        void fetchLoop(ChannelWorker *worker);
+        void consumeLoop(ChannelWorker *worker);
+        std::shared_ptr<ChannelWorker> findWorker(int chn_id) const;
 
         RK_U32 width_;
         RK_U32 height_;
         VPSS_GRP grp_id_;
         VPSS_CHN chn_id_;
+        VPSSChnConfig main_chn_;              // 主通道参数
+        std::vector<VPSSChnConfig> extra_chns_; // 已启用的附加通道
+        std::map<int, std::shared_ptr<ChannelWorker>> workers_; // 附加通道的扇出线程
+        std::vector<std::pair<MPP_CHN_S, MPP_CHN_S>> bindings_;  // 已建立的绑定（源, 目的）
+        mutable std::mutex mutex_; // 保护 extra_chns_ / workers_（控制路径）
+        driver::MPIBackend &mpi_; // MPI后端（板端/模拟）
 
         bool inited_ = false; // 初始化状态
     };
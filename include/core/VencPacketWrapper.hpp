@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <sys/uio.h>
+#include <vector>
+
+extern "C"
+{
+#include "rk_comm_venc.h"
+#include <libavcodec/avcodec.h>
+}
+
+namespace core
+{
+    // VENC码流归还回调（默认直接调用MPI后端的ReleaseStream，不依赖驱动对象生命周期；测试时可替换为mock）
+    typedef std::function<void(VENC_STREAM_S &stream)> VencReleaseHook;
+
+    /**
+     * VENC码流 → AVPacket 零拷贝封装
+     * pkt->data 直接指向VENC输出的MB块，pkt->buf 的释放回调负责把码流归还给VENC，
+     * 因此码流在队列、复用器持有的最后一个引用释放之前不会被编码器覆盖。
+     * 一帧码流可能由多个包组成（VPS/SPS/PPS/SEI/slice 各一包），每个包是同一访问单元的一段：
+     * 各段在内存中首尾相接时 pkt->data 直接覆盖全部段；不相接时才合并到一块新缓冲（并立即归还码流）。
+     * 各段的位置可通过 segments() 以 iovec 形式取得，无需再解析起始码。
+     * 注意：同时在途的码流数受VENC的 u32StreamBufCnt 限制，
+     * 需不小于 队列深度 + 编码线程/复用器各自持有的包数，否则编码会被反压阻塞。
+     */
+    class VencPacketWrapper
+    {
+    public:
+        explicit VencPacketWrapper(VencReleaseHook release_hook);
+
+        // 替换码流归还回调（需在开始包装码流之前调用）
+        void setReleaseHook(VencReleaseHook release_hook);
+
+        /**
+         * 将 stream 包装进 pkt（只填充 data/size/buf/pts/dts，关键帧标志由调用方按编码格式设置）
+         * @return 0成功（码流所有权转移给pkt，调用方不得再releaseStream），-1失败（所有权仍在调用方）
+         */
+        int wrap(const VENC_STREAM_S &stream, AVPacket *pkt);
+
+        /**
+         * 取出本类封装的 pkt 的各段（每个VENC包一段，av_packet_ref 出的引用同样有效）
+         * @return 段数；pkt 不是由本类封装时返回 -1
+         */
+        static int segments(const AVPacket *pkt, const struct iovec **iov);
+
+        // 已包装但尚未归还给VENC的码流数
+        int outstanding() const { return state_->outstanding.load(); }
+
+        // 因各段不相接而合并拷贝的码流数
+        uint64_t gatheredCount() const { return state_->gathered.load(); }
+
+    private:
+        // 包装器与所有在途码流共享的状态（包装器先析构时在途包仍可安全归还）
+        struct SharedState
+        {
+            VencReleaseHook release_hook;
+            std::atomic<int> outstanding{0};
+            std::atomic<uint64_t> gathered{0};
+        };
+
+        // AVBufferRef 的 opaque：保存码流描述的副本（pstPack 在调用方会被复用）
+        struct StreamHolder
+        {
+            std::shared_ptr<SharedState> state;
+            VENC_STREAM_S stream;
+            VENC_PACK_S *packs;
+            std::vector<struct iovec> segments; // 各包的数据段（指向 pkt->buf 覆盖的内存）
+            uint8_t *gathered = nullptr;        // 各段不相接时的合并缓冲（此时码流已归还）
+        };
+
+        static void releaseBuffer(void *opaque, uint8_t *data);
+
+        std::shared_ptr<SharedState> state_;
+    };
+
+} // namespace core
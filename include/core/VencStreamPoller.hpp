@@ -0,0 +1,77 @@
+#pragma once
+#include "core/VideoEncodeChannel.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace core
+{
+    // 单个编码通道的取流统计
+    struct VencPollStats
+    {
+        std::string name;
+        uint64_t wakeups = 0;  // fd 可读次数
+        uint64_t packets = 0;  // 取到的码流数
+        uint64_t spurious = 0; // fd 可读但没有取到码流的次数
+        uint64_t errors = 0;   // fd 报告 POLLERR/POLLHUP/POLLNVAL 的次数（每次暂停轮询该fd一段时间）
+    };
+
+    /**
+     * VENC码流轮询器：一个线程 poll 所有编码通道的码流就绪fd（RK_MPI_VENC_GetFd），
+     * 哪路可读就非阻塞地取完该路已就绪的码流，替代每路一个阻塞 GetStream 的取流线程。
+     * 码流按通道的配置进入各自的编码包队列或交给通道的包回调。
+     */
+    class VencStreamPoller
+    {
+    public:
+        VencStreamPoller();
+        ~VencStreamPoller();
+
+        VencStreamPoller(const VencStreamPoller &) = delete;
+        VencStreamPoller &operator=(const VencStreamPoller &) = delete;
+
+        // 加入/移出编码通道（运行中也可调用）；通道取不到fd时返回 -1，由调用方退回阻塞取流
+        int addChannel(VideoEncodeChannel *channel);
+        // 返回后轮询线程不会再访问该通道
+        void removeChannel(VideoEncodeChannel *channel);
+        size_t channelCount() const;
+
+        int start();
+        void stop();
+        bool isRunning() const { return running_; }
+
+        std::vector<VencPollStats> getStats() const;
+        void printStats() const;
+
+        // 统计日志输出周期（秒），0 表示不输出
+        void setStatsInterval(int seconds) { stats_interval_s_ = seconds; }
+
+    private:
+        struct Entry
+        {
+            VideoEncodeChannel *channel = nullptr;
+            int fd = -1;
+            uint64_t wakeups = 0;
+            uint64_t packets = 0;
+            uint64_t spurious = 0;
+            uint64_t errors = 0;
+            uint64_t retry_at_us = 0; // fd 出错后在此时刻之前不再轮询，避免 poll 立即返回导致空转
+            bool draining = false;    // 轮询线程正在（不持锁）取该通道的码流
+        };
+        void pollLoop();
+        void wake();
+
+        mutable std::mutex mutex_; // 保护 entries_；取流时不持有，以免增删通道、取统计被取流阻塞
+        std::condition_variable drain_done_; // removeChannel 等待该通道的在途取流结束
+        std::vector<Entry> entries_;
+        int wake_fd_ = -1;         // 通道增删、停止时唤醒 poll
+        std::atomic<bool> running_{false};
+        std::thread thread_;
+        int stats_interval_s_ = 10;
+    };
+
+} // namespace core
@@ -0,0 +1,184 @@
+#pragma once
+#include "core/GopCache.hpp"
+#include "core/ParameterSetCache.hpp"
+#include "core/RoiController.hpp"
+#include "core/VencPacketWrapper.hpp"
+#include "driver/VideoEncoderDriver.hpp"
+#include "infra/queue/SPSCRing.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+extern "C"
+{
+#include "rk_mpi.h"
+#include <libavcodec/avcodec.h>
+}
+
+namespace core
+{
+    // 编码包队列深度（零拷贝下每个排队的包都占用一个VENC码流缓冲）
+    constexpr int kVideoPacketQueueDepth = 8;
+    // VENC码流缓冲个数：队列深度 + 编码线程持有的1个 + 复用器正在写/交织缓冲的2个
+    // （每个缓冲按峰值码率估算大小，见 VideoEncoderDriver::streamBufSize：默认 1080p 主码流合计约6.7MB）
+    constexpr int kVideoStreamBufCnt = kVideoPacketQueueDepth + 3;
+
+    // 单路编码通道的统计
+    struct EncodeChannelStats
+    {
+        uint64_t frames = 0;           // 已编码帧数
+        uint64_t key_frames = 0;       // 关键帧数
+        uint64_t bytes = 0;            // 码流字节数
+        uint64_t dropped = 0;          // 队列满被丢弃的包数
+        uint64_t dropped_by[(int)infra::DropReason::kCount] = {}; // 按原因分类的丢弃数
+        uint64_t key_requests = 0;     // 丢弃参考帧后请求IDR的次数
+        uint64_t disposable_frames = 0; // 非参考帧数（可在水位高时提前丢弃）
+        uint64_t packs = 0;            // VENC包数（一帧可含 VPS/SPS/PPS/SEI/slice 多个包）
+        uint64_t gathered = 0;         // 各包不相接、需合并拷贝的帧数
+        uint64_t injected = 0;         // 缺少参数集、由缓存补上的关键帧数
+        uint64_t latency_us_total = 0; // 编码时延累计（送帧 → 取到码流），绑定模式下无送帧时刻，不统计
+        uint64_t latency_us_max = 0;
+        uint64_t capture_latency_us_total = 0; // 端到端时延累计（VI采集 → 取到码流），两种流水线模式可直接对比
+        uint64_t capture_latency_us_max = 0;
+        double bitrate_kbps = 0;       // 最近一个统计周期的码率
+    };
+
+    // 编码包回调：pkt 在回调返回后由通道释放，需要保留时在回调中 av_packet_ref
+    typedef std::function<void(AVPacket *pkt)> EncodedPacketCallback;
+
+    // 送帧观察者：送帧线程在每帧送VENC之前调用（可按画面调整编码参数，对这一帧生效）；
+    // 绑定模式下帧不经过用户态，取到码流时以 nullptr 调用
+    typedef std::function<void(const VIDEO_FRAME_INFO_S *frame)> FrameObserver;
+
+    /**
+     * 一路视频编码通道：VENC送帧/取码流 → 零拷贝AVPacket → 独立的编码包队列
+     * 主码流、子码流各用一个实例，互不影响（各自的码率控制、队列和统计）。
+     * 送帧（sendFrame）与取流入队（fetchStream/pushStream/releasePendingStream）可以分属两个线程，
+     * 使第N帧编码与第N+1帧的送帧重叠；同一侧的接口只能由一个线程调用。队列的消费端交给复用调度器。
+     */
+    class VideoEncodeChannel
+    {
+    public:
+        VideoEncodeChannel(const std::string &name, driver::VideoEncoderDriver *venc_driver,
+                           size_t queue_depth = kVideoPacketQueueDepth);
+        ~VideoEncodeChannel();
+
+        VideoEncodeChannel(const VideoEncodeChannel &) = delete;
+        VideoEncodeChannel &operator=(const VideoEncodeChannel &) = delete;
+
+        int start();
+        void stop();
+
+        // 送一帧并把码流放入队列（sendFrame + fetchStream + pushStream），帧由调用方归还
+        int encode(const VIDEO_FRAME_INFO_S &frame);
+
+        // 分步接口：送帧、取码流（码流暂存在通道内）、入队、归还未入队的码流
+        int sendFrame(const VIDEO_FRAME_INFO_S &frame);
+        int fetchStream(int timeout_ms = -1);
+        int pushStream();
+        void releasePendingStream();
+
+        /**
+         * 非阻塞地取完当前已就绪的全部码流并入队（或交给回调），返回取到的码流数
+         * 供 VencStreamPoller 在通道fd可读时调用
+         */
+        int drainReady();
+
+        // 设置后编码包交给回调而不进入队列（需在 start() 之前调用）
+        void setPacketCallback(EncodedPacketCallback callback) { packet_callback_ = std::move(callback); }
+
+        // 设置送帧观察者（需在 start() 之前调用）
+        void setFrameObserver(FrameObserver observer) { frame_observer_ = std::move(observer); }
+
+        driver::VideoEncoderDriver *driver() { return venc_driver_; }
+
+        // 已取到、尚未入队的码流的pts（fetchStream 之后有效，-1 表示没有暂存码流）
+        int64_t pendingPts() const { return stream_pending_ ? (int64_t)venc_stream_.pstPack[0].u64PTS : -1; }
+
+        infra::SPSCRing<AVPacket> &packetRing() { return packet_ring_; }
+
+        /**
+         * 替换队列的丢弃策略参数（需在 start() 之前调用）
+         * 默认：水位达到队列深度3/4时丢弃非参考帧，丢弃参考帧后请求IDR（间隔不小于1s）
+         */
+        void setDropConfig(const infra::DropConfig &config) { packet_ring_.setDropConfig(config); }
+        const std::string &name() const { return name_; }
+
+        // 从关键帧中缓存的参数集（推流写头前取 extradata）
+        const ParameterSetCache &parameterSets() const { return param_sets_; }
+
+        // 开启最近一个GOP的缓存（需在 start() 之前调用），byte_budget 为 0 时不缓存
+        void enableGopCache(size_t byte_budget);
+        // 未开启时返回 nullptr
+        GopCache *gopCache() { return gop_cache_.get(); }
+
+        // 感兴趣区域：分析模块注册来源并提交区域，送帧（绑定模式下为取流）时下发到VENC
+        RoiController &roi() { return roi_; }
+
+        // 请求编码器尽快输出IDR
+        int requestIDR() { return venc_driver_->requestIDR(true); }
+
+        // 替换VENC码流归还回调（mock测试用，需在start()之前调用）
+        void setStreamReleaseHook(VencReleaseHook hook) { packet_wrapper_.setReleaseHook(std::move(hook)); }
+
+        // 已入队/推流中、尚未归还给VENC的码流数
+        int outstandingStreams() const { return packet_wrapper_.outstanding(); }
+
+        EncodeChannelStats getStats() const;
+        void printStats() const;
+
+        // 统计日志输出周期（秒），0 表示不输出
+        void setStatsInterval(int seconds) { stats_interval_s_ = seconds; }
+
+        /**
+         * 码流pts是否为原始采集时刻（单调时钟微秒）：VPSS→VENC硬件绑定时帧不经过用户态，
+         * pts 只能在取到码流后再换算为媒体时间；用户态送帧时送帧前已换算，保持 false
+         */
+        void setCaptureTimestamps(bool raw) { raw_capture_pts_ = raw; }
+
+    private:
+        void updateStats(uint32_t bytes, uint32_t packs, bool key, bool disposable, uint64_t latency_us, uint64_t capture_latency_us);
+
+        std::string name_;
+        driver::VideoEncoderDriver *venc_driver_;
+
+        VENC_STREAM_S venc_stream_;    // 编码流结构体（pstPack 预分配，循环内复用）
+        uint32_t pack_capacity_ = 0;   // pstPack 已分配的包数，按VENC报告的 u32CurPacks 增长
+        int reservePacks(uint32_t count);
+        bool stream_pending_ = false;  // venc_stream_ 已获取但尚未转交给AVPacket
+        // 送帧时刻（按pts匹配取到的码流，计算编码时延；绑定模式下没有送帧记录）
+        struct SendStamp
+        {
+            int64_t pts = -1;
+            uint64_t send_us = 0;
+        };
+        static const int kSendStampSlots = 16; // 不小于在途帧数（VENC码流缓冲个数）
+        SendStamp send_stamps_[kSendStampSlots];
+        unsigned send_seq_ = 0;
+        uint64_t takeSendStamp(int64_t pts);
+        bool raw_capture_pts_ = false; // 码流pts为原始采集时刻（绑定模式）
+        VencPacketWrapper packet_wrapper_; // VENC码流 → AVPacket 零拷贝封装
+
+        // 编码包队列（编码线程 → 复用调度器），满时丢弃到下一个关键帧，水位高时先丢非参考帧
+        infra::SPSCRing<AVPacket> packet_ring_;
+        AVPacket *staging_pkt_ = nullptr; // 入队前的暂存包（预分配，避免每帧av_packet_alloc）
+        AVPacket *inject_pkt_ = nullptr;  // 补参数集的关键帧（仅缺参数集时使用）
+        ParameterSetCache param_sets_;
+        std::unique_ptr<GopCache> gop_cache_; // 最近一个GOP（新消费者接入时回放）
+        RoiController roi_;
+        EncodedPacketCallback packet_callback_; // 非空时编码包交给回调而不入队
+        FrameObserver frame_observer_;
+
+        mutable std::mutex stats_mutex_;
+        EncodeChannelStats stats_;
+        int stats_interval_s_ = 10;
+        uint64_t window_start_us_ = 0; // 码率统计窗口
+        uint64_t window_bytes_ = 0;
+        uint64_t last_print_us_ = 0;
+        uint64_t last_drop_log_us_ = 0; // 队列满丢帧告警（限频）的上次时刻，只在取流线程访问
+        uint64_t drop_logged_ = 0;      // 上次告警时的累计丢帧数
+    };
+
+} // namespace core
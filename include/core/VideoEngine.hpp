@@ -1,13 +1,21 @@
 #pragma once
+#include "core/ActivityGovernor.hpp"
+#include "core/MotionDetector.hpp"
+#include "core/PrivacyMasker.hpp"
 #include "core/VideoStreamProcessor.hpp"
+#include "core/VencStreamPoller.hpp"
+#include "core/VideoFormat.hpp"
+#include "core/VPSSManager.hpp"
 #include "driver/ISPDriver.hpp"
 #include "driver/VideoInputDriver.hpp"
 #include "driver/MPIManager.hpp"
 #include "driver/VideoEncoderDriver.hpp"
 #include <iostream>
 #include <atomic>
+#include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 
 extern "C"
 {
@@ -27,12 +35,55 @@ namespace driver
 
 namespace core
 {
+    // 附加编码流（如子码流）：由独立的VPSS通道供帧，编码到独立的VENC通道和编码包队列
+    struct VideoSubStreamConfig
+    {
+        std::string name = "sub";                 // 流名称（推流路径后缀、统计日志）
+        VPSSChnConfig vpss_chn;                   // 供帧的VPSS通道（分辨率/格式/帧率）
+        driver::VideoEncoderConfig encode_config; // 编码通道（独立码率控制）
+        size_t gop_cache_bytes = kSubGopCacheBytes; // 最近一个GOP的缓存预算（0 不缓存）
+    };
+
+    // 运动检测使用的VPSS通道（0 主码流编码、1 CV、2 子码流）
+    constexpr int kMotionVpssChn = 3;
+
+    // 主码流流水线模式
+    enum class VideoPipelineMode
+    {
+        kManual,    // 用户态搬运：单线程串行 VI取帧 → 送VPSS → 取帧叠加OSD → 送VENC → 取码流
+        kPipelined, // 用户态流水线：采集/处理/送编码/取码流 各一个线程，相邻帧的各阶段重叠执行
+        kBound,     // 硬件绑定：VI→VPSS→VENC 由 RK_MPI_SYS_Bind 串联，用户态只取码流（无用户态OSD）
+    };
+
     struct VedioEngineConfig
     {
         driver::VideoInputConfig input_config;    // 输入设备配置
         driver::VideoEncoderConfig encode_config; // 编码器配置
+        core::VideoFormatRequest format_request;  // 像素格式协商（默认NV12直通，无CV分支）
+        std::vector<VideoSubStreamConfig> sub_streams; // 附加编码流（子码流等）
+        VideoPipelineMode pipeline_mode = VideoPipelineMode::kPipelined; // 可由环境变量 CAMERA_PIPELINE=pipelined|manual|bound 覆盖
+        int pipeline_depth = 2; // 流水线模式下阶段间的帧队列深度
+        size_t gop_cache_bytes = kMainGopCacheBytes; // 主码流最近一个GOP的缓存预算（0 不缓存）
+        int output_fps = 0; // 主码流输出帧率（0 与sensor一致，低于sensor时按采集时间戳抽帧），可由 CAMERA_FPS 覆盖
+        bool activity_governor = false; // 主码流画面静止时切到空闲配置，可由 CAMERA_IDLE 开启（格式见 parseActivityGovernorConfig）
+        ActivityGovernorConfig idle_config;
+        std::vector<PrivacyMask> privacy_masks; // 隐私遮挡区域（主码流分辨率下的坐标），可由 CAMERA_PRIVACY_MASK 设置（格式见 parsePrivacyMasks）
+        int motion_fps = 0; // 运动检测帧率（0 不开启，start() 时开启），可由 CAMERA_MOTION 设置
     };
 
+    /**
+     * 用环境变量覆盖 config（VideoEngine 的 CAMERA_* 配置项都在这里解析，未设置的项保持原值）：
+     *   CAMERA_PIPELINE        pipelined | manual | bound
+     *   CAMERA_FPS             主码流输出帧率（0~120）
+     *   CAMERA_RC_PROFILE      主码流码率控制（格式见 driver::parseRcProfile）
+     *   CAMERA_SUB_RC_PROFILE  各路子码流码率控制
+     *   CAMERA_IDLE            0 关闭，1 默认参数，或空闲配置（格式见 parseActivityGovernorConfig）
+     *   CAMERA_PRIVACY_MASK    隐私遮挡区域（格式见 parsePrivacyMasks）
+     *   CAMERA_MOTION          运动检测帧率（0~120）
+     * @return 0成功，-1有变量含无效项（已告警，其余项照常生效）
+     */
+    int loadVedioEngineConfigFromEnv(VedioEngineConfig &config);
+
     class VideoStreamProcessor;
 
     class VideoEngine
@@ -50,7 +101,7 @@ namespace core
         // 3. 停止业务流程
         void stop();
 
-        int popEncodedPacket(AVPacket *&out_pkt, int timeout_ms = 1000)
+        int popEncodedPacket(AVPacket *out_pkt, int timeout_ms = 1000)
         {
             return video_stream_processor_->popEncodedPacket(out_pkt, timeout_ms);
         }
@@ -60,8 +111,112 @@ namespace core
             return video_stream_processor_->getQueueFrontPts(pts, timeout_ms = 20);
         }
 
+        // 编码包队列（供复用调度器直接等待/出队）
+        infra::SPSCRing<AVPacket> &packetRing() { return video_stream_processor_->packetRing(); }
+
+        /**
+         * 按需开启/关闭CV旁路（VPSS额外输出一路RGB帧，带独立取帧线程和队列），没有CV消费者时不产出RGB
+         * @param request 为空时使用默认的 BGR888 640x360
+         */
+        int enableCvOutput(const VideoFormatRequest *request = nullptr);
+        void disableCvOutput();
+
+        // CV消费者取帧（需先 enableCvOutput），frame 析构/reset 时归还VPSS；0成功，-1超时，-2未开启
+        int acquireCvFrame(VPSSFrame &frame, int timeout_ms);
+
+        /**
+         * VPSS多路扇出：启用一路附加输出通道（独立分辨率/格式/帧率），
+         * 并在该通道专属线程中把每帧交给 consumer（如子码流编码、分析）
+         */
+        int attachChannelConsumer(const VPSSChnConfig &config, VPSSFrameConsumer consumer, size_t queue_depth = 2);
+        void detachChannel(int chn_id);
+
+        VPSSChnStats channelStats(int chn_id) const { return vpss_manager_->getChannelStats(chn_id); }
+
+        const VideoFormatPlan &formatPlan() const { return format_plan_; }
+
+        VideoPipelineMode pipelineMode() const { return pipeline_mode_; }
+
+        // 流水线模式各阶段的利用率统计（找出瓶颈阶段）
+        VideoPipeline &pipeline() { return video_stream_processor_->pipeline(); }
+
+        // 主码流帧节拍统计（实际帧率、抖动、抽帧数）
+        infra::FramePacerStats pacerStats() const { return video_stream_processor_->framePacer().getStats(); }
+
+        // 主码流编码通道（编码时延/码率统计）
+        VideoEncodeChannel &mainChannel() { return video_stream_processor_->encodeChannel(); }
+
+        // 码流轮询器：流水线模式下一个线程按fd就绪从主/子码流VENC通道取流
+        VencStreamPoller &streamPoller() { return stream_poller_; }
+
+        /**
+         * 请求IDR：index 为 -1 时主码流，否则为子码流序号
+         * @return 0成功，-1失败
+         */
+        int requestIDR(int index = -1);
+
+        /**
+         * 运行中切换码率控制配置（CBR/VBR/AVBR/FixQP、GOP、码率、QP），不重建编码通道
+         * index 为 -1 时主码流，否则为子码流序号
+         */
+        int setRcProfile(int index, const driver::RcProfile &profile);
+
+        /**
+         * 感兴趣区域：分析模块（运动/目标检测）在该编码流上注册来源并异步提交区域
+         * index 为 -1 时主码流，否则为子码流序号；无效时返回 nullptr
+         */
+        RoiController *roiController(int index);
+
+        /**
+         * 新的消费者（推流客户端、录像、抓拍）接入：取出最近一个GOP（av_packet_ref 引用，
+         * 调用方用 av_packet_free 释放），从其关键帧开始即可解码；没有可用的GOP时请求IDR
+         * @return gop 中的包数，-1 序号无效
+         */
+        int joinStream(int index, std::vector<AVPacket *> &gop);
+
+        /**
+         * 运动检测：专用VPSS通道（kMotionVpssChn，检测分辨率 NV12，按 fps 抽帧）的消费线程中逐帧检测，
+         * 事件在该线程中交给 callback（为空时只记录运动开始/结束日志）
+         * 需在 start() 之后调用；也可由环境变量 CAMERA_MOTION=<检测帧率> 在启动时开启
+         */
+        int enableMotionDetection(const MotionDetectorConfig &config, int fps = 10, MotionCallback callback = nullptr);
+        void disableMotionDetection();
+        // 未开启时返回 nullptr
+        MotionDetector *motionDetector() { return motion_detector_.get(); }
+
+        // 主码流的活动/空闲配置切换（未开启时返回 nullptr），切换回调需在 start() 之前设置
+        ActivityGovernor *activityGovernor() { return governor_.get(); }
+
+        /**
+         * 隐私遮挡：整体替换各路编码流（主码流与子码流）的遮挡区域，各路按自己的分辨率缩放，下一帧生效
+         * ref_width/ref_height 为区域坐标所在的分辨率，0 表示主码流编码分辨率；空列表清除所有区域
+         * 帧在送编码前原地处理，绑定模式下主码流帧不经过用户态，配置了区域时 init() 改用流水线模式；
+         * 以绑定模式运行时设置非空区域返回 -1（清除区域仍可调用）
+         */
+        int setPrivacyMasks(const std::vector<PrivacyMask> &masks, int ref_width = 0, int ref_height = 0);
+        // index 为 -1 时主码流，否则为子码流序号
+        PrivacyMaskStats privacyStats(int index);
+
+        // 附加编码流（子码流等），每路有独立的编码包队列
+        int subStreamCount() const { return (int)sub_streams_.size(); }
+        VideoEncodeChannel &subChannel(int index) { return *sub_streams_[index].channel; }
+        const VideoSubStreamConfig &subStreamConfig(int index) const { return sub_streams_[index].config; }
+
     private:
         void videoThread();
+        VideoEncodeChannel *channelAt(int index);
+        int bindPipeline(const VedioEngineConfig &config);
+
+        struct SubStream
+        {
+            VideoSubStreamConfig config;
+            driver::VideoEncoderDriver *venc_driver = nullptr;
+            VideoEncodeChannel *channel = nullptr;
+            PrivacyMasker *privacy = nullptr;
+        };
+        int initSubStreams(const std::vector<VideoSubStreamConfig> &configs);
+        int startSubStreams();
+        void stopSubStreams();
 
         driver::MPIManager *mpi_manager_;
         driver::ISPDriver *isp_driver_;
@@ -69,12 +224,21 @@ namespace core
         driver::VideoEncoderDriver *venc_driver_;
 
         core::VPSSManager *vpss_manager_;
-        core::VideoStreamProcessor *video_stream_processor_;
+        core::VideoStreamProcessor *video_stream_processor_ = nullptr;
+        std::vector<SubStream> sub_streams_;
+        VencStreamPoller stream_poller_;
+        std::unique_ptr<MotionDetector> motion_detector_;
+        std::unique_ptr<ActivityGovernor> governor_;
 
         std::thread video_thread_;
         std::atomic<bool> is_running_;
         bool is_inited_ = false;
         VENC_STREAM_S venc_stream_;
+        VideoFormatRequest format_request_;
+        VideoFormatPlan format_plan_;
+        VideoPipelineMode pipeline_mode_ = VideoPipelineMode::kPipelined;
+        int pipeline_depth_ = 2;
+        int motion_fps_ = 0;
     };
 
 } // namespace core
\ No newline at end of file
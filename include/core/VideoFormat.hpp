@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+extern "C"
+{
+#include "rk_comm_video.h"
+}
+
+namespace core
+{
+    // VPSS 单个输出通道配置
+    struct VPSSChnConfig
+    {
+        int chn_id = 0;
+        uint32_t width = 1920;
+        uint32_t height = 1080;
+        PIXEL_FORMAT_E pixel_format = RK_FMT_YUV420SP;
+        int src_fps = -1; // 帧率控制（-1 不限制），dst_fps < src_fps 时VPSS按比例抽帧
+        int dst_fps = -1;
+        uint32_t depth = 1; // 用户获取模式下的输出队列深度
+    };
+
+    // 像素格式协商的输入：编码器期望的格式 + 可选的CV消费者
+    struct VideoFormatRequest
+    {
+        uint32_t width = 1920;
+        uint32_t height = 1080;
+        int fps = 30;                                   // 传感器帧率
+        PIXEL_FORMAT_E encode_format = RK_FMT_YUV420SP; // VENC 输入格式（默认NV12快路径）
+
+        bool cv_consumer = false;                   // 是否有CV消费者需要RGB帧
+        PIXEL_FORMAT_E cv_format = RK_FMT_BGR888;   // CV消费者需要的格式
+        uint32_t cv_width = 640;                    // CV分支分辨率（通常远小于编码分辨率）
+        uint32_t cv_height = 360;
+        int cv_fps = -1;                            // CV分支帧率（-1 与输入一致）
+    };
+
+    // 协商结果：VI/VPSS/VENC 各自使用的格式
+    struct VideoFormatPlan
+    {
+        PIXEL_FORMAT_E vi_format = RK_FMT_YUV420SP;     // VI 输出（传感器原生NV12）
+        VPSSChnConfig encode_chn;                       // VPSS → VENC 主通道
+        PIXEL_FORMAT_E venc_format = RK_FMT_YUV420SP;   // VENC 输入格式（= encode_chn 格式）
+        bool cv_enabled = false;                        // 是否启用CV旁路通道
+        VPSSChnConfig cv_chn;                           // VPSS → CV 旁路通道（按需）
+
+        // 每帧（按主通道帧率计）在DDR上读写的字节数估算：各级输出各写一次、下游各读一次
+        size_t bytesPerFrame(int vi_fps = 30) const;
+    };
+
+    // 协商VI/VPSS/VENC像素格式，request 中的格式不被支持时返回 -1
+    int negotiateVideoFormats(const VideoFormatRequest &request, VideoFormatPlan &plan);
+
+    // VENC 是否能直接接收该格式
+    bool vencAcceptsFormat(PIXEL_FORMAT_E fmt);
+
+    // 一帧图像占用的字节数（不支持的格式返回0）
+    size_t frameBytes(PIXEL_FORMAT_E fmt, uint32_t width, uint32_t height);
+
+    const char *pixelFormatName(PIXEL_FORMAT_E fmt);
+
+} // namespace core
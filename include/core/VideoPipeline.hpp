@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace core
+{
+    // 阶段单次迭代中的阻塞耗时，由阶段函数自行累加
+    struct StageClock
+    {
+        uint64_t wait_us = 0;  // 等待输入（上游无数据）
+        uint64_t stall_us = 0; // 等待输出（下游队列满，被反压）
+    };
+
+    // 单个阶段的利用率统计
+    struct PipelineStageStats
+    {
+        std::string name;
+        uint64_t frames = 0;     // 处理的帧数
+        uint64_t errors = 0;     // 出错的迭代数
+        uint64_t busy_us = 0;    // 实际工作时间
+        uint64_t wait_us = 0;    // 等待上游时间
+        uint64_t stall_us = 0;   // 被下游反压时间
+        uint64_t elapsed_us = 0; // 阶段线程运行时长
+
+        // 忙碌占比：最接近 1 的阶段即瓶颈；其上游表现为 stall 高，下游表现为 wait 高
+        double utilisation() const { return elapsed_us ? (double)busy_us / elapsed_us : 0; }
+    };
+
+    /**
+     * 多线程视频流水线：每个阶段一个线程，循环调用阶段函数，阶段之间通过有界队列衔接
+     * 阶段函数返回 >0 表示处理了一帧，0 表示本轮没有帧（超时/抽帧），<0 表示出错（短暂退避后重试）。
+     * 阶段函数内的阻塞等待需有超时，以便 stop() 能及时结束线程。
+     */
+    class VideoPipeline
+    {
+    public:
+        typedef std::function<int(StageClock &clock)> StageBody;
+
+        VideoPipeline() = default;
+        ~VideoPipeline();
+
+        VideoPipeline(const VideoPipeline &) = delete;
+        VideoPipeline &operator=(const VideoPipeline &) = delete;
+
+        // 按数据流顺序注册阶段（需在 start() 之前调用）
+        int addStage(const std::string &name, StageBody body);
+
+        int start();
+        // 按注册顺序停止（上游先停，下游把在途帧处理完后随超时退出）
+        void stop();
+        bool isRunning() const { return running_; }
+
+        size_t stageCount() const { return stages_.size(); }
+        PipelineStageStats getStats(size_t index) const;
+        void printStats() const;
+
+        // 统计日志输出周期（秒），0 表示不输出
+        void setStatsInterval(int seconds) { stats_interval_s_ = seconds; }
+
+    private:
+        struct Stage
+        {
+            std::string name;
+            StageBody body;
+            std::atomic<bool> running{false};
+            std::thread thread;
+            std::atomic<uint64_t> frames{0};
+            std::atomic<uint64_t> errors{0};
+            std::atomic<uint64_t> busy_us{0};
+            std::atomic<uint64_t> wait_us{0};
+            std::atomic<uint64_t> stall_us{0};
+            std::atomic<uint64_t> start_us{0};
+            std::atomic<uint64_t> stop_us{0};
+        };
+        void stageLoop(Stage *stage, bool reporter);
+
+        std::vector<std::unique_ptr<Stage>> stages_;
+        bool running_ = false;
+        int stats_interval_s_ = 10;
+    };
+
+} // namespace core
@@ -1,13 +1,16 @@
 #pragma once
 #include "driver/VideoInputDriver.hpp"
 #include "driver/VideoEncoderDriver.hpp"
+#include "core/VideoEncodeChannel.hpp"
+#include "core/OsdRenderer.hpp"
+#include "core/PrivacyMasker.hpp"
+#include "core/VPSSManager.hpp"
+#include "core/VideoPipeline.hpp"
+#include "infra/queue/SPSCRing.hpp"
+#include "infra/time/FramePacer.h"
 #include <atomic>
+#include <memory>
 #include <thread>
-#include <queue>
-#include <mutex>
-#include <condition_variable>
-
-#include <opencv2/core/core.hpp>
 
 extern "C"
 {
@@ -26,7 +29,6 @@ namespace core
 {
     class VPSSManager;
     class RTSPEngine;
-    ;
 
     class VideoStreamProcessor
     {
@@ -48,33 +50,71 @@ namespace core
 
         int loopProcess();
 
+        // getFromVIAndsendToVPSS() 的返回值：该帧被节拍器按目标帧率抽掉（已归还VI，不送VPSS）
+        static const int kFrameDecimated = 1;
+
+        // 阻塞等待VI出帧，按节拍器决定放行后送VPSS
         int getFromVIAndsendToVPSS();
-        //
+        // 从VPSS取NV12帧并原地遮挡隐私区域、叠加OSD
         int getFromVPSSAndProcessWithOpenCV(VIDEO_FRAME_INFO_S &encode_frame);
 
         int sendToVENCAndGetEncodedPacket(VIDEO_FRAME_INFO_S &process_frame);
 
         int pushEncodedPacketToQueue();
+
+        // 绑定模式（VI→VPSS→VENC 由硬件传帧）：只从VENC取码流入队，无OSD叠加
+        int pullBoundStream(int timeout_ms = 1000);
+
+        /**
+         * 流水线模式：采集、处理（遮挡/OSD）、送编码、取码流 四个阶段各一个线程
+         *  采集 → 处理：VPSS编码通道的输出队列（深度由通道 depth 决定）
+         *  处理 → 送编码：深度为 depth 的VPSS帧队列（帧句柄独占MB块，出队送编码后归还）
+         *  送编码 → 取码流：VENC码流缓冲（个数由 stream_buf_cnt 决定）
+         * 第N帧编码与第N+1帧的采集、OSD叠加可同时进行。需在 start() 之后调用。
+         * drain_stage 为 false 时不建取码流线程，由 VencStreamPoller 按fd就绪取流。
+         */
+        int startPipeline(size_t depth = 2, bool drain_stage = true);
+        void stopPipeline();
+        VideoPipeline &pipeline() { return pipeline_; }
         bool getQueueFrontPts(int64_t &pkt, int timeout_ms);
 
         /**
          * 取出H.265的AVPacket（供推流线程）
-         * @param out_pkt 输出的AVPacket（需用av_packet_free释放）
+         * @param out_pkt 输出的AVPacket（队列内容移入，用完需av_packet_unref）
          * @param timeout_ms 超时时间
          * @return 0成功，-1超时，-2停止
          */
-        int popEncodedPacket(AVPacket *&out_pkt, int timeout_ms = 1000);
+        int popEncodedPacket(AVPacket *out_pkt, int timeout_ms = 1000);
+
+        infra::SPSCRing<AVPacket> &packetRing() { return encode_channel_.packetRing(); }
+
+        // 主码流编码通道（统计等）
+        VideoEncodeChannel &encodeChannel() { return encode_channel_; }
+
+        // 主码流隐私遮挡（送编码前原地处理，OSD叠加在遮挡之上）
+        PrivacyMasker &privacyMasker() { return privacy_; }
 
+        // 主码流帧节拍器（目标帧率、实际帧率/抖动/抽帧统计）
+        infra::FramePacer &framePacer() { return pacer_; }
+
+        // 归还未交给队列的VENC码流（已入队的码流由AVPacket释放时归还）
         void releaseStreamAndFrame();
 
-    private:
-        // 初始化编码流缓冲区（处理 stFrame.pstPack 的 malloc）
-        int initStreamBuffer();
+        // 替换VENC码流归还回调（mock测试用，需在start()之前调用）
+        void setStreamReleaseHook(VencReleaseHook hook) { encode_channel_.setStreamReleaseHook(std::move(hook)); }
 
-        // 释放编码流缓冲区（处理 stFrame.pstPack 的 free）
-        void releaseStreamBuffer();
+        // 已入队/推流中、尚未归还给VENC的码流数
+        int outstandingStreams() const { return encode_channel_.outstandingStreams(); }
+
+    private:
+        // 隐私遮挡 + OSD叠加 + 时间戳换算（VPSS输出帧原地处理）
+        void processFrame(VIDEO_FRAME_INFO_S &frame);
 
-        void enqueuePacket(AVPacket *pkt, std::unique_lock<std::mutex> &lock);
+        // 流水线各阶段的单次迭代
+        int captureStage(StageClock &clock);
+        int processStage(StageClock &clock);
+        int submitStage(StageClock &clock);
+        int drainStage(StageClock &clock);
 
         int initPool();
         void releasePool();
@@ -90,7 +130,12 @@ namespace core
         bool is_inited_; // 初始化标志
 
         std::atomic<bool> is_running_; // 循环控制标志（原子变量，线程安全）
-        VENC_STREAM_S venc_stream_;    // 编码流结构体（需长期管理，避免循环内重复malloc/free）
+        VideoEncodeChannel encode_channel_; // 主码流：VENC → 零拷贝AVPacket → 编码包队列
+        infra::FramePacer pacer_;           // 按采集时间戳抽帧到目标帧率
+
+        std::unique_ptr<infra::SPSCRing<VPSSFrame>> frame_ring_; // 处理 → 送编码
+        std::atomic<uint64_t> frame_ring_dropped_{0};            // 送编码阶段跟不上而丢弃的帧
+        VideoPipeline pipeline_; // 流水线模式的阶段线程（声明在其使用的成员之后，先于它们析构）
         VIDEO_FRAME_INFO_S vi_frame;
 
         // FPS计算
@@ -99,8 +144,13 @@ namespace core
         uint64_t start_time_; // 时间戳统计，用于计算FPS
         char m_fpsText[32];   // 帧率文本
 
-        // OpenCV帧缓冲
-        cv::Mat m_bgrFrame;
+        // OSD叠加（文本变化时才重新渲染，逐帧只混合小块tile）
+        OsdRenderer osd_;
+        int osd_fps_region_ = -1;
+
+        // 隐私遮挡（区域变化时才重新生成扫描线，逐帧只处理遮挡区域）
+        PrivacyMasker privacy_{"main"};
+
         MB_POOL m_mb_pool; // 用于存储YUV转换后的内存池
 
         int m_frameCount = 0; // 帧计数
@@ -109,12 +159,6 @@ namespace core
         int width = 1920;
         int height = 1080;
 
-        std::queue<AVPacket *> packet_queue_;
-        std::mutex queue_mutex_;                  // 队列互斥锁
-        std::condition_variable queue_cv_;        // 同步条件变量
-        size_t max_queue_size_ = 30;              // 最大队列大小
-        AVRational src_time_base_ = {1, 1000000}; // 时间基（微秒）
-
         AVPacket *cached_sps = nullptr; // 缓存H.265 SPS参数集（NAL类型32）
         AVPacket *cached_pps = nullptr; // 缓存H.265 PPS参数集（NAL类型34）
         bool has_sent_sps_pps = false;  // 标记SPS/PPS是否已发送给播放器
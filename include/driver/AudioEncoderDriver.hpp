@@ -3,6 +3,7 @@
 #include <mutex>
 #include <string>
 #include <vector>
+#include "infra/time/MediaClock.h"
 extern "C"
 {
 #include <libavcodec/avcodec.h>
@@ -46,10 +47,11 @@ namespace driver
          * 编码PCM数据
          * @param pcm_data 原始PCM数据指针
          * @param data_size PCM数据大小（字节）
-         * @param out_pkt 输出的编码后数据包（需调用者手动释放av_packet_unref）
+         * @param out_pkt 输出的编码后数据包（需调用者手动释放av_packet_unref），pts 为媒体时间（微秒）
+         * @param capture_us 该块PCM最后一个样本的采集时刻（单调时钟微秒）
          * @return 0=成功，非0=失败（AVERROR(EAGAIN)表示需要更多输入）
          */
-        int encode(const uint8_t *pcm_data, int data_size, AVPacket &out_pkt);
+        int encode(const uint8_t *pcm_data, int data_size, AVPacket &out_pkt, int64_t capture_us);
 
         /**
          * 刷新编码器（处理剩余缓存数据）
@@ -81,6 +83,7 @@ namespace driver
 
         std::vector<uint8_t> frame_buffer_; // 每个实例独立的缓冲区
         int64_t total_samples_ = 0;
+        infra::AudioTimestamper timestamper_{48000}; // 采集时刻 → 媒体时间（init时按采样率重建）
 
         /**
          * 初始化编码帧（分配缓冲区等）
@@ -0,0 +1,100 @@
+#pragma once
+
+extern "C"
+{
+#include "rk_mpi.h"
+#include "rk_comm_video.h"
+#include "rk_comm_vi.h"
+#include "rk_comm_vpss.h"
+#include "rk_comm_venc.h"
+#include "rk_comm_mb.h"
+}
+
+namespace driver
+{
+    /**
+     * MPI后端接口
+     * driver层对 RK_MPI_* 的所有调用都经过这里，便于替换实现：
+     *  - RKMPIBackend  : 板端实现，直接转发到 Rockit MPI
+     *  - SimMPIBackend : 主机端软件模拟（合成/录制NV12 + libswscale + libavcodec），
+     *                    用于在 x86 Linux 上运行和测量 VI→VPSS→VENC 整条流水线
+     * 具体使用哪个实现由 CMake 选项 CAMERA_SIM_BACKEND 在编译期决定。
+     * 接口参数与返回值语义与对应的 RK_MPI_* 函数保持一致（RK_SUCCESS 为成功）。
+     */
+    class MPIBackend
+    {
+    public:
+        virtual ~MPIBackend() = default;
+
+        // 获取当前编译选中的后端实例
+        static MPIBackend &instance();
+
+        // 后端名称（日志用）
+        virtual const char *name() const = 0;
+
+        // SYS
+        virtual int sysInit() = 0;
+        virtual int sysExit() = 0;
+        virtual int sysBind(const MPP_CHN_S &src, const MPP_CHN_S &dst) = 0;
+        virtual int sysUnBind(const MPP_CHN_S &src, const MPP_CHN_S &dst) = 0;
+
+        // MB 内存块
+        virtual MB_POOL mbCreatePool(MB_POOL_CONFIG_S &config) = 0;
+        virtual int mbDestroyPool(MB_POOL pool) = 0;
+        virtual MB_BLK mbGetMB(MB_POOL pool, RK_U64 size, bool block) = 0;
+        virtual int mbReleaseMB(MB_BLK blk) = 0;
+        virtual void *mbHandle2VirAddr(MB_BLK blk) = 0;
+
+        // VI
+        virtual int viGetDevAttr(VI_DEV dev, VI_DEV_ATTR_S &attr) = 0;
+        virtual int viSetDevAttr(VI_DEV dev, const VI_DEV_ATTR_S &attr) = 0;
+        virtual int viGetDevIsEnable(VI_DEV dev) = 0;
+        virtual int viEnableDev(VI_DEV dev) = 0;
+        virtual int viSetDevBindPipe(VI_DEV dev, const VI_DEV_BIND_PIPE_S &bind_pipe) = 0;
+        virtual int viSetChnAttr(VI_PIPE pipe, VI_CHN chn, const VI_CHN_ATTR_S &attr) = 0;
+        virtual int viEnableChn(VI_PIPE pipe, VI_CHN chn) = 0;
+        virtual int viDisableChn(VI_PIPE pipe, VI_CHN chn) = 0;
+        virtual int viGetChnFrame(VI_PIPE pipe, VI_CHN chn, VIDEO_FRAME_INFO_S &frame, int timeout) = 0;
+        virtual int viReleaseChnFrame(VI_PIPE pipe, VI_CHN chn, const VIDEO_FRAME_INFO_S &frame) = 0;
+
+        // VPSS
+        virtual int vpssCreateGrp(VPSS_GRP grp, const VPSS_GRP_ATTR_S &attr) = 0;
+        virtual int vpssDestroyGrp(VPSS_GRP grp) = 0;
+        virtual int vpssStartGrp(VPSS_GRP grp) = 0;
+        virtual int vpssStopGrp(VPSS_GRP grp) = 0;
+        virtual int vpssSetChnAttr(VPSS_GRP grp, VPSS_CHN chn, const VPSS_CHN_ATTR_S &attr) = 0;
+        virtual int vpssEnableChn(VPSS_GRP grp, VPSS_CHN chn) = 0;
+        virtual int vpssDisableChn(VPSS_GRP grp, VPSS_CHN chn) = 0;
+        virtual int vpssEnableBackupFrame(VPSS_GRP grp) = 0;
+        virtual int vpssDisableBackupFrame(VPSS_GRP grp) = 0;
+        virtual int vpssSendFrame(VPSS_GRP grp, const VIDEO_FRAME_INFO_S &frame, int timeout) = 0;
+        virtual int vpssGetChnFrame(VPSS_GRP grp, VPSS_CHN chn, VIDEO_FRAME_INFO_S &frame, int timeout) = 0;
+        virtual int vpssReleaseChnFrame(VPSS_GRP grp, VPSS_CHN chn, const VIDEO_FRAME_INFO_S &frame) = 0;
+
+        // VENC
+        virtual int vencCreateChn(VENC_CHN chn, const VENC_CHN_ATTR_S &attr) = 0;
+        virtual int vencDestroyChn(VENC_CHN chn) = 0;
+        virtual int vencStartRecvFrame(VENC_CHN chn, const VENC_RECV_PIC_PARAM_S &param) = 0;
+        virtual int vencStopRecvFrame(VENC_CHN chn) = 0;
+        virtual int vencSendFrame(VENC_CHN chn, const VIDEO_FRAME_INFO_S &frame, int timeout) = 0;
+        virtual int vencGetStream(VENC_CHN chn, VENC_STREAM_S &stream, int timeout) = 0;
+        virtual int vencReleaseStream(VENC_CHN chn, VENC_STREAM_S &stream) = 0;
+        // 运行时修改通道属性（码率、帧率等码率控制参数；分辨率和编码格式不可改）
+        virtual int vencGetChnAttr(VENC_CHN chn, VENC_CHN_ATTR_S &attr) = 0;
+        virtual int vencSetChnAttr(VENC_CHN chn, const VENC_CHN_ATTR_S &attr) = 0;
+        // 码率控制高级参数（QP上下限等）
+        virtual int vencGetRcParam(VENC_CHN chn, VENC_RC_PARAM_S &param) = 0;
+        virtual int vencSetRcParam(VENC_CHN chn, const VENC_RC_PARAM_S &param) = 0;
+        // 感兴趣区域（按 u32Index 设置/查询，下一帧起生效）
+        virtual int vencSetRoiAttr(VENC_CHN chn, const VENC_ROI_ATTR_S &attr) = 0;
+        virtual int vencGetRoiAttr(VENC_CHN chn, RK_U32 index, VENC_ROI_ATTR_S &attr) = 0;
+        // 请求下一帧编码为IDR（instant 为 true 时立即生效，不等当前GOP结束）
+        virtual int vencRequestIDR(VENC_CHN chn, bool instant) = 0;
+        // 通道状态，u32CurPacks 为下一帧码流的包个数（GetStream 前按它分配 pstPack）
+        virtual int vencQueryStatus(VENC_CHN chn, VENC_CHN_STATUS_S &status) = 0;
+        // 通道码流就绪的文件描述符（有码流可取时 poll 可读），<0 表示失败
+        virtual int vencGetFd(VENC_CHN chn) = 0;
+        virtual int vencCloseFd(VENC_CHN chn) = 0;
+    };
+
+} // namespace driver
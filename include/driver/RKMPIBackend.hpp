@@ -0,0 +1,72 @@
+#pragma once
+
+#include "driver/MPIBackend.hpp"
+
+namespace driver
+{
+    // 板端MPI后端：直接转发到 Rockit RK_MPI_* 接口
+    class RKMPIBackend : public MPIBackend
+    {
+    public:
+        const char *name() const override { return "rockit"; }
+
+        // SYS
+        int sysInit() override;
+        int sysExit() override;
+        int sysBind(const MPP_CHN_S &src, const MPP_CHN_S &dst) override;
+        int sysUnBind(const MPP_CHN_S &src, const MPP_CHN_S &dst) override;
+
+        // MB 内存块
+        MB_POOL mbCreatePool(MB_POOL_CONFIG_S &config) override;
+        int mbDestroyPool(MB_POOL pool) override;
+        MB_BLK mbGetMB(MB_POOL pool, RK_U64 size, bool block) override;
+        int mbReleaseMB(MB_BLK blk) override;
+        void *mbHandle2VirAddr(MB_BLK blk) override;
+
+        // VI
+        int viGetDevAttr(VI_DEV dev, VI_DEV_ATTR_S &attr) override;
+        int viSetDevAttr(VI_DEV dev, const VI_DEV_ATTR_S &attr) override;
+        int viGetDevIsEnable(VI_DEV dev) override;
+        int viEnableDev(VI_DEV dev) override;
+        int viSetDevBindPipe(VI_DEV dev, const VI_DEV_BIND_PIPE_S &bind_pipe) override;
+        int viSetChnAttr(VI_PIPE pipe, VI_CHN chn, const VI_CHN_ATTR_S &attr) override;
+        int viEnableChn(VI_PIPE pipe, VI_CHN chn) override;
+        int viDisableChn(VI_PIPE pipe, VI_CHN chn) override;
+        int viGetChnFrame(VI_PIPE pipe, VI_CHN chn, VIDEO_FRAME_INFO_S &frame, int timeout) override;
+        int viReleaseChnFrame(VI_PIPE pipe, VI_CHN chn, const VIDEO_FRAME_INFO_S &frame) override;
+
+        // VPSS
+        int vpssCreateGrp(VPSS_GRP grp, const VPSS_GRP_ATTR_S &attr) override;
+        int vpssDestroyGrp(VPSS_GRP grp) override;
+        int vpssStartGrp(VPSS_GRP grp) override;
+        int vpssStopGrp(VPSS_GRP grp) override;
+        int vpssSetChnAttr(VPSS_GRP grp, VPSS_CHN chn, const VPSS_CHN_ATTR_S &attr) override;
+        int vpssEnableChn(VPSS_GRP grp, VPSS_CHN chn) override;
+        int vpssDisableChn(VPSS_GRP grp, VPSS_CHN chn) override;
+        int vpssEnableBackupFrame(VPSS_GRP grp) override;
+        int vpssDisableBackupFrame(VPSS_GRP grp) override;
+        int vpssSendFrame(VPSS_GRP grp, const VIDEO_FRAME_INFO_S &frame, int timeout) override;
+        int vpssGetChnFrame(VPSS_GRP grp, VPSS_CHN chn, VIDEO_FRAME_INFO_S &frame, int timeout) override;
+        int vpssReleaseChnFrame(VPSS_GRP grp, VPSS_CHN chn, const VIDEO_FRAME_INFO_S &frame) override;
+
+        // VENC
+        int vencCreateChn(VENC_CHN chn, const VENC_CHN_ATTR_S &attr) override;
+        int vencDestroyChn(VENC_CHN chn) override;
+        int vencStartRecvFrame(VENC_CHN chn, const VENC_RECV_PIC_PARAM_S &param) override;
+        int vencStopRecvFrame(VENC_CHN chn) override;
+        int vencSendFrame(VENC_CHN chn, const VIDEO_FRAME_INFO_S &frame, int timeout) override;
+        int vencGetStream(VENC_CHN chn, VENC_STREAM_S &stream, int timeout) override;
+        int vencReleaseStream(VENC_CHN chn, VENC_STREAM_S &stream) override;
+        int vencGetChnAttr(VENC_CHN chn, VENC_CHN_ATTR_S &attr) override;
+        int vencSetChnAttr(VENC_CHN chn, const VENC_CHN_ATTR_S &attr) override;
+        int vencGetRcParam(VENC_CHN chn, VENC_RC_PARAM_S &param) override;
+        int vencSetRcParam(VENC_CHN chn, const VENC_RC_PARAM_S &param) override;
+        int vencSetRoiAttr(VENC_CHN chn, const VENC_ROI_ATTR_S &attr) override;
+        int vencGetRoiAttr(VENC_CHN chn, RK_U32 index, VENC_ROI_ATTR_S &attr) override;
+        int vencRequestIDR(VENC_CHN chn, bool instant) override;
+        int vencQueryStatus(VENC_CHN chn, VENC_CHN_STATUS_S &status) override;
+        int vencGetFd(VENC_CHN chn) override;
+        int vencCloseFd(VENC_CHN chn) override;
+    };
+
+} // namespace driver
@@ -0,0 +1,68 @@
+#pragma once
+#include <string>
+
+extern "C"
+{
+#include "rk_comm_venc.h"
+}
+
+namespace driver
+{
+    // 码率控制模式
+    enum class RcMode
+    {
+        kCbr,   // 恒定码率：带宽固定的链路（码率平稳，复杂画面质量下降）
+        kVbr,   // 可变码率：在最小/最大码率之间按画面复杂度分配
+        kAvbr,  // 自适应码率：静止画面降到最小码率，运动时升到目标码率（监控场景省带宽）
+        kFixQp, // 固定QP：不控码率，用于画质评估
+    };
+
+    // GOP结构
+    enum class GopMode
+    {
+        kNormalP, // 普通P帧：每 gop 帧一个IDR
+        kSmartP,  // 智能P帧：IDR间隔拉长到 gop，期间每 vir_idr_len 帧插入一个只参考长期参考帧（上一个IDR）的
+                  // 虚拟I帧作为随机接入点，静止画面省掉大部分I帧码率（固定机位监控场景）
+    };
+
+    /**
+     * 码率控制配置：模式、GOP、码率、QP范围、I帧QP差、码率统计时间
+     * 取值为0的项使用该编码格式的默认值（见 VideoEncoderDriver），可在运行中整体切换（setRcProfile）
+     */
+    struct RcProfile
+    {
+        RcMode mode = RcMode::kVbr;
+        int gop = 0;              // GOP长度（帧）
+        int bitrate_kbps = 0;     // 目标码率（CBR/VBR/AVBR）
+        int max_bitrate_kbps = 0; // 最大码率（VBR/AVBR）
+        int min_bitrate_kbps = 0; // 最小码率（VBR/AVBR）
+        int min_qp = 0;           // QP下限（CBR/VBR/AVBR，I帧与P帧共用）
+        int max_qp = 0;           // QP上限
+        int i_qp_delta = 0;       // I帧相对P帧的QP差（负值使I帧更清晰、码率尖峰更大）
+        int fix_i_qp = 0;         // 固定QP模式下I帧/P帧的QP
+        int fix_p_qp = 0;
+        int stat_time_s = 0;      // 码率统计窗口（秒），窗口越长码率越平稳、响应越慢
+        GopMode gop_mode = GopMode::kNormalP;
+        int vir_idr_len = 0;      // 智能P帧的虚拟I帧间隔（帧），默认取普通P帧的GOP长度；gop 默认为其10倍
+    };
+
+    const char *rcModeName(RcMode mode);
+    const char *gopModeName(GopMode mode);
+
+    /**
+     * 从 "key=value" 列表（逗号分隔）解析码率控制配置，未出现的项保持 profile 原值
+     *   mode=cbr|vbr|avbr|fixqp  gop=60  bitrate=4096  max=8192  min=1024
+     *   qp=20-48  iqp_delta=-2  fixqp=28/30  stat=2  gopmode=normalp|smartp  viridr=60
+     * 例：CAMERA_RC_PROFILE="mode=avbr,bitrate=3072,max=6144,min=512,qp=22-48"
+     *     CAMERA_SUB_RC_PROFILE="gopmode=smartp,gop=600,viridr=60"
+     * @return 0成功，-1有无法识别的项（已解析的项仍然生效）
+     */
+    int parseRcProfile(const std::string &text, RcProfile &profile);
+
+    // 按编码格式填充 VENC 码率控制属性（MJPEG 只支持CBR，其他模式按CBR处理）
+    void buildRcAttr(RK_CODEC_ID_E type, const RcProfile &profile, int src_fps, int dst_fps, VENC_RC_ATTR_S &attr);
+
+    // 按编码格式填充 GOP 结构属性（MJPEG 没有GOP，保持默认）
+    void buildGopAttr(RK_CODEC_ID_E type, const RcProfile &profile, VENC_GOP_ATTR_S &attr);
+
+} // namespace driver
@@ -0,0 +1,226 @@
+#pragma once
+
+#include "driver/MPIBackend.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+
+struct SwsContext;
+struct AVCodecContext;
+struct AVFrame;
+
+namespace driver
+{
+    // 模拟后端配置
+    struct SimBackendConfig
+    {
+        std::string source_file; // 录制的NV12原始文件（按VI分辨率逐帧循环读取），为空则生成合成画面
+        int fps = 30;            // 模拟sensor帧率，<=0 表示不限速（吞吐测试）
+    };
+
+    /**
+     * 主机端模拟MPI后端
+     *  - VI  : 按帧率节拍输出合成/录制的NV12帧，u64PTS 为 CLOCK_MONOTONIC 微秒（与板端一致）
+     *  - VPSS: libswscale 完成缩放与颜色空间转换，每个通道独立输出队列
+     *  - VENC: libavcodec 编码 H.264/H.265/MJPEG，码流放入模拟MB块，
+     *          未释放的码流数受 u32StreamBufCnt 限制（与硬件行为一致），
+     *          SetChnAttr/SetRcParam 修改码率控制参数后，下一次送帧前按新参数重建编码器（首帧为IDR），
+     *          SetRoiAttr 的相对QP区域作为帧的 ROI side data 交给编码器（不重建，绝对QP区域不支持），
+     *          GetFd 返回每通道一个 eventfd，有待取码流时可读（模拟驱动的码流就绪fd）
+     *  - SYS绑定: 每个绑定关系一个转发线程（VI→VPSS、VPSS→VENC），模拟硬件自动传帧
+     * 配置可通过 setConfig() 或环境变量 CAMERA_SIM_SOURCE / CAMERA_SIM_FPS 指定。
+     */
+    class SimMPIBackend : public MPIBackend
+    {
+    public:
+        SimMPIBackend();
+        ~SimMPIBackend() override;
+
+        SimMPIBackend(const SimMPIBackend &) = delete;
+        SimMPIBackend &operator=(const SimMPIBackend &) = delete;
+
+        // 获取模拟后端实例（与 MPIBackend::instance() 为同一对象）
+        static SimMPIBackend &instance();
+
+        void setConfig(const SimBackendConfig &config);
+
+        const char *name() const override { return "sim"; }
+
+        // SYS
+        int sysInit() override;
+        int sysExit() override;
+        int sysBind(const MPP_CHN_S &src, const MPP_CHN_S &dst) override;
+        int sysUnBind(const MPP_CHN_S &src, const MPP_CHN_S &dst) override;
+
+        // MB 内存块
+        MB_POOL mbCreatePool(MB_POOL_CONFIG_S &config) override;
+        int mbDestroyPool(MB_POOL pool) override;
+        MB_BLK mbGetMB(MB_POOL pool, RK_U64 size, bool block) override;
+        int mbReleaseMB(MB_BLK blk) override;
+        void *mbHandle2VirAddr(MB_BLK blk) override;
+
+        // VI
+        int viGetDevAttr(VI_DEV dev, VI_DEV_ATTR_S &attr) override;
+        int viSetDevAttr(VI_DEV dev, const VI_DEV_ATTR_S &attr) override;
+        int viGetDevIsEnable(VI_DEV dev) override;
+        int viEnableDev(VI_DEV dev) override;
+        int viSetDevBindPipe(VI_DEV dev, const VI_DEV_BIND_PIPE_S &bind_pipe) override;
+        int viSetChnAttr(VI_PIPE pipe, VI_CHN chn, const VI_CHN_ATTR_S &attr) override;
+        int viEnableChn(VI_PIPE pipe, VI_CHN chn) override;
+        int viDisableChn(VI_PIPE pipe, VI_CHN chn) override;
+        int viGetChnFrame(VI_PIPE pipe, VI_CHN chn, VIDEO_FRAME_INFO_S &frame, int timeout) override;
+        int viReleaseChnFrame(VI_PIPE pipe, VI_CHN chn, const VIDEO_FRAME_INFO_S &frame) override;
+
+        // VPSS
+        int vpssCreateGrp(VPSS_GRP grp, const VPSS_GRP_ATTR_S &attr) override;
+        int vpssDestroyGrp(VPSS_GRP grp) override;
+        int vpssStartGrp(VPSS_GRP grp) override;
+        int vpssStopGrp(VPSS_GRP grp) override;
+        int vpssSetChnAttr(VPSS_GRP grp, VPSS_CHN chn, const VPSS_CHN_ATTR_S &attr) override;
+        int vpssEnableChn(VPSS_GRP grp, VPSS_CHN chn) override;
+        int vpssDisableChn(VPSS_GRP grp, VPSS_CHN chn) override;
+        int vpssEnableBackupFrame(VPSS_GRP grp) override;
+        int vpssDisableBackupFrame(VPSS_GRP grp) override;
+        int vpssSendFrame(VPSS_GRP grp, const VIDEO_FRAME_INFO_S &frame, int timeout) override;
+        int vpssGetChnFrame(VPSS_GRP grp, VPSS_CHN chn, VIDEO_FRAME_INFO_S &frame, int timeout) override;
+        int vpssReleaseChnFrame(VPSS_GRP grp, VPSS_CHN chn, const VIDEO_FRAME_INFO_S &frame) override;
+
+        // VENC
+        int vencCreateChn(VENC_CHN chn, const VENC_CHN_ATTR_S &attr) override;
+        int vencDestroyChn(VENC_CHN chn) override;
+        int vencStartRecvFrame(VENC_CHN chn, const VENC_RECV_PIC_PARAM_S &param) override;
+        int vencStopRecvFrame(VENC_CHN chn) override;
+        int vencSendFrame(VENC_CHN chn, const VIDEO_FRAME_INFO_S &frame, int timeout) override;
+        int vencGetStream(VENC_CHN chn, VENC_STREAM_S &stream, int timeout) override;
+        int vencReleaseStream(VENC_CHN chn, VENC_STREAM_S &stream) override;
+        int vencGetChnAttr(VENC_CHN chn, VENC_CHN_ATTR_S &attr) override;
+        int vencSetChnAttr(VENC_CHN chn, const VENC_CHN_ATTR_S &attr) override;
+        int vencGetRcParam(VENC_CHN chn, VENC_RC_PARAM_S &param) override;
+        int vencSetRcParam(VENC_CHN chn, const VENC_RC_PARAM_S &param) override;
+        int vencSetRoiAttr(VENC_CHN chn, const VENC_ROI_ATTR_S &attr) override;
+        int vencGetRoiAttr(VENC_CHN chn, RK_U32 index, VENC_ROI_ATTR_S &attr) override;
+        int vencRequestIDR(VENC_CHN chn, bool instant) override;
+        int vencQueryStatus(VENC_CHN chn, VENC_CHN_STATUS_S &status) override;
+        int vencGetFd(VENC_CHN chn) override;
+        int vencCloseFd(VENC_CHN chn) override;
+
+    private:
+        // 模拟MB块（MB_BLK 即指向该结构的指针）
+        struct SimBlock
+        {
+            std::vector<uint8_t> data;
+        };
+
+        struct ViChn
+        {
+            VI_CHN_ATTR_S attr;
+            bool enabled = false;
+            uint64_t next_due_us = 0; // 下一帧的采集时刻
+            uint64_t frame_index = 0;
+        };
+
+        struct VpssChn
+        {
+            VPSS_CHN_ATTR_S attr;
+            bool enabled = false;
+            int fps_acc = 0;                       // 帧率控制累加器
+            SwsContext *sws = nullptr;             // 缩放/转换上下文（按输入参数缓存）
+            std::deque<VIDEO_FRAME_INFO_S> frames; // 待用户获取的输出帧
+        };
+
+        struct VpssGrp
+        {
+            VPSS_GRP_ATTR_S attr;
+            bool started = false;
+            std::map<VPSS_CHN, VpssChn> chns;
+        };
+
+        // 码流中的一个包（一个NAL单元，含起始码），各包共用码流的内存块
+        struct VencPackDesc
+        {
+            uint32_t offset;
+            uint32_t end;
+            VENC_DATA_TYPE_U type;
+        };
+
+        struct VencStream
+        {
+            SimBlock *blk;
+            uint32_t len;
+            uint64_t pts;
+            bool key;
+            std::vector<VencPackDesc> packs; // 与硬件一致按NAL分包：VPS/SPS/PPS/SEI/slice 各一包
+        };
+
+        static const int kSimMaxRoi = 8; // 与硬件一致，每通道最多8个区域
+        struct VencChn
+        {
+            VENC_CHN_ATTR_S attr;
+            bool recv = false;
+            AVCodecContext *ctx = nullptr;
+            AVFrame *frame = nullptr;  // YUV420P 编码输入帧
+            SwsContext *sws = nullptr; // 输入格式 → YUV420P
+            std::deque<VencStream> streams;
+            uint32_t outstanding = 0; // 已取出未释放的码流数
+            uint32_t seq = 0;
+            int efd = -1;            // 码流就绪fd（streams 非空时可读）
+            bool force_idr = false;  // 下一帧强制编码为IDR
+            VENC_RC_PARAM_S rc_param; // QP上下限（0 表示使用编码器默认值）
+            bool reconfigure = false; // 码率控制参数已修改，下一次送帧前重建编码器
+            int src_fps = 30;         // 输入/输出帧率：输出低于输入时按比例丢帧（与硬件一致）
+            int dst_fps = 30;
+            int fps_acc = 0;
+            VENC_ROI_ATTR_S roi[kSimMaxRoi]; // 按 u32Index 保存的感兴趣区域
+            bool roi_changed = false;        // 下一次送帧时更新帧的 ROI side data
+            std::mutex encode_mutex; // 串行化同一通道的编码调用
+        };
+
+        // 绑定关系：转发线程从源通道取帧送往目的通道
+        struct Binding
+        {
+            MPP_CHN_S src;
+            MPP_CHN_S dst;
+            std::atomic<bool> running{true};
+            std::thread thread;
+        };
+
+        static SimBlock *allocBlock(size_t size);
+        void bindLoop(Binding *binding);
+        void unbindAll();
+        static void freeBlock(MB_BLK blk);
+
+        void fillViFrame(const ViChn &vi, uint8_t *dst);
+        int openEncoder(VencChn &venc);
+        int openCodec(VencChn &venc, const VENC_CHN_ATTR_S &attr, const VENC_RC_PARAM_S &param);
+        static void setFrameRoi(AVFrame *frame, const VENC_ROI_ATTR_S *roi, RK_CODEC_ID_E type);
+        void closeEncoder(VencChn &venc);
+
+        SimBackendConfig config_;
+        FILE *source_fp_ = nullptr;
+
+        std::mutex vi_mutex_;
+        std::map<int, ViChn> vi_chns_; // key = (pipe << 16) | chn
+
+        std::mutex vpss_mutex_;
+        std::condition_variable vpss_cv_;
+        std::map<VPSS_GRP, VpssGrp> vpss_grps_;
+
+        std::mutex venc_mutex_;
+        std::condition_variable venc_cv_;
+        std::map<VENC_CHN, std::unique_ptr<VencChn>> venc_chns_;
+
+        std::mutex bind_mutex_;
+        std::vector<std::unique_ptr<Binding>> bindings_;
+
+        MB_POOL next_pool_id_ = 0;
+    };
+
+} // namespace driver
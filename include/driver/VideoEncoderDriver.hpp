@@ -1,4 +1,8 @@
 #pragma once
+#include "driver/RcProfile.hpp"
+#include <mutex>
+#include <vector>
+
 extern "C"
 {
 #include "rk_mpi.h"
@@ -7,12 +11,35 @@ extern "C"
 
 namespace driver
 {
+    class MPIBackend;
+
     struct VideoEncoderConfig
     {
         int chn_id = 0;                           // 编码通道ID
         int width = 1920;                         // 编码宽度
         int height = 1080;                        // 编码高度
         RK_CODEC_ID_E en_type = RK_VIDEO_ID_HEVC; // 编码格式（H265）
+        int stream_buf_cnt = 2;                   // 码流缓冲个数（零拷贝时需覆盖所有在途包）
+        int stream_buf_size = 0;                  // 单个码流缓冲字节数，0 按峰值码率估算（见 VideoEncoderDriver::streamBufSize）
+        PIXEL_FORMAT_E pixel_format = RK_FMT_YUV420SP; // 输入像素格式（需与VPSS编码通道一致）
+
+        RcProfile rc;             // 码率控制（模式/GOP/码率/QP/普通或智能P帧），0 表示使用该编码格式的默认值
+        int fps = 0;              // 输入/输出帧率（送帧前已按目标帧率抽帧，0 使用编码器默认30fps）
+    };
+
+    // 每个编码通道的感兴趣区域个数上限（VENC 硬件限制）
+    constexpr int kMaxRoiRegions = 8;
+
+    // 感兴趣区域：区域内按 qp 调整量化（人脸、车牌、出入口等），区域外照常码率控制
+    struct RoiRegion
+    {
+        int x = 0; // 编码分辨率下的像素坐标，下发时向外扩展到16像素对齐
+        int y = 0;
+        int width = 0;
+        int height = 0;
+        int qp = 0;          // 相对QP（负值提高画质，通常 -3 ~ -8），abs_qp 时为绝对QP
+        bool abs_qp = false;
+        bool intra = false;  // 区域内强制帧内编码（快速运动目标，码率代价大）
     };
 
     class VideoEncoderDriver
@@ -37,16 +64,64 @@ namespace driver
         // 释放VENC编码流（封装 RK_MPI_VENC_ReleaseStream）
         void releaseStream(const VENC_STREAM_S &stream);
 
+        // 请求IDR（封装 RK_MPI_VENC_RequestIDR），新的消费者接入时调用以缩短起播等待
+        int requestIDR(bool instant = true);
+
+        // 查询通道状态（封装 RK_MPI_VENC_QueryStatus），u32CurPacks 为下一帧码流的包个数
+        int queryStatus(VENC_CHN_STATUS_S &status);
+
+        /**
+         * 运行时调整码率控制（封装 RK_MPI_VENC_SetChnAttr / SetRcParam），无需重建通道
+         *  - setBitrate  : 目标码率，VBR 的最大/最小码率按原比例随之缩放
+         *  - setFrameRate: 输出帧率（不超过输入帧率，VENC 内部按比例丢帧）
+         *  - setQpRange  : P帧的QP上下限（I帧QP范围由 setRcProfile 的配置决定，不受影响）
+         * 可在任意线程调用，成功返回0
+         */
+        int setBitrate(int bitrate_kbps);
+        /**
+         * 整体切换码率控制配置（模式、GOP长度与结构、码率、QP），通道不重建，下一帧起生效
+         * 输出帧率保持当前值（可能已被码率自适应降低）
+         */
+        int setRcProfile(const RcProfile &profile);
+        RcProfile rcProfile() const;
+        int setFrameRate(int fps);
+        int setQpRange(int min_qp, int max_qp);
+        // 当前生效的目标码率 / 输出帧率
+        int bitrateKbps() const;
+        int frameRate() const;
+
+        /**
+         * 整体替换感兴趣区域（封装 RK_MPI_VENC_SetRoiAttr），下一帧起生效
+         * 最多 kMaxRoiRegions 个，超出的忽略；索引大的区域在重叠处优先；传空列表关闭全部区域
+         * 可在任意线程调用，成功返回0
+         */
+        int setRoiRegions(const std::vector<RoiRegion> &regions);
+        int roiRegionCount() const;
+
+        // 码流就绪fd（封装 RK_MPI_VENC_GetFd），有码流可取时 poll 可读；失败返回 -1
+        int getFd();
+        void closeFd();
+
+        int chnId() const { return venc_config_.chn_id; }
+        const VideoEncoderConfig &config() const { return venc_config_; }
+
     private:
         // 私有辅助函数：拆分初始化逻辑（单一职责）
         void configRcParams();   // 配置码率控制参数（按编码格式）
+        int applyRcParam(const RcProfile &profile); // QP范围、I帧QP差（通道创建后设置）
         void configCommonAttr(); // 配置通用编码属性（分辨率、像素格式等）
+        RK_U32 streamBufSize();  // 单个码流缓冲大小（需在 configRcParams 之后调用）
 
         VideoEncoderConfig venc_config_; // 编码配置
 
         // VENC配置结构体（需长期保存，用于后续查询或修改）
+        mutable std::mutex attr_mutex_;    // 保护 st_attr_ / rc_（运行时码率调整）
+        RcProfile rc_;                     // 当前生效的码率控制配置
         VENC_CHN_ATTR_S st_attr_;          // 编码通道属性
         VENC_RECV_PIC_PARAM_S recv_param_; // 帧接收参数
+        mutable std::mutex roi_mutex_;     // 串行化区域下发
+        int roi_count_ = 0;                // 当前已启用的区域数（索引 0 ~ roi_count_-1）
+        MPIBackend &mpi_;                  // MPI后端（板端/模拟）
     };
 
 } // namespace driver
\ No newline at end of file
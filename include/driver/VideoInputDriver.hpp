@@ -9,6 +9,8 @@ extern "C"
 
 namespace driver
 {
+    class MPIBackend;
+
     struct VideoInputConfig
     {
         int dev_id = 0; // VI设备ID
@@ -37,6 +39,7 @@ namespace driver
         int vi_chn_init(driver::VideoInputConfig &config);
 
         VideoInputConfig vi_config_;
+        MPIBackend &mpi_; // MPI后端（板端/模拟）
     };
 
 } // namespace driver
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace infra
+{
+    /**
+     * NV12 图像处理内核：格式转换、缩放、裁剪、叠加、马赛克
+     * 直接在调用方的缓冲（VPSS/VENC 的MB缓冲、AVFrame）上读写，调用过程中不分配内存；
+     * 每个内核有 ARM NEON、x86 SSE2（部分有 AVX2）与标量三种实现，按编译目标选择，结果按位一致。
+     * 所有内核都是无状态的纯函数（BilinearScaler 除外），可在任意线程并发调用。
+     */
+    namespace imgproc
+    {
+        // NV12 图像视图：Y平面 + UV交织平面（宽高为偶数），只描述缓冲，不持有内存
+        struct NV12Image
+        {
+            uint8_t *y = nullptr;
+            uint8_t *uv = nullptr;
+            int width = 0;
+            int height = 0;
+            int y_stride = 0;
+            int uv_stride = 0;
+        };
+
+        // I420 图像视图：Y、U、V 三个平面
+        struct I420Image
+        {
+            uint8_t *y = nullptr;
+            uint8_t *u = nullptr;
+            uint8_t *v = nullptr;
+            int width = 0;
+            int height = 0;
+            int y_stride = 0;
+            int u_stride = 0;
+            int v_stride = 0;
+        };
+
+        // RGB 输出的字节顺序（OpenCV 默认 BGR）
+        enum class RgbOrder
+        {
+            kRGB,
+            kBGR,
+        };
+
+        /**
+         * 按MB缓冲的布局描述一帧NV12：UV平面紧接在 stride x vir_height 的Y平面之后
+         * （VIDEO_FRAME_S 的 u32VirWidth / u32VirHeight，vir_height 为0时取 height）
+         */
+        NV12Image nv12View(void *base, int width, int height, int stride, int vir_height = 0);
+
+        // 裁剪：返回原缓冲内子区域的视图（不拷贝），坐标与尺寸向下取偶并限制在图像内
+        NV12Image cropNV12(const NV12Image &src, int x, int y, int width, int height);
+
+        // 逐行拷贝（尺寸取两者较小值），配合 cropNV12 得到独立的裁剪图像
+        int copyNV12(const NV12Image &src, const NV12Image &dst);
+
+        // NV12 ↔ I420（Y平面拷贝，UV交织/解交织），尺寸必须相同；成功返回0
+        int nv12ToI420(const NV12Image &src, const I420Image &dst);
+        int i420ToNV12(const I420Image &src, const NV12Image &dst);
+
+        /**
+         * NV12 → 24位RGB/BGR（BT.601 limited range，6位定点，色度按2x2最近邻）
+         * rgb 至少 rgb_stride x height 字节
+         */
+        int nv12ToRgb(const NV12Image &src, uint8_t *rgb, int rgb_stride, RgbOrder order = RgbOrder::kBGR);
+
+        /**
+         * 把 src 按逐像素 alpha（与 src 同分辨率，0 透明 ~ 255 不透明）叠加到 dst 的 (x, y) 处，原地修改 dst
+         * 色度使用每个2x2块左上角像素的 alpha；超出 dst 的部分裁掉
+         */
+        int blendNV12(const NV12Image &dst, int x, int y, const NV12Image &src, const uint8_t *alpha, int alpha_stride);
+
+        /**
+         * 马赛克：区域内按 block x block 像素块取平均值填充（Y与UV分别平均），原地修改
+         * block 为2~256的偶数，区域边缘不足一块的按实际大小平均
+         */
+        int mosaicNV12(const NV12Image &image, int x, int y, int width, int height, int block);
+
+        /**
+         * 双线性缩放（8位定点权重，像素中心对齐）：configure 时按源/目标尺寸预先计算每列/每行的
+         * 采样位置与权重，之后每帧只做插值。垂直方向按整行SIMD插值，水平方向按预计算的列表取样；
+         * 缩小时先垂直后水平（插值行宽为源宽），放大时先水平后垂直（每个源行只水平取样一次）。
+         * 非线程安全：一个实例同一时刻只能在一个线程中使用
+         */
+        class BilinearScaler
+        {
+        public:
+            // 源宽高不小于4（色度平面每维至少2个采样点）、目标宽高不小于2，均为偶数；成功返回0
+            int configure(int src_width, int src_height, int dst_width, int dst_height);
+
+            // 尺寸必须与 configure 一致
+            int scaleNV12(const NV12Image &src, const NV12Image &dst);
+
+        private:
+            struct Axis
+            {
+                std::vector<int> index;     // 左/上采样点
+                std::vector<uint16_t> frac; // 右/下采样点的权重（0~256）
+            };
+            static void buildAxis(int src_size, int dst_size, Axis &axis);
+            void scalePlane(const uint8_t *src, int src_stride, uint8_t *dst, int dst_stride, const Axis &xs,
+                            const Axis &ys, int channels, bool horizontal_first);
+
+            int src_width_ = 0;
+            int src_height_ = 0;
+            int dst_width_ = 0;
+            int dst_height_ = 0;
+            Axis luma_x_;
+            Axis luma_y_;
+            Axis chroma_x_;
+            Axis chroma_y_;
+            std::vector<uint8_t> row_;     // 缩小：垂直插值后的一行
+            std::vector<uint8_t> hrow_[2]; // 放大：相邻两个源行水平取样的结果
+        };
+
+        // 当前使用的指令集："neon" / "avx2" / "sse2" / "scalar"
+        const char *simdName();
+
+        // 强制使用标量内核（与SIMD结果对比用），对所有调用生效
+        void setForceScalar(bool force);
+
+    } // namespace imgproc
+} // namespace infra
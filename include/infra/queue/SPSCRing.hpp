@@ -0,0 +1,643 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+}
+
+namespace infra
+{
+    // 队列满时的丢弃策略
+    enum class DropPolicy
+    {
+        DropOldest,     // 丢弃最早的元素
+        DropToKeyframe, // 丢弃到下一个关键帧（保证队列中的码流可独立解码）
+        Block,          // 阻塞生产者直到有空位或超时
+    };
+
+    // 元素被丢弃的原因（按原因分别计数）
+    enum class DropReason
+    {
+        Oldest,     // DropOldest：队列满，淘汰最早的元素
+        GopTail,    // DropToKeyframe：队列满，丢弃最早的GOP（队头到下一个关键帧为止）；或参考帧已被丢弃，消费者跳过其后续帧
+        Superseded, // DropToKeyframe：队列满时来了新关键帧，最早的GOP让位（队列中只有一个GOP时整体丢弃）
+        AwaitKey,   // DropToKeyframe：参考帧已被丢弃，后续帧无法解码，等待下一个关键帧
+        Disposable, // 队列水位高或已满时丢弃非参考帧（不影响其他帧解码）
+        Closed,     // 队列已关闭或 Block 策略等待超时
+        kCount
+    };
+
+    inline const char *dropReasonName(DropReason reason)
+    {
+        switch (reason)
+        {
+        case DropReason::Oldest:
+            return "oldest";
+        case DropReason::GopTail:
+            return "gop_tail";
+        case DropReason::Superseded:
+            return "superseded";
+        case DropReason::AwaitKey:
+            return "await_key";
+        case DropReason::Disposable:
+            return "disposable";
+        case DropReason::Closed:
+            return "closed";
+        default:
+            return "unknown";
+        }
+    }
+
+    // 丢弃策略的可调参数（每个队列单独配置）
+    struct DropConfig
+    {
+        // 队列中元素数达到该值时丢弃新来的非参考帧，给参考帧留出空间（0 不提前丢弃）
+        size_t disposable_watermark = 0;
+        // 进入"等待关键帧"状态时调用 key_request（如请求IDR），两次调用的最小间隔
+        int key_request_interval_ms = 1000;
+        std::function<void()> key_request;
+    };
+
+    /**
+     * 环形队列元素特性（move-only 类型的默认实现）
+     *  - Slot    : 槽位中实际保存的类型，构造队列时一次性分配
+     *  - moveIn  : 生产者把元素移入槽位（源对象被置空）
+     *  - moveOut : 消费者把槽位内容移出到目标（槽位被置空）
+     *  - reset   : 丢弃槽位/元素内容
+     *  - isKey / pts : 供丢弃策略和 peekFront() 使用
+     *  - isDisposable : 丢弃后不影响其他元素（非参考帧），队列水位高时优先丢弃
+     */
+    template <typename T>
+    struct RingTraits
+    {
+        typedef T Slot;
+        static void init(Slot &) {}
+        static void destroy(Slot &slot) { slot = T(); }
+        static void moveIn(Slot &slot, T &item) { slot = std::move(item); }
+        static void moveOut(T &out, Slot &slot) { out = std::move(slot); }
+        static void reset(Slot &slot) { slot = T(); }
+        static void release(T &item) { item = T(); }
+        static bool isKey(const T &) { return true; }
+        static bool isDisposable(const T &) { return false; }
+        static int64_t pts(const T &) { return 0; }
+    };
+
+    // AVPacket：槽位为预分配的 AVPacket，入队/出队均为 av_packet_move_ref（不拷贝、不增减引用）
+    template <>
+    struct RingTraits<AVPacket>
+    {
+        typedef AVPacket *Slot;
+        static void init(Slot &slot) { slot = av_packet_alloc(); }
+        static void destroy(Slot &slot) { av_packet_free(&slot); }
+        static void moveIn(Slot &slot, AVPacket &item) { av_packet_move_ref(slot, &item); }
+        static void moveOut(AVPacket &out, Slot &slot)
+        {
+            av_packet_unref(&out);
+            av_packet_move_ref(&out, slot);
+        }
+        static void reset(Slot &slot) { av_packet_unref(slot); }
+        static void release(AVPacket &item) { av_packet_unref(&item); }
+        static bool isKey(const AVPacket &item) { return (item.flags & AV_PKT_FLAG_KEY) != 0; }
+        static bool isDisposable(const AVPacket &item) { return (item.flags & AV_PKT_FLAG_DISPOSABLE) != 0; }
+        static int64_t pts(const AVPacket &item) { return item.pts; }
+    };
+
+    /**
+     * 单生产者/单消费者无锁环形队列
+     *  - 槽位在构造时预分配，运行期入队/出队无内存分配、无互斥锁
+     *  - 每个槽位带序号（Vyukov 有界队列），DropOldest/DropToKeyframe 时生产者
+     *    以"第二个消费者"的身份 CAS 队头淘汰旧元素，与消费者之间无锁竞争
+     *  - 阻塞等待基于 eventfd，仅在对端确实在等待时才写 eventfd（无等待者时零系统调用）
+     *  - readFd() 可交给 poll() 与其他队列一起等待（配合 beginWait()/endWait()）
+     * 元素的 pts / 关键帧标志另存一份原子副本，消费者可无锁 peekFront()。
+     */
+    template <typename T, typename Traits = RingTraits<T>>
+    class SPSCRing
+    {
+    public:
+        // push() 返回值
+        enum
+        {
+            kPushOk = 0,        // 入队成功
+            kPushDropped = 1,   // 按丢弃策略丢弃了新元素（非参考帧，或 DropToKeyframe 等待关键帧期间）
+            kPushTimeout = -1,  // Block 策略下等待空位超时
+            kPushClosed = -2,   // 队列已关闭
+        };
+
+        explicit SPSCRing(size_t capacity, DropPolicy policy = DropPolicy::DropOldest)
+            : capacity_(capacity > 0 ? capacity : 1), policy_(policy)
+        {
+            size_t cells = 1;
+            while (cells < capacity_)
+                cells <<= 1;
+            mask_ = cells - 1;
+            cells_.reset(new Cell[cells]);
+            for (size_t i = 0; i < cells; i++)
+            {
+                cells_[i].seq.store(i, std::memory_order_relaxed);
+                Traits::init(cells_[i].slot);
+            }
+            data_efd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            space_efd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        }
+
+        ~SPSCRing()
+        {
+            clear();
+            for (size_t i = 0; i <= mask_; i++)
+                Traits::destroy(cells_[i].slot);
+            if (data_efd_ >= 0)
+                ::close(data_efd_);
+            if (space_efd_ >= 0)
+                ::close(space_efd_);
+        }
+
+        SPSCRing(const SPSCRing &) = delete;
+        SPSCRing &operator=(const SPSCRing &) = delete;
+
+        /**
+         * 生产者：把 item 移入队列（成功后 item 被置空；被丢弃时 item 同样被释放）
+         * @param timeout_ms 仅 Block 策略使用，-1 表示一直等待
+         */
+        int push(T &item, int timeout_ms = -1)
+        {
+            if (closed_.load(std::memory_order_acquire))
+            {
+                Traits::release(item);
+                return kPushClosed;
+            }
+
+            bool key = Traits::isKey(item);
+            bool disposable = !key && Traits::isDisposable(item);
+            if (policy_ == DropPolicy::DropToKeyframe && skip_until_key_)
+            {
+                if (!key)
+                {
+                    Traits::release(item);
+                    countDrop(DropReason::AwaitKey, 1);
+                    requestKey();
+                    return kPushDropped;
+                }
+                skip_until_key_ = false;
+            }
+
+            // 水位高时先丢非参考帧，尽量避免之后整段丢弃GOP
+            if (drop_config_.disposable_watermark > 0 && disposable && size() >= drop_config_.disposable_watermark)
+            {
+                Traits::release(item);
+                countDrop(DropReason::Disposable, 1);
+                return kPushDropped;
+            }
+
+            while (!tryPush(item, key, disposable))
+            {
+                if (policy_ == DropPolicy::Block)
+                {
+                    int ret = waitSpace(timeout_ms);
+                    if (ret != 0)
+                    {
+                        Traits::release(item);
+                        countDrop(DropReason::Closed, 1);
+                        return ret == -2 ? kPushClosed : kPushTimeout;
+                    }
+                    continue;
+                }
+
+                // 消费者正在移出队头元素（已占位但槽位尚未归还），稍等即可
+                if (size() < capacity_)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                if (policy_ == DropPolicy::DropOldest)
+                {
+                    if (tryTake(nullptr))
+                        countDrop(DropReason::Oldest, 1);
+                    continue;
+                }
+
+                // DropToKeyframe：先丢非参考帧（新元素或队头），不影响其他帧解码
+                if (disposable)
+                {
+                    Traits::release(item);
+                    countDrop(DropReason::Disposable, 1);
+                    return kPushDropped;
+                }
+                if (tryTakeIf(nullptr, TakeIf::kDisposable) == kTaken)
+                {
+                    countDrop(DropReason::Disposable, 1);
+                    continue;
+                }
+
+                // 再丢弃最早的一个GOP：队头及其后直到下一个关键帧的元素（关键帧的判断与出队针对同一个元素，
+                // 见 tryTakeIf；消费者同时取走的同一GOP后续帧由 pop() 按 broken_gop_ 丢弃）。
+                // 新元素是关键帧时只让出最早的GOP，队列中只剩这一个GOP时才整体丢弃
+                size_t count = 0;
+                if (tryTake(nullptr))
+                    count++;
+                TakeResult result;
+                while ((result = tryTakeIf(nullptr, TakeIf::kNotKey)) == kTaken)
+                    count++;
+                countDrop(key ? DropReason::Superseded : DropReason::GopTail, count);
+                if (count == 0)
+                    continue; // 消费者已把队列取空，没有丢弃任何元素
+                if (result == kEmpty && !key)
+                {
+                    // 队列中没有后续关键帧：新元素依赖已丢弃的参考帧，一并丢弃直到下一个关键帧，
+                    // 同时请求关键帧，不必等到当前GOP自然结束
+                    skip_until_key_ = true;
+                    Traits::release(item);
+                    countDrop(DropReason::AwaitKey, 1);
+                    requestKey();
+                    return kPushDropped;
+                }
+            }
+            pushed_.fetch_add(1, std::memory_order_relaxed);
+            notify(consumer_waiting_, data_efd_);
+            return kPushOk;
+        }
+
+        /**
+         * 消费者：取出队头元素到 out
+         * @param timeout_ms 0 不等待，-1 一直等待
+         * @return 0成功，-1超时，-2队列已关闭
+         */
+        int pop(T &out, int timeout_ms = -1)
+        {
+            for (;;)
+            {
+                if (closed_.load(std::memory_order_acquire))
+                    return -2;
+                TakeResult result = tryTakeIf(&out, TakeIf::kAny);
+                if (result == kTaken)
+                {
+                    notify(producer_waiting_, space_efd_);
+                    return 0;
+                }
+                if (result == kBroken)
+                {
+                    // 所在GOP的参考帧已被丢弃，该帧无法解码，继续取下一个
+                    countDrop(DropReason::GopTail, 1);
+                    notify(producer_waiting_, space_efd_);
+                    continue;
+                }
+                int ret = waitReadable(timeout_ms);
+                if (ret != 0)
+                    return ret;
+            }
+        }
+
+        /**
+         * 消费者：无锁读取队头元素的 pts / 关键帧标志（不出队）
+         * @return false 表示队列为空
+         */
+        bool peekFront(int64_t &pts, bool *key = nullptr) const
+        {
+            for (;;)
+            {
+                size_t pos = head_.load(std::memory_order_acquire);
+                const Cell &cell = cells_[pos & mask_];
+                if (cell.seq.load(std::memory_order_acquire) != pos + 1)
+                    return false;
+                int64_t p = cell.pts.load(std::memory_order_relaxed);
+                bool k = cell.key.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                // 读取期间队头未被生产者淘汰，则读到的元数据有效
+                if (head_.load(std::memory_order_relaxed) == pos &&
+                    cell.seq.load(std::memory_order_relaxed) == pos + 1)
+                {
+                    pts = p;
+                    if (key)
+                        *key = k;
+                    return true;
+                }
+            }
+        }
+
+        /**
+         * 消费者：等待队列非空
+         * @return 0有数据，-1超时，-2队列已关闭
+         */
+        int waitReadable(int timeout_ms)
+        {
+            // eventfd 上可能残留之前的唤醒（通知与 endWait 交错），被唤醒后需重新检查，直到有数据或超时
+            Deadline deadline(timeout_ms);
+            for (;;)
+            {
+                if (!empty())
+                    return 0;
+                if (closed_.load(std::memory_order_acquire))
+                    return -2;
+                int wait_ms = deadline.remainingMs();
+                if (wait_ms == 0)
+                    return -1;
+                if (beginWait())
+                {
+                    struct pollfd pfd = {data_efd_, POLLIN, 0};
+                    poll(&pfd, 1, wait_ms);
+                }
+                endWait();
+            }
+        }
+
+        /**
+         * 外部 poll() 多个队列时使用：
+         * beginWait() 返回 true 表示队列仍为空，可以在 readFd() 上等待；等待结束后必须调用 endWait()
+         */
+        bool beginWait()
+        {
+            consumer_waiting_.store(true, std::memory_order_seq_cst);
+            return empty() && !closed_.load(std::memory_order_seq_cst);
+        }
+
+        void endWait()
+        {
+            consumer_waiting_.store(false, std::memory_order_relaxed);
+            drain(data_efd_);
+        }
+
+        int readFd() const { return data_efd_; }
+
+        // 关闭队列：唤醒所有等待者，之后 push/pop 返回 -2
+        void close()
+        {
+            closed_.store(true, std::memory_order_seq_cst);
+            eventfd_write(data_efd_, 1);
+            eventfd_write(space_efd_, 1);
+        }
+
+        bool isClosed() const { return closed_.load(std::memory_order_acquire); }
+
+        // 重新打开已关闭的队列（队列中残留的元素保留）
+        void open()
+        {
+            closed_.store(false, std::memory_order_seq_cst);
+            drain(data_efd_);
+            drain(space_efd_);
+        }
+
+        // 丢弃队列中所有元素，返回丢弃个数（生产者或消费者均可调用）
+        size_t clear()
+        {
+            size_t count = 0;
+            while (tryTake(nullptr))
+                count++;
+            if (count > 0)
+                notify(producer_waiting_, space_efd_);
+            return count;
+        }
+
+        size_t size() const
+        {
+            size_t tail = tail_.load(std::memory_order_acquire);
+            size_t head = head_.load(std::memory_order_acquire);
+            return tail > head ? tail - head : 0;
+        }
+
+        bool empty() const { return size() == 0; }
+        size_t capacity() const { return capacity_; }
+        DropPolicy policy() const { return policy_; }
+
+        // 元素时间戳的时间基（由生产者在开始入队前设置，随队列传给消费者）
+        void setTimeBase(AVRational time_base) { time_base_ = time_base; }
+        AVRational timeBase() const { return time_base_; }
+
+        // 丢弃策略参数（由生产者在开始入队前设置）
+        void setDropConfig(const DropConfig &config) { drop_config_ = config; }
+        const DropConfig &dropConfig() const { return drop_config_; }
+
+        // 统计：成功入队数 / 被丢弃数（总数与按原因）/ 请求关键帧次数
+        uint64_t pushedCount() const { return pushed_.load(std::memory_order_relaxed); }
+        uint64_t droppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+        uint64_t droppedCount(DropReason reason) const
+        {
+            return dropped_by_[(int)reason].load(std::memory_order_relaxed);
+        }
+        uint64_t keyRequestCount() const { return key_requests_.load(std::memory_order_relaxed); }
+
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> seq;
+            std::atomic<int64_t> pts{0};
+            std::atomic<bool> key{false};
+            std::atomic<bool> disposable{false};
+            std::atomic<uint64_t> gop{0}; // 所属GOP编号（生产者按关键帧递增）
+            typename Traits::Slot slot;
+        };
+
+        // 生产者：写入 tail 槽位（逻辑满或槽位尚未被消费者归还时失败）
+        bool tryPush(T &item, bool key, bool disposable)
+        {
+            size_t pos = tail_.load(std::memory_order_relaxed);
+            if (pos - head_.load(std::memory_order_acquire) >= capacity_)
+                return false;
+            Cell &cell = cells_[pos & mask_];
+            if (cell.seq.load(std::memory_order_acquire) != pos)
+                return false;
+            cell.pts.store(Traits::pts(item), std::memory_order_relaxed);
+            cell.key.store(key, std::memory_order_relaxed);
+            cell.disposable.store(disposable, std::memory_order_relaxed);
+            cell.gop.store(key ? gop_seq_ + 1 : gop_seq_, std::memory_order_relaxed);
+            Traits::moveIn(cell.slot, item);
+            cell.seq.store(pos + 1, std::memory_order_release);
+            tail_.store(pos + 1, std::memory_order_release);
+            if (key)
+                gop_seq_++;
+            return true;
+        }
+
+        // 出队条件（生产者淘汰队头时使用）
+        enum class TakeIf
+        {
+            kAny,        // 无条件
+            kNotKey,     // 队头不是关键帧
+            kDisposable, // 队头是非参考帧
+        };
+
+        enum TakeResult
+        {
+            kTaken,    // 已出队
+            kEmpty,    // 队列为空
+            kRejected, // 队头不满足条件，未出队
+            kBroken,   // 已出队并丢弃：所在GOP的参考帧已被丢弃（仅 out 非空时）
+        };
+
+        // 消费者（或执行淘汰的生产者）：CAS 占有队头槽位后移出，out 为空时直接丢弃
+        bool tryTake(T *out) { return tryTakeIf(out, TakeIf::kAny) == kTaken; }
+
+        // 条件出队：在占有队头的 CAS 之前检查该槽位的标志，CAS 失败（消费者先取走）时按新的队头重新检查，
+        // 因此被检查的与被移出的总是同一个元素（槽位在 seq == pos + 1 期间不会被改写）。
+        // DropToKeyframe 下丢弃（out 为空）参考帧前先记入 broken_gop_，取出（out 非空）非关键帧后检查 broken_gop_：
+        // 生产者淘汰队头与消费者出队并发时，消费者不会拿到参考帧已被丢弃的帧。
+        // 记录先于 CAS，消费者的 CAS 读到该 CAS 的结果即可见；CAS 失败时可能多丢该GOP的剩余帧，不会少丢
+        TakeResult tryTakeIf(T *out, TakeIf cond)
+        {
+            size_t pos = head_.load(std::memory_order_relaxed);
+            Cell *cell;
+            for (;;)
+            {
+                cell = &cells_[pos & mask_];
+                size_t seq = cell->seq.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+                if (diff == 0)
+                {
+                    if (cond == TakeIf::kNotKey && cell->key.load(std::memory_order_relaxed))
+                        return kRejected;
+                    if (cond == TakeIf::kDisposable && !cell->disposable.load(std::memory_order_relaxed))
+                        return kRejected;
+                    if (!out && policy_ == DropPolicy::DropToKeyframe && !cell->disposable.load(std::memory_order_relaxed))
+                        markBroken(cell->gop.load(std::memory_order_relaxed));
+                    if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_acq_rel,
+                                                    std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                    return kEmpty;
+                else
+                    pos = head_.load(std::memory_order_relaxed);
+            }
+            bool broken = out && policy_ == DropPolicy::DropToKeyframe && !cell->key.load(std::memory_order_relaxed) &&
+                          cell->gop.load(std::memory_order_relaxed) <= broken_gop_.load(std::memory_order_acquire);
+            if (out && !broken)
+                Traits::moveOut(*out, cell->slot);
+            else
+                Traits::reset(cell->slot);
+            cell->seq.store(pos + mask_ + 1, std::memory_order_release);
+            return broken ? kBroken : kTaken;
+        }
+
+        // broken_gop_ 只增不减（clear() 可由消费者调用，两端都可能写）
+        void markBroken(uint64_t gop)
+        {
+            uint64_t cur = broken_gop_.load(std::memory_order_relaxed);
+            while (cur < gop && !broken_gop_.compare_exchange_weak(cur, gop, std::memory_order_release,
+                                                                 std::memory_order_relaxed))
+            {
+            }
+        }
+
+        void countDrop(DropReason reason, size_t count)
+        {
+            if (count == 0)
+                return;
+            dropped_.fetch_add(count, std::memory_order_relaxed);
+            dropped_by_[(int)reason].fetch_add(count, std::memory_order_relaxed);
+        }
+
+        // 生产者：等待关键帧期间按最小间隔请求关键帧
+        void requestKey()
+        {
+            if (!drop_config_.key_request)
+                return;
+            auto now = std::chrono::steady_clock::now();
+            if (key_requests_.load(std::memory_order_relaxed) > 0 &&
+                now - last_key_request_ < std::chrono::milliseconds(drop_config_.key_request_interval_ms))
+                return;
+            last_key_request_ = now;
+            key_requests_.fetch_add(1, std::memory_order_relaxed);
+            drop_config_.key_request();
+        }
+
+        // 生产者（Block 策略）：等待空位，0有空位，-1超时，-2已关闭
+        int waitSpace(int timeout_ms)
+        {
+            Deadline deadline(timeout_ms);
+            for (;;)
+            {
+                if (closed_.load(std::memory_order_acquire))
+                    return -2;
+                if (size() < capacity_)
+                    return 0;
+                int wait_ms = deadline.remainingMs();
+                if (wait_ms == 0)
+                    return -1;
+                producer_waiting_.store(true, std::memory_order_seq_cst);
+                if (size() >= capacity_ && !closed_.load(std::memory_order_seq_cst))
+                {
+                    struct pollfd pfd = {space_efd_, POLLIN, 0};
+                    poll(&pfd, 1, wait_ms);
+                }
+                producer_waiting_.store(false, std::memory_order_relaxed);
+                drain(space_efd_);
+            }
+        }
+
+        // 超时计算：timeout_ms < 0 一直等待（remainingMs 返回 -1），0 不等待
+        struct Deadline
+        {
+            explicit Deadline(int timeout_ms)
+                : infinite(timeout_ms < 0),
+                  end(std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms < 0 ? 0 : timeout_ms)) {}
+
+            int remainingMs() const
+            {
+                if (infinite)
+                    return -1;
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(end - std::chrono::steady_clock::now());
+                return left.count() > 0 ? (int)left.count() : 0;
+            }
+
+            bool infinite;
+            std::chrono::steady_clock::time_point end;
+        };
+
+        // 对端正在等待时才写 eventfd（与 beginWait/waitSpace 中的 seq_cst 写配对）
+        static void notify(std::atomic<bool> &waiting, int efd)
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiting.load(std::memory_order_relaxed))
+                eventfd_write(efd, 1);
+        }
+
+        static void drain(int efd)
+        {
+            eventfd_t value;
+            eventfd_read(efd, &value);
+        }
+
+        const size_t capacity_;
+        const DropPolicy policy_;
+        size_t mask_;
+        std::unique_ptr<Cell[]> cells_;
+        bool skip_until_key_ = false; // 仅生产者访问
+        uint64_t gop_seq_ = 1;        // 仅生产者访问：当前GOP编号（0 留给 broken_gop_ 表示"无"）
+        DropConfig drop_config_;      // 仅生产者访问
+        std::chrono::steady_clock::time_point last_key_request_;
+        AVRational time_base_ = {1, 1000000};
+
+        // 队头/队尾/等待标志分处不同缓存行，避免生产者与消费者伪共享
+        // （用填充而不是 alignas(64)：C++14 的 new 不保证过对齐，且会触发 -Waligned-new）
+        char pad0_[64];
+        std::atomic<size_t> head_{0};
+        char pad1_[64 - sizeof(std::atomic<size_t>)];
+        std::atomic<size_t> tail_{0};
+        char pad2_[64 - sizeof(std::atomic<size_t>)];
+        std::atomic<bool> consumer_waiting_{false};
+        std::atomic<bool> producer_waiting_{false};
+        std::atomic<bool> closed_{false};
+        std::atomic<uint64_t> pushed_{0};
+        std::atomic<uint64_t> dropped_{0};
+        std::atomic<uint64_t> dropped_by_[(int)DropReason::kCount] = {};
+        std::atomic<uint64_t> key_requests_{0};
+        std::atomic<uint64_t> broken_gop_{0}; // 丢弃过参考帧的最大GOP编号
+
+        int data_efd_ = -1;
+        int space_efd_ = -1;
+    };
+
+} // namespace infra
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace infra
+{
+    // 帧节拍统计
+    struct FramePacerStats
+    {
+        uint64_t input = 0;      // 到达的采集帧数
+        uint64_t output = 0;     // 放行的帧数
+        uint64_t decimated = 0;  // 按目标帧率抽掉的帧数
+        uint64_t resyncs = 0;    // 采集断流/跳变后重新对齐节拍的次数
+        double achieved_fps = 0; // 最近一个统计周期的实际输出帧率
+        double jitter_avg_ms = 0; // 输出帧间隔相对目标周期的平均偏差
+        double jitter_max_ms = 0;
+    };
+
+    /**
+     * 按采集时间戳驱动的帧节拍器
+     * 不靠休眠控制帧率：调用方阻塞等待采集帧，每到一帧用其采集时刻（u64PTS）调用 admit()，
+     * 节拍器在目标帧率的理想时间网格上选取离网格点最近的帧放行，其余帧抽掉。
+     * 抽帧只取决于时间戳序列，同一输入总是得到同一输出（如 30→25fps 固定为每6帧抽1帧）。
+     * target_fps <= 0 时不抽帧，只统计实际帧率与抖动。
+     * 非线程安全：admit()/observe() 只能由同一线程调用，getStats() 可在任意线程读取。
+     */
+    class FramePacer
+    {
+    public:
+        explicit FramePacer(const std::string &name = "video", int target_fps = 0);
+
+        // 修改目标帧率（下一帧起生效，并重新对齐节拍）
+        void setTargetFps(int fps);
+        int targetFps() const { return target_fps_; }
+
+        // 一帧到达（capture_us 为单调时钟微秒），返回 true 表示放行、false 表示抽掉
+        bool admit(int64_t capture_us);
+
+        // 只统计不抽帧（帧率由硬件控制时，如VPSS帧率控制 + SYS绑定）
+        void observe(int64_t capture_us);
+
+        FramePacerStats getStats() const;
+        void printStats() const;
+
+        // 统计日志输出周期（秒），0 表示不输出
+        void setStatsInterval(int seconds) { stats_interval_s_ = seconds; }
+
+    private:
+        void onOutput(int64_t capture_us);
+
+        std::string name_;
+        int target_fps_;
+        int64_t period_us_;          // 目标帧周期（0 表示不抽帧）
+        int64_t next_due_us_ = -1;   // 下一个理想输出时刻（-1 表示待对齐）
+        int64_t last_input_us_ = -1; // 上一帧采集时刻（估计输入帧间隔）
+        int64_t last_output_us_ = -1;
+        double avg_interval_us_ = 0;  // 输出帧间隔的滑动平均（未设目标帧率时作为抖动基准）
+
+        mutable std::mutex mutex_;
+        FramePacerStats stats_;
+        uint64_t jitter_samples_ = 0;
+        double jitter_total_ms_ = 0;
+        int64_t window_start_us_ = -1; // 实际帧率统计窗口
+        uint64_t window_frames_ = 0;
+        int64_t last_print_us_ = -1;
+        int stats_interval_s_ = 10;
+    };
+
+} // namespace infra
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+extern "C"
+{
+#include <libavutil/rational.h>
+}
+
+namespace infra
+{
+    /**
+     * 统一媒体时钟
+     * 所有音视频时间戳都以 CLOCK_MONOTONIC（微秒，与VI帧 u64PTS 同源）为唯一时间源，
+     * 媒体时间 = 采集时刻 - epoch，时间基固定为 timeBase()（1/1000000），
+     * 队列、调度器、复用器之间不再各自换算。
+     * epoch 由 start() 设定；未调用 start() 时第一次打戳的时刻即为 epoch。
+     */
+    class MediaClock
+    {
+    public:
+        enum MediaKind
+        {
+            kVideo = 0,
+            kAudio = 1,
+        };
+
+        static MediaClock &instance();
+
+        // 媒体时间的时间基（微秒）
+        static AVRational timeBase() { return {1, 1000000}; }
+
+        // 单调时钟当前时刻（微秒）
+        static int64_t nowUs();
+
+        // 以当前时刻为 epoch 重新开始计时（并清空A/V偏差统计）
+        void start();
+
+        // 采集时刻（单调时钟微秒）→ 媒体时间（timeBase 单位，不小于0）
+        int64_t toMediaTime(int64_t capture_us);
+
+        // 记录某路刚输出到复用器的 pts（媒体时间），用于统计A/V偏差
+        void notePresented(MediaKind kind, int64_t pts);
+
+        // 最近一次输出的视频pts - 音频pts（微秒，正值表示视频领先）
+        int64_t avSkewUs() const;
+
+        // start() 以来A/V偏差绝对值的最大值（微秒）
+        int64_t maxAbsSkewUs() const { return max_abs_skew_us_.load(std::memory_order_relaxed); }
+
+    private:
+        MediaClock() = default;
+
+        static const int64_t kUnset = INT64_MIN;
+
+        std::atomic<int64_t> epoch_us_{kUnset};
+        std::atomic<int64_t> last_pts_[2] = {{kUnset}, {kUnset}};
+        std::atomic<int64_t> max_abs_skew_us_{0};
+    };
+
+    /**
+     * 音频时间戳生成器
+     * 以PCM块的采集时刻为锚点、按采样数推进，保证相邻帧时间戳严格连续；
+     * 当按采样数推算的时刻与实际采集时刻偏差超过阈值（声卡时钟漂移、丢数据）时重新对齐。
+     */
+    class AudioTimestamper
+    {
+    public:
+        explicit AudioTimestamper(int sample_rate, int64_t resync_threshold_us = 40000)
+            : sample_rate_(sample_rate), resync_threshold_us_(resync_threshold_us) {}
+
+        /**
+         * 一块PCM到达
+         * @param capture_end_us 该块最后一个样本的采集时刻（单调时钟微秒）
+         * @param pending_samples 加入该块后尚未打戳的样本总数
+         */
+        void onCapture(int64_t capture_end_us, int64_t pending_samples);
+
+        // 取下一帧（nb_samples 个样本）的媒体时间并前进
+        int64_t next(int nb_samples);
+
+        // 重新对齐次数（漂移诊断）
+        uint64_t resyncCount() const { return resync_count_; }
+
+    private:
+        int sample_rate_;
+        int64_t resync_threshold_us_;
+        bool anchored_ = false;
+        int64_t anchor_us_ = 0;     // 锚点样本的媒体时间
+        int64_t anchor_sample_ = 0; // 锚点样本序号
+        int64_t next_sample_ = 0;   // 下一帧第一个样本的序号
+        uint64_t resync_count_ = 0;
+    };
+
+} // namespace infra
@@ -2,6 +2,10 @@
 #include "core/VideoEngine.hpp"
 #include "core/AudioEngine.hpp"
 #include "core/RTSPEngine.hpp"
+#include "core/MuxScheduler.hpp"
+#include "core/RateController.hpp"
+#include "infra/queue/SPSCRing.hpp"
+#include "infra/time/MediaClock.h"
 #include "infra/time/TimeUtils.h"
 #include "iostream"
 #include <thread>
@@ -15,6 +19,11 @@ extern "C"
 std::atomic<bool> g_quit_flag(false);
 
 // 信号处理函数（收到 Ctrl+C 时触发）
+namespace
+{
+    const int kParamSetWaitMs = 3000; // 等待首个关键帧参数集的时长
+}
+
 static void signalHandler(int sig)
 {
     if (sig == SIGINT)
@@ -26,6 +35,19 @@ static void signalHandler(int sig)
 
 namespace app
 {
+    // 子码流推流会话：独立的RTSP路径和复用调度线程，音频从主会话分流一份引用
+    struct AppController::SubStreamSession
+    {
+        std::string name;
+        core::RTSPEngine *rtsp = nullptr;
+        core::MuxScheduler *mux = nullptr;
+        core::RateController *rate_controller = nullptr;
+        infra::SPSCRing<AVPacket> *audio_ring = nullptr;
+        core::RTSPConfig rtsp_config;
+        int channel_index = 0;
+        std::thread thread;
+    };
+
     AppController::AppController() : initialized_(false)
     {
         log_init("log.log", LOG_LEVEL_DEBUG);
@@ -96,14 +118,98 @@ namespace app
             rtsp_config.enable_tcp = false; // 是否强制使用TCP传输
         }
 
-        ret = rtsps_engine_->init(rtsp_config);
-        CHECK_RET(ret, "rtsps_engine_->init");
+        // RTSP 在 run() 中编码出首个关键帧、缓存到参数集后再写头
+        rtsp_config_ = new core::RTSPConfig(rtsp_config);
+
+        // 5. 注册复用调度器的输入（两路pts均为 MediaClock 媒体时间），视频写包耗时交给码率自适应
+        rate_controller_ = new core::RateController(video_engine_->mainChannel());
+        // 活动/空闲配置切换后，码率自适应以新配置为标称值（否则畅通时会把空闲帧率/码率"恢复"上去）
+        if (video_engine_->activityGovernor())
+        {
+            core::RateController *rate_controller = rate_controller_;
+            video_engine_->activityGovernor()->setSwitchCallback([rate_controller](bool, int bitrate_kbps, int fps)
+                                                                 { rate_controller->setNominal(bitrate_kbps, fps); });
+        }
+        mux_scheduler_ = new core::MuxScheduler();
+        mux_scheduler_->addStream("video", &video_engine_->packetRing(),
+                                  [this](AVPacket *pkt, AVRational time_base)
+                                  {
+                                      infra::MediaClock::instance().notePresented(infra::MediaClock::kVideo, pkt->pts);
+                                      uint64_t start_us = infra::now_us();
+                                      int ret = rtsps_engine_->pushVideoFrame(pkt, time_base);
+                                      rate_controller_->noteWrite(infra::now_us() - start_us);
+                                      return ret;
+                                  });
+        mux_scheduler_->addStream("audio", &audio_engine_->packetRing(),
+                                  [this](AVPacket *pkt, AVRational time_base)
+                                  {
+                                      infra::MediaClock::instance().notePresented(infra::MediaClock::kAudio, pkt->pts);
+                                      // 音频只采集编码一次，按引用分流给各子码流会话
+                                      for (SubStreamSession *session : sub_sessions_)
+                                      {
+                                          AVPacket *copy = av_packet_clone(pkt);
+                                          if (copy == nullptr)
+                                              continue;
+                                          session->audio_ring->push(*copy, 0);
+                                          av_packet_free(&copy);
+                                      }
+                                      return rtsps_engine_->pushAudioFrame(pkt, time_base);
+                                  });
+
+        // 6. 子码流：每路一个RTSP会话（路径为主路径加流名后缀）
+        ret = initSubStreams(rtsp_config);
+        CHECK_RET(ret, "initSubStreams");
 
         initialized_ = true;
         LOGI("AppController::init() - success!");
         return 0;
     }
 
+    int AppController::initSubStreams(const core::RTSPConfig &base_config)
+    {
+        for (int i = 0; i < video_engine_->subStreamCount(); i++)
+        {
+            const core::VideoSubStreamConfig &sub = video_engine_->subStreamConfig(i);
+
+            core::RTSPConfig rtsp_config = base_config;
+            rtsp_config.output_url = base_config.output_url + "_" + sub.name;
+            rtsp_config.video_width = sub.encode_config.width;
+            rtsp_config.video_height = sub.encode_config.height;
+            rtsp_config.video_bitrate = video_engine_->subChannel(i).driver()->bitrateKbps() * 1000;
+            rtsp_config.video_codec_id =
+                sub.encode_config.en_type == RK_VIDEO_ID_AVC ? AV_CODEC_ID_H264 : AV_CODEC_ID_H265;
+
+            SubStreamSession *session = new SubStreamSession();
+            sub_sessions_.push_back(session);
+            session->name = sub.name;
+            session->rtsp = new core::RTSPEngine();
+            session->rtsp_config = rtsp_config;
+            session->channel_index = i;
+
+            infra::SPSCRing<AVPacket> &audio_src = audio_engine_->packetRing();
+            session->audio_ring = new infra::SPSCRing<AVPacket>(audio_src.capacity(), infra::DropPolicy::DropOldest);
+            session->audio_ring->setTimeBase(audio_src.timeBase());
+
+            core::RTSPEngine *rtsp = session->rtsp;
+            core::RateController *rate_controller = new core::RateController(video_engine_->subChannel(i));
+            session->rate_controller = rate_controller;
+            session->mux = new core::MuxScheduler();
+            session->mux->addStream((sub.name + "-video").c_str(), &video_engine_->subChannel(i).packetRing(),
+                                    [rtsp, rate_controller](AVPacket *pkt, AVRational time_base)
+                                    {
+                                        uint64_t start_us = infra::now_us();
+                                        int ret = rtsp->pushVideoFrame(pkt, time_base);
+                                        rate_controller->noteWrite(infra::now_us() - start_us);
+                                        return ret;
+                                    });
+            session->mux->addStream((sub.name + "-audio").c_str(), session->audio_ring,
+                                    [rtsp](AVPacket *pkt, AVRational time_base)
+                                    { return rtsp->pushAudioFrame(pkt, time_base); });
+            LOGI("sub stream %s -> %s", sub.name.c_str(), rtsp_config.output_url.c_str());
+        }
+        return 0;
+    }
+
     int AppController::run()
     {
         if (!initialized_)
@@ -118,6 +224,9 @@ namespace app
 
         std::this_thread::sleep_for(std::chrono::seconds(1));
 
+        // 音视频共用同一个时间起点
+        infra::MediaClock::instance().start();
+
         // 启动视频采集
         printf("启动视频采集\n");
         video_engine_->start();
@@ -126,124 +235,102 @@ namespace app
         printf("启动音频采集\n");
         audio_engine_->start();
 
-        AVPacket audio_out_pkt = {0};
-        AVPacket *video_out_pkt = nullptr;
+        // 首个关键帧的参数集就绪后写RTSP头，SDP直接携带 VPS/SPS/PPS
+        if (openRtsp(rtsps_engine_, *rtsp_config_, video_engine_->mainChannel()) != 0)
+        {
+            LOGE("rtsps_engine_->init failed: %s", rtsp_config_->output_url.c_str());
+            shutdown();
+            return -1;
+        }
+        for (SubStreamSession *session : sub_sessions_)
+        {
+            if (openRtsp(session->rtsp, session->rtsp_config, video_engine_->subChannel(session->channel_index)) != 0)
+            {
+                LOGE("sub stream rtsp init failed: %s", session->rtsp_config.output_url.c_str());
+                shutdown();
+                return -1;
+            }
+        }
 
-        int64_t vedio_pts = 0;
-        int64_t audio_pts = 0;
+        // 推流会话建立后开始码率自适应（失败时保持固定码率继续推流）
+        rate_controller_->start();
+        for (SubStreamSession *session : sub_sessions_)
+            session->rate_controller->start();
 
-        int cnt = 0;
         std::this_thread::sleep_for(std::chrono::seconds(1));
         printf("主线程运行\n");
-        uint64_t main_start_time = infra::now_ms();
-        uint64_t main_end_time = 0;
-        while (!g_quit_flag)
+
+        // 子码流各自一个调度线程，互不阻塞
+        for (SubStreamSession *session : sub_sessions_)
         {
-            // main_end_time = infra::now_ms();
-            // std::cout << main_end_time - main_start_time << "主线程运行" << std::endl;
-            // main_start_time = main_end_time;
-
-            // int ret = 0;
-
-            // // 推音频
-            // if (audio_engine_->getProcessedPacket(audio_out_pkt,20))
-            // {
-            //     rtsps_engine_->pushAudioFrame(&audio_out_pkt);
-            //     av_packet_unref(&audio_out_pkt);
-            // }
-            // else
-            // {
-            //     printf("test111,\n");
-            // }
-            // std::this_thread::sleep_for(std::chrono::microseconds(15000));
-
-            // 推视频
-            // int v_ret = 0;
-            // v_ret = video_engine_->popEncodedPacket(video_out_pkt);
-            // if (v_ret == 0)
-            // {
-            //     rtsps_engine_->pushVideoFrame(video_out_pkt);
-            //     av_packet_unref(video_out_pkt);
-            //     // printf("已退流\n");
-            // }
-            // else
-            // {
-            //     // printf("test111,ret = %d\n", v_ret);
-            //     std::this_thread::sleep_for(std::chrono::microseconds(100));
-            // }
-            // std::this_thread::sleep_for(std::chrono::microseconds(10000));
-
-            // 音视频同步退流
-            bool v_ret = video_engine_->getQueueFrontPts(vedio_pts, 1000);
-            bool a_ret = audio_engine_->getQueueFrontPts(audio_pts, 1000);
-
-            if (v_ret && a_ret)
-            {
-                if (audio_pts != 0)
-                {
-                    audio_pts = audio_pts * 1000000 / 48000;
-                }
-                if (audio_pts <= vedio_pts)
-                {
-                    // std::cout << " 音频audio_pts = " << audio_pts << ",   video_pts = " << vedio_pts << std::endl;
-                    if (audio_engine_->getProcessedPacket(audio_out_pkt, 0))
-                        rtsps_engine_->pushAudioFrame(&audio_out_pkt);
-                    else
-                    {
-                        std::cout << "1音频获取失败" << std::endl;
-                        std::this_thread::sleep_for(std::chrono::microseconds(100));
-                    }
-                }
-                else
-                {
-                    // std::cout << " 视频video_pts = " << vedio_pts << ",   音频audio_pts = " << audio_pts << std::endl;
-                    if (video_engine_->popEncodedPacket(video_out_pkt, 0) == 0)
-                        rtsps_engine_->pushVideoFrame(video_out_pkt);
-                    else
-                    {
-                        std::cout << "2视频获取失败" << std::endl;
-                        std::this_thread::sleep_for(std::chrono::microseconds(100));
-                    }
-                }
-            }
-            // else if (v_ret && !a_ret)
-            // {
-            //     // std::cout << " 视频video_pts = " << vedio_pts << ",   音频audio_pts = " << audio_pts << std::endl;
-            //     if (video_engine_->popEncodedPacket(video_out_pkt) == 0)
-            //         rtsps_engine_->pushVideoFrame(video_out_pkt);
-            //     else
-            //     {
-            //         std::cout << "3视频获取失败" << std::endl;
-            //         std::this_thread::sleep_for(std::chrono::microseconds(100));
-            //     }
-            // }
-            // else if (!v_ret && a_ret)
-            // {
-            //     // std::cout << " 音频audio_pts = " << audio_pts << ",   video_pts = " << vedio_pts << std::endl;
-            //     if (audio_engine_->getProcessedPacket(audio_out_pkt))
-            //         rtsps_engine_->pushAudioFrame(&audio_out_pkt);
-            //     else
-            //     {
-            //         std::cout << "4音频获取失败" << std::endl;
-            //         std::this_thread::sleep_for(std::chrono::microseconds(100));
-            //     }
-            // }
-            else
-            {
-                std::this_thread::sleep_for(std::chrono::microseconds(100));
-            }
+            core::MuxScheduler *mux = session->mux;
+            session->thread = std::thread([mux]()
+                                          { mux->run(g_quit_flag); });
         }
+
+        // 音视频同步推流：调度器同时等待两路队列，按PTS顺序写入复用器，直到收到退出信号
+        mux_scheduler_->run(g_quit_flag);
         printf("循环结束\n");
 
         return shutdown();
     }
 
+    int AppController::openRtsp(core::RTSPEngine *rtsp, core::RTSPConfig &config, core::VideoEncodeChannel &channel)
+    {
+        const core::ParameterSetCache &param_sets = channel.parameterSets();
+        if (param_sets.waitReady(kParamSetWaitMs))
+            config.video_extradata = param_sets.extradata();
+        else
+            LOGW("openRtsp - %s: no parameter sets within %dms, SDP without sprop", channel.name().c_str(), kParamSetWaitMs);
+        if (rtsp->init(config) != 0)
+            return -1;
+        // 推流会话刚建立：请求IDR，服务端和首批客户端不必等到下一个GOP
+        channel.requestIDR();
+        return 0;
+    }
+
     // app 层关闭：释放 core 层资源
     int AppController::shutdown()
     {
         if (!initialized_)
             return 0;
 
+        if (mux_scheduler_)
+        {
+            delete mux_scheduler_;
+            mux_scheduler_ = nullptr;
+        }
+        // 码率自适应引用编码通道，需在 video_engine_ 之前停止；
+        // 视频线程在 video_engine_ 析构前仍可能切换活动/空闲配置，先摘掉引用码率自适应的切换回调
+        if (video_engine_ && video_engine_->activityGovernor())
+            video_engine_->activityGovernor()->setSwitchCallback(nullptr);
+        delete rate_controller_;
+        rate_controller_ = nullptr;
+
+        // 子码流会话同样要在 video_engine_ 之前关闭
+        g_quit_flag = true;
+        for (SubStreamSession *session : sub_sessions_)
+        {
+            if (session->thread.joinable())
+                session->thread.join();
+            delete session->mux;
+            delete session->rate_controller;
+            delete session->rtsp;
+            delete session->audio_ring;
+            delete session;
+        }
+        sub_sessions_.clear();
+
+        // 先关闭推流：复用器交织缓冲中的视频包零拷贝引用VENC码流，需在编码通道销毁前释放
+        printf("关闭rtsps_engine_\n");
+        if (rtsps_engine_)
+        {
+            delete rtsps_engine_;
+            rtsps_engine_ = nullptr;
+        }
+        delete rtsp_config_;
+        rtsp_config_ = nullptr;
+
         printf("关闭video_engine_\n");
         if (video_engine_)
         {
@@ -258,13 +345,6 @@ namespace app
             audio_engine_ = nullptr;
         }
 
-        printf("关闭rtsps_engine_\n");
-        if (rtsps_engine_)
-        {
-            delete rtsps_engine_;
-            rtsps_engine_ = nullptr;
-        }
-
         initialized_ = false;
         return 0;
     }
@@ -0,0 +1,320 @@
+#include "core/ActivityGovernor.hpp"
+#include "core/MotionDetector.hpp"
+#include "driver/MPIBackend.hpp"
+#include "infra/time/TimeUtils.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+extern "C"
+{
+#include "infra/logging/logger.h"
+}
+
+namespace core
+{
+    namespace
+    {
+        // 亮度采样网格（点采样，1080p 下每 30x30 像素取一点），一帧约 2300 点
+        const int kSampleCols = 64;
+        const int kSampleRows = 36;
+        const int kBgShift = 5;             // 背景更新速率 1/32
+        const int kBaselineFrames = 8;      // 帧大小基线至少统计的帧数，之前不判定突增
+        const double kBaselineAlpha = 1.0 / 16;
+        const int kRebaselineFrames = 90;   // 连续突增达到该帧数（30fps 约3秒）视为场景持久变化，以当前大小重建基线
+        const uint64_t kMinQuietUs = 2000000; // 静止画面码率的最少统计时长，不足时按目标码率估算节省
+    }
+
+    int parseActivityGovernorConfig(const std::string &text, ActivityGovernorConfig &config)
+    {
+        int ret = 0;
+        std::stringstream ss(text);
+        std::string item;
+        while (std::getline(ss, item, ','))
+        {
+            size_t eq = item.find('=');
+            if (eq == std::string::npos)
+            {
+                if (!item.empty())
+                    ret = -1;
+                continue;
+            }
+            std::string key = item.substr(0, eq);
+            int v = atoi(item.c_str() + eq + 1);
+            if (key == "fps")
+                config.idle_fps = v;
+            else if (key == "bitrate")
+                config.idle_bitrate_kbps = v;
+            else if (key == "percent")
+                config.idle_bitrate_percent = v;
+            else if (key == "after")
+                config.idle_after_ms = v * 1000;
+            else if (key == "threshold")
+                config.diff_threshold = v;
+            else if (key == "permille")
+                config.active_permille = v;
+            else if (key == "size")
+                config.size_jump_percent = v;
+            else if (key == "idr")
+                config.idr_on_switch = v != 0;
+            else
+                ret = -1;
+        }
+        return ret;
+    }
+
+    ActivityGovernor::ActivityGovernor(VideoEncodeChannel &channel, const ActivityGovernorConfig &config)
+        : channel_(channel), config_(config)
+    {
+        driver::VideoEncoderDriver *venc = channel_.driver();
+        active_profile_ = venc->rcProfile();
+        if (active_profile_.bitrate_kbps <= 0)
+            active_profile_.bitrate_kbps = venc->bitrateKbps(); // 编码格式默认值，空闲码率按它折算
+        active_fps_ = venc->frameRate();
+        buildIdleProfile();
+
+        sample_.assign(kSampleCols, 0);
+        prev_.assign(kSampleCols * kSampleRows, 0);
+        bg_.assign(kSampleCols * kSampleRows, 0);
+        acc_.assign(kSampleCols, 0);
+        LOGI("ActivityGovernor - %s: active %dkbps %dfps, idle %dkbps %dfps after %dms static", channel_.name().c_str(),
+             active_profile_.bitrate_kbps, active_fps_, idle_profile_.bitrate_kbps, config_.idle_fps, config_.idle_after_ms);
+    }
+
+    // 空闲配置：码率控制模式、GOP、QP与活动配置相同，目标/最大/最小码率按比例降低
+    void ActivityGovernor::buildIdleProfile()
+    {
+        const driver::RcProfile &active = active_profile_;
+        int active_kbps = std::max(1, active.bitrate_kbps);
+        int idle_kbps = config_.idle_bitrate_kbps > 0 ? config_.idle_bitrate_kbps
+                                                      : std::max(1, active_kbps * config_.idle_bitrate_percent / 100);
+        idle_profile_ = active;
+        idle_profile_.bitrate_kbps = idle_kbps;
+        // 最大/最小码率为0时驱动取编码格式的固定默认值，不随目标码率缩放，这里显式给出
+        idle_profile_.max_bitrate_kbps = active.max_bitrate_kbps > 0
+                                             ? std::max(idle_kbps, (int)((int64_t)active.max_bitrate_kbps * idle_kbps / active_kbps))
+                                             : idle_kbps * 8 / 5;
+        idle_profile_.min_bitrate_kbps = active.min_bitrate_kbps > 0
+                                             ? std::max(1, (int)((int64_t)active.min_bitrate_kbps * idle_kbps / active_kbps))
+                                             : std::max(1, idle_kbps / 4);
+    }
+
+    void ActivityGovernor::setSwitchCallback(ActivitySwitchCallback callback)
+    {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        callback_ = std::move(callback);
+    }
+
+    int ActivityGovernor::setActiveProfile(const driver::RcProfile &profile)
+    {
+        std::lock_guard<std::mutex> lock(profile_mutex_);
+        active_profile_ = profile;
+        if (active_profile_.bitrate_kbps <= 0)
+            active_profile_.bitrate_kbps = channel_.driver()->bitrateKbps();
+        buildIdleProfile();
+        if (idle_.load(std::memory_order_relaxed))
+            return 0;
+        return channel_.driver()->setRcProfile(profile);
+    }
+
+    void ActivityGovernor::observe(const VIDEO_FRAME_INFO_S *frame)
+    {
+        uint64_t start_us = infra::now_us();
+        bool idle = idle_.load(std::memory_order_relaxed);
+
+        // 1. 码流统计增量（上一次判定以来编码输出的帧）
+        EncodeChannelStats cs = channel_.getStats();
+        uint64_t frames = cs.frames - last_frames_;
+        uint64_t bytes = cs.bytes - last_bytes_;
+        uint64_t key_frames = cs.key_frames - last_key_frames_;
+        last_frames_ = cs.frames;
+        last_bytes_ = cs.bytes;
+        last_key_frames_ = cs.key_frames;
+        uint64_t elapsed_us = last_us_ ? start_us - last_us_ : 0;
+        last_us_ = start_us;
+
+        // 2. 活动信号：亮度变化（该帧送VENC之前）与帧大小突增（已编码的帧）
+        bool luma = frame != nullptr && lumaActivity(*frame);
+        bool size = sizeActivity(frames, bytes, key_frames);
+        if (luma || size || last_activity_us_ == 0)
+            last_activity_us_ = start_us;
+
+        // 3. 切换：空闲中有活动立即切回（对这一帧生效），活动配置下持续静止才切到空闲
+        if (idle && (luma || size))
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            stats_.luma_triggers += luma ? 1 : 0;
+            stats_.size_triggers += (!luma && size) ? 1 : 0;
+        }
+        if (idle && (luma || size))
+            switchTo(false, luma ? "luma" : "size");
+        else if (!idle && start_us - last_activity_us_ >= (uint64_t)config_.idle_after_ms * 1000)
+            switchTo(true, "static");
+
+        // 4. 统计：时长与字节数记到判定前所在的配置
+        uint64_t cost_us = infra::now_us() - start_us;
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        if (!idle && !luma && !size)
+        {
+            quiet_us_ += elapsed_us;
+            quiet_bytes_ += bytes;
+        }
+        if (idle)
+        {
+            stats_.idle_ms += elapsed_us / 1000;
+            stats_.idle_bytes += bytes;
+        }
+        else
+        {
+            stats_.active_ms += elapsed_us / 1000;
+            stats_.active_bytes += bytes;
+        }
+        checks_++;
+        check_us_total_ += cost_us;
+        stats_.check_us_max = std::max(stats_.check_us_max, cost_us);
+    }
+
+    // 在亮度平面上按网格点采样，与上一帧/背景比较；帧尺寸变化（或首帧）时只建立背景
+    bool ActivityGovernor::lumaActivity(const VIDEO_FRAME_INFO_S &frame)
+    {
+        const VIDEO_FRAME_S &vf = frame.stVFrame;
+        if (vf.enPixelFormat != RK_FMT_YUV420SP && vf.enPixelFormat != RK_FMT_YUV420P)
+            return false;
+        const uint8_t *y = (const uint8_t *)driver::MPIBackend::instance().mbHandle2VirAddr(vf.pMbBlk);
+        int width = (int)vf.u32Width;
+        int height = (int)vf.u32Height;
+        if (y == nullptr || width < kSampleCols || height < kSampleRows)
+            return false;
+        int stride = vf.u32VirWidth > 0 ? (int)vf.u32VirWidth : width;
+        int step_x = width / kSampleCols;
+        int step_y = height / kSampleRows;
+        bool prime = width != sample_w_ || height != sample_h_;
+        sample_w_ = width;
+        sample_h_ = height;
+
+        memset(acc_.data(), 0, acc_.size());
+        for (int r = 0; r < kSampleRows; r++)
+        {
+            const uint8_t *src = y + (size_t)(r * step_y + step_y / 2) * stride + step_x / 2;
+            for (int c = 0; c < kSampleCols; c++)
+                sample_[c] = src[c * step_x];
+            uint8_t *prev = &prev_[r * kSampleCols];
+            uint16_t *bg = &bg_[r * kSampleCols];
+            if (prime)
+            {
+                memcpy(prev, sample_.data(), kSampleCols);
+                for (int c = 0; c < kSampleCols; c++)
+                    bg[c] = (uint16_t)(sample_[c] << 8);
+                continue;
+            }
+            motionDiffRow(sample_.data(), prev, bg, acc_.data(), kSampleCols, config_.diff_threshold, kBgShift);
+        }
+        if (prime)
+            return false;
+
+        int changed = 0;
+        for (int c = 0; c < kSampleCols; c++)
+            changed += acc_[c];
+        return changed * 1000 >= config_.active_permille * kSampleCols * kSampleRows;
+    }
+
+    // P帧平均大小相对当前配置基线的突增；含关键帧的增量不参与（IDR本身就大）
+    // 突增期间基线不跟随（否则持续的运动会被慢慢当成常态），但突增持续 kRebaselineFrames 帧后
+    // 视为场景持久变化（开灯、镜头被移动、画面噪声变大），以当前大小重建基线，之后才能再判定静止
+    bool ActivityGovernor::sizeActivity(uint64_t frames, uint64_t bytes, uint64_t key_frames)
+    {
+        if (config_.size_jump_percent <= 0 || frames == 0 || key_frames > 0)
+            return false;
+        double avg = (double)bytes / frames;
+        bool jump = baseline_frames_ >= kBaselineFrames && avg * 100 > size_baseline_ * config_.size_jump_percent;
+        if (jump)
+        {
+            jump_frames_ += (int)frames;
+            if (jump_frames_ < kRebaselineFrames)
+                return true;
+            size_baseline_ = avg;
+            baseline_frames_ = kBaselineFrames;
+            jump_frames_ = 0;
+            return false;
+        }
+        jump_frames_ = 0;
+        size_baseline_ = baseline_frames_ == 0 ? avg : size_baseline_ + (avg - size_baseline_) * kBaselineAlpha;
+        baseline_frames_ += (int)frames;
+        return false;
+    }
+
+    int ActivityGovernor::switchTo(bool idle, const char *reason)
+    {
+        int bitrate, fps;
+        {
+            std::lock_guard<std::mutex> lock(profile_mutex_);
+            const driver::RcProfile &profile = idle ? idle_profile_ : active_profile_;
+            fps = idle ? config_.idle_fps : active_fps_;
+            bitrate = profile.bitrate_kbps;
+            driver::VideoEncoderDriver *venc = channel_.driver();
+            if (venc->setRcProfile(profile) != 0 || venc->setFrameRate(fps) != 0)
+            {
+                LOGW("ActivityGovernor - %s: switch to %s failed", channel_.name().c_str(), idle ? "idle" : "active");
+                std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+                stats_.failures++;
+                // 切到空闲失败时重新计时，避免每帧重试；切回活动失败则下一帧继续尝试
+                if (idle)
+                    last_activity_us_ = infra::now_us();
+                return -1;
+            }
+            idle_.store(idle, std::memory_order_relaxed);
+            if (config_.idr_on_switch)
+                venc->requestIDR(true);
+        }
+        // 新配置下的帧大小与之前不可比，重新建立基线
+        size_baseline_ = 0;
+        baseline_frames_ = 0;
+        jump_frames_ = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            stats_.idle = idle;
+            stats_.to_idle += idle ? 1 : 0;
+            stats_.to_active += idle ? 0 : 1;
+        }
+        LOGI("[idle] %s: -> %s (%s), %dkbps %dfps", channel_.name().c_str(), idle ? "idle" : "active", reason, bitrate, fps);
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        if (callback_)
+            callback_(idle, bitrate, fps);
+        return 0;
+    }
+
+    ActivityGovernorStats ActivityGovernor::getStats() const
+    {
+        ActivityGovernorStats stats;
+        int active_kbps;
+        {
+            std::lock_guard<std::mutex> lock(profile_mutex_);
+            active_kbps = active_profile_.bitrate_kbps;
+        }
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats = stats_;
+        stats.check_us_avg = checks_ ? (double)check_us_total_ / checks_ : 0;
+        // 空闲期间若保持活动配置，码率按活动配置下静止画面的实测码率（统计不足时按目标码率）计
+        double bytes_per_ms = quiet_us_ >= kMinQuietUs ? (double)quiet_bytes_ * 1000 / quiet_us_ : active_kbps / 8.0;
+        double would_be = bytes_per_ms * stats.idle_ms;
+        stats.saved_bytes = would_be > stats.idle_bytes ? (uint64_t)(would_be - stats.idle_bytes) : 0;
+        return stats;
+    }
+
+    void ActivityGovernor::printStats() const
+    {
+        ActivityGovernorStats st = getStats();
+        uint64_t total_ms = st.active_ms + st.idle_ms;
+        LOGI("[idle] %s: %s, active %.1fs (%llu KB) idle %.1fs (%llu KB, %.1f%% of time), switches %llu/%llu "
+             "(luma %llu size %llu failed %llu), saved ~%llu KB, check avg=%.1fus max=%lluus",
+             channel_.name().c_str(), st.idle ? "idle" : "active", st.active_ms / 1000.0,
+             (unsigned long long)(st.active_bytes / 1024), st.idle_ms / 1000.0, (unsigned long long)(st.idle_bytes / 1024),
+             total_ms ? st.idle_ms * 100.0 / total_ms : 0.0, (unsigned long long)st.to_idle,
+             (unsigned long long)st.to_active, (unsigned long long)st.luma_triggers, (unsigned long long)st.size_triggers,
+             (unsigned long long)st.failures, (unsigned long long)(st.saved_bytes / 1024), st.check_us_avg,
+             (unsigned long long)st.check_us_max);
+    }
+
+} // namespace core
@@ -2,6 +2,7 @@
 #include "core/AudioStreamProcessor.hpp"
 #include "driver/AudioInputDriver.hpp"
 #include "driver/AudioEncoderDriver.hpp"
+#include "infra/time/MediaClock.h"
 #include <chrono>
 #include <memory>
 #include <fstream>
@@ -135,8 +136,9 @@ namespace core
                 continue;
             }
 
-            // 2. 编码PCM数据
-            ret = encoder_driver_->encode(input_pkt->data, input_pkt->size, *encoded_pkt);
+            // 2. 编码PCM数据（读取返回时刻即该块最后一个样本的采集时刻）
+            int64_t capture_us = infra::MediaClock::nowUs();
+            ret = encoder_driver_->encode(input_pkt->data, input_pkt->size, *encoded_pkt, capture_us);
             if (ret == 0)
             {
                 // 3. 将编码后的数据推送到流处理器
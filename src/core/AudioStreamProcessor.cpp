@@ -1,4 +1,5 @@
 #include "core/AudioStreamProcessor.hpp"
+#include "infra/time/MediaClock.h"
 #include <chrono>
 #include <cstring>
 extern "C"
@@ -25,12 +26,6 @@ namespace core
         stop();
         flush();
         closeOutputFile();
-        // 确保队列空
-        while (!packet_queue_.empty())
-        {
-            av_packet_unref(&packet_queue_.front());
-            packet_queue_.pop();
-        }
     }
 
     int AudioStreamProcessor::init(AudioStreamConfig &config)
@@ -38,6 +33,8 @@ namespace core
 
         config_ = config;
         buffer_size_ = config_.buffer_size > 0 ? config_.buffer_size : DEFAULT_BUFFER_SIZE;
+        packet_ring_.reset(new infra::SPSCRing<AVPacket>(buffer_size_, config_.drop_policy));
+        packet_ring_->setTimeBase(infra::MediaClock::timeBase()); // 编码器输出的pts为媒体时间
         return 0;
     }
 
@@ -45,6 +42,7 @@ namespace core
     {
         if (!is_running_)
         {
+            packet_ring_->open();
             is_running_ = true;
             LOGI("Audio stream processor started");
         }
@@ -56,6 +54,7 @@ namespace core
         if (is_running_)
         {
             is_running_ = false;
+            packet_ring_->close(); // 唤醒等待中的出队线程
             LOGI("Audio stream processor stopped");
         }
     }
@@ -75,115 +74,42 @@ namespace core
         //     addADTSHeader(pkt);
         // }
 
-        // 对队列操作加锁
-        std::lock_guard<std::mutex> lock(queue_mutex_);
-
-        // 限制缓冲区大小，防止内存溢出
-        if (packet_queue_.size() >= buffer_size_)
+        // 移入队列（不拷贝、不增加引用），队列满时按策略丢弃
+        uint64_t dropped = packet_ring_->droppedCount();
+        packet_ring_->push(pkt);
+        if (packet_ring_->droppedCount() != dropped)
         {
-            // 从队列中取出但不移动
-            AVPacket *front = &packet_queue_.front();
-            // 直接解引用并弹出
-            av_packet_unref(front);
-            packet_queue_.pop();
             printf("音频队列 已满，丢弃最早的数据包: %zu/%zu\n",
-                   packet_queue_.size(), buffer_size_);
+                   packet_ring_->size(), buffer_size_);
         }
-
-        // 在队列中创建新的AVPacket
-        packet_queue_.emplace();
-        AVPacket *new_pkt = &packet_queue_.back();
-
-        // printf("时间戳,pkt.pts = %lld\n", pkt.pts);
-
-        // 复制packet内容
-        if (av_packet_ref(new_pkt, &pkt) < 0)
-        {
-            printf("Failed to ref audio packet");
-            packet_queue_.pop();
-            av_packet_unref(&pkt);
-            return;
-        }
-
-        // 原packet安全解引用
-        av_packet_unref(&pkt);
-        queue_cv_.notify_one();
     }
 
-    // 出队操作添加锁
     bool AudioStreamProcessor::getProcessedPacket(AVPacket &out_pkt, int timeout_ms)
     {
-        // 使用unique_lock配合条件变量
-        std::unique_lock<std::mutex> lock(queue_mutex_);
-
-        // 等待队列非空或处理器停止运行，最多等待timeout_ms
-        bool has_data = queue_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms),
-                                           [this]()
-                                           { return !is_running_ || !packet_queue_.empty(); });
-
-        // 处理退出情况
+        // 处理器停止或超时都返回失败
         if (!is_running_)
         {
-            return false; // 处理器停止，返回失败
-        }
-
-        // 处理超时情况
-        if (!has_data)
-        {
-            return false; // 超时且无数据
-        }
-
-        // 正常取数据
-        // printf("音频队列: %zu/%zu\n",packet_queue_.size(), buffer_size_);
-        AVPacket *front = &packet_queue_.front();
-        if (av_packet_ref(&out_pkt, front) < 0)
-        {
-            printf("Failed to ref output packet");
             return false;
         }
-
-        av_packet_unref(front);
-        packet_queue_.pop();
-
-        return true;
+        return packet_ring_->pop(out_pkt, timeout_ms) == 0;
     }
 
     // 获取队列首元素的时间戳
     bool AudioStreamProcessor::getQueueFrontPts(int64_t &pts, int timeout_ms)
     {
-        std::unique_lock<std::mutex> lock(queue_mutex_);
         // 等待队列非空或处理器停止运行，最多等待timeout_ms
-        bool has_data = queue_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms),
-                                           [this]()
-                                           { return !is_running_ || !packet_queue_.empty(); });
-
-        // 处理退出情况
-        if (!is_running_)
-        {
-            return false; // 处理器停止，返回失败
-        }
-
-        // 处理超时情况
-        if (!has_data)
+        if (!is_running_ || packet_ring_->waitReadable(timeout_ms) != 0)
         {
-            return false; // 超时且无数据
+            return false;
         }
-
-        pts = packet_queue_.front().pts;
-        // printf("音频队列首时间戳：%lld\n", pts);
-        return true;
+        return packet_ring_->peekFront(pts);
     }
 
     void AudioStreamProcessor::flush()
     {
-        while (!packet_queue_.empty())
+        if (packet_ring_)
         {
-            // 直接获取队首元素的引用，释放资源
-            AVPacket &front_pkt = packet_queue_.front();
-            av_packet_unref(&front_pkt);
-
-            // 删除队首元素
-            packet_queue_.pop();
+            packet_ring_->clear();
         }
 
         last_pts_ = 0;
@@ -0,0 +1,99 @@
+#include "core/GopCache.hpp"
+#include <cstring>
+
+extern "C"
+{
+#include "infra/logging/logger.h"
+}
+
+namespace core
+{
+    GopCache::GopCache(size_t byte_budget) : byte_budget_(byte_budget)
+    {
+    }
+
+    GopCache::~GopCache()
+    {
+        clear();
+    }
+
+    int GopCache::append(const AVPacket *pkt)
+    {
+        bool key = (pkt->flags & AV_PKT_FLAG_KEY) != 0;
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (key)
+        {
+            clearLocked();
+            collecting_ = true;
+            stats_.gops++;
+        }
+        if (!collecting_)
+            return -1;
+
+        if (bytes_ + pkt->size > byte_budget_)
+        {
+            LOGW("GopCache - GOP exceeds %zu bytes, dropped until next keyframe", byte_budget_);
+            clearLocked();
+            collecting_ = false;
+            stats_.overflows++;
+            return -1;
+        }
+
+        // 只拷贝缓存自己的一份，原包继续零拷贝引用VENC码流（见类注释）
+        AVPacket *copy = av_packet_alloc();
+        if (copy == nullptr || av_new_packet(copy, pkt->size) < 0 || av_packet_copy_props(copy, pkt) < 0)
+        {
+            LOGE("GopCache::append - alloc %d bytes failed", pkt->size);
+            av_packet_free(&copy);
+            clearLocked();
+            collecting_ = false;
+            return -1;
+        }
+        memcpy(copy->data, pkt->data, pkt->size);
+        packets_.push_back(copy);
+        bytes_ += pkt->size;
+        return 0;
+    }
+
+    int GopCache::snapshot(std::vector<AVPacket *> &out) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!collecting_)
+            return 0;
+        int count = 0;
+        for (const AVPacket *pkt : packets_)
+        {
+            AVPacket *ref = av_packet_clone(pkt);
+            if (ref == nullptr)
+                break;
+            out.push_back(ref);
+            count++;
+        }
+        return count;
+    }
+
+    void GopCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        clearLocked();
+        collecting_ = false;
+    }
+
+    void GopCache::clearLocked()
+    {
+        for (AVPacket *pkt : packets_)
+            av_packet_free(&pkt);
+        packets_.clear();
+        bytes_ = 0;
+    }
+
+    GopCacheStats GopCache::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        GopCacheStats stats = stats_;
+        stats.packets = packets_.size();
+        stats.bytes = bytes_;
+        return stats;
+    }
+
+} // namespace core
@@ -0,0 +1,331 @@
+#include "core/MotionDetector.hpp"
+#include "infra/time/TimeUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define MOTION_HAVE_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define MOTION_HAVE_SSE2 1
+#endif
+
+extern "C"
+{
+#include "infra/logging/logger.h"
+}
+
+namespace core
+{
+    namespace
+    {
+        std::atomic<bool> g_force_scalar{false};
+
+        void diffRowScalar(const uint8_t *cur, uint8_t *prev, uint16_t *bg, uint8_t *acc, int n, int threshold, int shift)
+        {
+            for (int i = 0; i < n; i++)
+            {
+                int c = cur[i];
+                int dp = std::abs(c - prev[i]);
+                int db = std::abs(c - (bg[i] >> 8));
+                acc[i] += std::max(dp, db) > threshold ? 1 : 0;
+                prev[i] = (uint8_t)c;
+                bg[i] = (uint16_t)(bg[i] - (bg[i] >> shift) + (c << (8 - shift)));
+            }
+        }
+
+#ifdef MOTION_HAVE_NEON
+        void diffRowNeon(const uint8_t *cur, uint8_t *prev, uint16_t *bg, uint8_t *acc, int n, int threshold, int shift)
+        {
+            const uint8x16_t thr = vdupq_n_u8((uint8_t)threshold);
+            const int16x8_t down = vdupq_n_s16((int16_t)-shift); // vshlq 负数为右移
+            const int16x8_t up = vdupq_n_s16((int16_t)(8 - shift));
+            int i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                uint8x16_t c = vld1q_u8(cur + i);
+                uint8x16_t p = vld1q_u8(prev + i);
+                uint16x8_t bg_lo = vld1q_u16(bg + i);
+                uint16x8_t bg_hi = vld1q_u16(bg + i + 8);
+                uint8x16_t b = vcombine_u8(vshrn_n_u16(bg_lo, 8), vshrn_n_u16(bg_hi, 8));
+
+                uint8x16_t d = vmaxq_u8(vabdq_u8(c, p), vabdq_u8(c, b));
+                uint8x16_t m = vcgtq_u8(d, thr);                  // 变化像素为 0xFF
+                vst1q_u8(acc + i, vsubq_u8(vld1q_u8(acc + i), m)); // 减 0xFF 即加1
+                vst1q_u8(prev + i, c);
+
+                bg_lo = vaddq_u16(vsubq_u16(bg_lo, vshlq_u16(bg_lo, down)), vshlq_u16(vmovl_u8(vget_low_u8(c)), up));
+                bg_hi = vaddq_u16(vsubq_u16(bg_hi, vshlq_u16(bg_hi, down)), vshlq_u16(vmovl_u8(vget_high_u8(c)), up));
+                vst1q_u16(bg + i, bg_lo);
+                vst1q_u16(bg + i + 8, bg_hi);
+            }
+            diffRowScalar(cur + i, prev + i, bg + i, acc + i, n - i, threshold, shift);
+        }
+#endif
+
+#ifdef MOTION_HAVE_SSE2
+        void diffRowSse2(const uint8_t *cur, uint8_t *prev, uint16_t *bg, uint8_t *acc, int n, int threshold, int shift)
+        {
+            const __m128i thr = _mm_set1_epi8((char)threshold);
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i down = _mm_cvtsi32_si128(shift);
+            const __m128i up = _mm_cvtsi32_si128(8 - shift);
+            int i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                __m128i c = _mm_loadu_si128((const __m128i *)(cur + i));
+                __m128i p = _mm_loadu_si128((const __m128i *)(prev + i));
+                __m128i bg_lo = _mm_loadu_si128((const __m128i *)(bg + i));
+                __m128i bg_hi = _mm_loadu_si128((const __m128i *)(bg + i + 8));
+                __m128i b = _mm_packus_epi16(_mm_srli_epi16(bg_lo, 8), _mm_srli_epi16(bg_hi, 8));
+
+                // 无符号绝对差：两个方向的饱和减法取或
+                __m128i dp = _mm_or_si128(_mm_subs_epu8(c, p), _mm_subs_epu8(p, c));
+                __m128i db = _mm_or_si128(_mm_subs_epu8(c, b), _mm_subs_epu8(b, c));
+                __m128i d = _mm_max_epu8(dp, db);
+                // 无符号 d > thr：饱和减法结果非零
+                __m128i m = _mm_xor_si128(_mm_cmpeq_epi8(_mm_subs_epu8(d, thr), zero), _mm_set1_epi8(-1));
+                __m128i a = _mm_loadu_si128((const __m128i *)(acc + i));
+                _mm_storeu_si128((__m128i *)(acc + i), _mm_sub_epi8(a, m));
+                _mm_storeu_si128((__m128i *)(prev + i), c);
+
+                bg_lo = _mm_add_epi16(_mm_sub_epi16(bg_lo, _mm_srl_epi16(bg_lo, down)), _mm_sll_epi16(_mm_unpacklo_epi8(c, zero), up));
+                bg_hi = _mm_add_epi16(_mm_sub_epi16(bg_hi, _mm_srl_epi16(bg_hi, down)), _mm_sll_epi16(_mm_unpackhi_epi8(c, zero), up));
+                _mm_storeu_si128((__m128i *)(bg + i), bg_lo);
+                _mm_storeu_si128((__m128i *)(bg + i + 8), bg_hi);
+            }
+            diffRowScalar(cur + i, prev + i, bg + i, acc + i, n - i, threshold, shift);
+        }
+#endif
+    } // namespace
+
+    void motionDiffRow(const uint8_t *cur, uint8_t *prev, uint16_t *bg, uint8_t *acc, int n, int threshold, int shift)
+    {
+        if (!g_force_scalar.load(std::memory_order_relaxed))
+        {
+#if defined(MOTION_HAVE_NEON)
+            diffRowNeon(cur, prev, bg, acc, n, threshold, shift);
+            return;
+#elif defined(MOTION_HAVE_SSE2)
+            diffRowSse2(cur, prev, bg, acc, n, threshold, shift);
+            return;
+#endif
+        }
+        diffRowScalar(cur, prev, bg, acc, n, threshold, shift);
+    }
+
+    void MotionDetector::setForceScalar(bool force)
+    {
+        g_force_scalar.store(force, std::memory_order_relaxed);
+    }
+
+    MotionDetector::MotionDetector(const MotionDetectorConfig &config) : config_(config)
+    {
+        config_.width = std::max(config_.width, kMotionBlockSize);
+        config_.height = std::max(config_.height, kMotionBlockSize);
+        config_.bg_shift = std::min(std::max(config_.bg_shift, 1), 8);
+        config_.diff_threshold = std::min(std::max(config_.diff_threshold, 0), 255);
+        cols_ = (config_.width + kMotionBlockSize - 1) / kMotionBlockSize;
+        rows_ = (config_.height + kMotionBlockSize - 1) / kMotionBlockSize;
+        size_t pixels = (size_t)config_.width * config_.height;
+        prev_.resize(pixels);
+        bg_.resize(pixels);
+        acc_.resize(config_.width);
+        grid_.resize((size_t)cols_ * rows_);
+    }
+
+    void MotionDetector::reset()
+    {
+        primed_ = false;
+        hit_frames_ = 0;
+    }
+
+    int MotionDetector::process(const uint8_t *y, int stride, int width, int height, uint64_t pts_us)
+    {
+        if (y == nullptr || width < config_.width || height < config_.height ||
+            width % config_.width != 0 || height % config_.height != 0)
+        {
+            LOGE("MotionDetector::process - unsupported plane %dx%d (detector %dx%d)", width, height,
+                 config_.width, config_.height);
+            return -1;
+        }
+        uint64_t start_us = infra::now_us();
+
+        const uint8_t *plane = y;
+        int plane_stride = stride;
+        if (width != config_.width || height != config_.height)
+        {
+            decimate(y, stride, width / config_.width, height / config_.height);
+            plane = small_.data();
+            plane_stride = config_.width;
+        }
+
+        if (!primed_)
+        {
+            // 第一帧：建立上一帧与背景，不做判断
+            for (int r = 0; r < config_.height; r++)
+            {
+                const uint8_t *src = plane + (size_t)r * plane_stride;
+                memcpy(&prev_[(size_t)r * config_.width], src, config_.width);
+                uint16_t *bg = &bg_[(size_t)r * config_.width];
+                for (int i = 0; i < config_.width; i++)
+                    bg[i] = (uint16_t)(src[i] << 8);
+            }
+            primed_ = true;
+        }
+        else
+        {
+            analyze(plane, plane_stride, pts_us);
+        }
+
+        uint64_t cost = infra::now_us() - start_us;
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.frames++;
+        stats_.motion_frames += motion_ ? 1 : 0;
+        process_us_total_ += cost;
+        stats_.process_us_avg = (double)process_us_total_ / stats_.frames;
+        stats_.process_us_max = std::max(stats_.process_us_max, cost);
+        return 0;
+    }
+
+    // 整数倍缩小：每个输出像素取对应源区域中心的 2x2 平均（倍数为1的方向直接取样）
+    void MotionDetector::decimate(const uint8_t *y, int stride, int fx, int fy)
+    {
+        small_.resize((size_t)config_.width * config_.height);
+        int ox = fx > 1 ? fx / 2 - 1 : 0;
+        int oy = fy > 1 ? fy / 2 - 1 : 0;
+        int dx = fx > 1 ? 1 : 0;
+        int dy = fy > 1 ? stride : 0;
+        for (int r = 0; r < config_.height; r++)
+        {
+            const uint8_t *src = y + (size_t)(r * fy + oy) * stride + ox;
+            uint8_t *dst = &small_[(size_t)r * config_.width];
+            for (int i = 0; i < config_.width; i++, src += fx)
+                dst[i] = (uint8_t)((src[0] + src[dx] + src[dy] + src[dy + dx] + 2) >> 2);
+        }
+    }
+
+    void MotionDetector::analyze(const uint8_t *plane, int stride, uint64_t pts_us)
+    {
+        const int w = config_.width;
+        const int h = config_.height;
+        uint64_t changed_pixels = 0;
+        int active_blocks = 0;
+        int min_bx = cols_, min_by = rows_, max_bx = -1, max_by = -1;
+
+        for (int by = 0; by < rows_; by++)
+        {
+            int y0 = by * kMotionBlockSize;
+            int y1 = std::min(h, y0 + kMotionBlockSize);
+            memset(acc_.data(), 0, w);
+            for (int r = y0; r < y1; r++)
+            {
+                size_t off = (size_t)r * w;
+                motionDiffRow(plane + (size_t)r * stride, &prev_[off], &bg_[off], acc_.data(), w,
+                              config_.diff_threshold, config_.bg_shift);
+            }
+            // 块行结束：按列累加得到每块的变化像素数（每块最多16行，u8计数不溢出）
+            for (int bx = 0; bx < cols_; bx++)
+            {
+                int x0 = bx * kMotionBlockSize;
+                int x1 = std::min(w, x0 + kMotionBlockSize);
+                int count = 0;
+                for (int x = x0; x < x1; x++)
+                    count += acc_[x];
+                int percent = count * 100 / ((x1 - x0) * (y1 - y0));
+                grid_[(size_t)by * cols_ + bx] = (uint8_t)percent;
+                changed_pixels += count;
+                if (percent >= config_.block_active_percent)
+                {
+                    active_blocks++;
+                    min_bx = std::min(min_bx, bx);
+                    max_bx = std::max(max_bx, bx);
+                    min_by = std::min(min_by, by);
+                    max_by = std::max(max_by, by);
+                }
+            }
+        }
+
+        // 整体光照变化：背景作废，从当前帧重新建立，本帧不计为运动
+        int total_blocks = cols_ * rows_;
+        if (active_blocks * 100 >= total_blocks * config_.global_change_percent)
+        {
+            LOGI("MotionDetector - global change (%d/%d blocks), background reset", active_blocks, total_blocks);
+            for (size_t i = 0; i < bg_.size(); i++)
+                bg_[i] = (uint16_t)(prev_[i] << 8); // prev_ 已更新为当前帧
+            hit_frames_ = 0;
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            stats_.global_changes++;
+            return;
+        }
+
+        bool changed = false;
+        if (active_blocks >= config_.min_active_blocks)
+        {
+            last_active_us_ = pts_us;
+            if (!motion_ && ++hit_frames_ >= config_.trigger_frames)
+            {
+                motion_ = true;
+                changed = true;
+                std::lock_guard<std::mutex> lock(stats_mutex_);
+                stats_.events++;
+            }
+        }
+        else
+        {
+            hit_frames_ = 0;
+            if (motion_ && pts_us - last_active_us_ >= (uint64_t)config_.release_ms * 1000)
+            {
+                motion_ = false;
+                changed = true;
+            }
+        }
+
+        bool due = config_.publish_interval_ms >= 0 &&
+                   pts_us - last_publish_us_ >= (uint64_t)config_.publish_interval_ms * 1000;
+        if (!callback_ || (!changed && !due))
+            return;
+
+        MotionEvent event;
+        event.pts_us = pts_us;
+        event.motion = motion_;
+        event.changed = changed;
+        event.active_blocks = active_blocks;
+        event.activity_permille = (int)(changed_pixels * 1000 / ((uint64_t)w * h));
+        event.grid_cols = cols_;
+        event.grid_rows = rows_;
+        event.grid = grid_;
+        if (max_bx >= 0)
+        {
+            event.box_x = min_bx * kMotionBlockSize;
+            event.box_y = min_by * kMotionBlockSize;
+            event.box_w = std::min(w, (max_bx + 1) * kMotionBlockSize) - event.box_x;
+            event.box_h = std::min(h, (max_by + 1) * kMotionBlockSize) - event.box_y;
+        }
+        last_publish_us_ = pts_us;
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            stats_.published++;
+        }
+        callback_(event);
+    }
+
+    MotionStats MotionDetector::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        return stats_;
+    }
+
+    void MotionDetector::printStats() const
+    {
+        MotionStats st = getStats();
+        LOGI("[motion] frames=%llu motion=%llu events=%llu published=%llu global=%llu cost avg=%.1fus max=%lluus",
+             (unsigned long long)st.frames, (unsigned long long)st.motion_frames, (unsigned long long)st.events,
+             (unsigned long long)st.published, (unsigned long long)st.global_changes, st.process_us_avg,
+             (unsigned long long)st.process_us_max);
+    }
+
+} // namespace core
@@ -0,0 +1,215 @@
+#include "core/MuxScheduler.hpp"
+#include "infra/time/MediaClock.h"
+#include "infra/time/TimeUtils.h"
+#include <poll.h>
+
+extern "C"
+{
+#include "infra/logging/logger.h"
+#include <libavutil/mathematics.h>
+}
+
+namespace core
+{
+    namespace
+    {
+        const AVRational kMicrosecondTimeBase = {1, 1000000};
+        const int64_t kDefaultWaitUs = 100000; // 无数据时的等待周期（用于检查退出标志）
+    }
+
+    MuxScheduler::MuxScheduler(const MuxSchedulerConfig &config)
+        : config_(config)
+    {
+        pkt_ = av_packet_alloc();
+    }
+
+    MuxScheduler::~MuxScheduler()
+    {
+        av_packet_free(&pkt_);
+    }
+
+    int MuxScheduler::addStream(const char *name, infra::SPSCRing<AVPacket> *ring, PacketSink sink)
+    {
+        Stream stream;
+        stream.name = name;
+        stream.ring = ring;
+        stream.time_base = ring->timeBase();
+        stream.sink = std::move(sink);
+        streams_.push_back(std::move(stream));
+        return (int)streams_.size() - 1;
+    }
+
+    int MuxScheduler::run(const std::atomic<bool> &quit_flag)
+    {
+        if (streams_.empty() || pkt_ == nullptr)
+        {
+            LOGE("MuxScheduler::run - no stream registered");
+            return -1;
+        }
+
+        int64_t last_stats_us = infra::TEST_COMM_GetNowUs();
+        std::vector<int> blockers;
+        while (!quit_flag)
+        {
+            int64_t now = infra::TEST_COMM_GetNowUs();
+            if (config_.stats_interval_s > 0 && now - last_stats_us >= config_.stats_interval_s * 1000000LL)
+            {
+                printStats();
+                last_stats_us = now;
+            }
+
+            // 1. 刷新各路队头，选出 PTS 最小的一路
+            int pick = -1;
+            int open_streams = 0;
+            for (size_t i = 0; i < streams_.size(); i++)
+            {
+                Stream &s = streams_[i];
+                s.has_head = s.ring->peekFront(s.head_pts);
+                if (s.has_head)
+                {
+                    if (s.head_since_us == 0)
+                        s.head_since_us = now;
+                    s.last_data_us = now;
+                    if (pick < 0 || av_compare_ts(s.head_pts, s.time_base,
+                                                  streams_[pick].head_pts, streams_[pick].time_base) < 0)
+                        pick = (int)i;
+                }
+                if (s.has_head || !s.ring->isClosed())
+                    open_streams++;
+            }
+            if (open_streams == 0)
+                break;
+            if (pick < 0)
+            {
+                blockers.clear();
+                for (size_t i = 0; i < streams_.size(); i++)
+                {
+                    if (!streams_[i].ring->isClosed())
+                        blockers.push_back((int)i);
+                }
+                waitFor(blockers, -1);
+                continue;
+            }
+
+            // 2. 没有数据的流可能随后送来更早的包：在延迟窗口内等待它，空闲/已关闭的流不等待
+            Stream &head = streams_[pick];
+            int64_t lateness_left = head.head_since_us + config_.max_lateness_us - now;
+            int64_t wait_us = lateness_left;
+            bool lone = false;
+            blockers.clear();
+            for (size_t i = 0; i < streams_.size(); i++)
+            {
+                Stream &s = streams_[i];
+                if ((int)i == pick || s.has_head || s.ring->isClosed())
+                    continue;
+                int64_t idle_left = s.last_data_us == 0 ? 0 : s.last_data_us + config_.idle_threshold_us - now;
+                if (idle_left <= 0)
+                {
+                    lone = true;
+                    continue;
+                }
+                if (lateness_left > 0)
+                {
+                    blockers.push_back((int)i);
+                    if (idle_left < wait_us)
+                        wait_us = idle_left;
+                }
+            }
+
+            if (blockers.empty())
+                emit(pick, now, lone);
+            else
+                waitFor(blockers, wait_us);
+        }
+
+        printStats();
+        return 0;
+    }
+
+    void MuxScheduler::emit(int index, int64_t now, bool lone)
+    {
+        Stream &s = streams_[index];
+        if (s.ring->pop(*pkt_, 0) != 0)
+        {
+            // 队列已关闭：残留的包不再输出
+            if (s.ring->isClosed())
+                s.ring->clear();
+            return;
+        }
+
+        int64_t pts_us = av_rescale_q(s.head_pts, s.time_base, kMicrosecondTimeBase);
+        bool late = last_emit_us_ != AV_NOPTS_VALUE && pts_us < last_emit_us_;
+        if (!late)
+            last_emit_us_ = pts_us;
+
+        uint64_t wait_us = now - s.head_since_us;
+        size_t depth = s.ring->size();
+        s.head_since_us = 0;
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            s.stats.packets++;
+            s.stats.lone_packets += lone ? 1 : 0;
+            s.stats.late_packets += late ? 1 : 0;
+            s.stats.wait_us_total += wait_us;
+            if (wait_us > s.stats.wait_us_max)
+                s.stats.wait_us_max = wait_us;
+            s.stats.reorder_depth_total += depth;
+            if (depth > s.stats.reorder_depth_max)
+                s.stats.reorder_depth_max = depth;
+        }
+
+        s.sink(pkt_, s.time_base);
+        av_packet_unref(pkt_);
+    }
+
+    void MuxScheduler::waitFor(const std::vector<int> &streams, int64_t timeout_us)
+    {
+        if (timeout_us < 0)
+            timeout_us = kDefaultWaitUs;
+
+        // 先登记等待再检查队列，避免错过等待前刚到达的数据
+        std::vector<struct pollfd> fds;
+        bool ready = false;
+        for (int index : streams)
+        {
+            infra::SPSCRing<AVPacket> *ring = streams_[index].ring;
+            if (!ring->beginWait())
+                ready = true;
+            fds.push_back({ring->readFd(), POLLIN, 0});
+        }
+
+        // 被信号打断（EINTR）时直接返回，由 run() 检查退出标志
+        if (!ready)
+            poll(fds.data(), fds.size(), (int)((timeout_us + 999) / 1000));
+
+        for (int index : streams)
+            streams_[index].ring->endWait();
+    }
+
+    MuxStreamStats MuxScheduler::getStats(int index) const
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        return streams_[index].stats;
+    }
+
+    void MuxScheduler::printStats() const
+    {
+        for (size_t i = 0; i < streams_.size(); i++)
+        {
+            MuxStreamStats st = getStats((int)i);
+            if (st.packets == 0)
+                continue;
+            LOGI("[mux] %s: packets=%llu lone=%llu late=%llu wait avg=%.2fms max=%.2fms reorder depth avg=%.2f max=%zu",
+                 streams_[i].name.c_str(),
+                 (unsigned long long)st.packets, (unsigned long long)st.lone_packets,
+                 (unsigned long long)st.late_packets,
+                 st.wait_us_total / 1000.0 / st.packets, st.wait_us_max / 1000.0,
+                 (double)st.reorder_depth_total / st.packets, st.reorder_depth_max);
+        }
+
+        infra::MediaClock &clock = infra::MediaClock::instance();
+        LOGI("[mux] av skew last=%.2fms max=%.2fms",
+             clock.avSkewUs() / 1000.0, clock.maxAbsSkewUs() / 1000.0);
+    }
+
+} // namespace core
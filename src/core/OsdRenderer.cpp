@@ -0,0 +1,367 @@
+#include "core/OsdRenderer.hpp"
+#include "infra/time/TimeUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define OSD_HAVE_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define OSD_HAVE_SSE2 1
+#endif
+
+extern "C"
+{
+#include "infra/logging/logger.h"
+}
+
+namespace core
+{
+    namespace
+    {
+        std::atomic<bool> g_force_scalar{false};
+
+        inline uint8_t div255(uint32_t v)
+        {
+            // 与 NEON vraddhn_u16(v, vrshrq_n_u16(v, 8)) 按位一致
+            return (uint8_t)((v + ((v + 128) >> 8) + 128) >> 8);
+        }
+
+        void blendRowScalar(uint8_t *dst, const uint8_t *src, const uint8_t *alpha, int n)
+        {
+            for (int i = 0; i < n; i++)
+            {
+                uint32_t a = alpha[i];
+                if (a == 0)
+                    continue;
+                dst[i] = div255(src[i] * a + dst[i] * (255 - a));
+            }
+        }
+
+#ifdef OSD_HAVE_NEON
+        void blendRowNeon(uint8_t *dst, const uint8_t *src, const uint8_t *alpha, int n)
+        {
+            int i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                uint8x16_t a = vld1q_u8(alpha + i);
+                // 文字tile大部分是透明像素，整块透明时不读写目标（ARMv7 没有 vmaxvq，按64位判零）
+                uint8x8_t any = vorr_u8(vget_low_u8(a), vget_high_u8(a));
+                if (vget_lane_u64(vreinterpret_u64_u8(any), 0) == 0)
+                    continue;
+                uint8x16_t s = vld1q_u8(src + i);
+                uint8x16_t d = vld1q_u8(dst + i);
+                uint8x16_t ia = vmvnq_u8(a);
+
+                uint16x8_t lo = vmull_u8(vget_low_u8(s), vget_low_u8(a));
+                lo = vmlal_u8(lo, vget_low_u8(d), vget_low_u8(ia));
+                uint16x8_t hi = vmull_u8(vget_high_u8(s), vget_high_u8(a));
+                hi = vmlal_u8(hi, vget_high_u8(d), vget_high_u8(ia));
+
+                uint8x8_t rlo = vraddhn_u16(lo, vrshrq_n_u16(lo, 8));
+                uint8x8_t rhi = vraddhn_u16(hi, vrshrq_n_u16(hi, 8));
+                vst1q_u8(dst + i, vcombine_u8(rlo, rhi));
+            }
+            blendRowScalar(dst + i, src + i, alpha + i, n - i);
+        }
+#elif defined(OSD_HAVE_SSE2)
+        // 8个16位的 src*a + dst*(255-a) → 除以255四舍五入（与 div255 相同的 (t + (t>>8)) >> 8，t = v + 128）
+        inline __m128i blendHalfSse2(__m128i s, __m128i d, __m128i a)
+        {
+            const __m128i k255 = _mm_set1_epi16(255);
+            const __m128i k128 = _mm_set1_epi16(128);
+            __m128i v = _mm_add_epi16(_mm_mullo_epi16(s, a), _mm_mullo_epi16(d, _mm_sub_epi16(k255, a)));
+            __m128i t = _mm_add_epi16(v, k128);
+            return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+        }
+
+        void blendRowSse2(uint8_t *dst, const uint8_t *src, const uint8_t *alpha, int n)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            int i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                __m128i a = _mm_loadu_si128((const __m128i *)(alpha + i));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(a, zero)) == 0xFFFF)
+                    continue; // 整块透明
+                __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+                __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+                __m128i lo = blendHalfSse2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero),
+                                           _mm_unpacklo_epi8(a, zero));
+                __m128i hi = blendHalfSse2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero),
+                                           _mm_unpackhi_epi8(a, zero));
+                _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(lo, hi));
+            }
+            blendRowScalar(dst + i, src + i, alpha + i, n - i);
+        }
+#endif
+
+        inline int clampU8(int v)
+        {
+            return v < 0 ? 0 : (v > 255 ? 255 : v);
+        }
+    } // namespace
+
+    void osdBlendRow(uint8_t *dst, const uint8_t *src, const uint8_t *alpha, int n)
+    {
+#if defined(OSD_HAVE_NEON)
+        if (!g_force_scalar.load(std::memory_order_relaxed))
+        {
+            blendRowNeon(dst, src, alpha, n);
+            return;
+        }
+#elif defined(OSD_HAVE_SSE2)
+        if (!g_force_scalar.load(std::memory_order_relaxed))
+        {
+            blendRowSse2(dst, src, alpha, n);
+            return;
+        }
+#endif
+        blendRowScalar(dst, src, alpha, n);
+    }
+
+    // ======================== OsdRegion ========================
+
+    bool OsdRegion::setText(const std::string &text)
+    {
+        if (!custom_tile_ && text == text_ && !argb_.empty())
+            return false;
+        text_ = text;
+        custom_tile_ = false;
+        render();
+        buildYUVA();
+        return true;
+    }
+
+    int OsdRegion::setTile(const uint32_t *argb, int width, int height)
+    {
+        if (argb == nullptr || width <= 0 || height <= 0)
+            return -1;
+
+        // NV12 下 tile 宽高需为偶数
+        int w = std::min(width, config_.max_width) & ~1;
+        int h = std::min(height, config_.max_height) & ~1;
+        if (w <= 0 || h <= 0)
+            return -1;
+
+        tile_w_ = w;
+        tile_h_ = h;
+        argb_.resize((size_t)w * h);
+        for (int r = 0; r < h; r++)
+            std::copy(argb + (size_t)r * width, argb + (size_t)r * width + w, &argb_[(size_t)r * w]);
+        text_.clear();
+        custom_tile_ = true;
+        buildYUVA();
+        return 0;
+    }
+
+    // 渲染文本覆盖度 → ARGB tile（文字色按覆盖度叠在背景色上，非预乘alpha）
+    void OsdRegion::render()
+    {
+        std::vector<std::string> lines;
+        std::stringstream ss(text_);
+        std::string line;
+        while (std::getline(ss, line, '\n'))
+            lines.push_back(line);
+
+        const int font = cv::FONT_HERSHEY_SIMPLEX;
+        int w = 0;
+        int h = config_.line_spacing;
+        std::vector<int> baselines;
+        for (const std::string &l : lines)
+        {
+            int baseline = 0;
+            cv::Size size = cv::getTextSize(l, font, config_.font_scale, config_.thickness, &baseline);
+            w = std::max(w, size.width + config_.line_spacing * 2);
+            h += size.height + baseline;
+            baselines.push_back(h - baseline);
+            h += config_.line_spacing;
+        }
+
+        // NV12 下 tile 宽高需为偶数
+        tile_w_ = std::min(w, config_.max_width) & ~1;
+        tile_h_ = std::min(h, config_.max_height) & ~1;
+        if (lines.empty() || tile_w_ <= 0 || tile_h_ <= 0)
+        {
+            tile_w_ = tile_h_ = 0;
+            argb_.clear();
+            return;
+        }
+
+        cv::Mat coverage(tile_h_, tile_w_, CV_8UC1, cv::Scalar(0));
+        for (size_t i = 0; i < lines.size(); i++)
+        {
+            cv::putText(coverage, lines[i], cv::Point(config_.line_spacing, baselines[i]),
+                        font, config_.font_scale, cv::Scalar(255), config_.thickness, cv::LINE_AA);
+        }
+
+        const uint32_t fg = config_.color;
+        const uint32_t bg = config_.background;
+        const int fa = fg >> 24, ba = bg >> 24;
+        argb_.resize((size_t)tile_w_ * tile_h_);
+        for (int r = 0; r < tile_h_; r++)
+        {
+            const uint8_t *cov = coverage.ptr<uint8_t>(r);
+            uint32_t *out = &argb_[(size_t)r * tile_w_];
+            for (int c = 0; c < tile_w_; c++)
+            {
+                int k = cov[c];
+                int fw = fa * k;         // 前景权重（×255）
+                int bw = ba * (255 - k); // 背景权重（×255）
+                int a = (fw + bw + 127) / 255;
+                if (a == 0)
+                {
+                    out[c] = 0;
+                    continue;
+                }
+                uint32_t px = (uint32_t)a << 24;
+                for (int shift = 0; shift <= 16; shift += 8)
+                {
+                    int f = (fg >> shift) & 0xFF;
+                    int b = (bg >> shift) & 0xFF;
+                    int v = (f * fw + b * bw + (fw + bw) / 2) / (fw + bw);
+                    px |= (uint32_t)v << shift;
+                }
+                out[c] = px;
+            }
+        }
+    }
+
+    // ARGB → NV12 分量（BT.601 limited range），色度按 2x2 块以 alpha 加权平均
+    void OsdRegion::buildYUVA()
+    {
+        size_t n = argb_.size();
+        y_.assign(n, 0);
+        y_alpha_.assign(n, 0);
+        uv_.assign(n / 2, 128);
+        uv_alpha_.assign(n / 2, 0);
+        row_used_.assign(tile_h_, 0);
+
+        for (int r = 0; r < tile_h_; r++)
+        {
+            for (int c = 0; c < tile_w_; c++)
+            {
+                uint32_t px = argb_[(size_t)r * tile_w_ + c];
+                int a = px >> 24, R = (px >> 16) & 0xFF, G = (px >> 8) & 0xFF, B = px & 0xFF;
+                y_[(size_t)r * tile_w_ + c] = (uint8_t)clampU8(((66 * R + 129 * G + 25 * B + 128) >> 8) + 16);
+                y_alpha_[(size_t)r * tile_w_ + c] = (uint8_t)a;
+                if (a != 0)
+                    row_used_[r] = 1;
+            }
+        }
+
+        for (int r = 0; r < tile_h_ / 2; r++)
+        {
+            for (int c = 0; c < tile_w_ / 2; c++)
+            {
+                int sum_a = 0, sum_u = 0, sum_v = 0;
+                for (int k = 0; k < 4; k++)
+                {
+                    uint32_t px = argb_[(size_t)(r * 2 + k / 2) * tile_w_ + c * 2 + k % 2];
+                    int a = px >> 24, R = (px >> 16) & 0xFF, G = (px >> 8) & 0xFF, B = px & 0xFF;
+                    sum_a += a;
+                    sum_u += a * (((-38 * R - 74 * G + 112 * B + 128) >> 8) + 128);
+                    sum_v += a * (((112 * R - 94 * G - 18 * B + 128) >> 8) + 128);
+                }
+                size_t idx = (size_t)r * tile_w_ + c * 2;
+                uint8_t a = (uint8_t)((sum_a + 2) / 4);
+                uv_alpha_[idx] = uv_alpha_[idx + 1] = a;
+                if (sum_a != 0)
+                {
+                    uv_[idx] = (uint8_t)clampU8((sum_u + sum_a / 2) / sum_a);
+                    uv_[idx + 1] = (uint8_t)clampU8((sum_v + sum_a / 2) / sum_a);
+                }
+            }
+        }
+    }
+
+    void OsdRegion::blendNV12(uint8_t *y, uint8_t *uv, int stride, int width, int height) const
+    {
+        if (argb_.empty())
+            return;
+
+        int x0 = config_.x & ~1;
+        int y0 = config_.y & ~1;
+        if (x0 < 0 || y0 < 0 || x0 >= width || y0 >= height)
+            return;
+        int w = std::min(tile_w_, (width - x0) & ~1);
+        int h = std::min(tile_h_, (height - y0) & ~1);
+
+        for (int r = 0; r < h; r++)
+        {
+            if (!row_used_[r])
+                continue;
+            size_t src = (size_t)r * tile_w_;
+            osdBlendRow(y + (size_t)(y0 + r) * stride + x0, &y_[src], &y_alpha_[src], w);
+        }
+        for (int r = 0; r < h / 2; r++)
+        {
+            if (!row_used_[r * 2] && !row_used_[r * 2 + 1])
+                continue;
+            size_t src = (size_t)r * tile_w_;
+            osdBlendRow(uv + (size_t)(y0 / 2 + r) * stride + x0, &uv_[src], &uv_alpha_[src], w);
+        }
+    }
+
+    // ======================== OsdRenderer ========================
+
+    int OsdRenderer::addRegion(const OsdRegionConfig &config)
+    {
+        regions_.emplace_back(config);
+        return (int)regions_.size() - 1;
+    }
+
+    bool OsdRenderer::setText(int id, const std::string &text)
+    {
+        if (id < 0 || id >= (int)regions_.size())
+        {
+            LOGE("OsdRenderer::setText - invalid region %d", id);
+            return false;
+        }
+        if (!regions_[id].setText(text))
+            return false;
+        render_count_++;
+        return true;
+    }
+
+    int OsdRenderer::setTile(int id, const uint32_t *argb, int width, int height)
+    {
+        if (id < 0 || id >= (int)regions_.size())
+        {
+            LOGE("OsdRenderer::setTile - invalid region %d", id);
+            return -1;
+        }
+        if (regions_[id].setTile(argb, width, height) != 0)
+        {
+            LOGE("OsdRenderer::setTile - invalid tile %dx%d", width, height);
+            return -1;
+        }
+        render_count_++;
+        return 0;
+    }
+
+    int OsdRenderer::drawNV12(uint8_t *y, uint8_t *uv, int stride, int width, int height)
+    {
+        if (y == nullptr || uv == nullptr || stride < width || width <= 0 || height <= 0)
+        {
+            LOGE("OsdRenderer::drawNV12 - invalid frame %dx%d stride=%d", width, height, stride);
+            return -1;
+        }
+
+        uint64_t start = infra::TEST_COMM_GetNowUs();
+        for (const OsdRegion &region : regions_)
+            region.blendNV12(y, uv, stride, width, height);
+        last_blend_us_ = (int64_t)(infra::TEST_COMM_GetNowUs() - start);
+        return 0;
+    }
+
+    void OsdRenderer::setForceScalar(bool force)
+    {
+        g_force_scalar.store(force, std::memory_order_relaxed);
+    }
+
+} // namespace core
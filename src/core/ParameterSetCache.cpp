@@ -0,0 +1,195 @@
+#include "core/ParameterSetCache.hpp"
+#include "core/VencPacketWrapper.hpp"
+#include <chrono>
+#include <cstring>
+
+extern "C"
+{
+#include "infra/logging/logger.h"
+}
+
+namespace core
+{
+    namespace
+    {
+        const uint8_t kStartCode[4] = {0, 0, 0, 1};
+
+        // 从 pos 起查找下一个起始码，返回起始码之后的位置（没有则返回 len）；start 为起始码的首字节位置
+        size_t findStartCode(const uint8_t *data, size_t len, size_t pos, size_t &start)
+        {
+            for (size_t i = pos; i + 3 <= len; i++)
+            {
+                if (data[i] == 0 && data[i + 1] == 0 && data[i + 2] == 1)
+                {
+                    start = i > pos && data[i - 1] == 0 ? i - 1 : i;
+                    return i + 3;
+                }
+            }
+            start = len;
+            return len;
+        }
+
+        // 去掉段首的起始码
+        void stripStartCode(const uint8_t *&data, size_t &len)
+        {
+            size_t i = 0;
+            while (i < len && data[i] == 0)
+                i++;
+            if (i >= 2 && i < len && data[i] == 1)
+            {
+                data += i + 1;
+                len -= i + 1;
+            }
+        }
+    }
+
+    ParameterSetCache::ParameterSetCache(RK_CODEC_ID_E codec)
+        : codec_(codec), has_param_sets_(codec == RK_VIDEO_ID_AVC || codec == RK_VIDEO_ID_HEVC)
+    {
+    }
+
+    int ParameterSetCache::classify(uint8_t header) const
+    {
+        if (codec_ == RK_VIDEO_ID_HEVC)
+        {
+            int type = (header >> 1) & 0x3f;
+            if (type < 32)
+                return -2; // VCL
+            if (type == 32)
+                return kVps;
+            if (type == 33)
+                return kSps;
+            if (type == 34)
+                return kPps;
+            return -1;
+        }
+        int type = header & 0x1f;
+        if (type >= 1 && type <= 5)
+            return -2; // VCL
+        if (type == 7)
+            return kSps;
+        if (type == 8)
+            return kPps;
+        return -1;
+    }
+
+    bool ParameterSetCache::visit(const uint8_t *nal, size_t len, bool found[kParamTypes])
+    {
+        if (len == 0)
+            return true;
+        int type = classify(nal[0]);
+        if (type == -2)
+            return false; // 参数集都在slice之前
+        if (type < 0)
+            return true;
+
+        found[type] = true;
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<uint8_t> &cached = sets_[type];
+        if (cached.size() != len || memcmp(cached.data(), nal, len) != 0)
+        {
+            bool was_ready = readyLocked();
+            cached.assign(nal, nal + len);
+            if (was_ready)
+                LOGI("ParameterSetCache - parameter set %d changed (%zu bytes)", type, len);
+            if (readyLocked())
+                cv_.notify_all();
+        }
+        return true;
+    }
+
+    bool ParameterSetCache::inspect(const AVPacket *pkt)
+    {
+        if (!has_param_sets_)
+            return true;
+        if (pkt == nullptr || pkt->data == nullptr || pkt->size <= 0)
+            return false;
+
+        bool found[kParamTypes] = {codec_ != RK_VIDEO_ID_HEVC, false, false}; // H.264 没有VPS
+        const struct iovec *iov = nullptr;
+        int count = VencPacketWrapper::segments(pkt, &iov);
+        if (count > 0)
+        {
+            // VENC按NAL分包：每段即一个NAL
+            for (int i = 0; i < count; i++)
+            {
+                const uint8_t *nal = (const uint8_t *)iov[i].iov_base;
+                size_t len = iov[i].iov_len;
+                stripStartCode(nal, len);
+                if (!visit(nal, len, found))
+                    break;
+            }
+        }
+        else
+        {
+            const uint8_t *data = pkt->data;
+            size_t size = pkt->size;
+            size_t start = 0;
+            size_t pos = findStartCode(data, size, 0, start);
+            while (pos < size)
+            {
+                size_t next_start = 0;
+                size_t next = findStartCode(data, size, pos, next_start);
+                if (!visit(data + pos, next_start - pos, found))
+                    break;
+                pos = next;
+            }
+        }
+        return found[kVps] && found[kSps] && found[kPps];
+    }
+
+    bool ParameterSetCache::readyLocked() const
+    {
+        return (codec_ != RK_VIDEO_ID_HEVC || !sets_[kVps].empty()) && !sets_[kSps].empty() && !sets_[kPps].empty();
+    }
+
+    bool ParameterSetCache::ready() const
+    {
+        if (!has_param_sets_)
+            return true;
+        std::lock_guard<std::mutex> lock(mutex_);
+        return readyLocked();
+    }
+
+    bool ParameterSetCache::waitReady(int timeout_ms) const
+    {
+        if (!has_param_sets_)
+            return true;
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this]()
+                            { return readyLocked(); });
+    }
+
+    std::vector<uint8_t> ParameterSetCache::extradata() const
+    {
+        std::vector<uint8_t> out;
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!has_param_sets_ || !readyLocked())
+            return out;
+        for (const std::vector<uint8_t> &set : sets_)
+        {
+            if (set.empty())
+                continue;
+            out.insert(out.end(), kStartCode, kStartCode + sizeof(kStartCode));
+            out.insert(out.end(), set.begin(), set.end());
+        }
+        return out;
+    }
+
+    int ParameterSetCache::prepend(const AVPacket *pkt, AVPacket *out) const
+    {
+        std::vector<uint8_t> sets = extradata();
+        if (sets.empty())
+            return -1;
+        if (av_new_packet(out, sets.size() + pkt->size) < 0)
+        {
+            LOGE("ParameterSetCache::prepend - av_new_packet failed");
+            return -1;
+        }
+        memcpy(out->data, sets.data(), sets.size());
+        memcpy(out->data + sets.size(), pkt->data, pkt->size);
+        av_packet_copy_props(out, pkt);
+        return 0;
+    }
+
+} // namespace core
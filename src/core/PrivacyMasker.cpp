@@ -0,0 +1,515 @@
+#include "core/PrivacyMasker.hpp"
+#include "infra/time/TimeUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+extern "C"
+{
+#include "infra/logging/logger.h"
+}
+
+namespace core
+{
+    namespace
+    {
+        struct Interval
+        {
+            double x0;
+            double x1;
+        };
+
+        // 解析 "a:b:c..." 形式的整数列表
+        bool parseInts(const std::string &text, std::vector<int> &out)
+        {
+            out.clear();
+            std::stringstream ss(text);
+            std::string item;
+            while (std::getline(ss, item, ':'))
+            {
+                char *end = nullptr;
+                long v = strtol(item.c_str(), &end, 10);
+                if (item.empty() || *end != '\0')
+                    return false;
+                out.push_back((int)v);
+            }
+            return !out.empty();
+        }
+
+        // RGB → BT.601 limited range YUV（与VENC的色彩空间一致）
+        void rgbToYuv(uint32_t rgb, PrivacyMask &mask)
+        {
+            int r = (rgb >> 16) & 0xFF;
+            int g = (rgb >> 8) & 0xFF;
+            int b = rgb & 0xFF;
+            mask.y = (uint8_t)(16 + ((66 * r + 129 * g + 25 * b + 128) >> 8));
+            mask.u = (uint8_t)(128 + ((-38 * r - 74 * g + 112 * b + 128) >> 8));
+            mask.v = (uint8_t)(128 + ((112 * r - 94 * g - 18 * b + 128) >> 8));
+        }
+
+        // 水平线 yc 与多边形各边的交点，按奇偶规则两两成对
+        void scanLine(const std::vector<PrivacyPoint> &polygon, double sx, double sy, double yc, std::vector<Interval> &out)
+        {
+            double xs[kMaxPrivacyVertices];
+            int n = 0;
+            size_t count = polygon.size();
+            for (size_t i = 0; i < count; i++)
+            {
+                const PrivacyPoint &a = polygon[i];
+                const PrivacyPoint &b = polygon[(i + 1) % count];
+                double ay = a.y * sy, by = b.y * sy;
+                if ((ay <= yc && yc < by) || (by <= yc && yc < ay))
+                    xs[n++] = a.x * sx + (yc - ay) * (b.x - a.x) * sx / (by - ay);
+            }
+            std::sort(xs, xs + n);
+            for (int i = 0; i + 1 < n; i += 2)
+                out.push_back({xs[i], xs[i + 1]});
+        }
+    }
+
+    PrivacyMask PrivacyMask::rect(int x, int y, int width, int height, PrivacyMaskMode mode)
+    {
+        PrivacyMask mask;
+        mask.mode = mode;
+        mask.polygon = {{x, y}, {x + width, y}, {x + width, y + height}, {x, y + height}};
+        return mask;
+    }
+
+    int parsePrivacyMasks(const std::string &text, std::vector<PrivacyMask> &masks)
+    {
+        int ret = 0;
+        std::stringstream regions(text);
+        std::string region;
+        while (std::getline(regions, region, ';'))
+        {
+            if (region.empty())
+                continue;
+            PrivacyMask mask;
+            std::stringstream ss(region);
+            std::string item;
+            std::vector<int> values;
+            while (std::getline(ss, item, ','))
+            {
+                size_t eq = item.find('=');
+                if (eq == std::string::npos)
+                {
+                    if (!item.empty())
+                        ret = -1;
+                    continue;
+                }
+                std::string key = item.substr(0, eq);
+                std::string value = item.substr(eq + 1);
+                if (key == "rect" && parseInts(value, values) && values.size() == 4)
+                {
+                    PrivacyMaskMode mode = mask.mode;
+                    mask.polygon = PrivacyMask::rect(values[0], values[1], values[2], values[3]).polygon;
+                    mask.mode = mode;
+                }
+                else if (key == "poly" && parseInts(value, values) && values.size() % 2 == 0)
+                {
+                    mask.polygon.clear();
+                    for (size_t i = 0; i < values.size(); i += 2)
+                        mask.polygon.push_back({values[i], values[i + 1]});
+                }
+                else if (key == "mode" && value == "solid")
+                    mask.mode = PrivacyMaskMode::kSolid;
+                else if (key == "mode" && value == "pixelate")
+                    mask.mode = PrivacyMaskMode::kPixelate;
+                else if (key == "mode" && value == "blur")
+                    mask.mode = PrivacyMaskMode::kBlur;
+                else if (key == "block")
+                    mask.block = atoi(value.c_str());
+                else if (key == "color")
+                    rgbToYuv((uint32_t)strtoul(value.c_str(), nullptr, 16), mask);
+                else
+                    ret = -1;
+            }
+            if (mask.polygon.size() < 3)
+            {
+                ret = -1;
+                continue;
+            }
+            masks.push_back(mask);
+        }
+        return ret;
+    }
+
+    bool PrivacyMasker::validMask(const PrivacyMask &mask)
+    {
+        return mask.polygon.size() >= 3 && mask.polygon.size() <= (size_t)kMaxPrivacyVertices && mask.block >= 2 &&
+               mask.block <= 256 && (mask.block & 1) == 0;
+    }
+
+    int PrivacyMasker::setMasks(const std::vector<PrivacyMask> &masks, int ref_width, int ref_height)
+    {
+        if (masks.size() > (size_t)kMaxPrivacyMasks || ref_width < 0 || ref_height < 0)
+        {
+            LOGE("PrivacyMasker::setMasks - %s: %zu masks (max %d), ref %dx%d", name_.c_str(), masks.size(),
+                 kMaxPrivacyMasks, ref_width, ref_height);
+            return -1;
+        }
+        for (size_t i = 0; i < masks.size(); i++)
+        {
+            if (!validMask(masks[i]))
+            {
+                LOGE("PrivacyMasker::setMasks - %s: mask %zu invalid (%zu vertices, block %d)", name_.c_str(), i,
+                     masks[i].polygon.size(), masks[i].block);
+                return -1;
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ = masks;
+        ref_width_ = ref_width;
+        ref_height_ = ref_height;
+        count_.store((int)masks.size(), std::memory_order_relaxed);
+        dirty_.store(true, std::memory_order_release);
+        return 0;
+    }
+
+    /**
+     * 每两行一条扫描线：在两行的像素中心各求一次交点区间并取并集，端点向外取整、取偶，
+     * 保证任何被多边形覆盖到的像素（及其所在的色度块）都在遮挡范围内
+     */
+    void PrivacyMasker::rasterize(const std::vector<PrivacyPoint> &polygon, double scale_x, double scale_y, int width,
+                                  int height, std::vector<Span> &spans)
+    {
+        spans.clear();
+        double min_y = polygon[0].y, max_y = polygon[0].y;
+        for (const PrivacyPoint &p : polygon)
+        {
+            min_y = std::min(min_y, (double)p.y);
+            max_y = std::max(max_y, (double)p.y);
+        }
+        int row_begin = std::max(0, (int)std::floor(min_y * scale_y) & ~1);
+        int row_end = std::min(height, (int)std::ceil(max_y * scale_y));
+
+        std::vector<Interval> intervals;
+        for (int row = row_begin; row < row_end; row += 2)
+        {
+            intervals.clear();
+            scanLine(polygon, scale_x, scale_y, row + 0.5, intervals);
+            scanLine(polygon, scale_x, scale_y, row + 1.5, intervals);
+            std::sort(intervals.begin(), intervals.end(), [](const Interval &a, const Interval &b)
+                      { return a.x0 < b.x0; });
+            for (const Interval &iv : intervals)
+            {
+                int x0 = std::max(0, (int)std::floor(iv.x0) & ~1);
+                int x1 = std::min(width, ((int)std::ceil(iv.x1) + 1) & ~1);
+                if (x1 <= x0)
+                    continue;
+                if (!spans.empty() && spans.back().row == row && x0 <= spans.back().x1)
+                    spans.back().x1 = std::max(spans.back().x1, x1); // 与上一段重叠或相接则合并
+                else
+                    spans.push_back({row, x0, x1});
+            }
+        }
+    }
+
+    void PrivacyMasker::rebuild(int width, int height)
+    {
+        std::vector<PrivacyMask> masks;
+        int ref_width, ref_height;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            masks = pending_;
+            ref_width = ref_width_;
+            ref_height = ref_height_;
+        }
+
+        double scale_x = ref_width > 0 ? (double)width / ref_width : 1.0;
+        double scale_y = ref_height > 0 ? (double)height / ref_height : 1.0;
+        uint64_t masked = 0;
+        regions_.clear();
+        regions_.reserve(masks.size());
+        for (const PrivacyMask &mask : masks)
+        {
+            Region region;
+            rasterize(mask.polygon, scale_x, scale_y, width, height, region.spans);
+            if (region.spans.empty())
+                continue; // 区域在画面外
+            int x0 = width, x1 = 0;
+            for (const Span &span : region.spans)
+            {
+                x0 = std::min(x0, span.x0);
+                x1 = std::max(x1, span.x1);
+                masked += (uint64_t)(span.x1 - span.x0) * 2;
+            }
+            region.mode = mask.mode;
+            region.block = mask.block;
+            region.x = x0;
+            region.y = region.spans.front().row;
+            region.width = x1 - x0;
+            region.height = region.spans.back().row + 2 - region.y;
+            region.is_rect = (int)region.spans.size() == region.height / 2;
+            for (size_t i = 0; region.is_rect && i < region.spans.size(); i++)
+                region.is_rect = region.spans[i].x0 == x0 && region.spans[i].x1 == x1;
+
+            if (region.mode == PrivacyMaskMode::kSolid)
+            {
+                region.fill_y = mask.y;
+                region.fill_uv.resize(region.width);
+                for (int i = 0; i < region.width; i += 2)
+                {
+                    region.fill_uv[i] = mask.u;
+                    region.fill_uv[i + 1] = mask.v;
+                }
+            }
+            else
+            {
+                region.cells_w = (region.width + region.block - 1) / region.block;
+                region.cells_h = (region.height + region.block - 1) / region.block;
+                region.sums.resize((size_t)region.cells_w * region.cells_h * 3);
+                region.counts.resize((size_t)region.cells_w * region.cells_h);
+                region.cells.resize(region.sums.size());
+            }
+            if (region.mode == PrivacyMaskMode::kBlur)
+            {
+                // 块网格每格放大为 2x2 像素（色度一格一个样本），不足两格时复制最后一格，满足缩放器的最小尺寸
+                int small_w = std::max(2, region.cells_w) * 2;
+                int small_h = std::max(2, region.cells_h) * 2;
+                if (region.scaler.configure(small_w, small_h, region.width, region.height) == 0)
+                {
+                    region.small.resize((size_t)small_w * small_h * 3 / 2);
+                    region.blurred.resize((size_t)region.width * region.height * 3 / 2);
+                }
+                else
+                {
+                    // 缩放器不支持该尺寸时退化为马赛克（块网格已建立），不能留下未遮挡的区域
+                    LOGW("PrivacyMasker - %s: blur %dx%d -> %dx%d not supported, pixelate instead", name_.c_str(),
+                         small_w, small_h, region.width, region.height);
+                    region.mode = PrivacyMaskMode::kPixelate;
+                }
+            }
+            regions_.push_back(std::move(region));
+        }
+        width_ = width;
+        height_ = height;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.masks = (int)regions_.size();
+        stats_.masked_pixels = masked;
+        stats_.frame_pixels = (uint64_t)width * height;
+        stats_.rebuilds++;
+        LOGI("PrivacyMasker - %s: %d masks at %dx%d, %llu px (%.1f%% of frame)", name_.c_str(), stats_.masks, width,
+             height, (unsigned long long)masked, masked * 100.0 / stats_.frame_pixels);
+    }
+
+    // 每格的 Y/U/V 平均值：按扫描线累加，只统计遮挡范围内的像素（外接矩形内、多边形外的画面不混入）；
+    // 遮挡范围没有覆盖到的格（只有模糊插值会用到）取整个区域的平均值
+    void PrivacyMasker::averageCells(const infra::imgproc::NV12Image &frame, Region &region)
+    {
+        const int block = region.block;
+        std::fill(region.sums.begin(), region.sums.end(), 0);
+        std::fill(region.counts.begin(), region.counts.end(), 0);
+        for (const Span &span : region.spans)
+        {
+            size_t row_cells = (size_t)((span.row - region.y) / block) * region.cells_w;
+            const uint8_t *y0 = frame.y + (size_t)span.row * frame.y_stride;
+            const uint8_t *y1 = y0 + frame.y_stride;
+            const uint8_t *uv = frame.uv + (size_t)(span.row / 2) * frame.uv_stride;
+            for (int x = span.x0; x < span.x1;)
+            {
+                int cx = (x - region.x) / block;
+                int end = std::min(span.x1, region.x + (cx + 1) * block);
+                uint32_t acc_y = 0, acc_u = 0, acc_v = 0;
+                region.counts[row_cells + cx] += (uint32_t)(end - x) * 2;
+                for (; x < end; x += 2)
+                {
+                    acc_y += y0[x] + y0[x + 1] + y1[x] + y1[x + 1];
+                    acc_u += uv[x];
+                    acc_v += uv[x + 1];
+                }
+                uint32_t *sums = &region.sums[(row_cells + cx) * 3];
+                sums[0] += acc_y;
+                sums[1] += acc_u;
+                sums[2] += acc_v;
+            }
+        }
+
+        // 扫描线端点为偶数、块大小为偶数，每格的色度样本数恰为Y像素数的 1/4
+        uint64_t total[3] = {0, 0, 0};
+        uint64_t total_luma = 0;
+        size_t cells = (size_t)region.cells_w * region.cells_h;
+        for (size_t i = 0; i < cells; i++)
+        {
+            total[0] += region.sums[i * 3];
+            total[1] += region.sums[i * 3 + 1];
+            total[2] += region.sums[i * 3 + 2];
+            total_luma += region.counts[i];
+        }
+        uint64_t total_chroma = std::max<uint64_t>(1, total_luma / 4);
+        total_luma = std::max<uint64_t>(1, total_luma);
+        for (size_t i = 0; i < cells; i++)
+        {
+            uint8_t *cell = &region.cells[i * 3];
+            uint32_t luma = region.counts[i];
+            if (luma == 0)
+            {
+                cell[0] = (uint8_t)((total[0] + total_luma / 2) / total_luma);
+                cell[1] = (uint8_t)((total[1] + total_chroma / 2) / total_chroma);
+                cell[2] = (uint8_t)((total[2] + total_chroma / 2) / total_chroma);
+                continue;
+            }
+            uint32_t chroma = luma / 4;
+            cell[0] = (uint8_t)((region.sums[i * 3] + luma / 2) / luma);
+            cell[1] = (uint8_t)((region.sums[i * 3 + 1] + chroma / 2) / chroma);
+            cell[2] = (uint8_t)((region.sums[i * 3 + 2] + chroma / 2) / chroma);
+        }
+    }
+
+    void PrivacyMasker::fillSolid(const infra::imgproc::NV12Image &frame, const Region &region)
+    {
+        for (const Span &span : region.spans)
+        {
+            int n = span.x1 - span.x0;
+            memset(frame.y + (size_t)span.row * frame.y_stride + span.x0, region.fill_y, n);
+            memset(frame.y + (size_t)(span.row + 1) * frame.y_stride + span.x0, region.fill_y, n);
+            memcpy(frame.uv + (size_t)(span.row / 2) * frame.uv_stride + span.x0, region.fill_uv.data(), n);
+        }
+    }
+
+    // 马赛克：扫描线按块边界分段，每段填该格的平均值
+    void PrivacyMasker::fillCells(const infra::imgproc::NV12Image &frame, const Region &region)
+    {
+        const int block = region.block;
+        for (const Span &span : region.spans)
+        {
+            const uint8_t *cells = &region.cells[(size_t)((span.row - region.y) / block) * region.cells_w * 3];
+            uint8_t *y0 = frame.y + (size_t)span.row * frame.y_stride;
+            uint8_t *y1 = y0 + frame.y_stride;
+            uint8_t *uv = frame.uv + (size_t)(span.row / 2) * frame.uv_stride;
+            for (int x = span.x0; x < span.x1;)
+            {
+                int cx = (x - region.x) / block;
+                int end = std::min(span.x1, region.x + (cx + 1) * block);
+                const uint8_t *cell = cells + cx * 3;
+                memset(y0 + x, cell[0], end - x);
+                memset(y1 + x, cell[0], end - x);
+                for (; x < end; x += 2)
+                {
+                    uv[x] = cell[1];
+                    uv[x + 1] = cell[2];
+                }
+            }
+        }
+    }
+
+    // 模糊：块平均 → 放大成外接矩形大小（双线性），再按扫描线拷回
+    void PrivacyMasker::fillBlurred(const infra::imgproc::NV12Image &frame, Region &region)
+    {
+        averageCells(frame, region);
+        int small_w = std::max(2, region.cells_w) * 2;
+        int small_h = std::max(2, region.cells_h) * 2;
+        infra::imgproc::NV12Image small = infra::imgproc::nv12View(region.small.data(), small_w, small_h, small_w);
+        for (int sy = 0; sy < small_h / 2; sy++)
+        {
+            const uint8_t *cells = &region.cells[(size_t)std::min(sy, region.cells_h - 1) * region.cells_w * 3];
+            uint8_t *y0 = small.y + (size_t)sy * 2 * small.y_stride;
+            uint8_t *y1 = y0 + small.y_stride;
+            uint8_t *uv = small.uv + (size_t)sy * small.uv_stride;
+            for (int sx = 0; sx < small_w / 2; sx++)
+            {
+                const uint8_t *cell = cells + std::min(sx, region.cells_w - 1) * 3;
+                y0[2 * sx] = y0[2 * sx + 1] = y1[2 * sx] = y1[2 * sx + 1] = cell[0];
+                uv[2 * sx] = cell[1];
+                uv[2 * sx + 1] = cell[2];
+            }
+        }
+        infra::imgproc::NV12Image blurred =
+            infra::imgproc::nv12View(region.blurred.data(), region.width, region.height, region.width);
+        region.scaler.scaleNV12(small, blurred);
+
+        for (const Span &span : region.spans)
+        {
+            int n = span.x1 - span.x0;
+            int r = span.row - region.y;
+            int c = span.x0 - region.x;
+            memcpy(frame.y + (size_t)span.row * frame.y_stride + span.x0, blurred.y + (size_t)r * blurred.y_stride + c, n);
+            memcpy(frame.y + (size_t)(span.row + 1) * frame.y_stride + span.x0,
+                   blurred.y + (size_t)(r + 1) * blurred.y_stride + c, n);
+            memcpy(frame.uv + (size_t)(span.row / 2) * frame.uv_stride + span.x0,
+                   blurred.uv + (size_t)(r / 2) * blurred.uv_stride + c, n);
+        }
+    }
+
+    int PrivacyMasker::maskNV12(uint8_t *y, uint8_t *uv, int stride, int width, int height)
+    {
+        bool dirty = dirty_.load(std::memory_order_acquire);
+        if (!dirty && regions_.empty())
+            return 0;
+        if (y == nullptr || uv == nullptr || width < 2 || height < 2 || stride < width)
+        {
+            LOGE("PrivacyMasker::maskNV12 - %s: invalid frame %dx%d stride=%d", name_.c_str(), width, height, stride);
+            return -1;
+        }
+        width &= ~1;
+        height &= ~1;
+
+        uint64_t start = infra::now_us();
+        if (dirty || width != width_ || height != height_)
+        {
+            dirty_.store(false, std::memory_order_relaxed);
+            rebuild(width, height);
+        }
+        if (regions_.empty())
+            return 0;
+
+        infra::imgproc::NV12Image frame;
+        frame.y = y;
+        frame.uv = uv;
+        frame.width = width;
+        frame.height = height;
+        frame.y_stride = frame.uv_stride = stride;
+        for (Region &region : regions_)
+        {
+            switch (region.mode)
+            {
+            case PrivacyMaskMode::kSolid:
+                fillSolid(frame, region);
+                break;
+            case PrivacyMaskMode::kPixelate:
+                if (region.is_rect)
+                {
+                    infra::imgproc::mosaicNV12(frame, region.x, region.y, region.width, region.height, region.block);
+                    break;
+                }
+                averageCells(frame, region);
+                fillCells(frame, region);
+                break;
+            case PrivacyMaskMode::kBlur:
+                fillBlurred(frame, region);
+                break;
+            }
+        }
+
+        uint64_t cost = infra::now_us() - start;
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.frames++;
+        stats_.last_apply_us = cost;
+        stats_.apply_us_max = std::max(stats_.apply_us_max, cost);
+        apply_us_total_ += cost;
+        return 0;
+    }
+
+    PrivacyMaskStats PrivacyMasker::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        PrivacyMaskStats st = stats_;
+        st.apply_us_avg = st.frames > 0 ? (double)apply_us_total_ / st.frames : 0;
+        return st;
+    }
+
+    void PrivacyMasker::printStats() const
+    {
+        PrivacyMaskStats st = getStats();
+        if (st.rebuilds == 0)
+            return; // 从未设置过区域
+        LOGI("[privacy] %s: %d masks, %llu px (%.1f%% of frame), %llu frames, apply avg=%.1fus max=%lluus, rebuilt %llu times",
+             name_.c_str(), st.masks, (unsigned long long)st.masked_pixels,
+             st.frame_pixels ? st.masked_pixels * 100.0 / st.frame_pixels : 0.0, (unsigned long long)st.frames,
+             st.apply_us_avg, (unsigned long long)st.apply_us_max, (unsigned long long)st.rebuilds);
+    }
+
+} // namespace core
@@ -69,11 +69,7 @@ namespace core
         av_dict_set(&opts, "rw_timeout", std::to_string(config_.rw_timeout).c_str(), 0);
         av_dict_set(&opts, "stimeout", std::to_string(config_.rw_timeout).c_str(), 0);
         av_dict_set(&opts, "max_delay", std::to_string(config_.max_delay).c_str(), 0);
-
-        av_dict_set(&opts, "max_bitrate", "10000000", 0); // 最大10Mbps
-        av_dict_set(&opts, "min_bitrate", "1000000", 0);  // 最小1Mbps
-        av_dict_set(&opts, "bufsize", "20000000", 0); // 20Mbps
-        av_dict_set(&opts, "rc_mode", "vbr", 0);
+        // 码率由编码器控制（见 RateController），复用器不接受码率类选项
 
         // 强制使用 TCP 传输（更可靠）
         if (config_.enable_tcp)
@@ -164,7 +160,7 @@ namespace core
     //     return 0;
     // }
 
-    int RTSPEngine::pushVideoFrame(AVPacket *pkt)
+    int RTSPEngine::pushVideoFrame(AVPacket *pkt, AVRational src_time_base)
     {
         if (!initialized_)
         {
@@ -180,7 +176,7 @@ namespace core
 
         pkt->stream_index = video_stream_->index;
         // printf("视频video_stream_->index = %d\n",video_stream_->index);
-        av_packet_rescale_ts(pkt, (AVRational){1, 1000000}, (AVRational){1, 90000});
+        av_packet_rescale_ts(pkt, src_time_base, video_stream_->time_base);
 
         // 写入数据包
         // printf("pkt->pts = %lld\n",pkt->pts);
@@ -200,7 +196,7 @@ namespace core
         return 0;
     }
 
-    int RTSPEngine::pushAudioFrame(AVPacket *pkt)
+    int RTSPEngine::pushAudioFrame(AVPacket *pkt, AVRational src_time_base)
     {
         if (!initialized_)
         {
@@ -211,7 +207,7 @@ namespace core
         // 设置时间戳
         pkt->stream_index = audio_stream_->index;
         // printf("音频audio_stream_->index = %d\n",audio_stream_->index);
-        av_packet_rescale_ts(pkt, audio_time_base_, audio_stream_->time_base);
+        av_packet_rescale_ts(pkt, src_time_base, audio_stream_->time_base);
 
         // 写入数据包
         int ret = av_interleaved_write_frame(ofmt_ctx_, pkt);
@@ -256,6 +252,20 @@ namespace core
             video_stream_->codecpar->profile = FF_PROFILE_HEVC_MAIN;
         }
 
+        // 参数集写入extradata：SDP直接携带，客户端无需等待并解析带内的IDR
+        if (!config_.video_extradata.empty())
+        {
+            size_t size = config_.video_extradata.size();
+            video_stream_->codecpar->extradata = (uint8_t *)av_mallocz(size + AV_INPUT_BUFFER_PADDING_SIZE);
+            if (!video_stream_->codecpar->extradata)
+            {
+                LOGE("Failed to allocate extradata for video");
+                return false;
+            }
+            memcpy(video_stream_->codecpar->extradata, config_.video_extradata.data(), size);
+            video_stream_->codecpar->extradata_size = size;
+        }
+
         return true;
     }
 
@@ -0,0 +1,247 @@
+#include "core/RateController.hpp"
+#include "infra/time/TimeUtils.h"
+#include <algorithm>
+#include <chrono>
+
+extern "C"
+{
+#include "infra/logging/logger.h"
+}
+
+namespace core
+{
+    namespace
+    {
+        template <typename T>
+        void updateMax(std::atomic<T> &max, T value)
+        {
+            T prev = max.load(std::memory_order_relaxed);
+            while (value > prev && !max.compare_exchange_weak(prev, value, std::memory_order_relaxed))
+            {
+            }
+        }
+    }
+
+    RateController::RateController(VideoEncodeChannel &channel, const RateControllerConfig &config)
+        : channel_(channel), config_(config)
+    {
+    }
+
+    RateController::~RateController()
+    {
+        stop();
+    }
+
+    int RateController::start()
+    {
+        if (running_)
+            return 0;
+        driver::VideoEncoderDriver *venc = channel_.driver();
+        int bitrate = venc->bitrateKbps();
+        int fps = venc->frameRate();
+        if (bitrate <= 0 || fps <= 0)
+        {
+            LOGW("RateController - %s: rc mode has no target bitrate, adaptation disabled", channel_.name().c_str());
+            return -1;
+        }
+        min_bitrate_kbps_ = std::max(1, bitrate * config_.min_bitrate_percent / 100);
+        last_dropped_ = channel_.packetRing().droppedCount();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_ = RateControlStats();
+            stats_.bitrate_kbps = stats_.nominal_bitrate_kbps = bitrate;
+            stats_.fps = stats_.nominal_fps = fps;
+            running_ = true;
+        }
+        applyQp(false);
+        thread_ = std::thread(&RateController::controlLoop, this);
+        LOGI("RateController - %s: nominal %dkbps %dfps, floor %dkbps %dfps", channel_.name().c_str(), bitrate, fps,
+             min_bitrate_kbps_, std::min(fps, config_.min_fps));
+        return 0;
+    }
+
+    void RateController::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_)
+                return;
+            running_ = false;
+        }
+        cv_.notify_all();
+        if (thread_.joinable())
+            thread_.join();
+    }
+
+    void RateController::noteWrite(uint64_t write_us)
+    {
+        writes_.fetch_add(1, std::memory_order_relaxed);
+        write_us_total_.fetch_add(write_us, std::memory_order_relaxed);
+        updateMax(write_us_max_, write_us);
+        updateMax(queue_max_, channel_.packetRing().size());
+    }
+
+    void RateController::controlLoop()
+    {
+        uint64_t last_print = infra::now_us();
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (running_)
+        {
+            cv_.wait_for(lock, std::chrono::milliseconds(config_.interval_ms), [this]()
+                         { return !running_; });
+            if (!running_)
+                break;
+            lock.unlock();
+            evaluate();
+            uint64_t now = infra::now_us();
+            if (config_.stats_interval_s > 0 && now - last_print >= (uint64_t)config_.stats_interval_s * 1000000)
+            {
+                last_print = now;
+                printStats();
+            }
+            lock.lock();
+        }
+    }
+
+    void RateController::evaluate()
+    {
+        // 1. 取走本周期的观测值
+        uint64_t writes = writes_.exchange(0, std::memory_order_relaxed);
+        uint64_t write_total = write_us_total_.exchange(0, std::memory_order_relaxed);
+        uint64_t write_max = write_us_max_.exchange(0, std::memory_order_relaxed);
+        infra::SPSCRing<AVPacket> &ring = channel_.packetRing();
+        size_t depth = ring.size();
+        size_t queue_max = std::max(queue_max_.exchange(0, std::memory_order_relaxed), depth);
+        uint64_t dropped_total = ring.droppedCount();
+        uint64_t dropped = dropped_total - last_dropped_;
+        last_dropped_ = dropped_total;
+
+        uint64_t write_avg = writes ? write_total / writes : 0;
+        size_t capacity = ring.capacity();
+        bool stalled = writes == 0 && depth > 0; // 有积压却一个包都没写出去
+        bool congested = stalled || dropped > 0 || write_avg > (uint64_t)config_.congested_write_us ||
+                         queue_max * 100 >= capacity * config_.congested_queue_percent;
+        bool clear = writes > 0 && dropped == 0 && write_avg < (uint64_t)config_.clear_write_us &&
+                     queue_max * 100 <= capacity * config_.clear_queue_percent;
+
+        // 2. 决策：拥塞先降码率、到下限再降帧率；畅通持续 recover_periods 个周期后先恢复帧率、再逐级回升码率
+        driver::VideoEncoderDriver *venc = channel_.driver();
+        int nominal_bitrate, nominal_fps;
+        bool was_degraded;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            nominal_bitrate = stats_.nominal_bitrate_kbps;
+            nominal_fps = stats_.nominal_fps;
+            was_degraded = stats_.degraded;
+        }
+        min_bitrate_kbps_ = std::max(1, nominal_bitrate * config_.min_bitrate_percent / 100);
+        int bitrate = venc->bitrateKbps();
+        int fps = venc->frameRate();
+        bool decreased = false;
+        bool increased = false;
+
+        if (settle_left_ > 0)
+        {
+            settle_left_--;
+            clear_periods_ = 0;
+        }
+        else if (congested)
+        {
+            clear_periods_ = 0;
+            if (bitrate > min_bitrate_kbps_)
+            {
+                int target = std::max(min_bitrate_kbps_, bitrate * (100 - config_.decrease_percent) / 100);
+                decreased = venc->setBitrate(target) == 0;
+            }
+            else if (fps > config_.min_fps)
+            {
+                decreased = venc->setFrameRate(std::max(config_.min_fps, fps / 2)) == 0;
+            }
+            if (decreased)
+                settle_left_ = config_.settle_periods;
+        }
+        else if (clear && ++clear_periods_ >= config_.recover_periods)
+        {
+            clear_periods_ = 0;
+            if (fps < nominal_fps)
+                increased = venc->setFrameRate(std::min(nominal_fps, fps * 2)) == 0;
+            else if (bitrate < nominal_bitrate)
+                increased = venc->setBitrate(std::min(nominal_bitrate, bitrate + nominal_bitrate * config_.increase_percent / 100)) == 0;
+        }
+        else if (!clear)
+        {
+            clear_periods_ = 0;
+        }
+
+        int new_bitrate = venc->bitrateKbps();
+        int new_fps = venc->frameRate();
+        bool degraded = new_bitrate < nominal_bitrate || new_fps < nominal_fps;
+        if (decreased || increased)
+        {
+            LOGI("[abr] %s: %s bitrate %d -> %dkbps, fps %d -> %d (write avg=%.2fms max=%.2fms queue max=%zu/%zu dropped=%llu)",
+                 channel_.name().c_str(), decreased ? "congested," : "recovered,", bitrate, new_bitrate, fps, new_fps,
+                 write_avg / 1000.0, write_max / 1000.0, queue_max, capacity, (unsigned long long)dropped);
+        }
+        if (degraded != was_degraded)
+            applyQp(degraded);
+
+        // 3. 统计
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.bitrate_kbps = new_bitrate;
+        stats_.fps = new_fps;
+        stats_.degraded = degraded;
+        stats_.periods++;
+        stats_.congested_periods += congested ? 1 : 0;
+        stats_.decreases += decreased ? 1 : 0;
+        stats_.increases += increased ? 1 : 0;
+        stats_.write_avg_ms = write_avg / 1000.0;
+        stats_.write_max_ms = write_max / 1000.0;
+        stats_.queue_max = queue_max;
+        stats_.dropped = dropped;
+    }
+
+    // QP范围以通道当前的码率控制配置为准（CAMERA_RC_PROFILE / setRcProfile 的 qp），配置未指定时取 config_ 的默认值；
+    // 降级期间在此基础上抬高下限、放开上限
+    void RateController::applyQp(bool degraded)
+    {
+        driver::RcProfile profile = channel_.driver()->rcProfile();
+        if (profile.mode == driver::RcMode::kFixQp)
+            return;
+        int base_min = profile.min_qp > 0 ? profile.min_qp : config_.min_qp;
+        int base_max = profile.max_qp > 0 ? profile.max_qp : config_.max_qp;
+        int max_qp = degraded ? std::max(base_max, config_.degraded_max_qp) : base_max;
+        int min_qp = degraded ? std::min(base_min + config_.degraded_min_qp_boost, max_qp) : base_min;
+        if (channel_.driver()->setQpRange(min_qp, max_qp) != 0)
+            LOGW("RateController - %s: set qp [%d,%d] failed", channel_.name().c_str(), min_qp, max_qp);
+    }
+
+    void RateController::setNominal(int bitrate_kbps, int fps)
+    {
+        if (bitrate_kbps <= 0 || fps <= 0)
+            return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.nominal_bitrate_kbps = bitrate_kbps;
+        stats_.nominal_fps = fps;
+        LOGI("RateController - %s: nominal -> %dkbps %dfps", channel_.name().c_str(), bitrate_kbps, fps);
+    }
+
+    RateControlStats RateController::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    void RateController::printStats() const
+    {
+        RateControlStats st = getStats();
+        if (st.periods == 0)
+            return;
+        LOGI("[abr] %s: bitrate=%d/%dkbps fps=%d/%d degraded=%d periods=%llu congested=%llu down=%llu up=%llu "
+             "write avg=%.2fms max=%.2fms queue max=%zu dropped=%llu",
+             channel_.name().c_str(), st.bitrate_kbps, st.nominal_bitrate_kbps, st.fps, st.nominal_fps, st.degraded ? 1 : 0,
+             (unsigned long long)st.periods, (unsigned long long)st.congested_periods,
+             (unsigned long long)st.decreases, (unsigned long long)st.increases,
+             st.write_avg_ms, st.write_max_ms, st.queue_max, (unsigned long long)st.dropped);
+    }
+
+} // namespace core
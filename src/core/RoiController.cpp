@@ -0,0 +1,143 @@
+#include "core/RoiController.hpp"
+#include "infra/time/TimeUtils.h"
+#include <algorithm>
+
+extern "C"
+{
+#include "infra/logging/logger.h"
+}
+
+namespace core
+{
+    namespace
+    {
+        bool sameRegion(const driver::RoiRegion &a, const driver::RoiRegion &b)
+        {
+            return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height && a.qp == b.qp &&
+                   a.abs_qp == b.abs_qp && a.intra == b.intra;
+        }
+
+        bool sameRegions(const std::vector<driver::RoiRegion> &a, const std::vector<driver::RoiRegion> &b)
+        {
+            if (a.size() != b.size())
+                return false;
+            for (size_t i = 0; i < a.size(); i++)
+            {
+                if (!sameRegion(a[i], b[i]))
+                    return false;
+            }
+            return true;
+        }
+    }
+
+    RoiController::RoiController(driver::VideoEncoderDriver *venc_driver, int width, int height)
+        : venc_driver_(venc_driver), width_(width), height_(height)
+    {
+    }
+
+    int RoiController::addSource(const std::string &name, int priority, int width, int height)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Source source;
+        source.name = name;
+        source.priority = priority;
+        source.width = width > 0 ? width : width_;
+        source.height = height > 0 ? height : height_;
+        sources_.push_back(source);
+        return (int)sources_.size() - 1;
+    }
+
+    void RoiController::update(int source, const std::vector<driver::RoiRegion> &regions, int hold_ms)
+    {
+        uint64_t expire_us = hold_ms > 0 ? infra::now_us() + (uint64_t)hold_ms * 1000 : 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (source < 0 || source >= (int)sources_.size())
+                return;
+            sources_[source].regions = regions;
+            sources_[source].expire_us = regions.empty() ? 0 : expire_us;
+            stats_.updates++;
+        }
+        dirty_.store(true, std::memory_order_release);
+    }
+
+    void RoiController::clear(int source)
+    {
+        update(source, std::vector<driver::RoiRegion>(), 0);
+    }
+
+    void RoiController::apply(uint64_t now_us)
+    {
+        uint64_t next_expire = next_expire_us_.load(std::memory_order_relaxed);
+        bool expired = next_expire != 0 && now_us >= next_expire;
+        if (!expired && !dirty_.load(std::memory_order_acquire))
+            return;
+        dirty_.store(false, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<driver::RoiRegion> regions;
+        merge(now_us, regions);
+        if (sameRegions(regions, applied_))
+            return;
+        if (venc_driver_->setRoiRegions(regions) != 0)
+        {
+            stats_.failures++;
+            dirty_.store(true, std::memory_order_relaxed); // 下一帧重试
+            return;
+        }
+        applied_ = regions;
+        stats_.applies++;
+        stats_.active = (int)regions.size();
+    }
+
+    // 按优先级从高到低取区域并缩放到编码分辨率；高优先级放在索引大的一端（重叠处优先）
+    void RoiController::merge(uint64_t now_us, std::vector<driver::RoiRegion> &out)
+    {
+        std::vector<const Source *> order;
+        uint64_t next_expire = 0;
+        for (Source &source : sources_)
+        {
+            if (source.expire_us != 0 && now_us >= source.expire_us)
+            {
+                LOGI("RoiController - source %s expired, %zu regions dropped", source.name.c_str(), source.regions.size());
+                source.regions.clear();
+                source.expire_us = 0;
+                stats_.expired++;
+            }
+            if (source.regions.empty())
+                continue;
+            order.push_back(&source);
+            if (source.expire_us != 0 && (next_expire == 0 || source.expire_us < next_expire))
+                next_expire = source.expire_us;
+        }
+        next_expire_us_.store(next_expire, std::memory_order_relaxed);
+        std::stable_sort(order.begin(), order.end(), [](const Source *a, const Source *b)
+                         { return a->priority > b->priority; });
+
+        for (const Source *source : order)
+        {
+            for (const driver::RoiRegion &r : source->regions)
+            {
+                if ((int)out.size() >= driver::kMaxRoiRegions)
+                {
+                    stats_.truncated++;
+                    continue;
+                }
+                driver::RoiRegion scaled = r;
+                scaled.x = (int)((int64_t)r.x * width_ / source->width);
+                scaled.y = (int)((int64_t)r.y * height_ / source->height);
+                scaled.width = (int)((int64_t)r.width * width_ / source->width);
+                scaled.height = (int)((int64_t)r.height * height_ / source->height);
+                out.push_back(scaled);
+            }
+        }
+        std::reverse(out.begin(), out.end());
+    }
+
+    RoiStats RoiController::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+} // namespace core
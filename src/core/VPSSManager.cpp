@@ -1,4 +1,6 @@
 #include "core/VPSSManager.hpp"
+#include "driver/MPIBackend.hpp"
+#include <chrono>
 
 extern "C"
 {
@@ -10,18 +12,66 @@ extern "C"
 
 namespace core
 {
+    namespace
+    {
+        const int kFetchTimeoutMs = 100; // 取帧线程单次等待时长（用于检查退出标志）
+    }
+
+    VPSSFrame &VPSSFrame::operator=(VPSSFrame &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            owner_ = other.owner_;
+            chn_id_ = other.chn_id_;
+            frame_ = other.frame_;
+            other.owner_ = nullptr;
+            other.chn_id_ = -1;
+        }
+        return *this;
+    }
+
+    void VPSSFrame::reset()
+    {
+        if (owner_ != nullptr)
+        {
+            owner_->releaseChnFrame(chn_id_, frame_);
+            owner_ = nullptr;
+            chn_id_ = -1;
+        }
+    }
+
+    void *VPSSFrame::virAddr() const
+    {
+        return owner_ ? driver::MPIBackend::instance().mbHandle2VirAddr(frame_.stVFrame.pMbBlk) : nullptr;
+    }
 
     VPSSManager::VPSSManager(int width, int height)
-        : width_(width), height_(height)
+        : width_(width), height_(height), mpi_(driver::MPIBackend::instance())
     {
         grp_id_ = 0;
         chn_id_ = 0;
+        main_chn_.width = width;
+        main_chn_.height = height;
     }
 
     VPSSManager::~VPSSManager()
     {
+        // 先停扇出线程并归还队列中的帧，再关闭通道
+        std::vector<int> running;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto &item : workers_)
+                running.push_back(item.first);
+        }
+        for (int chn_id : running)
+            stopChannel(chn_id);
+
+        unbindAll();
         disableBackupFrame();
-        disableVPSSChn();
+        for (const VPSSChnConfig &chn : extra_chns_)
+            disableVPSSChn(chn.chn_id);
+        disableVPSSChn(chn_id_);
         stopVPSS();
         destroyGroup();
     }
@@ -36,47 +86,292 @@ namespace core
         ret = startVPSS();
         CHECK_RET(ret, "startVPSS");
 
-        // 3. 配置 VPSS 通道属性
-        ret = setVPSSChnAttr();
+        // 3. 配置 VPSS 主通道属性
+        chn_id_ = main_chn_.chn_id;
+        ret = setVPSSChnAttr(main_chn_);
         CHECK_RET(ret, "setVPSSChnAttr");
 
-        // 4. 启用 VPSS 通道
-        ret = enableVPSSChn();
+        // 4. 启用 VPSS 主通道
+        ret = enableVPSSChn(chn_id_);
         CHECK_RET(ret, "enableVPSSChn");
 
         // 5. 启用备份帧防止丢帧
         enableBackupFrame();
 
-        LOGI("VPSS init success");
+        LOGI("VPSS init success (chn%d %ux%u %s)", chn_id_, main_chn_.width, main_chn_.height,
+             pixelFormatName(main_chn_.pixel_format));
         return 0;
     }
 
-    int VPSSManager::bindViToVpss()
+    int VPSSManager::enableChannel(const VPSSChnConfig &config)
     {
-        // 1. 定义 VI 源通道（假设使用 VI 通道 0，设备 0）
-        MPP_CHN_S vi_chn;
-        vi_chn.enModId = RK_ID_VI; // 模块 ID：视频输入
-        vi_chn.s32DevId = 0;       // VI 设备 ID
-        vi_chn.s32ChnId = 0;       // VI 通道 ID
+        if (isChannelEnabled(config.chn_id))
+        {
+            LOGE("VPSSManager::enableChannel - chn%d already enabled", config.chn_id);
+            return -1;
+        }
 
-        // 2. 定义 VPSS 目的通道（假设使用 VPSS 组 0，通道 0）
-        MPP_CHN_S vpss_chn;
-        vpss_chn.enModId = RK_ID_VPSS; // 模块 ID：视频处理子系统
-        vpss_chn.s32DevId = 0;         // VPSS 组 ID
-        vpss_chn.s32ChnId = 0;         // VPSS 通道 ID
+        int ret = setVPSSChnAttr(config);
+        CHECK_RET(ret, "setVPSSChnAttr");
+        ret = enableVPSSChn(config.chn_id);
+        CHECK_RET(ret, "enableVPSSChn");
 
-        // 3. 执行绑定
-        RK_S32 ret = RK_MPI_SYS_Bind(&vi_chn, &vpss_chn);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            extra_chns_.push_back(config);
+        }
+        LOGI("VPSS chn%d enabled (%ux%u %s)", config.chn_id, config.width, config.height,
+             pixelFormatName(config.pixel_format));
+        return 0;
+    }
+
+    int VPSSManager::disableChannel(int chn_id)
+    {
+        stopChannel(chn_id);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < extra_chns_.size(); i++)
+        {
+            if (extra_chns_[i].chn_id == chn_id)
+            {
+                extra_chns_.erase(extra_chns_.begin() + i);
+                return disableVPSSChn(chn_id);
+            }
+        }
+        return -1;
+    }
+
+    bool VPSSManager::isChannelEnabled(int chn_id) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (chn_id == chn_id_)
+            return true;
+        for (const VPSSChnConfig &chn : extra_chns_)
+        {
+            if (chn.chn_id == chn_id)
+                return true;
+        }
+        return false;
+    }
+
+    int VPSSManager::bind(const MPP_CHN_S &src, const MPP_CHN_S &dst)
+    {
+        RK_S32 ret = mpi_.sysBind(src, dst);
         if (ret != RK_SUCCESS)
         {
-            LOGE("VI bind to VPSS failed! ret=%d", ret);
+            LOGE("SYS bind mod%d[%d:%d] -> mod%d[%d:%d] failed! ret=%x", src.enModId, src.s32DevId, src.s32ChnId,
+                 dst.enModId, dst.s32DevId, dst.s32ChnId, ret);
             return -1;
         }
+        bindings_.push_back(std::make_pair(src, dst));
+        return 0;
+    }
+
+    int VPSSManager::bindViToVpss(int vi_dev, int vi_chn)
+    {
+        MPP_CHN_S vi_chn_s;
+        vi_chn_s.enModId = RK_ID_VI; // 模块 ID：视频输入
+        vi_chn_s.s32DevId = vi_dev;  // VI 设备 ID
+        vi_chn_s.s32ChnId = vi_chn;  // VI 通道 ID
 
-        LOGI("VI bind to VPSS success");
+        // VPSS 组输入（通道号固定为0）
+        MPP_CHN_S vpss_grp;
+        vpss_grp.enModId = RK_ID_VPSS; // 模块 ID：视频处理子系统
+        vpss_grp.s32DevId = grp_id_;   // VPSS 组 ID
+        vpss_grp.s32ChnId = 0;
+
+        int ret = bind(vi_chn_s, vpss_grp);
+        CHECK_RET(ret, "bind(VI -> VPSS)");
+        LOGI("VI[%d:%d] bind to VPSS grp%d success", vi_dev, vi_chn, grp_id_);
+        return 0;
+    }
+
+    int VPSSManager::bindToVenc(int chn_id, int venc_chn)
+    {
+        MPP_CHN_S vpss_chn;
+        vpss_chn.enModId = RK_ID_VPSS;
+        vpss_chn.s32DevId = grp_id_;
+        vpss_chn.s32ChnId = chn_id;
+
+        MPP_CHN_S venc_chn_s;
+        venc_chn_s.enModId = RK_ID_VENC;
+        venc_chn_s.s32DevId = 0;
+        venc_chn_s.s32ChnId = venc_chn;
+
+        int ret = bind(vpss_chn, venc_chn_s);
+        CHECK_RET(ret, "bind(VPSS -> VENC)");
+        LOGI("VPSS chn%d bind to VENC chn%d success", chn_id, venc_chn);
         return 0;
     }
 
+    // 按绑定的逆序解绑（先断下游）
+    void VPSSManager::unbindAll()
+    {
+        while (!bindings_.empty())
+        {
+            const std::pair<MPP_CHN_S, MPP_CHN_S> &b = bindings_.back();
+            RK_S32 ret = mpi_.sysUnBind(b.first, b.second);
+            if (ret != RK_SUCCESS)
+                LOGW("SYS unbind mod%d -> mod%d failed! ret=%x", b.first.enModId, b.second.enModId, ret);
+            bindings_.pop_back();
+        }
+    }
+
+    int VPSSManager::sendFrame(const VIDEO_FRAME_INFO_S &frame, int timeout)
+    {
+        return mpi_.vpssSendFrame(grp_id_, frame, timeout);
+    }
+
+    int VPSSManager::getFrame(VIDEO_FRAME_INFO_S &frame, int timeout)
+    {
+        return mpi_.vpssGetChnFrame(grp_id_, chn_id_, frame, timeout);
+    }
+
+    int VPSSManager::releaseFrame(const VIDEO_FRAME_INFO_S &frame)
+    {
+        return mpi_.vpssReleaseChnFrame(grp_id_, chn_id_, frame);
+    }
+
+    int VPSSManager::getChnFrame(int chn_id, VIDEO_FRAME_INFO_S &frame, int timeout)
+    {
+        return mpi_.vpssGetChnFrame(grp_id_, chn_id, frame, timeout);
+    }
+
+    int VPSSManager::releaseChnFrame(int chn_id, const VIDEO_FRAME_INFO_S &frame)
+    {
+        return mpi_.vpssReleaseChnFrame(grp_id_, chn_id, frame);
+    }
+
+    int VPSSManager::startChannel(int chn_id, size_t queue_depth)
+    {
+        if (chn_id == chn_id_ || !isChannelEnabled(chn_id))
+        {
+            LOGE("VPSSManager::startChannel - chn%d is not an enabled extra channel", chn_id);
+            return -1;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (workers_.count(chn_id))
+            return 0;
+
+        std::shared_ptr<ChannelWorker> worker = std::make_shared<ChannelWorker>();
+        worker->chn_id = chn_id;
+        worker->queue.reset(new infra::SPSCRing<VPSSFrame>(queue_depth, infra::DropPolicy::DropOldest));
+        worker->queue->open();
+        worker->running = true;
+        worker->fetch_thread = std::thread(&VPSSManager::fetchLoop, this, worker.get());
+        workers_[chn_id] = worker;
+        LOGI("VPSS chn%d fan-out started (queue depth %zu)", chn_id, queue_depth);
+        return 0;
+    }
+
+    void VPSSManager::stopChannel(int chn_id)
+    {
+        std::shared_ptr<ChannelWorker> worker;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = workers_.find(chn_id);
+            if (it == workers_.end())
+                return;
+            worker = it->second;
+            workers_.erase(it);
+        }
+
+        worker->running = false;
+        worker->queue->close(); // 唤醒等待中的消费者
+        if (worker->fetch_thread.joinable())
+            worker->fetch_thread.join();
+        if (worker->consumer_thread.joinable())
+            worker->consumer_thread.join();
+        worker->queue->clear(); // 队列中剩余的帧归还VPSS
+
+        VPSSChnStats stats = {worker->fetched.load(), worker->queue->droppedCount(), worker->consumed.load()};
+        LOGI("VPSS chn%d fan-out stopped: fetched=%llu dropped=%llu consumed=%llu", chn_id,
+             (unsigned long long)stats.fetched, (unsigned long long)stats.dropped,
+             (unsigned long long)stats.consumed);
+    }
+
+    int VPSSManager::popChannelFrame(int chn_id, VPSSFrame &frame, int timeout_ms)
+    {
+        std::shared_ptr<ChannelWorker> worker = findWorker(chn_id);
+        if (!worker)
+            return -2;
+        int ret = worker->queue->pop(frame, timeout_ms);
+        if (ret == 0)
+            worker->consumed++;
+        return ret;
+    }
+
+    int VPSSManager::setChannelConsumer(int chn_id, VPSSFrameConsumer consumer)
+    {
+        std::shared_ptr<ChannelWorker> worker = findWorker(chn_id);
+        if (!worker || worker->consumer_thread.joinable())
+        {
+            LOGE("VPSSManager::setChannelConsumer - chn%d not started or already consumed", chn_id);
+            return -1;
+        }
+        worker->consumer = std::move(consumer);
+        worker->consumer_thread = std::thread(&VPSSManager::consumeLoop, this, worker.get());
+        return 0;
+    }
+
+    VPSSChnStats VPSSManager::getChannelStats(int chn_id) const
+    {
+        VPSSChnStats stats;
+        std::shared_ptr<ChannelWorker> worker = findWorker(chn_id);
+        if (worker)
+        {
+            stats.fetched = worker->fetched.load(std::memory_order_relaxed);
+            stats.dropped = worker->queue->droppedCount();
+            stats.consumed = worker->consumed.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+    std::shared_ptr<VPSSManager::ChannelWorker> VPSSManager::findWorker(int chn_id) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = workers_.find(chn_id);
+        return it == workers_.end() ? nullptr : it->second;
+    }
+
+    // 取帧线程：VPSS通道 → 帧队列（队列满丢最旧帧，被丢弃的帧立即归还VPSS）
+    void VPSSManager::fetchLoop(ChannelWorker *worker)
+    {
+        while (worker->running)
+        {
+            VIDEO_FRAME_INFO_S info;
+            int ret = mpi_.vpssGetChnFrame(grp_id_, worker->chn_id, info, kFetchTimeoutMs);
+            if (ret != RK_SUCCESS)
+            {
+                // 超时继续等；其他错误（通道被关闭等）稍作退避避免空转
+                if (ret != (RK_S32)RK_ERR_VPSS_BUF_EMPTY)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                continue;
+            }
+            worker->fetched++;
+            VPSSFrame frame(this, worker->chn_id, info);
+            worker->queue->push(frame);
+        }
+    }
+
+    // 消费线程：帧队列 → 消费回调
+    void VPSSManager::consumeLoop(ChannelWorker *worker)
+    {
+        VPSSFrame frame;
+        while (worker->running)
+        {
+            int ret = worker->queue->pop(frame, kFetchTimeoutMs);
+            if (ret == -2)
+                break;
+            if (ret != 0)
+                continue;
+            worker->consumed++;
+            worker->consumer(frame);
+            frame.reset();
+        }
+    }
+
     int VPSSManager::createGroup()
     {
         VPSS_GRP_ATTR_S grpAttr = {
@@ -86,7 +381,7 @@ namespace core
             .enDynamicRange = DYNAMIC_RANGE_SDR10,
             .enCompressMode = COMPRESS_MODE_NONE};
 
-        int ret = RK_MPI_VPSS_CreateGrp(grp_id_, &grpAttr);
+        int ret = mpi_.vpssCreateGrp(grp_id_, grpAttr);
         if (ret != RK_SUCCESS)
         {
             printf("[VPSS] Create group failed: 0x%X\n", ret);
@@ -97,7 +392,7 @@ namespace core
 
     int VPSSManager::startVPSS()
     {
-        int ret = RK_MPI_VPSS_StartGrp(grp_id_);
+        int ret = mpi_.vpssStartGrp(grp_id_);
         if (ret != RK_SUCCESS)
         {
             printf("[VPSS] Start group failed: 0x%X\n", ret);
@@ -107,24 +402,24 @@ namespace core
     }
 
     // 配置 VPSS 通道属性
-    int VPSSManager::setVPSSChnAttr()
+    int VPSSManager::setVPSSChnAttr(const VPSSChnConfig &config)
     {
         VPSS_CHN_ATTR_S chnAttr = {
             .enChnMode = VPSS_CHN_MODE_USER,
-            .u32Width = width_,
-            .u32Height = height_,
+            .u32Width = config.width,
+            .u32Height = config.height,
             .enVideoFormat = VIDEO_FORMAT_LINEAR,  // 线性视频格式
-            .enPixelFormat = RK_FMT_RGB888,        // 输出格式为 BGR888
+            .enPixelFormat = config.pixel_format,  // 输出格式（协商结果，编码主通道默认NV12）
             .enDynamicRange = DYNAMIC_RANGE_SDR10, // SDR 10位动态范围
             .enCompressMode = COMPRESS_MODE_NONE,  // 无压缩
             .stFrameRate = {
                 // 帧率控制
-                .s32SrcFrameRate = -1, // 源帧率 (不限制)
-                .s32DstFrameRate = -1  // 目标帧率 (不限制)
+                .s32SrcFrameRate = config.src_fps, // 源帧率 (-1 不限制)
+                .s32DstFrameRate = config.dst_fps  // 目标帧率 (-1 不限制)
             },
             .bMirror = RK_FALSE, // 镜像: 禁用
             .bFlip = RK_FALSE,   // 翻转: 禁用
-            .u32Depth = 1,       // 缓冲区深度
+            .u32Depth = config.depth, // 缓冲区深度
             .stAspectRatio = {
                 // 宽高比
                 .enMode = ASPECT_RATIO_NONE, // 不改变宽高比
@@ -133,7 +428,7 @@ namespace core
             .u32FrameBufCnt = 0 // 使用默认帧缓冲区数量
         };
 
-        int ret = RK_MPI_VPSS_SetChnAttr(grp_id_, chn_id_, &chnAttr);
+        int ret = mpi_.vpssSetChnAttr(grp_id_, config.chn_id, chnAttr);
         if (ret != RK_SUCCESS)
         {
             printf("[VPSS] Set channel attr failed: 0x%X\n", ret);
@@ -143,9 +438,9 @@ namespace core
     }
 
     // 启用 VPSS 通道
-    int VPSSManager::enableVPSSChn()
+    int VPSSManager::enableVPSSChn(int chn_id)
     {
-        int ret = RK_MPI_VPSS_EnableChn(grp_id_, chn_id_);
+        int ret = mpi_.vpssEnableChn(grp_id_, chn_id);
         if (ret != RK_SUCCESS)
         {
             printf("[VPSS] Enable channel failed: 0x%X\n", ret);
@@ -157,7 +452,7 @@ namespace core
     // 启用备份帧防止丢帧
     int VPSSManager::enableBackupFrame()
     {
-        int ret = RK_MPI_VPSS_EnableBackupFrame(grp_id_);
+        int ret = mpi_.vpssEnableBackupFrame(grp_id_);
         if (ret != RK_SUCCESS)
         {
             printf("[VPSS] Enable backup frame failed: 0x%X\n", ret);
@@ -168,7 +463,7 @@ namespace core
 
     int VPSSManager::disableBackupFrame()
     {
-        int ret = RK_MPI_VPSS_DisableBackupFrame(grp_id_);
+        int ret = mpi_.vpssDisableBackupFrame(grp_id_);
         if (ret != RK_SUCCESS)
         {
             printf("[VPSS] Disable backup frame failed: 0x%X\n", ret);
@@ -177,9 +472,9 @@ namespace core
         return 0;
     }
 
-    int VPSSManager::disableVPSSChn()
+    int VPSSManager::disableVPSSChn(int chn_id)
     {
-        int ret = RK_MPI_VPSS_DisableChn(grp_id_, chn_id_);
+        int ret = mpi_.vpssDisableChn(grp_id_, chn_id);
         if (ret != RK_SUCCESS)
         {
             printf("[VPSS] Disable channel failed: 0x%X\n", ret);
@@ -189,7 +484,7 @@ namespace core
     }
     int VPSSManager::stopVPSS()
     {
-        int ret = RK_MPI_VPSS_StopGrp(grp_id_);
+        int ret = mpi_.vpssStopGrp(grp_id_);
         if (ret != RK_SUCCESS)
         {
             printf("[VPSS] Stop group failed: 0x%X\n", ret);
@@ -199,7 +494,7 @@ namespace core
     }
     int VPSSManager::destroyGroup()
     {
-        int ret = RK_MPI_VPSS_DestroyGrp(grp_id_);
+        int ret = mpi_.vpssDestroyGrp(grp_id_);
         if (ret != RK_SUCCESS)
         {
             printf("[VPSS] Destroy group failed: 0x%X\n", ret);
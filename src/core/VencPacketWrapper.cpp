@@ -0,0 +1,172 @@
+#include "core/VencPacketWrapper.hpp"
+#include "driver/MPIBackend.hpp"
+#include <cstring>
+#include <mutex>
+#include <unordered_set>
+
+extern "C"
+{
+#include "infra/logging/logger.h"
+}
+
+namespace core
+{
+    namespace
+    {
+        // 本类创建、尚未释放的 AVBufferRef 的 opaque：AVBuffer 的释放回调不在公开接口中，
+        // 只能按 opaque 的地址识别，其他来源的 opaque 不能解引用
+        std::mutex holders_mutex;
+        std::unordered_set<const void *> live_holders;
+    }
+
+    VencPacketWrapper::VencPacketWrapper(VencReleaseHook release_hook)
+        : state_(std::make_shared<SharedState>())
+    {
+        state_->release_hook = std::move(release_hook);
+    }
+
+    void VencPacketWrapper::setReleaseHook(VencReleaseHook release_hook)
+    {
+        state_->release_hook = std::move(release_hook);
+    }
+
+    int VencPacketWrapper::wrap(const VENC_STREAM_S &stream, AVPacket *pkt)
+    {
+        if (stream.pstPack == nullptr || stream.u32PackCount == 0)
+        {
+            LOGE("VencPacketWrapper::wrap - empty stream");
+            return -1;
+        }
+
+        // 各包的数据段，同一MB块只换算一次虚拟地址
+        std::vector<struct iovec> segments(stream.u32PackCount);
+        MB_BLK last_blk = nullptr;
+        uint8_t *base = nullptr;
+        size_t total = 0;
+        bool contiguous = true;
+        for (uint32_t i = 0; i < stream.u32PackCount; i++)
+        {
+            const VENC_PACK_S &pack = stream.pstPack[i];
+            if (i == 0 || pack.pMbBlk != last_blk)
+            {
+                last_blk = pack.pMbBlk;
+                base = (uint8_t *)driver::MPIBackend::instance().mbHandle2VirAddr(pack.pMbBlk);
+                if (base == nullptr)
+                {
+                    LOGE("VencPacketWrapper::wrap - Handle2VirAddr failed");
+                    return -1;
+                }
+            }
+            // Rockit 的 u32Len 是包的数据长度（不是块内结束位置），数据从 u32Offset 开始
+            segments[i].iov_base = base + pack.u32Offset;
+            segments[i].iov_len = pack.u32Len;
+            if (i > 0 && (uint8_t *)segments[i].iov_base !=
+                             (uint8_t *)segments[i - 1].iov_base + segments[i - 1].iov_len)
+                contiguous = false;
+            total += segments[i].iov_len;
+        }
+
+        // 拷贝码流描述（不拷贝码流数据），归还时需要原始的 pstPack 内容
+        StreamHolder *holder = new StreamHolder;
+        holder->state = state_;
+        holder->stream = stream;
+        holder->packs = new VENC_PACK_S[stream.u32PackCount];
+        memcpy(holder->packs, stream.pstPack, sizeof(VENC_PACK_S) * stream.u32PackCount);
+        holder->stream.pstPack = holder->packs;
+        holder->segments.swap(segments);
+
+        uint8_t *data = (uint8_t *)holder->segments[0].iov_base;
+        if (!contiguous)
+        {
+            // 复用器需要连续的访问单元：合并到新缓冲后码流即可归还
+            holder->gathered = (uint8_t *)av_malloc(total + AV_INPUT_BUFFER_PADDING_SIZE);
+            if (holder->gathered == nullptr)
+            {
+                LOGE("VencPacketWrapper::wrap - av_malloc failed");
+                delete[] holder->packs;
+                delete holder;
+                return -1;
+            }
+            size_t offset = 0;
+            for (struct iovec &seg : holder->segments)
+            {
+                memcpy(holder->gathered + offset, seg.iov_base, seg.iov_len);
+                seg.iov_base = holder->gathered + offset;
+                offset += seg.iov_len;
+            }
+            memset(holder->gathered + total, 0, AV_INPUT_BUFFER_PADDING_SIZE);
+            data = holder->gathered;
+        }
+
+        pkt->buf = av_buffer_create(data, total, releaseBuffer, holder, AV_BUFFER_FLAG_READONLY);
+        if (pkt->buf == nullptr)
+        {
+            LOGE("VencPacketWrapper::wrap - av_buffer_create failed");
+            av_free(holder->gathered);
+            delete[] holder->packs;
+            delete holder;
+            return -1;
+        }
+        {
+            std::lock_guard<std::mutex> lock(holders_mutex);
+            live_holders.insert(holder);
+        }
+
+        pkt->data = data;
+        pkt->size = total;
+        pkt->pts = stream.pstPack[0].u64PTS;
+        pkt->dts = pkt->pts;
+        if (holder->gathered != nullptr)
+        {
+            state_->gathered++;
+            if (state_->release_hook)
+                state_->release_hook(holder->stream);
+        }
+        else
+        {
+            state_->outstanding++;
+        }
+        return 0;
+    }
+
+    int VencPacketWrapper::segments(const AVPacket *pkt, const struct iovec **iov)
+    {
+        if (pkt == nullptr || pkt->buf == nullptr)
+            return -1;
+        // 其余来源的 AVBufferRef（av_new_packet、其他模块的 av_buffer_create 等）不在登记表中
+        void *opaque = av_buffer_get_opaque(pkt->buf);
+        {
+            std::lock_guard<std::mutex> lock(holders_mutex);
+            if (opaque == nullptr || live_holders.count(opaque) == 0)
+                return -1;
+        }
+        // pkt 持有引用，holder 在返回后仍有效
+        StreamHolder *holder = (StreamHolder *)opaque;
+        *iov = holder->segments.data();
+        return (int)holder->segments.size();
+    }
+
+    // 最后一个引用释放时调用（可能在复用器线程）：把码流归还给VENC
+    void VencPacketWrapper::releaseBuffer(void *opaque, uint8_t *data)
+    {
+        (void)data;
+        StreamHolder *holder = (StreamHolder *)opaque;
+        {
+            std::lock_guard<std::mutex> lock(holders_mutex);
+            live_holders.erase(holder);
+        }
+        if (holder->gathered != nullptr)
+        {
+            av_free(holder->gathered); // 码流在合并时已归还
+        }
+        else
+        {
+            if (holder->state->release_hook)
+                holder->state->release_hook(holder->stream);
+            holder->state->outstanding--;
+        }
+        delete[] holder->packs;
+        delete holder;
+    }
+
+} // namespace core
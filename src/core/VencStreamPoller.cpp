@@ -0,0 +1,231 @@
+#include "core/VencStreamPoller.hpp"
+#include "infra/time/TimeUtils.h"
+#include <algorithm>
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+extern "C"
+{
+#include "infra/logging/logger.h"
+}
+
+namespace core
+{
+    namespace
+    {
+        const int kPollTimeoutMs = 500;          // poll 超时，兜底检查退出标志与出错fd的恢复时刻
+        const uint64_t kErrorBackoffUs = 1000000; // fd 出错后暂停轮询的时长
+    }
+
+    VencStreamPoller::VencStreamPoller()
+    {
+        wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wake_fd_ < 0)
+            LOGE("VencStreamPoller - eventfd failed");
+    }
+
+    VencStreamPoller::~VencStreamPoller()
+    {
+        stop();
+        if (wake_fd_ >= 0)
+            close(wake_fd_);
+    }
+
+    int VencStreamPoller::addChannel(VideoEncodeChannel *channel)
+    {
+        int fd = channel->driver()->getFd();
+        if (fd < 0)
+            return -1;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            Entry entry;
+            entry.channel = channel;
+            entry.fd = fd;
+            entries_.push_back(entry);
+        }
+        wake();
+        LOGI("VencStreamPoller - add %s (fd=%d)", channel->name().c_str(), fd);
+        return 0;
+    }
+
+    void VencStreamPoller::removeChannel(VideoEncodeChannel *channel)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            auto find = [this, channel]()
+            {
+                return std::find_if(entries_.begin(), entries_.end(), [channel](const Entry &e)
+                                    { return e.channel == channel; });
+            };
+            auto it = find();
+            if (it == entries_.end())
+                return;
+            // 轮询线程不持锁取流：等该通道的在途取流结束后再移出
+            drain_done_.wait(lock, [&]()
+                             { it = find(); return it == entries_.end() || !it->draining; });
+            if (it == entries_.end())
+                return;
+            entries_.erase(it);
+        }
+        channel->driver()->closeFd();
+        wake();
+    }
+
+    size_t VencStreamPoller::channelCount() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+    int VencStreamPoller::start()
+    {
+        if (running_ || wake_fd_ < 0)
+            return -1;
+        running_ = true;
+        thread_ = std::thread(&VencStreamPoller::pollLoop, this);
+        return 0;
+    }
+
+    void VencStreamPoller::stop()
+    {
+        if (!running_)
+            return;
+        running_ = false;
+        wake();
+        if (thread_.joinable())
+            thread_.join();
+    }
+
+    void VencStreamPoller::wake()
+    {
+        uint64_t one = 1;
+        if (wake_fd_ >= 0 && write(wake_fd_, &one, sizeof(one)) < 0)
+            LOGW("VencStreamPoller - wake failed");
+    }
+
+    void VencStreamPoller::pollLoop()
+    {
+        std::vector<struct pollfd> fds;
+        uint64_t last_print = infra::now_us();
+        while (running_)
+        {
+            // 每轮按当前通道表重建fd数组，通道增删通过 wake_fd_ 打断 poll
+            fds.clear();
+            struct pollfd wake_pfd = {wake_fd_, POLLIN, 0};
+            fds.push_back(wake_pfd);
+            uint64_t now = infra::now_us();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (const Entry &entry : entries_)
+                {
+                    if (entry.retry_at_us > now)
+                        continue; // 出错暂停中
+                    struct pollfd pfd = {entry.fd, POLLIN, 0};
+                    fds.push_back(pfd);
+                }
+            }
+
+            int ret = poll(fds.data(), fds.size(), kPollTimeoutMs);
+            if (ret < 0)
+            {
+                if (errno != EINTR)
+                {
+                    LOGE("VencStreamPoller - poll failed, errno=%d", errno);
+                    break;
+                }
+                continue;
+            }
+
+            if (fds[0].revents & POLLIN)
+            {
+                uint64_t count;
+                if (read(wake_fd_, &count, sizeof(count)) < 0)
+                    count = 0; // 计数已为0
+            }
+
+            for (size_t i = 1; i < fds.size(); i++)
+            {
+                short revents = fds[i].revents;
+                if (revents == 0)
+                    continue;
+                // 通道可能已在 poll 期间被移出：持锁查找并标记在途，取流时不持锁
+                VideoEncodeChannel *channel = nullptr;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    for (Entry &entry : entries_)
+                    {
+                        if (entry.fd != fds[i].fd)
+                            continue;
+                        if (revents & (POLLERR | POLLHUP | POLLNVAL))
+                        {
+                            // fd 不再可用：poll 会一直立即返回，暂停轮询该fd，仍取一次已就绪的码流
+                            entry.errors++;
+                            entry.retry_at_us = infra::now_us() + kErrorBackoffUs;
+                            LOGW("VencStreamPoller - %s fd=%d revents=0x%x, pause polling", entry.channel->name().c_str(),
+                                 entry.fd, revents);
+                        }
+                        entry.draining = true;
+                        channel = entry.channel;
+                        break;
+                    }
+                }
+                if (channel == nullptr)
+                    continue;
+
+                int packets = channel->drainReady();
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    for (Entry &entry : entries_)
+                    {
+                        if (entry.channel != channel)
+                            continue;
+                        entry.draining = false;
+                        entry.wakeups++;
+                        entry.packets += packets;
+                        entry.spurious += packets == 0 ? 1 : 0;
+                        break;
+                    }
+                }
+                drain_done_.notify_all();
+            }
+
+            now = infra::now_us();
+            if (stats_interval_s_ > 0 && now - last_print >= (uint64_t)stats_interval_s_ * 1000000)
+            {
+                last_print = now;
+                printStats();
+            }
+        }
+    }
+
+    std::vector<VencPollStats> VencStreamPoller::getStats() const
+    {
+        std::vector<VencPollStats> stats;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const Entry &entry : entries_)
+        {
+            VencPollStats st;
+            st.name = entry.channel->name();
+            st.wakeups = entry.wakeups;
+            st.packets = entry.packets;
+            st.spurious = entry.spurious;
+            st.errors = entry.errors;
+            stats.push_back(st);
+        }
+        return stats;
+    }
+
+    void VencStreamPoller::printStats() const
+    {
+        for (const VencPollStats &st : getStats())
+        {
+            LOGI("[poller] %s: wakeups=%llu packets=%llu spurious=%llu errors=%llu packets/wakeup=%.2f", st.name.c_str(),
+                 (unsigned long long)st.wakeups, (unsigned long long)st.packets, (unsigned long long)st.spurious,
+                 (unsigned long long)st.errors, st.wakeups ? (double)st.packets / st.wakeups : 0);
+        }
+    }
+
+} // namespace core
@@ -0,0 +1,417 @@
+#include "core/VideoEncodeChannel.hpp"
+#include "driver/MPIBackend.hpp"
+#include "infra/time/MediaClock.h"
+#include "infra/time/TimeUtils.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+extern "C"
+{
+#include "infra/logging/logger.h"
+}
+
+namespace core
+{
+    namespace
+    {
+        const uint64_t kBitrateWindowUs = 1000000; // 码率统计窗口（微秒）
+        const uint32_t kInitialPackCount = 4;      // pstPack 初始包数（参数集 + SEI + slice）
+        const uint64_t kDropLogIntervalUs = 1000000; // 队列满丢帧告警的最小间隔（微秒）
+
+        // 按编码格式判断码流是否为IDR（任一包为IDR slice即为关键帧，参数集包在其之前）
+        bool isKeyStream(RK_CODEC_ID_E type, const VENC_STREAM_S &stream)
+        {
+            if (type != RK_VIDEO_ID_AVC && type != RK_VIDEO_ID_HEVC)
+                return true; // MJPEG 每帧独立
+            for (uint32_t i = 0; i < stream.u32PackCount; i++)
+            {
+                const VENC_PACK_S &pack = stream.pstPack[i];
+                if (type == RK_VIDEO_ID_AVC && pack.DataType.enH264EType == H264E_NALU_IDRSLICE)
+                    return true;
+                if (type == RK_VIDEO_ID_HEVC && pack.DataType.enH265EType == H265E_NALU_IDRSLICE)
+                    return true;
+            }
+            return false;
+        }
+
+        // 按第一个slice的NAL头判断是否为非参考帧（丢弃后不影响其他帧解码）
+        //  - H.264: nal_ref_idc == 0
+        //  - H.265: 类型号 < 16 且为偶数（TRAIL_N/TSA_N/STSA_N/RADL_N/RASL_N 等子层非参考帧）
+        bool isDisposableStream(RK_CODEC_ID_E type, const AVPacket *pkt)
+        {
+            if (type != RK_VIDEO_ID_AVC && type != RK_VIDEO_ID_HEVC)
+                return false;
+            const struct iovec *iov = nullptr;
+            int count = VencPacketWrapper::segments(pkt, &iov);
+            for (int i = 0; i < count; i++)
+            {
+                const uint8_t *data = (const uint8_t *)iov[i].iov_base;
+                size_t len = iov[i].iov_len;
+                size_t pos = 0;
+                while (pos < len && data[pos] == 0)
+                    pos++;
+                if (pos < 2 || pos + 1 >= len || data[pos] != 1)
+                    continue;
+                uint8_t header = data[pos + 1];
+                if (type == RK_VIDEO_ID_HEVC)
+                {
+                    int nal_type = (header >> 1) & 0x3f;
+                    if (nal_type >= 32)
+                        continue; // 参数集/SEI
+                    return nal_type < 16 && (nal_type & 1) == 0;
+                }
+                int nal_type = header & 0x1f;
+                if (nal_type < 1 || nal_type > 5)
+                    continue;
+                return ((header >> 5) & 0x3) == 0;
+            }
+            return false;
+        }
+    }
+
+    VideoEncodeChannel::VideoEncodeChannel(const std::string &name, driver::VideoEncoderDriver *venc_driver,
+                                           size_t queue_depth)
+        : name_(name), venc_driver_(venc_driver),
+          packet_wrapper_([chn = venc_driver->chnId()](VENC_STREAM_S &stream)
+                          { driver::MPIBackend::instance().vencReleaseStream(chn, stream); }),
+          packet_ring_(queue_depth, infra::DropPolicy::DropToKeyframe),
+          param_sets_(venc_driver->config().en_type),
+          roi_(venc_driver, venc_driver->config().width, venc_driver->config().height)
+    {
+        memset(&venc_stream_, 0, sizeof(VENC_STREAM_S));
+        reservePacks(kInitialPackCount);
+
+        staging_pkt_ = av_packet_alloc();
+        inject_pkt_ = av_packet_alloc();
+        packet_ring_.setTimeBase(infra::MediaClock::timeBase());
+
+        // 默认丢弃策略：水位达到3/4时先丢非参考帧；丢弃参考帧后立即请求IDR，不等GOP自然结束
+        infra::DropConfig drop_config;
+        drop_config.disposable_watermark = queue_depth * 3 / 4;
+        drop_config.key_request = [this]()
+        { requestIDR(); };
+        packet_ring_.setDropConfig(drop_config);
+    }
+
+    VideoEncodeChannel::~VideoEncodeChannel()
+    {
+        releasePendingStream();
+
+        // 队列中的包仍引用VENC码流，需在编码通道销毁前归还
+        packet_ring_.close();
+        packet_ring_.clear();
+        av_packet_free(&staging_pkt_);
+        av_packet_free(&inject_pkt_);
+
+        free(venc_stream_.pstPack);
+        venc_stream_.pstPack = nullptr;
+    }
+
+    int VideoEncodeChannel::start()
+    {
+        if (venc_stream_.pstPack == nullptr || staging_pkt_ == nullptr || inject_pkt_ == nullptr)
+        {
+            LOGE("VideoEncodeChannel[%s]::start - buffer alloc failed", name_.c_str());
+            return -1;
+        }
+        packet_ring_.open();
+        window_start_us_ = last_print_us_ = infra::TEST_COMM_GetNowUs();
+        return venc_driver_->start();
+    }
+
+    void VideoEncodeChannel::stop()
+    {
+        packet_ring_.close(); // 唤醒等待中的推流线程
+        venc_driver_->stop();
+    }
+
+    int VideoEncodeChannel::encode(const VIDEO_FRAME_INFO_S &frame)
+    {
+        if (sendFrame(frame) != 0 || fetchStream(-1) != 0)
+            return -1;
+        int ret = pushStream();
+        releasePendingStream();
+        return ret;
+    }
+
+    int VideoEncodeChannel::sendFrame(const VIDEO_FRAME_INFO_S &frame)
+    {
+        uint64_t send_us = infra::TEST_COMM_GetNowUs();
+        roi_.apply(send_us); // 分析模块提交的区域在这一帧生效
+        if (frame_observer_)
+            frame_observer_(&frame);
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            SendStamp &stamp = send_stamps_[send_seq_++ % kSendStampSlots];
+            stamp.pts = (int64_t)frame.stVFrame.u64PTS;
+            stamp.send_us = send_us;
+        }
+        if (venc_driver_->sendFrame(frame) != 0)
+        {
+            printf("[%s] Failed to send frame to encoder\n", name_.c_str());
+            return -1;
+        }
+        return 0;
+    }
+
+    void VideoEncodeChannel::enableGopCache(size_t byte_budget)
+    {
+        if (byte_budget == 0)
+            gop_cache_.reset();
+        else
+            gop_cache_.reset(new GopCache(byte_budget));
+    }
+
+    int VideoEncodeChannel::reservePacks(uint32_t count)
+    {
+        if (count <= pack_capacity_)
+            return 0;
+        VENC_PACK_S *packs = (VENC_PACK_S *)realloc(venc_stream_.pstPack, sizeof(VENC_PACK_S) * count);
+        if (packs == nullptr)
+        {
+            LOGE("VideoEncodeChannel[%s] - alloc %u packs failed", name_.c_str(), count);
+            return -1;
+        }
+        memset(packs + pack_capacity_, 0, sizeof(VENC_PACK_S) * (count - pack_capacity_));
+        venc_stream_.pstPack = packs;
+        pack_capacity_ = count;
+        return 0;
+    }
+
+    int VideoEncodeChannel::fetchStream(int timeout_ms)
+    {
+        releasePendingStream();
+
+        // 按VENC报告的下一帧包数准备 pstPack，一帧的参数集/SEI/slice 各包都要取到
+        VENC_CHN_STATUS_S status;
+        if (venc_driver_->queryStatus(status) == RK_SUCCESS && reservePacks(status.u32CurPacks) != 0)
+            return -1;
+        venc_stream_.u32PackCount = pack_capacity_;
+        int ret = venc_driver_->getStream(venc_stream_, timeout_ms);
+        if (ret == (RK_S32)RK_ERR_VENC_ILLEGAL_PARAM)
+        {
+            // 阻塞等待期间到达的帧包数超过预分配：重新查询后立即再取
+            if (venc_driver_->queryStatus(status) != RK_SUCCESS || reservePacks(status.u32CurPacks) != 0)
+                return -1;
+            venc_stream_.u32PackCount = pack_capacity_;
+            ret = venc_driver_->getStream(venc_stream_, 0);
+        }
+        if (ret == (RK_S32)RK_ERR_VENC_BUF_EMPTY)
+            return -1; // 等待超时
+        if (ret != RK_SUCCESS)
+        {
+            printf("[%s] get VENC stream failed! ret=%d\n", name_.c_str(), ret);
+            return -1;
+        }
+        stream_pending_ = true;
+        return 0;
+    }
+
+    /**
+     * 将暂存的VENC码流零拷贝封装为AVPacket并放入队列
+     * @return 0成功，非0失败（码流由 releasePendingStream() 归还）
+     */
+    int VideoEncodeChannel::pushStream()
+    {
+        if (!stream_pending_)
+            return -1;
+        if (raw_capture_pts_ && frame_observer_)
+            frame_observer_(nullptr); // 绑定模式没有送帧调用，在取流线程中观察
+
+        uint32_t packs = venc_stream_.u32PackCount;
+        bool key = isKeyStream(venc_driver_->config().en_type, venc_stream_);
+        uint64_t send_us = takeSendStamp((int64_t)venc_stream_.pstPack[0].u64PTS);
+        uint64_t latency_us = send_us ? infra::TEST_COMM_GetNowUs() - send_us : 0;
+
+        // 零拷贝：pkt 直接引用VENC码流，最后一个引用释放时归还给VENC
+        AVPacket *pkt = staging_pkt_;
+        if (packet_wrapper_.wrap(venc_stream_, pkt) != 0)
+            return -1;
+        stream_pending_ = false;
+        uint32_t bytes = pkt->size;
+        bool disposable = false;
+
+        infra::MediaClock &clock = infra::MediaClock::instance();
+        if (raw_capture_pts_)
+            pkt->pts = pkt->dts = clock.toMediaTime(pkt->pts);
+        int64_t capture_latency_us = clock.toMediaTime(infra::MediaClock::nowUs()) - pkt->pts;
+
+        // 按当前生效的输出帧率（空闲降帧、码率调整后会变化），取不到时退回配置帧率
+        int fps = venc_driver_->frameRate();
+        if (fps <= 0)
+            fps = venc_driver_->config().fps > 0 ? venc_driver_->config().fps : 30;
+        pkt->duration = 1000000 / fps;
+        if (key)
+        {
+            pkt->flags |= AV_PKT_FLAG_KEY;
+            // 关键帧缺参数集时补上（换成拷贝的包，原码流随即归还），客户端从任一关键帧都能起播
+            if (!param_sets_.inspect(pkt) && param_sets_.prepend(pkt, inject_pkt_) == 0)
+            {
+                av_packet_unref(pkt);
+                av_packet_move_ref(pkt, inject_pkt_);
+                bytes = pkt->size;
+                std::lock_guard<std::mutex> lock(stats_mutex_);
+                stats_.injected++;
+            }
+        }
+        else if (isDisposableStream(venc_driver_->config().en_type, pkt))
+        {
+            pkt->flags |= AV_PKT_FLAG_DISPOSABLE;
+            disposable = true;
+        }
+
+        // GOP缓存保存一份拷贝，pkt 仍零拷贝引用VENC码流（分段信息随包进入队列）
+        if (gop_cache_)
+            gop_cache_->append(pkt);
+
+        if (packet_callback_)
+        {
+            packet_callback_(pkt);
+            av_packet_unref(pkt);
+            updateStats(bytes, packs, key, disposable, latency_us, capture_latency_us > 0 ? capture_latency_us : 0);
+            return 0;
+        }
+
+        // 移入队列（队列满时丢弃到下一个关键帧，被丢弃的包释放即把码流归还给VENC）
+        uint64_t dropped = packet_ring_.droppedCount();
+        int ret = packet_ring_.push(*pkt);
+        if (packet_ring_.droppedCount() != dropped)
+        {
+            // 持续拥塞时每包都会丢帧：限频告警，汇总上次告警以来的丢帧数
+            uint64_t now = infra::TEST_COMM_GetNowUs();
+            if (now - last_drop_log_us_ >= kDropLogIntervalUs)
+            {
+                uint64_t total = packet_ring_.droppedCount();
+                LOGW("[%s] packet queue full, dropped %llu frames, remain {%zu/%zu}", name_.c_str(),
+                     (unsigned long long)(total - drop_logged_), packet_ring_.size(), packet_ring_.capacity());
+                last_drop_log_us_ = now;
+                drop_logged_ = total;
+            }
+        }
+
+        updateStats(bytes, packs, key, disposable, latency_us, capture_latency_us > 0 ? capture_latency_us : 0);
+        return ret == infra::SPSCRing<AVPacket>::kPushOk ? 0 : -1;
+    }
+
+    int VideoEncodeChannel::drainReady()
+    {
+        // 绑定模式下没有送帧调用，在取流时下发区域（对下一帧生效）
+        roi_.apply(infra::TEST_COMM_GetNowUs());
+        int count = 0;
+        while (fetchStream(0) == 0)
+        {
+            pushStream();
+            releasePendingStream();
+            count++;
+        }
+        return count;
+    }
+
+    uint64_t VideoEncodeChannel::takeSendStamp(int64_t pts)
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        for (SendStamp &stamp : send_stamps_)
+        {
+            if (stamp.pts == pts)
+            {
+                stamp.pts = -1;
+                return stamp.send_us;
+            }
+        }
+        return 0;
+    }
+
+    void VideoEncodeChannel::releasePendingStream()
+    {
+        if (stream_pending_)
+        {
+            venc_driver_->releaseStream(venc_stream_);
+            stream_pending_ = false;
+        }
+    }
+
+    void VideoEncodeChannel::updateStats(uint32_t bytes, uint32_t packs, bool key, bool disposable, uint64_t latency_us, uint64_t capture_latency_us)
+    {
+        uint64_t now = infra::TEST_COMM_GetNowUs();
+        bool print = false;
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            stats_.frames++;
+            stats_.key_frames += key ? 1 : 0;
+            stats_.disposable_frames += disposable ? 1 : 0;
+            stats_.bytes += bytes;
+            stats_.packs += packs;
+            stats_.latency_us_total += latency_us;
+            if (latency_us > stats_.latency_us_max)
+                stats_.latency_us_max = latency_us;
+            stats_.capture_latency_us_total += capture_latency_us;
+            if (capture_latency_us > stats_.capture_latency_us_max)
+                stats_.capture_latency_us_max = capture_latency_us;
+
+            window_bytes_ += bytes;
+            if (now - window_start_us_ >= kBitrateWindowUs)
+            {
+                stats_.bitrate_kbps = window_bytes_ * 8 * 1000.0 / (now - window_start_us_);
+                window_bytes_ = 0;
+                window_start_us_ = now;
+            }
+
+            if (stats_interval_s_ > 0 && now - last_print_us_ >= (uint64_t)stats_interval_s_ * 1000000)
+            {
+                last_print_us_ = now;
+                print = true;
+            }
+        }
+        if (print)
+            printStats();
+    }
+
+    EncodeChannelStats VideoEncodeChannel::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        EncodeChannelStats stats = stats_;
+        stats.dropped = packet_ring_.droppedCount();
+        stats.gathered = packet_wrapper_.gatheredCount();
+        for (int i = 0; i < (int)infra::DropReason::kCount; i++)
+            stats.dropped_by[i] = packet_ring_.droppedCount((infra::DropReason)i);
+        stats.key_requests = packet_ring_.keyRequestCount();
+        return stats;
+    }
+
+    void VideoEncodeChannel::printStats() const
+    {
+        EncodeChannelStats st = getStats();
+        if (st.frames == 0)
+            return;
+        LOGI("[venc] %s: frames=%llu key=%llu dropped=%llu packs/frame=%.2f gathered=%llu injected=%llu "
+             "latency avg=%.2fms max=%.2fms capture->stream avg=%.2fms max=%.2fms bitrate=%.1fkbps",
+             name_.c_str(), (unsigned long long)st.frames, (unsigned long long)st.key_frames,
+             (unsigned long long)st.dropped, (double)st.packs / st.frames, (unsigned long long)st.gathered,
+             (unsigned long long)st.injected,
+             st.latency_us_total / 1000.0 / st.frames,
+             st.latency_us_max / 1000.0, st.capture_latency_us_total / 1000.0 / st.frames,
+             st.capture_latency_us_max / 1000.0, st.bitrate_kbps);
+        if (st.dropped > 0 || st.disposable_frames > 0)
+        {
+            LOGI("[drop] %s: gop_tail=%llu superseded=%llu await_key=%llu disposable=%llu(of %llu) oldest=%llu "
+                 "closed=%llu idr_requests=%llu",
+                 name_.c_str(), (unsigned long long)st.dropped_by[(int)infra::DropReason::GopTail],
+                 (unsigned long long)st.dropped_by[(int)infra::DropReason::Superseded],
+                 (unsigned long long)st.dropped_by[(int)infra::DropReason::AwaitKey],
+                 (unsigned long long)st.dropped_by[(int)infra::DropReason::Disposable],
+                 (unsigned long long)st.disposable_frames,
+                 (unsigned long long)st.dropped_by[(int)infra::DropReason::Oldest],
+                 (unsigned long long)st.dropped_by[(int)infra::DropReason::Closed],
+                 (unsigned long long)st.key_requests);
+        }
+        if (gop_cache_)
+        {
+            GopCacheStats gop = gop_cache_->getStats();
+            LOGI("[gop] %s: cached=%zu packets/%zu bytes (budget %zu) gops=%llu overflows=%llu", name_.c_str(),
+                 gop.packets, gop.bytes, gop_cache_->byteBudget(), (unsigned long long)gop.gops,
+                 (unsigned long long)gop.overflows);
+        }
+    }
+
+} // namespace core
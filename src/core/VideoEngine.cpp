@@ -2,6 +2,10 @@
 #include "core/VPSSManager.hpp"
 #include "core/VideoStreamProcessor.hpp"
 #include "driver/VideoInputDriver.hpp"
+#include "infra/time/MediaClock.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
 #include <thread>
 
 extern "C"
@@ -11,6 +15,89 @@ extern "C"
 
 namespace core
 {
+    namespace
+    {
+        const long kMaxEnvFps = 120; // 帧率类变量的上限
+
+        // 解析整数型环境变量：整串须为 [min_value, max_value] 内的十进制整数，否则告警并保留原值
+        bool parseEnvInt(const char *name, const char *text, long min_value, long max_value, int &out)
+        {
+            char *end = nullptr;
+            errno = 0;
+            long v = strtol(text, &end, 10);
+            if (end == text || *end != '\0' || errno == ERANGE || v < min_value || v > max_value)
+            {
+                LOGW("loadVedioEngineConfigFromEnv - %s=%s is not an integer in [%ld, %ld]", name, text, min_value, max_value);
+                return false;
+            }
+            out = (int)v;
+            return true;
+        }
+    }
+
+    int loadVedioEngineConfigFromEnv(VedioEngineConfig &config)
+    {
+        int ret = 0;
+        const char *mode = getenv("CAMERA_PIPELINE");
+        if (mode != nullptr)
+        {
+            if (strcmp(mode, "bound") == 0)
+                config.pipeline_mode = VideoPipelineMode::kBound;
+            else if (strcmp(mode, "manual") == 0)
+                config.pipeline_mode = VideoPipelineMode::kManual;
+            else if (strcmp(mode, "pipelined") == 0)
+                config.pipeline_mode = VideoPipelineMode::kPipelined;
+            else
+            {
+                LOGW("loadVedioEngineConfigFromEnv - unknown CAMERA_PIPELINE %s, keep default", mode);
+                ret = -1;
+            }
+        }
+        const char *fps = getenv("CAMERA_FPS");
+        if (fps != nullptr && !parseEnvInt("CAMERA_FPS", fps, 0, kMaxEnvFps, config.output_fps))
+            ret = -1;
+        // 码率控制配置，格式见 driver::parseRcProfile，例 "mode=cbr,bitrate=4096,qp=22-46"
+        const char *rc = getenv("CAMERA_RC_PROFILE");
+        if (rc != nullptr && driver::parseRcProfile(rc, config.encode_config.rc) != 0)
+        {
+            LOGW("loadVedioEngineConfigFromEnv - CAMERA_RC_PROFILE has bad items: %s", rc);
+            ret = -1;
+        }
+        const char *sub_rc = getenv("CAMERA_SUB_RC_PROFILE");
+        for (VideoSubStreamConfig &sub : config.sub_streams)
+        {
+            if (sub_rc != nullptr && driver::parseRcProfile(sub_rc, sub.encode_config.rc) != 0)
+            {
+                LOGW("loadVedioEngineConfigFromEnv - CAMERA_SUB_RC_PROFILE has bad items: %s", sub_rc);
+                ret = -1;
+            }
+        }
+        // 空闲配置，例 "fps=5,bitrate=384,after=30"；值为空或 "1" 时使用默认参数
+        const char *idle = getenv("CAMERA_IDLE");
+        if (idle != nullptr)
+        {
+            config.activity_governor = strcmp(idle, "0") != 0;
+            if (config.activity_governor && strcmp(idle, "1") != 0 &&
+                parseActivityGovernorConfig(idle, config.idle_config) != 0)
+            {
+                LOGW("loadVedioEngineConfigFromEnv - CAMERA_IDLE has bad items: %s", idle);
+                ret = -1;
+            }
+        }
+        // 隐私遮挡区域，例 "rect=1500:0:420:300,mode=pixelate;poly=0:600:300:500:300:1080:0:1080,mode=blur"
+        const char *privacy = getenv("CAMERA_PRIVACY_MASK");
+        if (privacy != nullptr && parsePrivacyMasks(privacy, config.privacy_masks) != 0)
+        {
+            LOGW("loadVedioEngineConfigFromEnv - CAMERA_PRIVACY_MASK has bad items: %s", privacy);
+            ret = -1;
+        }
+        // 运动检测帧率，如 10
+        const char *motion = getenv("CAMERA_MOTION");
+        if (motion != nullptr && !parseEnvInt("CAMERA_MOTION", motion, 0, kMaxEnvFps, config.motion_fps))
+            ret = -1;
+        return ret;
+    }
+
     VideoEngine::VideoEngine()
     {
         mpi_manager_ = new driver::MPIManager();
@@ -53,9 +140,61 @@ namespace core
                 .width = 1920,
                 .height = 1080,
                 .en_type = RK_VIDEO_ID_HEVC,
+                .stream_buf_cnt = core::kVideoStreamBufCnt,
             },
         };
 
+        // 子码流：640x360 NV12，独立VENC通道，低码率供移动端观看
+        {
+            VideoSubStreamConfig sub;
+            sub.name = "sub";
+            sub.vpss_chn.chn_id = 2;
+            sub.vpss_chn.width = 640;
+            sub.vpss_chn.height = 360;
+            sub.vpss_chn.pixel_format = RK_FMT_YUV420SP;
+            sub.encode_config.chn_id = 1;
+            sub.encode_config.width = 640;
+            sub.encode_config.height = 360;
+            sub.encode_config.en_type = RK_VIDEO_ID_HEVC;
+            sub.encode_config.stream_buf_cnt = core::kVideoStreamBufCnt;
+            sub.encode_config.rc.bitrate_kbps = 512;
+            sub.encode_config.rc.max_bitrate_kbps = 1024;
+            sub.encode_config.rc.min_bitrate_kbps = 128;
+            vedio_config.sub_streams.push_back(sub);
+        }
+
+        // 环境变量覆盖默认配置（有无效项时只告警，其余项照常生效）
+        loadVedioEngineConfigFromEnv(vedio_config);
+        // 遮挡需要在用户态改写帧，绑定模式下主码流帧不经过用户态，不能为省一次拷贝而漏遮
+        if (!vedio_config.privacy_masks.empty() && vedio_config.pipeline_mode == VideoPipelineMode::kBound)
+        {
+            LOGW("VideoEngine::init() - privacy masks need user-space frames, use pipelined mode instead of bound");
+            vedio_config.pipeline_mode = VideoPipelineMode::kPipelined;
+        }
+
+        // 协商各级像素格式：VI(NV12) → VPSS编码通道 → VENC，默认全程NV12不做色彩转换
+        format_request_ = vedio_config.format_request;
+        format_request_.width = vedio_config.encode_config.width;
+        format_request_.height = vedio_config.encode_config.height;
+        ret = negotiateVideoFormats(format_request_, format_plan_);
+        CHECK_RET(ret, "negotiateVideoFormats");
+        vedio_config.encode_config.pixel_format = format_plan_.venc_format;
+
+        // 输出帧率：用户态模式由节拍器按采集时间戳抽帧；绑定模式帧不经过用户态，交给VPSS主通道帧率控制
+        int sensor_fps = format_request_.fps;
+        int output_fps = vedio_config.output_fps > 0 && vedio_config.output_fps < sensor_fps ? vedio_config.output_fps : 0;
+        if (vedio_config.output_fps > sensor_fps)
+            LOGW("VideoEngine::init() - output fps %d above sensor fps %d, use sensor rate", vedio_config.output_fps, sensor_fps);
+        vedio_config.encode_config.fps = output_fps > 0 ? output_fps : sensor_fps;
+        if (output_fps > 0 && vedio_config.pipeline_mode == VideoPipelineMode::kBound)
+        {
+            format_plan_.encode_chn.src_fps = sensor_fps;
+            format_plan_.encode_chn.dst_fps = output_fps;
+        }
+        if (vedio_config.pipeline_mode == VideoPipelineMode::kPipelined)
+            format_plan_.encode_chn.depth = vedio_config.pipeline_depth; // 采集 → 处理 的交接队列
+        vpss_manager_->setMainChannel(format_plan_.encode_chn);
+
         // 初始化VI
         ret = vi_driver_->init(vedio_config.input_config);
         CHECK_RET(ret, "vi_driver_->init()");
@@ -68,10 +207,52 @@ namespace core
         ret = venc_driver_->init(vedio_config.encode_config);
         CHECK_RET(ret, "venc_driver_->init()");
 
+        if (format_plan_.cv_enabled)
+        {
+            ret = vpss_manager_->enableChannel(format_plan_.cv_chn);
+            CHECK_RET(ret, "vpss_manager_->enableChannel(cv)");
+            ret = vpss_manager_->startChannel(format_plan_.cv_chn.chn_id);
+            CHECK_RET(ret, "vpss_manager_->startChannel(cv)");
+        }
+
+        // 初始化子码流编码通道
+        ret = initSubStreams(vedio_config.sub_streams);
+        CHECK_RET(ret, "initSubStreams()");
+
         // 初始化视频流处理器
         video_stream_processor_ = new core::VideoStreamProcessor(vi_driver_, venc_driver_, vpss_manager_);
         ret = video_stream_processor_->init();
         CHECK_RET(ret, "video_stream_processor_->init()");
+        video_stream_processor_->framePacer().setTargetFps(output_fps);
+        video_stream_processor_->encodeChannel().enableGopCache(vedio_config.gop_cache_bytes);
+
+        // 绑定模式：建立 VI→VPSS→VENC 硬件通路，失败时退回用户态流水线
+        pipeline_mode_ = vedio_config.pipeline_mode;
+        pipeline_depth_ = vedio_config.pipeline_depth;
+        motion_fps_ = vedio_config.motion_fps;
+        if (pipeline_mode_ == VideoPipelineMode::kBound && bindPipeline(vedio_config) != 0)
+        {
+            LOGW("VideoEngine::init() - bind pipeline failed, fallback to pipelined mode");
+            pipeline_mode_ = VideoPipelineMode::kPipelined;
+            if (format_plan_.encode_chn.dst_fps > 0)
+                video_stream_processor_->framePacer().setTargetFps(0); // VPSS已按目标帧率抽帧
+        }
+
+        // 主码流按画面活动切换活动/空闲配置：送帧前判定，对这一帧生效
+        if (vedio_config.activity_governor)
+        {
+            VideoEncodeChannel &channel = video_stream_processor_->encodeChannel();
+            governor_.reset(new ActivityGovernor(channel, vedio_config.idle_config));
+            ActivityGovernor *governor = governor_.get();
+            channel.setFrameObserver([governor](const VIDEO_FRAME_INFO_S *frame)
+                                     { governor->observe(frame); });
+        }
+
+        if (!vedio_config.privacy_masks.empty())
+        {
+            ret = setPrivacyMasks(vedio_config.privacy_masks);
+            CHECK_RET(ret, "setPrivacyMasks");
+        }
 
         LOGI("VideoEngine::init() - success!");
         is_inited_ = true;
@@ -89,7 +270,29 @@ namespace core
         int ret = video_stream_processor_->start();
         CHECK_RET(ret, "video_stream_processor_->start");
 
+        // 流水线模式：主码流不再单独起取码流线程，与子码流一起由轮询线程按fd就绪取流
+        bool main_polled = pipeline_mode_ == VideoPipelineMode::kPipelined &&
+                           stream_poller_.addChannel(&video_stream_processor_->encodeChannel()) == 0;
+
+        ret = startSubStreams();
+        CHECK_RET(ret, "startSubStreams");
+
+        if (motion_fps_ > 0 && enableMotionDetection(MotionDetectorConfig(), motion_fps_) != 0)
+            LOGW("VideoEngine::start() - motion detection disabled");
+
+        if (stream_poller_.channelCount() > 0)
+        {
+            ret = stream_poller_.start();
+            CHECK_RET(ret, "stream_poller_.start");
+        }
+
         is_running_ = true;
+        if (pipeline_mode_ == VideoPipelineMode::kPipelined)
+        {
+            ret = video_stream_processor_->startPipeline(pipeline_depth_, !main_polled);
+            CHECK_RET(ret, "video_stream_processor_->startPipeline");
+            return 0;
+        }
         video_thread_ = std::thread(&VideoEngine::videoThread, this);
         return 0;
     }
@@ -105,17 +308,51 @@ namespace core
         {
             video_thread_.join();
         }
+        if (video_stream_processor_)
+        {
+            video_stream_processor_->stopPipeline();
+        }
+
+        // 轮询线程先于编码通道停止，之后不再有线程从VENC取流
+        stream_poller_.printStats();
+        stream_poller_.stop();
+        if (video_stream_processor_)
+            stream_poller_.removeChannel(&video_stream_processor_->encodeChannel());
+        for (SubStream &sub : sub_streams_)
+            stream_poller_.removeChannel(sub.channel);
+
+        // 3. 先解除硬件绑定，再停各模块
+        if (vpss_manager_)
+        {
+            vpss_manager_->unbindAll();
+        }
 
         if (video_stream_processor_)
         {
+            video_stream_processor_->encodeChannel().printStats();
+            video_stream_processor_->framePacer().printStats();
+            video_stream_processor_->privacyMasker().printStats();
             video_stream_processor_->stop();
         }
+        if (governor_)
+        {
+            governor_->printStats();
+            video_stream_processor_->encodeChannel().setFrameObserver(nullptr);
+            governor_.reset();
+        }
+        disableMotionDetection();
+        stopSubStreams();
 
         if (video_stream_processor_)
         {
             delete video_stream_processor_;
             video_stream_processor_ = nullptr;
         }
+        if (vpss_manager_)
+        {
+            delete vpss_manager_; // 先停扇出线程并归还帧，再销毁VPSS组
+            vpss_manager_ = nullptr;
+        }
         if (venc_driver_)
         {
             delete venc_driver_;
@@ -139,14 +376,335 @@ namespace core
         is_inited_ = false;
     }
 
+    int VideoEngine::bindPipeline(const VedioEngineConfig &config)
+    {
+        int ret = vpss_manager_->bindViToVpss(config.input_config.dev_id, config.input_config.chn_id);
+        if (ret == 0)
+            ret = vpss_manager_->bindToVenc(format_plan_.encode_chn.chn_id, config.encode_config.chn_id);
+        if (ret != 0)
+        {
+            vpss_manager_->unbindAll();
+            return -1;
+        }
+
+        // 帧不经过用户态，码流pts为VI原始采集时刻，取流后再换算为媒体时间
+        video_stream_processor_->encodeChannel().setCaptureTimestamps(true);
+        pipeline_mode_ = VideoPipelineMode::kBound;
+        LOGI("VideoEngine - pipeline mode: bound (VI -> VPSS chn%d -> VENC chn%d)",
+             format_plan_.encode_chn.chn_id, config.encode_config.chn_id);
+        return 0;
+    }
+
+    int VideoEngine::initSubStreams(const std::vector<VideoSubStreamConfig> &configs)
+    {
+        for (const VideoSubStreamConfig &config : configs)
+        {
+            SubStream sub;
+            sub.config = config;
+            sub.config.encode_config.pixel_format = config.vpss_chn.pixel_format;
+            sub.venc_driver = new driver::VideoEncoderDriver();
+            int ret = sub.venc_driver->init(sub.config.encode_config);
+            if (ret != 0)
+            {
+                LOGE("initSubStreams - VENC chn%d for %s failed", config.encode_config.chn_id, config.name.c_str());
+                delete sub.venc_driver;
+                return -1;
+            }
+            sub.channel = new VideoEncodeChannel(config.name, sub.venc_driver);
+            sub.channel->enableGopCache(config.gop_cache_bytes);
+            sub.privacy = new PrivacyMasker(config.name);
+            sub_streams_.push_back(sub);
+        }
+        return 0;
+    }
+
+    int VideoEngine::startSubStreams()
+    {
+        for (SubStream &sub : sub_streams_)
+        {
+            int ret = sub.channel->start();
+            CHECK_RET(ret, "sub channel start");
+
+            // 子码流在自己的VPSS通道消费线程中送帧，与主码流编码线程互不阻塞；
+            // 能取到VENC fd时码流由轮询线程取，消费线程送帧后即可处理下一帧，否则阻塞等码流
+            // 隐私区域与主码流相同（按子码流分辨率缩放），送帧前原地遮挡
+            VideoEncodeChannel *channel = sub.channel;
+            PrivacyMasker *privacy = sub.privacy;
+            bool polled = stream_poller_.addChannel(channel) == 0;
+            ret = attachChannelConsumer(sub.config.vpss_chn, [channel, privacy, polled](VPSSFrame &frame)
+                                        {
+                                            VIDEO_FRAME_INFO_S info = frame.info();
+                                            uint8_t *y = (uint8_t *)frame.virAddr();
+                                            if (privacy->active() && y != nullptr && info.stVFrame.enPixelFormat == RK_FMT_YUV420SP)
+                                            {
+                                                const VIDEO_FRAME_S &vf = info.stVFrame;
+                                                int stride = vf.u32VirWidth > 0 ? (int)vf.u32VirWidth : (int)vf.u32Width;
+                                                int vir_height = vf.u32VirHeight > 0 ? (int)vf.u32VirHeight : (int)vf.u32Height;
+                                                privacy->maskNV12(y, y + (size_t)stride * vir_height, stride, vf.u32Width, vf.u32Height);
+                                            }
+                                            info.stVFrame.u64PTS = infra::MediaClock::instance().toMediaTime(info.stVFrame.u64PTS);
+                                            if (polled)
+                                                channel->sendFrame(info);
+                                            else
+                                                channel->encode(info); });
+            CHECK_RET(ret, "attachChannelConsumer(sub)");
+            LOGI("sub stream %s started: VPSS chn%d -> VENC chn%d (%dx%d, %dkbps)", sub.config.name.c_str(),
+                 sub.config.vpss_chn.chn_id, sub.config.encode_config.chn_id, sub.config.encode_config.width,
+                 sub.config.encode_config.height, sub.channel->driver()->bitrateKbps());
+        }
+        return 0;
+    }
+
+    // 先停VPSS消费线程（不再送帧），再停编码；通道对象析构时归还队列中的码流，需先于VENC通道销毁
+    void VideoEngine::stopSubStreams()
+    {
+        for (SubStream &sub : sub_streams_)
+        {
+            if (vpss_manager_)
+                detachChannel(sub.config.vpss_chn.chn_id);
+            sub.channel->printStats();
+            sub.privacy->printStats();
+            sub.channel->stop();
+            delete sub.channel;
+            delete sub.privacy;
+            delete sub.venc_driver;
+        }
+        sub_streams_.clear();
+    }
+
+    VideoEncodeChannel *VideoEngine::channelAt(int index)
+    {
+        if (index < 0)
+            return video_stream_processor_ ? &video_stream_processor_->encodeChannel() : nullptr;
+        if (index >= (int)sub_streams_.size())
+            return nullptr;
+        return sub_streams_[index].channel;
+    }
+
+    int VideoEngine::requestIDR(int index)
+    {
+        VideoEncodeChannel *channel = channelAt(index);
+        if (channel == nullptr)
+        {
+            LOGE("requestIDR - invalid stream index %d", index);
+            return -1;
+        }
+        return channel->requestIDR();
+    }
+
+    int VideoEngine::setRcProfile(int index, const driver::RcProfile &profile)
+    {
+        VideoEncodeChannel *channel = channelAt(index);
+        if (channel == nullptr)
+        {
+            LOGE("setRcProfile - invalid stream index %d", index);
+            return -1;
+        }
+        // 主码流开启了活动/空闲切换时替换的是活动配置，空闲中在切回时生效
+        if (index < 0 && governor_)
+            return governor_->setActiveProfile(profile);
+        return channel->driver()->setRcProfile(profile);
+    }
+
+    int VideoEngine::setPrivacyMasks(const std::vector<PrivacyMask> &masks, int ref_width, int ref_height)
+    {
+        if (!video_stream_processor_)
+        {
+            LOGE("setPrivacyMasks - not inited!");
+            return -1;
+        }
+        if (ref_width <= 0 || ref_height <= 0)
+        {
+            ref_width = format_request_.width;
+            ref_height = format_request_.height;
+        }
+        // 绑定模式下主码流帧不经过用户态，无法遮挡：拒绝设置，避免调用方误以为已生效
+        if (!masks.empty() && pipeline_mode_ == VideoPipelineMode::kBound)
+        {
+            LOGE("setPrivacyMasks - bound mode, main stream frames bypass user space and cannot be masked");
+            return -1;
+        }
+        int ret = video_stream_processor_->privacyMasker().setMasks(masks, ref_width, ref_height);
+        CHECK_RET(ret, "main privacy setMasks");
+        for (SubStream &sub : sub_streams_)
+        {
+            ret = sub.privacy->setMasks(masks, ref_width, ref_height);
+            CHECK_RET(ret, "sub privacy setMasks");
+        }
+        return 0;
+    }
+
+    PrivacyMaskStats VideoEngine::privacyStats(int index)
+    {
+        if (index < 0)
+            return video_stream_processor_ ? video_stream_processor_->privacyMasker().getStats() : PrivacyMaskStats();
+        if (index >= (int)sub_streams_.size())
+            return PrivacyMaskStats();
+        return sub_streams_[index].privacy->getStats();
+    }
+
+    RoiController *VideoEngine::roiController(int index)
+    {
+        VideoEncodeChannel *channel = channelAt(index);
+        if (channel == nullptr)
+        {
+            LOGE("roiController - invalid stream index %d", index);
+            return nullptr;
+        }
+        return &channel->roi();
+    }
+
+    int VideoEngine::joinStream(int index, std::vector<AVPacket *> &gop)
+    {
+        VideoEncodeChannel *channel = channelAt(index);
+        if (channel == nullptr)
+        {
+            LOGE("joinStream - invalid stream index %d", index);
+            return -1;
+        }
+        int count = channel->gopCache() ? channel->gopCache()->snapshot(gop) : 0;
+        if (count == 0)
+            channel->requestIDR(); // 没有可回放的GOP：让编码器尽快出关键帧
+        return count;
+    }
+
+    int VideoEngine::enableCvOutput(const VideoFormatRequest *request)
+    {
+        if (!is_inited_)
+        {
+            LOGE("enableCvOutput - not inited!");
+            return -1;
+        }
+        if (format_plan_.cv_enabled)
+            return 0;
+
+        VideoFormatRequest cv_request = request ? *request : format_request_;
+        cv_request.width = format_request_.width;
+        cv_request.height = format_request_.height;
+        cv_request.encode_format = format_plan_.venc_format; // 编码路径不随CV分支改变
+        cv_request.cv_consumer = true;
+
+        VideoFormatPlan plan;
+        int ret = negotiateVideoFormats(cv_request, plan);
+        CHECK_RET(ret, "negotiateVideoFormats(cv)");
+        ret = vpss_manager_->enableChannel(plan.cv_chn);
+        CHECK_RET(ret, "vpss_manager_->enableChannel(cv)");
+        ret = vpss_manager_->startChannel(plan.cv_chn.chn_id);
+        CHECK_RET(ret, "vpss_manager_->startChannel(cv)");
+
+        format_plan_.cv_enabled = true;
+        format_plan_.cv_chn = plan.cv_chn;
+        return 0;
+    }
+
+    void VideoEngine::disableCvOutput()
+    {
+        if (!format_plan_.cv_enabled)
+            return;
+        vpss_manager_->disableChannel(format_plan_.cv_chn.chn_id);
+        format_plan_.cv_enabled = false;
+    }
+
+    int VideoEngine::acquireCvFrame(VPSSFrame &frame, int timeout_ms)
+    {
+        if (!format_plan_.cv_enabled)
+            return -2;
+        return vpss_manager_->popChannelFrame(format_plan_.cv_chn.chn_id, frame, timeout_ms);
+    }
+
+    int VideoEngine::attachChannelConsumer(const VPSSChnConfig &config, VPSSFrameConsumer consumer, size_t queue_depth)
+    {
+        if (!is_inited_)
+        {
+            LOGE("attachChannelConsumer - not inited!");
+            return -1;
+        }
+
+        int ret = vpss_manager_->enableChannel(config);
+        CHECK_RET(ret, "vpss_manager_->enableChannel");
+        ret = vpss_manager_->startChannel(config.chn_id, queue_depth);
+        if (ret == 0)
+            ret = vpss_manager_->setChannelConsumer(config.chn_id, std::move(consumer));
+        if (ret != 0)
+        {
+            vpss_manager_->disableChannel(config.chn_id);
+            return -1;
+        }
+        return 0;
+    }
+
+    void VideoEngine::detachChannel(int chn_id)
+    {
+        vpss_manager_->disableChannel(chn_id);
+    }
+
+    int VideoEngine::enableMotionDetection(const MotionDetectorConfig &config, int fps, MotionCallback callback)
+    {
+        if (motion_detector_)
+            return 0;
+        VPSSChnConfig chn;
+        chn.chn_id = kMotionVpssChn;
+        chn.width = config.width;
+        chn.height = config.height;
+        chn.pixel_format = RK_FMT_YUV420SP;
+        chn.src_fps = format_request_.fps;
+        chn.dst_fps = fps > 0 && fps < format_request_.fps ? fps : -1;
+
+        std::unique_ptr<MotionDetector> detector(new MotionDetector(config));
+        if (!callback)
+        {
+            callback = [](const MotionEvent &event)
+            {
+                if (event.changed)
+                    LOGI("[motion] %s: %d blocks, box=(%d,%d %dx%d)", event.motion ? "start" : "end",
+                         event.active_blocks, event.box_x, event.box_y, event.box_w, event.box_h);
+            };
+        }
+        detector->setCallback(std::move(callback));
+        MotionDetector *raw = detector.get();
+        int ret = attachChannelConsumer(chn, [raw](VPSSFrame &frame)
+                                        {
+                                            const VIDEO_FRAME_S &vf = frame.info().stVFrame;
+                                            int stride = vf.u32VirWidth > 0 ? (int)vf.u32VirWidth : (int)vf.u32Width;
+                                            raw->process((const uint8_t *)frame.virAddr(), stride, vf.u32Width, vf.u32Height,
+                                                         infra::MediaClock::instance().toMediaTime(vf.u64PTS)); });
+        CHECK_RET(ret, "attachChannelConsumer(motion)");
+        motion_detector_ = std::move(detector);
+        LOGI("VideoEngine - motion detection on VPSS chn%d (%dx%d @%dfps)", chn.chn_id, config.width, config.height,
+             chn.dst_fps > 0 ? chn.dst_fps : format_request_.fps);
+        return 0;
+    }
+
+    // 先停消费线程（不再调用检测器），再释放检测器
+    void VideoEngine::disableMotionDetection()
+    {
+        if (!motion_detector_)
+            return;
+        if (vpss_manager_)
+            detachChannel(kMotionVpssChn);
+        motion_detector_->printStats();
+        motion_detector_.reset();
+    }
+
     void VideoEngine::videoThread()
     {
-        std::this_thread::sleep_for(std::chrono::milliseconds(3000));
         printf("开始视频处理线程\n");
-        int ret = 0;
+
+        // 绑定模式：VENC取流阻塞等待即可
+        if (pipeline_mode_ == VideoPipelineMode::kBound)
+        {
+            while (is_running_)
+                video_stream_processor_->pullBoundStream(1000);
+            return;
+        }
+
+        // 用户态模式：阻塞等待VI出帧，节拍由采集时间戳决定，不做固定休眠
         while (is_running_)
         {
-            if (video_stream_processor_->getFromVIAndsendToVPSS() != 0)
+            int ret = video_stream_processor_->getFromVIAndsendToVPSS();
+            if (ret == VideoStreamProcessor::kFrameDecimated)
+                continue;
+            if (ret != 0)
             {
                 printf("getFromVIAndsendToVPSS失败！ret=%d\n", ret);
                 continue;
@@ -155,7 +713,7 @@ namespace core
             VIDEO_FRAME_INFO_S bgr_frame;
             if (video_stream_processor_->getFromVPSSAndProcessWithOpenCV(bgr_frame) != 0)
             {
-                printf("getFromVPSSAndProcessWithOpenCV失败！ret=%d\n", ret);
+                printf("getFromVPSSAndProcessWithOpenCV失败！\n");
                 continue;
             }
 
@@ -167,11 +725,7 @@ namespace core
 
             video_stream_processor_->pushEncodedPacketToQueue();
             video_stream_processor_->releaseStreamAndFrame();
-            // std::this_thread::sleep_for(std::chrono::microseconds(8000)); // 
-            std::this_thread::sleep_for(std::chrono::microseconds(11000)); // 
-            // std::this_thread::sleep_for(std::chrono::microseconds(16666)); // 
         }
     }
 
-
-} // namespace core
\ No newline at end of file
+} // namespace core
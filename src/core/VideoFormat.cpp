@@ -0,0 +1,130 @@
+#include "core/VideoFormat.hpp"
+
+extern "C"
+{
+#include "infra/logging/logger.h"
+}
+
+namespace core
+{
+    namespace
+    {
+        const int kEncodeVpssChn = 0; // VPSS → VENC 主通道
+        const int kCvVpssChn = 1;     // VPSS → CV 旁路通道
+
+        bool vpssOutputsFormat(PIXEL_FORMAT_E fmt)
+        {
+            switch (fmt)
+            {
+            case RK_FMT_YUV420SP:
+            case RK_FMT_YUV420P:
+            case RK_FMT_RGB888:
+            case RK_FMT_BGR888:
+                return true;
+            default:
+                return false;
+            }
+        }
+    }
+
+    size_t frameBytes(PIXEL_FORMAT_E fmt, uint32_t width, uint32_t height)
+    {
+        switch (fmt)
+        {
+        case RK_FMT_YUV420SP:
+        case RK_FMT_YUV420P:
+            return (size_t)width * height * 3 / 2;
+        case RK_FMT_RGB888:
+        case RK_FMT_BGR888:
+            return (size_t)width * height * 3;
+        default:
+            return 0;
+        }
+    }
+
+    const char *pixelFormatName(PIXEL_FORMAT_E fmt)
+    {
+        switch (fmt)
+        {
+        case RK_FMT_YUV420SP:
+            return "NV12";
+        case RK_FMT_YUV420P:
+            return "I420";
+        case RK_FMT_RGB888:
+            return "RGB888";
+        case RK_FMT_BGR888:
+            return "BGR888";
+        default:
+            return "unknown";
+        }
+    }
+
+    bool vencAcceptsFormat(PIXEL_FORMAT_E fmt)
+    {
+        // RGB 输入时VENC内部还要再转一次YUV，仅为兼容保留
+        return vpssOutputsFormat(fmt);
+    }
+
+    size_t VideoFormatPlan::bytesPerFrame(int vi_fps) const
+    {
+        // VI 写 + VPSS 读
+        size_t bytes = frameBytes(vi_format, encode_chn.width, encode_chn.height) * 2;
+        // VPSS 写 + VENC 读
+        bytes += frameBytes(encode_chn.pixel_format, encode_chn.width, encode_chn.height) * 2;
+        if (cv_enabled)
+        {
+            // CV旁路按其帧率折算到每个编码帧
+            size_t cv = frameBytes(cv_chn.pixel_format, cv_chn.width, cv_chn.height) * 2;
+            if (cv_chn.dst_fps > 0 && vi_fps > 0 && cv_chn.dst_fps < vi_fps)
+                cv = cv * cv_chn.dst_fps / vi_fps;
+            bytes += cv;
+        }
+        return bytes;
+    }
+
+    int negotiateVideoFormats(const VideoFormatRequest &request, VideoFormatPlan &plan)
+    {
+        if (!vencAcceptsFormat(request.encode_format))
+        {
+            LOGE("negotiateVideoFormats - VENC does not accept %s", pixelFormatName(request.encode_format));
+            return -1;
+        }
+        if (request.cv_consumer && !vpssOutputsFormat(request.cv_format))
+        {
+            LOGE("negotiateVideoFormats - VPSS cannot output %s", pixelFormatName(request.cv_format));
+            return -1;
+        }
+
+        plan = VideoFormatPlan();
+        plan.vi_format = RK_FMT_YUV420SP;
+
+        // 编码主通道直接使用VENC期望的格式，NV12时VPSS只做缩放不做色彩转换
+        plan.encode_chn.chn_id = kEncodeVpssChn;
+        plan.encode_chn.width = request.width;
+        plan.encode_chn.height = request.height;
+        plan.encode_chn.pixel_format = request.encode_format;
+        plan.venc_format = request.encode_format;
+
+        // RGB 只在有CV消费者时由独立的低分辨率通道产出，不影响编码路径
+        plan.cv_enabled = request.cv_consumer;
+        if (plan.cv_enabled)
+        {
+            plan.cv_chn.chn_id = kCvVpssChn;
+            plan.cv_chn.width = request.cv_width;
+            plan.cv_chn.height = request.cv_height;
+            plan.cv_chn.pixel_format = request.cv_format;
+            if (request.cv_fps > 0)
+            {
+                plan.cv_chn.src_fps = request.fps;
+                plan.cv_chn.dst_fps = request.cv_fps;
+            }
+        }
+
+        LOGI("video formats: VI=%s VPSS[%d]->VENC=%s%s%s (%.2f MB/frame)",
+             pixelFormatName(plan.vi_format), plan.encode_chn.chn_id, pixelFormatName(plan.venc_format),
+             plan.cv_enabled ? " VPSS->CV=" : "", plan.cv_enabled ? pixelFormatName(plan.cv_chn.pixel_format) : "",
+             plan.bytesPerFrame(request.fps) / 1048576.0);
+        return 0;
+    }
+
+} // namespace core
@@ -0,0 +1,131 @@
+#include "core/VideoPipeline.hpp"
+#include "infra/time/TimeUtils.h"
+#include <chrono>
+
+extern "C"
+{
+#include "infra/logging/logger.h"
+}
+
+namespace core
+{
+    namespace
+    {
+        const int kErrorBackoffMs = 10; // 阶段出错后的退避时间
+    }
+
+    VideoPipeline::~VideoPipeline()
+    {
+        stop();
+    }
+
+    int VideoPipeline::addStage(const std::string &name, StageBody body)
+    {
+        if (running_)
+        {
+            LOGE("VideoPipeline::addStage - %s: pipeline already running", name.c_str());
+            return -1;
+        }
+        std::unique_ptr<Stage> stage(new Stage());
+        stage->name = name;
+        stage->body = std::move(body);
+        stages_.push_back(std::move(stage));
+        return (int)stages_.size() - 1;
+    }
+
+    int VideoPipeline::start()
+    {
+        if (running_ || stages_.empty())
+            return -1;
+        running_ = true;
+        for (size_t i = 0; i < stages_.size(); i++)
+        {
+            Stage *stage = stages_[i].get();
+            stage->running = true;
+            stage->start_us = infra::now_us();
+            stage->stop_us = 0;
+            // 最后一个阶段负责周期性输出全流水线的统计
+            stage->thread = std::thread(&VideoPipeline::stageLoop, this, stage, i + 1 == stages_.size());
+        }
+        LOGI("VideoPipeline started with %zu stages", stages_.size());
+        return 0;
+    }
+
+    void VideoPipeline::stop()
+    {
+        if (!running_)
+            return;
+        for (auto &stage : stages_)
+        {
+            stage->running = false;
+            if (stage->thread.joinable())
+                stage->thread.join();
+        }
+        running_ = false;
+    }
+
+    void VideoPipeline::stageLoop(Stage *stage, bool reporter)
+    {
+        uint64_t last_print = infra::now_us();
+        while (stage->running)
+        {
+            StageClock clock;
+            uint64_t t0 = infra::now_us();
+            int ret = stage->body(clock);
+            uint64_t t1 = infra::now_us();
+
+            uint64_t blocked = clock.wait_us + clock.stall_us;
+            uint64_t total = t1 - t0;
+            stage->busy_us.fetch_add(total > blocked ? total - blocked : 0, std::memory_order_relaxed);
+            stage->wait_us.fetch_add(clock.wait_us, std::memory_order_relaxed);
+            stage->stall_us.fetch_add(clock.stall_us, std::memory_order_relaxed);
+            if (ret > 0)
+                stage->frames.fetch_add(1, std::memory_order_relaxed);
+            else if (ret < 0)
+            {
+                stage->errors.fetch_add(1, std::memory_order_relaxed);
+                std::this_thread::sleep_for(std::chrono::milliseconds(kErrorBackoffMs));
+            }
+
+            if (reporter && stats_interval_s_ > 0 && t1 - last_print >= (uint64_t)stats_interval_s_ * 1000000)
+            {
+                last_print = t1;
+                printStats();
+            }
+        }
+        stage->stop_us = infra::now_us();
+    }
+
+    PipelineStageStats VideoPipeline::getStats(size_t index) const
+    {
+        PipelineStageStats st;
+        if (index >= stages_.size())
+            return st;
+        const Stage &stage = *stages_[index];
+        st.name = stage.name;
+        st.frames = stage.frames.load(std::memory_order_relaxed);
+        st.errors = stage.errors.load(std::memory_order_relaxed);
+        st.busy_us = stage.busy_us.load(std::memory_order_relaxed);
+        st.wait_us = stage.wait_us.load(std::memory_order_relaxed);
+        st.stall_us = stage.stall_us.load(std::memory_order_relaxed);
+        uint64_t start = stage.start_us.load(std::memory_order_relaxed);
+        uint64_t stop = stage.stop_us.load(std::memory_order_relaxed);
+        if (start)
+            st.elapsed_us = (stop ? stop : infra::now_us()) - start;
+        return st;
+    }
+
+    void VideoPipeline::printStats() const
+    {
+        for (size_t i = 0; i < stages_.size(); i++)
+        {
+            PipelineStageStats st = getStats(i);
+            LOGI("[pipeline] %-8s frames=%llu util=%5.1f%% wait=%5.1f%% stall=%5.1f%% avg=%.2fms errors=%llu",
+                 st.name.c_str(), (unsigned long long)st.frames, st.utilisation() * 100,
+                 st.elapsed_us ? st.wait_us * 100.0 / st.elapsed_us : 0,
+                 st.elapsed_us ? st.stall_us * 100.0 / st.elapsed_us : 0,
+                 st.frames ? st.busy_us / 1000.0 / st.frames : 0, (unsigned long long)st.errors);
+        }
+    }
+
+} // namespace core
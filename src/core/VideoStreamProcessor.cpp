@@ -4,13 +4,11 @@
 #include <cstring>
 #include <chrono> // 用于FPS统计
 
-#include <opencv2/highgui/highgui.hpp>
-#include <opencv2/imgproc/imgproc.hpp>
-
-#include "core/RTSPStreamer.hpp"
 #include "core/VPSSManager.hpp"
 
 #include "core/RTSPEngine.hpp"
+#include "driver/MPIBackend.hpp"
+#include "infra/time/MediaClock.h"
 #include "infra/time/TimeUtils.h"
 
 extern "C"
@@ -23,18 +21,22 @@ extern "C"
 
 namespace core
 {
+    namespace
+    {
+        const int kStageTimeoutMs = 100; // 流水线阶段单次等待时长（用于检查退出标志）
+    }
+
     VideoStreamProcessor::VideoStreamProcessor(driver::VideoInputDriver *vi_driver,
                                                driver::VideoEncoderDriver *venc_driver,
                                                core::VPSSManager *vpss_manager)
-        : vi_driver_(vi_driver), venc_driver_(venc_driver), vpss_manager_(vpss_manager)
+        : vi_driver_(vi_driver), venc_driver_(venc_driver), vpss_manager_(vpss_manager),
+          encode_channel_("main", venc_driver), pacer_("main")
     {
         is_inited_ = false;
 
-        // 初始化编码流缓冲区
-        memset(&venc_stream_, 0, sizeof(VENC_STREAM_S));
-
-        // 初始化BGR帧缓冲
-        m_bgrFrame = cv::Mat(cv::Size(width, height), CV_8UC3);
+        // FPS/时间OSD（左上角，绿色文字，透明背景）
+        osd_fps_region_ = osd_.addRegion(OsdRegionConfig());
+        m_fpsText[0] = '\0';
         LOGI("VideoStreamProcessor initialized (%dx%d)", width, height);
 
         // 初始化视频帧信息
@@ -46,40 +48,8 @@ namespace core
     // 析构函数：释放资源+停止循环
     VideoStreamProcessor::~VideoStreamProcessor()
     {
-        releaseStreamBuffer(); // 释放malloc的VENC_PACK_S
-
+        stopPipeline();
         releasePool(); // 释放YUV内存池
-
-        queue_cv_.notify_all();
-        // std::lock_guard<std::mutex> lock(queue_mutex_);
-        // while (!packet_queue_.empty())
-        // {
-        //     av_packet_free(&packet_queue_.front());
-        //     packet_queue_.pop();
-        // }
-    }
-
-    // 初始化编码流缓冲区
-    int VideoStreamProcessor::initStreamBuffer()
-    {
-        venc_stream_.pstPack = (VENC_PACK_S *)malloc(sizeof(VENC_PACK_S));
-        if (venc_stream_.pstPack == nullptr)
-        {
-            printf("VideoStreamProcessor::initStreamBuffer - malloc failed!\n");
-            return -1;
-        }
-        memset(venc_stream_.pstPack, 0, sizeof(VENC_PACK_S));
-        return 0;
-    }
-
-    // 释放编码流缓冲区
-    void VideoStreamProcessor::releaseStreamBuffer()
-    {
-        if (venc_stream_.pstPack != nullptr)
-        {
-            free(venc_stream_.pstPack);
-            venc_stream_.pstPack = nullptr;
-        }
     }
 
     // 初始化YUV内存池（大小为width*height*3，保留5个缓冲块）
@@ -90,7 +60,7 @@ namespace core
         pool_cfg.u64MBSize = width * height * 3;  // YUV420SP内存大小
         pool_cfg.u32MBCnt = 5;                    // 5个缓冲块，避免帧处理阻塞
         pool_cfg.enAllocType = MB_ALLOC_TYPE_DMA; // 使用DMA内存，支持硬件编码
-        m_mb_pool = RK_MPI_MB_CreatePool(&pool_cfg);
+        m_mb_pool = driver::MPIBackend::instance().mbCreatePool(pool_cfg);
         if (m_mb_pool == MB_INVALID_POOLID)
         {
             LOGE("Failed to create YUV memory pool");
@@ -104,7 +74,7 @@ namespace core
     {
         if (m_mb_pool != MB_INVALID_POOLID)
         {
-            RK_MPI_MB_DestroyPool(m_mb_pool);
+            driver::MPIBackend::instance().mbDestroyPool(m_mb_pool);
             m_mb_pool = MB_INVALID_POOLID;
         }
     }
@@ -118,13 +88,6 @@ namespace core
             return 0;
         }
 
-        // 初始化编码流缓冲区
-        if (initStreamBuffer() != 0)
-        {
-            LOGE("VideoStreamProcessor::initStreamBuffer - failed!");
-            return -1;
-        }
-
         // 初始化YUV内存池
         if (initPool() != 0)
         {
@@ -177,7 +140,7 @@ namespace core
         }
 
         int ret = vi_driver_->start();
-        ret |= venc_driver_->start();
+        ret |= encode_channel_.start();
 
         is_running_ = true;
         return ret;
@@ -193,14 +156,16 @@ namespace core
 
         is_inited_ = false;
         is_running_ = false;
+        encode_channel_.stop(); // 关闭队列唤醒等待中的推流线程，并停止编码
         vi_driver_->stop();
-        venc_driver_->stop();
     }
 
     int VideoStreamProcessor::loopProcess()
     {
-        int ret = 0;
-        if (getFromVIAndsendToVPSS() != 0)
+        int ret = getFromVIAndsendToVPSS();
+        if (ret == kFrameDecimated)
+            return 0;
+        if (ret != 0)
         {
             printf("getFromVIAndsendToVPSS失败！ret=%d\n", ret);
             return -1;
@@ -234,8 +199,15 @@ namespace core
             printf("VI获取帧失败！ret=%d\n", ret);
             return -1;
         }
+
+        // 按采集时刻节拍抽帧：被抽掉的帧不进入VPSS/VENC
+        if (!pacer_.admit((int64_t)vi_frame.stVFrame.u64PTS))
+        {
+            vi_driver_->releaseFrame(vi_frame);
+            return kFrameDecimated;
+        }
         // 2. 发送VI帧到VPSS进行硬件格式转换
-        ret = RK_MPI_VPSS_SendFrame(0, 0, &vi_frame, -1);
+        ret = vpss_manager_->sendFrame(vi_frame, -1);
         if (ret != RK_SUCCESS)
         {
             printf("VPSS发送帧失败！ret=%d\n", ret);
@@ -248,16 +220,23 @@ namespace core
 
     int VideoStreamProcessor::getFromVPSSAndProcessWithOpenCV(VIDEO_FRAME_INFO_S &bgr_frame)
     {
-        // 从VPSS获取转换后的BGR帧
+        // 从VPSS获取缩放后的NV12帧
         // VIDEO_FRAME_INFO_S bgr_frame;
-        int ret = RK_MPI_VPSS_GetChnFrame(0, 0, &bgr_frame, 1000);
+        int ret = vpss_manager_->getFrame(bgr_frame, 1000);
         if (ret != RK_SUCCESS)
         {
-            printf("VPSS获取BGR帧失败！ret=%d\n", ret);
+            printf("VPSS获取帧失败！ret=%d\n", ret);
             return -1;
         }
 
-        // 4. FPS计算与时间戳处理
+        // FPS统计、隐私遮挡、OSD叠加、时间戳换算
+        processFrame(bgr_frame);
+        return 0;
+    }
+
+    void VideoStreamProcessor::processFrame(VIDEO_FRAME_INFO_S &frame)
+    {
+        // 1. FPS统计（每秒更新一次OSD文本）
         uint64_t now = std::chrono::duration_cast<std::chrono::microseconds>(
                            std::chrono::steady_clock::now().time_since_epoch())
                            .count();
@@ -286,65 +265,39 @@ namespace core
             snprintf(m_fpsText, sizeof(m_fpsText), "%.2f fps\n%s", m_fps, time_str);
 
             m_frameCount = 0;
-        }
-
-        // 5. 绘制FPS文本（基于VPSS输出的BGR帧，无需中间Mat）
-        cv::Mat bgr_mat(
-            bgr_frame.stVFrame.u32Height,
-            bgr_frame.stVFrame.u32Width,
-            CV_8UC3,
-            RK_MPI_MB_Handle2VirAddr(bgr_frame.stVFrame.pMbBlk));
-        cv::putText(bgr_mat, m_fpsText, cv::Point(40, 40),
-                    cv::FONT_HERSHEY_SIMPLEX, 1, cv::Scalar(0, 255, 0), 2);
-
-        // 6. 准备编码帧
-        static uint64_t start_time_pts = 0;
-        if (start_time_pts == 0)
-            start_time_pts = now;
-        // process_frame = bgr_frame;                            // 拷贝帧信息（浅拷贝，共享内存块）
-        bgr_frame.stVFrame.enPixelFormat = RK_FMT_RGB888; // 匹配编码器格式（需与VPSS输出兼容）
-        bgr_frame.stVFrame.u64PTS = now - start_time_pts; // 更新时间戳
 
-        return 0;
-    }
-
-    int VideoStreamProcessor::sendToVENCAndGetEncodedPacket(VIDEO_FRAME_INFO_S &process_frame)
-    {
-        int ret = 0;
-        // 发送到编码器
-        if (venc_driver_->sendFrame(process_frame) != 0)
-        {
-            printf("Failed to send frame to encoder\n");
-            RK_MPI_VPSS_ReleaseGrpFrame(0, 0, &process_frame);
-            return -1;
+            osd_.setText(osd_fps_region_, m_fpsText); // 文本每秒变化一次，仅此时重新渲染tile
         }
 
-        // 从编码器获取编码流
-        ret = venc_driver_->getStream(venc_stream_, -1);
-        if (ret != RK_SUCCESS)
+        // 2. 原地遮挡隐私区域、叠加OSD到VPSS输出的NV12帧（只处理区域/tile覆盖的像素；非NV12编码路径不处理）
+        //    先遮挡再叠加，时间戳OSD不会被遮住
+        uint8_t *y_plane = (uint8_t *)driver::MPIBackend::instance().mbHandle2VirAddr(frame.stVFrame.pMbBlk);
+        if (y_plane != nullptr && frame.stVFrame.enPixelFormat == RK_FMT_YUV420SP)
         {
-            printf("VideoStreamProcessor::run - get VENC stream failed! ret=%d\n", ret);
-            return -1;
+            uint32_t stride = frame.stVFrame.u32VirWidth;
+            uint8_t *uv_plane = y_plane + (size_t)stride * frame.stVFrame.u32VirHeight;
+            privacy_.maskNV12(y_plane, uv_plane, stride, frame.stVFrame.u32Width, frame.stVFrame.u32Height);
+            osd_.drawNV12(y_plane, uv_plane, stride,
+                          frame.stVFrame.u32Width, frame.stVFrame.u32Height);
         }
 
-        // void *streamData = RK_MPI_MB_Handle2VirAddr(encode_frame.pstPack->pMbBlk);
-
-        // 打印帧信息
-        // printf("获取视频数据且编码成功 当前帧数据长度==%d 当前帧时间戳==%lld\r\n",
-        //        venc_stream_.pstPack->u32Len,
-        //        venc_stream_.pstPack->u64PTS);
-
-        // 释放编码器流资源
-        // venc_driver_->releaseStream(venc_stream_);
+        // 3. 准备编码帧：时间戳取VI采集时刻（VPSS透传 u64PTS），换算为统一媒体时间
+        frame.stVFrame.u64PTS = infra::MediaClock::instance().toMediaTime(frame.stVFrame.u64PTS);
+    }
 
-        RK_MPI_VPSS_ReleaseGrpFrame(0, 0, &process_frame);
+    int VideoStreamProcessor::sendToVENCAndGetEncodedPacket(VIDEO_FRAME_INFO_S &process_frame)
+    {
+        // 送帧并取回码流（码流暂存在编码通道中，由 pushEncodedPacketToQueue 入队）
+        int ret = encode_channel_.sendFrame(process_frame);
+        if (ret == 0)
+            ret = encode_channel_.fetchStream(-1);
 
-        return 0;
+        vpss_manager_->releaseFrame(process_frame);
+        return ret;
     }
 
     /**
      * 将VENC_STREAM_S转换为AVPacket并放入队列
-     * @param encode_frame 编码器输出的H.265流
      * @return 0成功，非0失败
      */
     int VideoStreamProcessor::pushEncodedPacketToQueue()
@@ -354,111 +307,156 @@ namespace core
             printf("ERROR: VideoStreamProcessor is not running\n");
             return -1;
         }
+        return encode_channel_.pushStream();
+    }
 
-        void *streamData = RK_MPI_MB_Handle2VirAddr(venc_stream_.pstPack->pMbBlk);
-
-        AVPacket *pkt = av_packet_alloc();
-
-        pkt->data = (uint8_t *)streamData;
-        pkt->size = venc_stream_.pstPack->u32Len;
-        pkt->pts = venc_stream_.pstPack->u64PTS;
-        pkt->dts = pkt->pts;
+    int VideoStreamProcessor::pullBoundStream(int timeout_ms)
+    {
+        if (!is_running_)
+            return -1;
+        if (encode_channel_.fetchStream(timeout_ms) != 0)
+            return -1;
+        pacer_.observe(encode_channel_.pendingPts()); // 帧率由VPSS帧率控制，这里只统计
+        int ret = encode_channel_.pushStream();
+        encode_channel_.releasePendingStream();
+        return ret;
+    }
 
-        pkt->duration = 33333;
+    int VideoStreamProcessor::startPipeline(size_t depth, bool drain_stage)
+    {
+        if (!is_running_ || pipeline_.isRunning())
+        {
+            LOGE("VideoStreamProcessor::startPipeline - not running or already started");
+            return -1;
+        }
+        frame_ring_.reset(new infra::SPSCRing<VPSSFrame>(depth, infra::DropPolicy::Block));
+        if (pipeline_.stageCount() == 0)
+        {
+            pipeline_.addStage("capture", [this](StageClock &clock)
+                               { return captureStage(clock); });
+            pipeline_.addStage("process", [this](StageClock &clock)
+                               { return processStage(clock); });
+            pipeline_.addStage("submit", [this](StageClock &clock)
+                               { return submitStage(clock); });
+            if (drain_stage)
+                pipeline_.addStage("drain", [this](StageClock &clock)
+                                   { return drainStage(clock); });
+        }
+        return pipeline_.start();
+    }
 
-        // 设置关键帧标志
-        H265E_NALU_TYPE_E nalu_type = venc_stream_.pstPack->DataType.enH265EType;
-        if (nalu_type == H265E_NALU_IDRSLICE)
+    void VideoStreamProcessor::stopPipeline()
+    {
+        if (!pipeline_.isRunning())
+            return;
+        pipeline_.stop();
+        pipeline_.printStats();
+        if (frame_ring_)
         {
-            pkt->flags |= AV_PKT_FLAG_KEY; // 标记为关键帧
-            printf("关键帧或参数集：类型=%d,长度=%u\n",
-                   nalu_type, venc_stream_.pstPack->u32Len);
+            frame_ring_->close();
+            frame_ring_->clear(); // 归还队列中的VPSS帧
+            LOGI("pipeline frame queue dropped %llu frames", (unsigned long long)frame_ring_dropped_.load());
         }
+        encode_channel_.releasePendingStream();
+    }
 
-        std::unique_lock<std::mutex> lock(queue_mutex_);
-        // 队列满时丢最早的包
-        if (packet_queue_.size() >= 30)
+    // 采集：等待VI出帧，按节拍放行后送VPSS
+    int VideoStreamProcessor::captureStage(StageClock &clock)
+    {
+        uint64_t t0 = infra::now_us();
+        VIDEO_FRAME_INFO_S frame;
+        int ret = vi_driver_->getFrame(frame, kStageTimeoutMs);
+        clock.wait_us += infra::now_us() - t0;
+        if (ret != RK_SUCCESS)
+            return 0;
+
+        if (!pacer_.admit((int64_t)frame.stVFrame.u64PTS))
         {
-            AVPacket *old_pkt = packet_queue_.front();
-            av_packet_free(&old_pkt);
-            packet_queue_.pop();
-            printf("视频队列已满，丢弃帧,剩余{%lld/30}\n", (long long)packet_queue_.size());
+            vi_driver_->releaseFrame(frame);
+            return 0;
         }
+        ret = vpss_manager_->sendFrame(frame, kStageTimeoutMs);
+        vi_driver_->releaseFrame(frame);
+        return ret == RK_SUCCESS ? 1 : -1;
+    }
 
-        packet_queue_.push(pkt); // 转移所有权到队列
-        queue_cv_.notify_one();  // 通知等待的出队线程
+    // 处理：取VPSS输出帧，遮挡隐私区域、叠加OSD后交给送编码阶段（队列满时等待，超时丢弃该帧）
+    int VideoStreamProcessor::processStage(StageClock &clock)
+    {
+        uint64_t t0 = infra::now_us();
+        VIDEO_FRAME_INFO_S info;
+        int ret = vpss_manager_->getFrame(info, kStageTimeoutMs);
+        clock.wait_us += infra::now_us() - t0;
+        if (ret != RK_SUCCESS)
+            return 0;
 
-        return 0;
+        processFrame(info);
+        VPSSFrame frame(vpss_manager_, vpss_manager_->mainChannel().chn_id, info);
+
+        uint64_t t1 = infra::now_us();
+        ret = frame_ring_->push(frame, kStageTimeoutMs);
+        clock.stall_us += infra::now_us() - t1;
+        if (ret == infra::SPSCRing<VPSSFrame>::kPushTimeout)
+            frame_ring_dropped_++;
+        return ret == infra::SPSCRing<VPSSFrame>::kPushOk ? 1 : 0;
+    }
+
+    // 送编码：送帧后立即归还VPSS帧，不等待码流
+    int VideoStreamProcessor::submitStage(StageClock &clock)
+    {
+        uint64_t t0 = infra::now_us();
+        VPSSFrame frame;
+        int ret = frame_ring_->pop(frame, kStageTimeoutMs);
+        clock.wait_us += infra::now_us() - t0;
+        if (ret != 0)
+            return 0;
+
+        ret = encode_channel_.sendFrame(frame.info());
+        frame.reset();
+        return ret == 0 ? 1 : -1;
+    }
+
+    // 取码流：零拷贝入编码包队列
+    int VideoStreamProcessor::drainStage(StageClock &clock)
+    {
+        uint64_t t0 = infra::now_us();
+        int ret = encode_channel_.fetchStream(kStageTimeoutMs);
+        clock.wait_us += infra::now_us() - t0;
+        if (ret != 0)
+            return 0;
+
+        ret = encode_channel_.pushStream();
+        encode_channel_.releasePendingStream();
+        return ret == 0 ? 1 : -1;
     }
 
-    /**
-     * 取出H.265的AVPacket（供推流线程）
-     * @param out_pkt 输出的AVPacket（需用av_packet_free释放）
-     * @param timeout_ms 超时时间
-     * @return 0成功，-1超时
-     */
     /**
      * 取出队列中的AVPacket（供推流线程）
-     * @param out_pkt 输出参数（用于接收AVPacket指针，需用av_packet_free释放）
+     * @param out_pkt 输出参数（队列内容移入，用完需av_packet_unref）
      * @param timeout_ms 超时时间（毫秒）
      * @return 0成功，-1超时，-2线程需退出
      */
-    int VideoStreamProcessor::popEncodedPacket(AVPacket *&out_pkt, int timeout_ms)
+    int VideoStreamProcessor::popEncodedPacket(AVPacket *out_pkt, int timeout_ms)
     {
-        std::unique_lock<std::mutex> lock(queue_mutex_);
-
-        // 等待条件：队列非空 或 线程需退出
-        bool has_data = queue_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms),
-                                           [this]()
-                                           { return !is_running_ || !packet_queue_.empty(); });
-
-        if (!has_data)
-        {
-            out_pkt = nullptr;
-            return -1; // 超时
-        }
-
         // 线程需退出时，无论队列是否有数据都返回退出信号
         if (!is_running_)
-        {
-            out_pkt = nullptr;
-            return -2; // 线程需退出
-        }
-
-        // printf("视频队列剩余{%lld/30}\n", (long long)packet_queue_.size());
-
-        // 正常取出数据（转移所有权给out_pkt）
-        out_pkt = packet_queue_.front();
-        packet_queue_.pop();
-        return 0;
+            return -2;
+        return encode_channel_.packetRing().pop(*out_pkt, timeout_ms);
     }
 
     bool VideoStreamProcessor::getQueueFrontPts(int64_t &pkt, int timeout_ms)
     {
-        std::unique_lock<std::mutex> lock(queue_mutex_);
-
-        // 等待条件：队列非空 或 线程需退出
-        bool has_data = queue_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms),
-                                           [this]()
-                                           { return !is_running_ || !packet_queue_.empty(); });
-
-        if (!has_data)
-        {
-            return false;
-        }
-
-        if (!is_running_)
+        infra::SPSCRing<AVPacket> &ring = encode_channel_.packetRing();
+        if (!is_running_ || ring.waitReadable(timeout_ms) != 0)
         {
             return false;
         }
-        pkt = packet_queue_.front()->pts;
-        // printf("视频队列首的时间戳是：%lld\n", pkt);
-        return true;
+        return ring.peekFront(pkt);
     }
 
     void VideoStreamProcessor::releaseStreamAndFrame()
     {
-        venc_driver_->releaseStream(venc_stream_);
+        encode_channel_.releasePendingStream();
     }
 
 } // namespace core
\ No newline at end of file
@@ -32,6 +32,8 @@ namespace driver
 
         // 保存配置
         config_ = config;
+        total_samples_ = 0;
+        timestamper_ = infra::AudioTimestamper(config_.sample_rate);
 
         // 查找编码器（优先按名称查找，如"libfdk_aac"）
         codec_ = avcodec_find_encoder_by_name(config.codec_name.c_str());
@@ -125,7 +127,7 @@ namespace driver
         return 0;
     }
 
-    int AudioEncoderDriver::encode(const uint8_t *pcm_data, int data_size, AVPacket &out_pkt)
+    int AudioEncoderDriver::encode(const uint8_t *pcm_data, int data_size, AVPacket &out_pkt, int64_t capture_us)
     {
         // std::lock_guard<std::mutex> lock(mutex_);
 
@@ -145,6 +147,7 @@ namespace driver
 
         // 添加帧缓冲区 (已改为类成员变量)
         frame_buffer_.insert(frame_buffer_.end(), pcm_data, pcm_data + data_size);
+        timestamper_.onCapture(capture_us, frame_buffer_.size() / (codec_ctx_->channels * bytes_per_sample));
 
         // 检查是否有足够数据组成完整帧
         if (frame_buffer_.size() < bytes_per_frame)
@@ -198,8 +201,9 @@ namespace driver
         //                            (AVRational){1, 48000}, // 原始时间基：1/采样率 (48000Hz)
         //                            codec_ctx_->time_base); // 目标时间基：编码器使用的时间基
 
-        out_pkt.pts = frame_->pts;
-        out_pkt.duration = 64;
+        // 媒体时间（与视频同一时间基）：按采样数连续推进，锚定在PCM的采集时刻
+        out_pkt.pts = timestamper_.next(frame_->nb_samples);
+        out_pkt.duration = (int64_t)frame_->nb_samples * 1000000 / codec_ctx_->sample_rate;
 
 
         // out_pkt.duration = av_rescale_q(frame_->nb_samples,
@@ -2,8 +2,13 @@
 
 int driver::ISPDriver::init()
 {
+#ifdef CAMERA_SIM_BACKEND
+    // 模拟后端没有sensor/ISP，VI直接输出合成或录制的NV12
+    return 0;
+#else
     int ret = 0;
     ret = SAMPLE_COMM_ISP_Init(cam_id_, hdr_mode_, multi_sensor_, iq_dir_);
     ret |= SAMPLE_COMM_ISP_Run(cam_id_);
     return ret;
+#endif
 }
@@ -1,19 +1,22 @@
 #include "driver/MPIManager.hpp"
+#include "driver/MPIBackend.hpp"
 
 extern "C"
 {
-#include "rk_mpi_sys.h"
+#include "infra/logging/logger.h"
 }
 
 namespace driver
 {
     int MPIManager::init()
     {
-        if (RK_MPI_SYS_Init() != RK_SUCCESS)
+        MPIBackend &mpi = MPIBackend::instance();
+        if (mpi.sysInit() != RK_SUCCESS)
         {
-            RK_LOGE("rk mpi sys init fail!");
+            LOGE("mpi sys init fail! backend=%s", mpi.name());
             return -1;
         }
+        LOGI("mpi sys init success, backend=%s", mpi.name());
         return 0;
     }
 } // namespace driver
@@ -0,0 +1,114 @@
+#include "driver/RKMPIBackend.hpp"
+
+extern "C"
+{
+#include "rk_mpi_sys.h"
+#include "rk_mpi_mb.h"
+#include "rk_mpi_vi.h"
+#include "rk_mpi_vpss.h"
+#include "rk_mpi_venc.h"
+}
+
+namespace driver
+{
+    MPIBackend &MPIBackend::instance()
+    {
+        static RKMPIBackend backend;
+        return backend;
+    }
+
+    // SYS
+    int RKMPIBackend::sysInit() { return RK_MPI_SYS_Init(); }
+    int RKMPIBackend::sysExit() { return RK_MPI_SYS_Exit(); }
+    int RKMPIBackend::sysBind(const MPP_CHN_S &src, const MPP_CHN_S &dst) { return RK_MPI_SYS_Bind(&src, &dst); }
+    int RKMPIBackend::sysUnBind(const MPP_CHN_S &src, const MPP_CHN_S &dst) { return RK_MPI_SYS_UnBind(&src, &dst); }
+
+    // MB 内存块
+    MB_POOL RKMPIBackend::mbCreatePool(MB_POOL_CONFIG_S &config) { return RK_MPI_MB_CreatePool(&config); }
+    int RKMPIBackend::mbDestroyPool(MB_POOL pool) { return RK_MPI_MB_DestroyPool(pool); }
+    MB_BLK RKMPIBackend::mbGetMB(MB_POOL pool, RK_U64 size, bool block)
+    {
+        return RK_MPI_MB_GetMB(pool, size, block ? RK_TRUE : RK_FALSE);
+    }
+    int RKMPIBackend::mbReleaseMB(MB_BLK blk) { return RK_MPI_MB_ReleaseMB(blk); }
+    void *RKMPIBackend::mbHandle2VirAddr(MB_BLK blk) { return RK_MPI_MB_Handle2VirAddr(blk); }
+
+    // VI
+    int RKMPIBackend::viGetDevAttr(VI_DEV dev, VI_DEV_ATTR_S &attr) { return RK_MPI_VI_GetDevAttr(dev, &attr); }
+    int RKMPIBackend::viSetDevAttr(VI_DEV dev, const VI_DEV_ATTR_S &attr) { return RK_MPI_VI_SetDevAttr(dev, &attr); }
+    int RKMPIBackend::viGetDevIsEnable(VI_DEV dev) { return RK_MPI_VI_GetDevIsEnable(dev); }
+    int RKMPIBackend::viEnableDev(VI_DEV dev) { return RK_MPI_VI_EnableDev(dev); }
+    int RKMPIBackend::viSetDevBindPipe(VI_DEV dev, const VI_DEV_BIND_PIPE_S &bind_pipe) { return RK_MPI_VI_SetDevBindPipe(dev, &bind_pipe); }
+    int RKMPIBackend::viSetChnAttr(VI_PIPE pipe, VI_CHN chn, const VI_CHN_ATTR_S &attr) { return RK_MPI_VI_SetChnAttr(pipe, chn, &attr); }
+    int RKMPIBackend::viEnableChn(VI_PIPE pipe, VI_CHN chn) { return RK_MPI_VI_EnableChn(pipe, chn); }
+    int RKMPIBackend::viDisableChn(VI_PIPE pipe, VI_CHN chn) { return RK_MPI_VI_DisableChn(pipe, chn); }
+
+    int RKMPIBackend::viGetChnFrame(VI_PIPE pipe, VI_CHN chn, VIDEO_FRAME_INFO_S &frame, int timeout)
+    {
+        return RK_MPI_VI_GetChnFrame(pipe, chn, &frame, timeout);
+    }
+
+    int RKMPIBackend::viReleaseChnFrame(VI_PIPE pipe, VI_CHN chn, const VIDEO_FRAME_INFO_S &frame)
+    {
+        return RK_MPI_VI_ReleaseChnFrame(pipe, chn, &frame);
+    }
+
+    // VPSS
+    int RKMPIBackend::vpssCreateGrp(VPSS_GRP grp, const VPSS_GRP_ATTR_S &attr) { return RK_MPI_VPSS_CreateGrp(grp, &attr); }
+    int RKMPIBackend::vpssDestroyGrp(VPSS_GRP grp) { return RK_MPI_VPSS_DestroyGrp(grp); }
+    int RKMPIBackend::vpssStartGrp(VPSS_GRP grp) { return RK_MPI_VPSS_StartGrp(grp); }
+    int RKMPIBackend::vpssStopGrp(VPSS_GRP grp) { return RK_MPI_VPSS_StopGrp(grp); }
+    int RKMPIBackend::vpssSetChnAttr(VPSS_GRP grp, VPSS_CHN chn, const VPSS_CHN_ATTR_S &attr) { return RK_MPI_VPSS_SetChnAttr(grp, chn, &attr); }
+    int RKMPIBackend::vpssEnableChn(VPSS_GRP grp, VPSS_CHN chn) { return RK_MPI_VPSS_EnableChn(grp, chn); }
+    int RKMPIBackend::vpssDisableChn(VPSS_GRP grp, VPSS_CHN chn) { return RK_MPI_VPSS_DisableChn(grp, chn); }
+    int RKMPIBackend::vpssEnableBackupFrame(VPSS_GRP grp) { return RK_MPI_VPSS_EnableBackupFrame(grp); }
+    int RKMPIBackend::vpssDisableBackupFrame(VPSS_GRP grp) { return RK_MPI_VPSS_DisableBackupFrame(grp); }
+
+    int RKMPIBackend::vpssSendFrame(VPSS_GRP grp, const VIDEO_FRAME_INFO_S &frame, int timeout)
+    {
+        return RK_MPI_VPSS_SendFrame(grp, 0, &frame, timeout);
+    }
+
+    int RKMPIBackend::vpssGetChnFrame(VPSS_GRP grp, VPSS_CHN chn, VIDEO_FRAME_INFO_S &frame, int timeout)
+    {
+        return RK_MPI_VPSS_GetChnFrame(grp, chn, &frame, timeout);
+    }
+
+    int RKMPIBackend::vpssReleaseChnFrame(VPSS_GRP grp, VPSS_CHN chn, const VIDEO_FRAME_INFO_S &frame)
+    {
+        return RK_MPI_VPSS_ReleaseChnFrame(grp, chn, &frame);
+    }
+
+    // VENC
+    int RKMPIBackend::vencCreateChn(VENC_CHN chn, const VENC_CHN_ATTR_S &attr) { return RK_MPI_VENC_CreateChn(chn, &attr); }
+    int RKMPIBackend::vencDestroyChn(VENC_CHN chn) { return RK_MPI_VENC_DestroyChn(chn); }
+    int RKMPIBackend::vencStartRecvFrame(VENC_CHN chn, const VENC_RECV_PIC_PARAM_S &param) { return RK_MPI_VENC_StartRecvFrame(chn, &param); }
+    int RKMPIBackend::vencStopRecvFrame(VENC_CHN chn) { return RK_MPI_VENC_StopRecvFrame(chn); }
+
+    int RKMPIBackend::vencSendFrame(VENC_CHN chn, const VIDEO_FRAME_INFO_S &frame, int timeout)
+    {
+        return RK_MPI_VENC_SendFrame(chn, &frame, timeout);
+    }
+
+    int RKMPIBackend::vencGetStream(VENC_CHN chn, VENC_STREAM_S &stream, int timeout)
+    {
+        return RK_MPI_VENC_GetStream(chn, &stream, timeout);
+    }
+
+    int RKMPIBackend::vencReleaseStream(VENC_CHN chn, VENC_STREAM_S &stream)
+    {
+        return RK_MPI_VENC_ReleaseStream(chn, &stream);
+    }
+
+    int RKMPIBackend::vencGetChnAttr(VENC_CHN chn, VENC_CHN_ATTR_S &attr) { return RK_MPI_VENC_GetChnAttr(chn, &attr); }
+    int RKMPIBackend::vencSetChnAttr(VENC_CHN chn, const VENC_CHN_ATTR_S &attr) { return RK_MPI_VENC_SetChnAttr(chn, &attr); }
+    int RKMPIBackend::vencGetRcParam(VENC_CHN chn, VENC_RC_PARAM_S &param) { return RK_MPI_VENC_GetRcParam(chn, &param); }
+    int RKMPIBackend::vencSetRcParam(VENC_CHN chn, const VENC_RC_PARAM_S &param) { return RK_MPI_VENC_SetRcParam(chn, &param); }
+    int RKMPIBackend::vencSetRoiAttr(VENC_CHN chn, const VENC_ROI_ATTR_S &attr) { return RK_MPI_VENC_SetRoiAttr(chn, &attr); }
+    int RKMPIBackend::vencGetRoiAttr(VENC_CHN chn, RK_U32 index, VENC_ROI_ATTR_S &attr) { return RK_MPI_VENC_GetRoiAttr(chn, index, &attr); }
+    int RKMPIBackend::vencRequestIDR(VENC_CHN chn, bool instant) { return RK_MPI_VENC_RequestIDR(chn, instant ? RK_TRUE : RK_FALSE); }
+    int RKMPIBackend::vencQueryStatus(VENC_CHN chn, VENC_CHN_STATUS_S &status) { return RK_MPI_VENC_QueryStatus(chn, &status); }
+    int RKMPIBackend::vencGetFd(VENC_CHN chn) { return RK_MPI_VENC_GetFd(chn); }
+    int RKMPIBackend::vencCloseFd(VENC_CHN chn) { return RK_MPI_VENC_CloseFd(chn); }
+
+} // namespace driver
@@ -0,0 +1,255 @@
+#include "driver/RcProfile.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+extern "C"
+{
+#include "infra/logging/logger.h"
+}
+
+namespace driver
+{
+    namespace
+    {
+        const int kDefaultFixIQp = 26;
+        const int kDefaultFixPQp = 28;
+        const int kSmartPGopFactor = 10; // 智能P帧默认IDR间隔 = 虚拟I帧间隔 × 10
+
+        // 普通P帧的默认GOP：H264 30帧，H265 60帧
+        RK_U32 defaultGop(RK_CODEC_ID_E type)
+        {
+            return type == RK_VIDEO_ID_AVC ? 30 : 60;
+        }
+
+        RK_U32 virIdrLen(RK_CODEC_ID_E type, const RcProfile &p)
+        {
+            return p.vir_idr_len > 0 ? (RK_U32)p.vir_idr_len : defaultGop(type);
+        }
+
+        // IDR间隔：智能P帧模式下默认拉长到虚拟I帧间隔的 kSmartPGopFactor 倍
+        RK_U32 gopLength(RK_CODEC_ID_E type, const RcProfile &p)
+        {
+            if (p.gop > 0)
+                return p.gop;
+            return p.gop_mode == GopMode::kSmartP ? virIdrLen(type, p) * kSmartPGopFactor : defaultGop(type);
+        }
+
+        // 配置项为0时取默认值
+        inline RK_U32 orDefault(int value, RK_U32 def)
+        {
+            return value > 0 ? (RK_U32)value : def;
+        }
+
+        // CBR/VBR/AVBR/FixQP 的公共字段（GOP、帧率）
+        template <typename Attr>
+        void fillCommon(Attr &a, RK_U32 gop, int src_fps, int dst_fps)
+        {
+            a.u32Gop = gop;
+            a.u32SrcFrameRateNum = orDefault(src_fps, 30);
+            a.u32SrcFrameRateDen = 1;
+            a.fr32DstFrameRateNum = orDefault(dst_fps, 30);
+            a.fr32DstFrameRateDen = 1;
+        }
+
+        template <typename Attr>
+        void fillVbr(Attr &a, const RcProfile &p, RK_U32 bitrate, RK_U32 max_bitrate, RK_U32 min_bitrate)
+        {
+            a.u32BitRate = orDefault(p.bitrate_kbps, bitrate);
+            a.u32MaxBitRate = orDefault(p.max_bitrate_kbps, max_bitrate);
+            a.u32MinBitRate = orDefault(p.min_bitrate_kbps, min_bitrate);
+            a.u32StatTime = orDefault(p.stat_time_s, 0);
+        }
+    }
+
+    const char *rcModeName(RcMode mode)
+    {
+        switch (mode)
+        {
+        case RcMode::kCbr:
+            return "cbr";
+        case RcMode::kVbr:
+            return "vbr";
+        case RcMode::kAvbr:
+            return "avbr";
+        case RcMode::kFixQp:
+            return "fixqp";
+        default:
+            return "unknown";
+        }
+    }
+
+    const char *gopModeName(GopMode mode)
+    {
+        return mode == GopMode::kSmartP ? "smartp" : "normalp";
+    }
+
+    int parseRcProfile(const std::string &text, RcProfile &profile)
+    {
+        int ret = 0;
+        std::stringstream ss(text);
+        std::string item;
+        while (std::getline(ss, item, ','))
+        {
+            size_t eq = item.find('=');
+            if (eq == std::string::npos)
+            {
+                if (!item.empty())
+                    ret = -1;
+                continue;
+            }
+            std::string key = item.substr(0, eq);
+            std::string value = item.substr(eq + 1);
+            const char *v = value.c_str();
+            if (key == "mode")
+            {
+                if (value == "cbr")
+                    profile.mode = RcMode::kCbr;
+                else if (value == "vbr")
+                    profile.mode = RcMode::kVbr;
+                else if (value == "avbr")
+                    profile.mode = RcMode::kAvbr;
+                else if (value == "fixqp")
+                    profile.mode = RcMode::kFixQp;
+                else
+                    ret = -1;
+            }
+            else if (key == "gop")
+                profile.gop = atoi(v);
+            else if (key == "bitrate")
+                profile.bitrate_kbps = atoi(v);
+            else if (key == "max")
+                profile.max_bitrate_kbps = atoi(v);
+            else if (key == "min")
+                profile.min_bitrate_kbps = atoi(v);
+            else if (key == "qp")
+            {
+                if (sscanf(v, "%d-%d", &profile.min_qp, &profile.max_qp) != 2)
+                    ret = -1;
+            }
+            else if (key == "iqp_delta")
+                profile.i_qp_delta = atoi(v);
+            else if (key == "fixqp")
+            {
+                if (sscanf(v, "%d/%d", &profile.fix_i_qp, &profile.fix_p_qp) != 2)
+                    ret = -1;
+            }
+            else if (key == "stat")
+                profile.stat_time_s = atoi(v);
+            else if (key == "gopmode")
+            {
+                if (value == "normalp")
+                    profile.gop_mode = GopMode::kNormalP;
+                else if (value == "smartp")
+                    profile.gop_mode = GopMode::kSmartP;
+                else
+                    ret = -1;
+            }
+            else if (key == "viridr")
+                profile.vir_idr_len = atoi(v);
+            else
+                ret = -1;
+            if (ret != 0)
+                LOGW("parseRcProfile - bad item '%s'", item.c_str());
+        }
+        return ret;
+    }
+
+    void buildRcAttr(RK_CODEC_ID_E type, const RcProfile &p, int src_fps, int dst_fps, VENC_RC_ATTR_S &attr)
+    {
+        memset(&attr, 0, sizeof(attr));
+        if (type == RK_VIDEO_ID_AVC)
+        { // H264：默认GOP 30，目标5Mbps，VBR 2~8Mbps
+            RK_U32 gop = gopLength(type, p);
+            switch (p.mode)
+            {
+            case RcMode::kCbr:
+                attr.enRcMode = VENC_RC_MODE_H264CBR;
+                fillCommon(attr.stH264Cbr, gop, src_fps, dst_fps);
+                attr.stH264Cbr.u32BitRate = orDefault(p.bitrate_kbps, 5 * 1024);
+                attr.stH264Cbr.u32StatTime = orDefault(p.stat_time_s, 0);
+                break;
+            case RcMode::kAvbr:
+                attr.enRcMode = VENC_RC_MODE_H264AVBR;
+                fillCommon(attr.stH264Avbr, gop, src_fps, dst_fps);
+                fillVbr(attr.stH264Avbr, p, 5 * 1024, 8 * 1024, 1 * 1024);
+                break;
+            case RcMode::kFixQp:
+                attr.enRcMode = VENC_RC_MODE_H264FIXQP;
+                fillCommon(attr.stH264FixQp, gop, src_fps, dst_fps);
+                attr.stH264FixQp.u32IQp = orDefault(p.fix_i_qp, kDefaultFixIQp);
+                attr.stH264FixQp.u32PQp = orDefault(p.fix_p_qp, kDefaultFixPQp);
+                attr.stH264FixQp.u32BQp = attr.stH264FixQp.u32PQp;
+                break;
+            case RcMode::kVbr:
+            default:
+                attr.enRcMode = VENC_RC_MODE_H264VBR;
+                fillCommon(attr.stH264Vbr, gop, src_fps, dst_fps);
+                fillVbr(attr.stH264Vbr, p, 5 * 1024, 8 * 1024, 2 * 1024);
+                break;
+            }
+        }
+        else if (type == RK_VIDEO_ID_HEVC)
+        { // H265：默认GOP 60，目标5Mbps，VBR 1~10Mbps
+            RK_U32 gop = gopLength(type, p);
+            switch (p.mode)
+            {
+            case RcMode::kCbr:
+                attr.enRcMode = VENC_RC_MODE_H265CBR;
+                fillCommon(attr.stH265Cbr, gop, src_fps, dst_fps);
+                attr.stH265Cbr.u32BitRate = orDefault(p.bitrate_kbps, 5 * 1024);
+                attr.stH265Cbr.u32StatTime = orDefault(p.stat_time_s, 0);
+                break;
+            case RcMode::kAvbr:
+                attr.enRcMode = VENC_RC_MODE_H265AVBR;
+                fillCommon(attr.stH265Avbr, gop, src_fps, dst_fps);
+                fillVbr(attr.stH265Avbr, p, 5 * 1024, 10 * 1024, 512);
+                break;
+            case RcMode::kFixQp:
+                attr.enRcMode = VENC_RC_MODE_H265FIXQP;
+                fillCommon(attr.stH265FixQp, gop, src_fps, dst_fps);
+                attr.stH265FixQp.u32IQp = orDefault(p.fix_i_qp, kDefaultFixIQp);
+                attr.stH265FixQp.u32PQp = orDefault(p.fix_p_qp, kDefaultFixPQp);
+                attr.stH265FixQp.u32BQp = attr.stH265FixQp.u32PQp;
+                break;
+            case RcMode::kVbr:
+            default:
+                attr.enRcMode = VENC_RC_MODE_H265VBR;
+                fillCommon(attr.stH265Vbr, gop, src_fps, dst_fps);
+                fillVbr(attr.stH265Vbr, p, 5 * 1024, 10 * 1024, 1 * 1024);
+                break;
+            }
+        }
+        else if (type == RK_VIDEO_ID_MJPEG)
+        { // MJPEG：默认10Mbps
+            attr.enRcMode = VENC_RC_MODE_MJPEGCBR;
+            attr.stMjpegCbr.u32SrcFrameRateNum = orDefault(src_fps, 30);
+            attr.stMjpegCbr.u32SrcFrameRateDen = 1;
+            attr.stMjpegCbr.fr32DstFrameRateNum = orDefault(dst_fps, 30);
+            attr.stMjpegCbr.fr32DstFrameRateDen = 1;
+            attr.stMjpegCbr.u32BitRate = orDefault(p.bitrate_kbps, 10 * 1024);
+            attr.stMjpegCbr.u32StatTime = orDefault(p.stat_time_s, 0);
+        }
+    }
+
+    void buildGopAttr(RK_CODEC_ID_E type, const RcProfile &p, VENC_GOP_ATTR_S &attr)
+    {
+        memset(&attr, 0, sizeof(attr));
+        if (type != RK_VIDEO_ID_AVC && type != RK_VIDEO_ID_HEVC)
+            return;
+        if (p.gop_mode == GopMode::kSmartP)
+        {
+            // 虚拟I帧间隔不能超过IDR间隔
+            attr.enGopMode = VENC_GOPMODE_SMARTP;
+            attr.s32VirIdrLen = (RK_S32)std::min(virIdrLen(type, p), gopLength(type, p));
+            attr.u32MaxLtrCount = 1; // 长期参考帧：最近的IDR
+        }
+        else
+        {
+            attr.enGopMode = VENC_GOPMODE_NORMALP;
+        }
+    }
+
+} // namespace driver
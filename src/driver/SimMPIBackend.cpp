@@ -0,0 +1,1311 @@
+#include "driver/SimMPIBackend.hpp"
+#include "infra/time/TimeUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+extern "C"
+{
+#include "infra/logging/logger.h"
+#include <libavcodec/avcodec.h>
+#include <libavutil/opt.h>
+#include <libswscale/swscale.h>
+}
+
+namespace driver
+{
+    namespace
+    {
+        // RK像素格式 → FFmpeg像素格式
+        AVPixelFormat toAVPixelFormat(PIXEL_FORMAT_E fmt)
+        {
+            switch (fmt)
+            {
+            case RK_FMT_YUV420SP:
+                return AV_PIX_FMT_NV12;
+            case RK_FMT_YUV420P:
+                return AV_PIX_FMT_YUV420P;
+            case RK_FMT_RGB888:
+                return AV_PIX_FMT_RGB24;
+            case RK_FMT_BGR888:
+                return AV_PIX_FMT_BGR24;
+            default:
+                return AV_PIX_FMT_NONE;
+            }
+        }
+
+        // 按虚宽/虚高计算一帧所占字节数
+        size_t frameBytes(PIXEL_FORMAT_E fmt, uint32_t vir_w, uint32_t vir_h)
+        {
+            switch (fmt)
+            {
+            case RK_FMT_YUV420SP:
+            case RK_FMT_YUV420P:
+                return (size_t)vir_w * vir_h * 3 / 2;
+            case RK_FMT_RGB888:
+            case RK_FMT_BGR888:
+                return (size_t)vir_w * vir_h * 3;
+            default:
+                return 0;
+            }
+        }
+
+        // 根据帧格式填充各平面指针与行跨度
+        void framePlanes(const VIDEO_FRAME_S &vf, uint8_t *base, uint8_t *data[4], int linesize[4])
+        {
+            memset(data, 0, sizeof(uint8_t *) * 4);
+            memset(linesize, 0, sizeof(int) * 4);
+            size_t luma = (size_t)vf.u32VirWidth * vf.u32VirHeight;
+            switch (vf.enPixelFormat)
+            {
+            case RK_FMT_YUV420SP:
+                data[0] = base;
+                data[1] = base + luma;
+                linesize[0] = linesize[1] = vf.u32VirWidth;
+                break;
+            case RK_FMT_YUV420P:
+                data[0] = base;
+                data[1] = base + luma;
+                data[2] = base + luma + luma / 4;
+                linesize[0] = vf.u32VirWidth;
+                linesize[1] = linesize[2] = vf.u32VirWidth / 2;
+                break;
+            case RK_FMT_RGB888:
+            case RK_FMT_BGR888:
+                data[0] = base;
+                linesize[0] = vf.u32VirWidth * 3;
+                break;
+            default:
+                break;
+            }
+        }
+
+        // 按 RK 超时语义等待：-1 无限等待，0 不等待，>0 毫秒
+        template <typename Pred>
+        bool waitFor(std::condition_variable &cv, std::unique_lock<std::mutex> &lock, int timeout, Pred pred)
+        {
+            if (timeout < 0)
+            {
+                cv.wait(lock, pred);
+                return true;
+            }
+            return cv.wait_for(lock, std::chrono::milliseconds(timeout), pred);
+        }
+
+        // 码率控制属性中与 libavcodec 编码器对应的部分
+        struct SimRcSettings
+        {
+            int gop = 60;
+            int bitrate_kbps = 0; // 0 表示固定QP
+            int max_kbps = 0;
+            int fps = 30;         // 输出帧率
+            int src_fps = 30;     // 输入帧率
+            int stat_time_s = 0;  // 码率统计窗口（VBV缓冲 = 最大码率 × 窗口）
+            int fix_qp = 0;       // 固定QP模式的P帧QP
+        };
+
+        template <typename Attr>
+        void parseCommon(const Attr &a, SimRcSettings &rc)
+        {
+            rc.gop = a.u32Gop;
+            rc.fps = a.fr32DstFrameRateNum;
+            rc.src_fps = a.u32SrcFrameRateNum;
+        }
+
+        template <typename Attr>
+        void parseVbr(const Attr &a, SimRcSettings &rc)
+        {
+            parseCommon(a, rc);
+            rc.bitrate_kbps = a.u32BitRate;
+            rc.max_kbps = a.u32MaxBitRate;
+            rc.stat_time_s = a.u32StatTime;
+        }
+
+        template <typename Attr>
+        void parseCbr(const Attr &a, SimRcSettings &rc)
+        {
+            rc.fps = a.fr32DstFrameRateNum;
+            rc.src_fps = a.u32SrcFrameRateNum;
+            rc.bitrate_kbps = rc.max_kbps = a.u32BitRate;
+            rc.stat_time_s = a.u32StatTime;
+        }
+
+        // 从码率控制属性中取出 GOP / 码率(kbps) / 帧率 / 固定QP
+        // AVBR 按VBR模拟（libavcodec 没有静止画面降码率的模式）
+        void parseRcAttr(const VENC_RC_ATTR_S &attr, SimRcSettings &rc)
+        {
+            switch (attr.enRcMode)
+            {
+            case VENC_RC_MODE_H264CBR:
+                parseCbr(attr.stH264Cbr, rc);
+                rc.gop = attr.stH264Cbr.u32Gop;
+                break;
+            case VENC_RC_MODE_H264VBR:
+                parseVbr(attr.stH264Vbr, rc);
+                break;
+            case VENC_RC_MODE_H264AVBR:
+                parseVbr(attr.stH264Avbr, rc);
+                break;
+            case VENC_RC_MODE_H264FIXQP:
+                parseCommon(attr.stH264FixQp, rc);
+                rc.fix_qp = attr.stH264FixQp.u32PQp;
+                break;
+            case VENC_RC_MODE_H265CBR:
+                parseCbr(attr.stH265Cbr, rc);
+                rc.gop = attr.stH265Cbr.u32Gop;
+                break;
+            case VENC_RC_MODE_H265VBR:
+                parseVbr(attr.stH265Vbr, rc);
+                break;
+            case VENC_RC_MODE_H265AVBR:
+                parseVbr(attr.stH265Avbr, rc);
+                break;
+            case VENC_RC_MODE_H265FIXQP:
+                parseCommon(attr.stH265FixQp, rc);
+                rc.fix_qp = attr.stH265FixQp.u32PQp;
+                break;
+            case VENC_RC_MODE_MJPEGCBR:
+                parseCbr(attr.stMjpegCbr, rc);
+                break;
+            default:
+                break;
+            }
+            if (rc.gop <= 0)
+                rc.gop = 60;
+            if (rc.fps <= 0)
+                rc.fps = 30;
+            if (rc.src_fps < rc.fps)
+                rc.src_fps = rc.fps;
+            if (rc.stat_time_s <= 0)
+                rc.stat_time_s = 1;
+        }
+
+        // NAL头 → 包类型（其余NAL按P帧处理）
+        VENC_DATA_TYPE_U nalDataType(RK_CODEC_ID_E codec, uint8_t header, bool key)
+        {
+            VENC_DATA_TYPE_U type;
+            memset(&type, 0, sizeof(type));
+            if (codec == RK_VIDEO_ID_HEVC)
+            {
+                int nal = (header >> 1) & 0x3f;
+                if (nal == 32)
+                    type.enH265EType = H265E_NALU_VPS;
+                else if (nal == 33)
+                    type.enH265EType = H265E_NALU_SPS;
+                else if (nal == 34)
+                    type.enH265EType = H265E_NALU_PPS;
+                else if (nal == 39 || nal == 40)
+                    type.enH265EType = H265E_NALU_SEI;
+                else if (nal == 19 || nal == 20)
+                    type.enH265EType = H265E_NALU_IDRSLICE;
+                else if (nal >= 16 && nal <= 21)
+                    type.enH265EType = H265E_NALU_ISLICE;
+                else
+                    type.enH265EType = H265E_NALU_PSLICE;
+            }
+            else if (codec == RK_VIDEO_ID_AVC)
+            {
+                int nal = header & 0x1f;
+                if (nal == 7)
+                    type.enH264EType = H264E_NALU_SPS;
+                else if (nal == 8)
+                    type.enH264EType = H264E_NALU_PPS;
+                else if (nal == 6)
+                    type.enH264EType = H264E_NALU_SEI;
+                else if (nal == 5)
+                    type.enH264EType = H264E_NALU_IDRSLICE;
+                else
+                    type.enH264EType = H264E_NALU_PSLICE;
+            }
+            else
+            {
+                type.enH264EType = key ? H264E_NALU_IDRSLICE : H264E_NALU_PSLICE;
+            }
+            return type;
+        }
+
+        // 按Annex-B起始码把一帧码流拆成NAL单元，返回各单元的起始位置（含起始码）
+        void splitNalUnits(RK_CODEC_ID_E codec, const uint8_t *data, uint32_t len, std::vector<uint32_t> &starts)
+        {
+            starts.clear();
+            if (codec == RK_VIDEO_ID_AVC || codec == RK_VIDEO_ID_HEVC)
+            {
+                for (uint32_t i = 0; i + 3 <= len; i++)
+                {
+                    if (data[i] == 0 && data[i + 1] == 0 && data[i + 2] == 1)
+                    {
+                        starts.push_back(i > 0 && data[i - 1] == 0 ? i - 1 : i);
+                        i += 2;
+                    }
+                }
+            }
+            if (starts.empty() || starts[0] != 0)
+                starts.insert(starts.begin(), 0);
+        }
+
+        const int kBindPollMs = 100; // 绑定转发线程单次等待时长（用于检查解绑）
+
+        bool sameChn(const MPP_CHN_S &a, const MPP_CHN_S &b)
+        {
+            return a.enModId == b.enModId && a.s32DevId == b.s32DevId && a.s32ChnId == b.s32ChnId;
+        }
+    } // namespace
+
+    MPIBackend &MPIBackend::instance()
+    {
+        return SimMPIBackend::instance();
+    }
+
+    SimMPIBackend &SimMPIBackend::instance()
+    {
+        static SimMPIBackend backend;
+        return backend;
+    }
+
+    SimMPIBackend::SimMPIBackend()
+    {
+        SimBackendConfig config;
+        const char *source = getenv("CAMERA_SIM_SOURCE");
+        if (source)
+            config.source_file = source;
+        const char *fps = getenv("CAMERA_SIM_FPS");
+        if (fps)
+            config.fps = atoi(fps);
+        setConfig(config);
+    }
+
+    SimMPIBackend::~SimMPIBackend()
+    {
+        sysExit();
+        if (source_fp_)
+            fclose(source_fp_);
+    }
+
+    void SimMPIBackend::setConfig(const SimBackendConfig &config)
+    {
+        std::lock_guard<std::mutex> lock(vi_mutex_);
+        config_ = config;
+        if (source_fp_)
+        {
+            fclose(source_fp_);
+            source_fp_ = nullptr;
+        }
+        if (!config_.source_file.empty())
+        {
+            source_fp_ = fopen(config_.source_file.c_str(), "rb");
+            if (!source_fp_)
+                LOGW("SimMPIBackend - open %s failed, fallback to synthetic frames", config_.source_file.c_str());
+        }
+    }
+
+    SimMPIBackend::SimBlock *SimMPIBackend::allocBlock(size_t size)
+    {
+        SimBlock *blk = new SimBlock();
+        blk->data.resize(size);
+        return blk;
+    }
+
+    void SimMPIBackend::freeBlock(MB_BLK blk)
+    {
+        delete static_cast<SimBlock *>(blk);
+    }
+
+    // SYS
+    int SimMPIBackend::sysInit()
+    {
+        LOGI("SimMPIBackend - init (source=%s, fps=%d)",
+             config_.source_file.empty() ? "synthetic" : config_.source_file.c_str(), config_.fps);
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::sysExit()
+    {
+        unbindAll();
+        {
+            std::lock_guard<std::mutex> lock(venc_mutex_);
+            for (auto &item : venc_chns_)
+                closeEncoder(*item.second);
+            venc_chns_.clear();
+        }
+        {
+            std::lock_guard<std::mutex> lock(vpss_mutex_);
+            for (auto &grp : vpss_grps_)
+            {
+                for (auto &chn : grp.second.chns)
+                {
+                    for (auto &f : chn.second.frames)
+                        freeBlock(f.stVFrame.pMbBlk);
+                    sws_freeContext(chn.second.sws);
+                }
+            }
+            vpss_grps_.clear();
+        }
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::sysBind(const MPP_CHN_S &src, const MPP_CHN_S &dst)
+    {
+        bool supported = (src.enModId == RK_ID_VI && dst.enModId == RK_ID_VPSS) ||
+                         (src.enModId == RK_ID_VPSS && dst.enModId == RK_ID_VENC);
+        if (!supported)
+        {
+            LOGE("SimMPIBackend - sysBind mod %d -> %d not supported", src.enModId, dst.enModId);
+            return -1;
+        }
+
+        std::lock_guard<std::mutex> lock(bind_mutex_);
+        for (const auto &b : bindings_)
+        {
+            if (sameChn(b->dst, dst))
+                return -1; // 目的通道只能有一个源
+        }
+        std::unique_ptr<Binding> binding(new Binding());
+        binding->src = src;
+        binding->dst = dst;
+        binding->thread = std::thread(&SimMPIBackend::bindLoop, this, binding.get());
+        bindings_.push_back(std::move(binding));
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::sysUnBind(const MPP_CHN_S &src, const MPP_CHN_S &dst)
+    {
+        std::unique_ptr<Binding> binding;
+        {
+            std::lock_guard<std::mutex> lock(bind_mutex_);
+            for (auto it = bindings_.begin(); it != bindings_.end(); ++it)
+            {
+                if (sameChn((*it)->src, src) && sameChn((*it)->dst, dst))
+                {
+                    binding = std::move(*it);
+                    bindings_.erase(it);
+                    break;
+                }
+            }
+        }
+        if (!binding)
+            return -1;
+        binding->running = false;
+        binding->thread.join();
+        return RK_SUCCESS;
+    }
+
+    void SimMPIBackend::unbindAll()
+    {
+        std::vector<std::unique_ptr<Binding>> bindings;
+        {
+            std::lock_guard<std::mutex> lock(bind_mutex_);
+            bindings.swap(bindings_);
+        }
+        for (auto &b : bindings)
+        {
+            b->running = false;
+            b->thread.join();
+        }
+    }
+
+    // 转发线程：源通道出帧即送往目的通道（目的端满时丢帧，与硬件绑定行为一致），用户态不参与
+    void SimMPIBackend::bindLoop(Binding *binding)
+    {
+        const MPP_CHN_S &src = binding->src;
+        const MPP_CHN_S &dst = binding->dst;
+        while (binding->running)
+        {
+            VIDEO_FRAME_INFO_S frame;
+            int ret = src.enModId == RK_ID_VI
+                          ? viGetChnFrame(src.s32DevId, src.s32ChnId, frame, kBindPollMs)
+                          : vpssGetChnFrame(src.s32DevId, src.s32ChnId, frame, kBindPollMs);
+            if (ret != RK_SUCCESS)
+            {
+                if (ret != (RK_S32)RK_ERR_VI_BUF_EMPTY && ret != (RK_S32)RK_ERR_VPSS_BUF_EMPTY)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10)); // 源通道未就绪
+                continue;
+            }
+
+            if (dst.enModId == RK_ID_VPSS)
+                vpssSendFrame(dst.s32DevId, frame, kBindPollMs);
+            else
+                vencSendFrame(dst.s32ChnId, frame, kBindPollMs);
+
+            if (src.enModId == RK_ID_VI)
+                viReleaseChnFrame(src.s32DevId, src.s32ChnId, frame);
+            else
+                vpssReleaseChnFrame(src.s32DevId, src.s32ChnId, frame);
+        }
+    }
+
+    // MB 内存块：模拟实现中池仅做编号，块按需分配
+    MB_POOL SimMPIBackend::mbCreatePool(MB_POOL_CONFIG_S &)
+    {
+        return next_pool_id_++;
+    }
+
+    int SimMPIBackend::mbDestroyPool(MB_POOL)
+    {
+        return RK_SUCCESS;
+    }
+
+    // 模拟内存池不限制块数，按需分配
+    MB_BLK SimMPIBackend::mbGetMB(MB_POOL, RK_U64 size, bool)
+    {
+        return allocBlock((size_t)size);
+    }
+
+    int SimMPIBackend::mbReleaseMB(MB_BLK blk)
+    {
+        freeBlock(blk);
+        return RK_SUCCESS;
+    }
+
+    void *SimMPIBackend::mbHandle2VirAddr(MB_BLK blk)
+    {
+        return blk ? static_cast<SimBlock *>(blk)->data.data() : nullptr;
+    }
+
+    // VI
+    int SimMPIBackend::viGetDevAttr(VI_DEV, VI_DEV_ATTR_S &)
+    {
+        return RK_ERR_VI_NOT_CONFIG;
+    }
+
+    int SimMPIBackend::viSetDevAttr(VI_DEV, const VI_DEV_ATTR_S &) { return RK_SUCCESS; }
+    int SimMPIBackend::viGetDevIsEnable(VI_DEV) { return -1; }
+    int SimMPIBackend::viEnableDev(VI_DEV) { return RK_SUCCESS; }
+    int SimMPIBackend::viSetDevBindPipe(VI_DEV, const VI_DEV_BIND_PIPE_S &) { return RK_SUCCESS; }
+
+    int SimMPIBackend::viSetChnAttr(VI_PIPE pipe, VI_CHN chn, const VI_CHN_ATTR_S &attr)
+    {
+        std::lock_guard<std::mutex> lock(vi_mutex_);
+        vi_chns_[(pipe << 16) | chn].attr = attr;
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::viEnableChn(VI_PIPE pipe, VI_CHN chn)
+    {
+        std::lock_guard<std::mutex> lock(vi_mutex_);
+        auto it = vi_chns_.find((pipe << 16) | chn);
+        if (it == vi_chns_.end())
+            return RK_ERR_VI_NOT_CONFIG;
+        it->second.enabled = true;
+        it->second.next_due_us = infra::TEST_COMM_GetNowUs();
+        // 每次启用从片头开始（录制文件回到开头、合成画面从第0帧开始），基准程序的各轮输入相同
+        it->second.frame_index = 0;
+        if (source_fp_)
+            rewind(source_fp_);
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::viDisableChn(VI_PIPE pipe, VI_CHN chn)
+    {
+        std::lock_guard<std::mutex> lock(vi_mutex_);
+        auto it = vi_chns_.find((pipe << 16) | chn);
+        if (it != vi_chns_.end())
+            it->second.enabled = false;
+        return RK_SUCCESS;
+    }
+
+    // 生成一帧NV12：优先读取录制文件，否则生成移动渐变+方块的合成画面
+    void SimMPIBackend::fillViFrame(const ViChn &vi, uint8_t *dst)
+    {
+        uint32_t w = vi.attr.stSize.u32Width;
+        uint32_t h = vi.attr.stSize.u32Height;
+        size_t size = (size_t)w * h * 3 / 2;
+
+        if (source_fp_)
+        {
+            if (fread(dst, 1, size, source_fp_) == size)
+                return;
+            rewind(source_fp_); // 循环播放
+            if (fread(dst, 1, size, source_fp_) == size)
+                return;
+        }
+
+        uint32_t shift = (uint32_t)vi.frame_index * 4;
+        for (uint32_t y = 0; y < h; y++)
+        {
+            uint8_t *row = dst + (size_t)y * w;
+            for (uint32_t x = 0; x < w; x++)
+                row[x] = (uint8_t)(x + y + shift);
+        }
+        uint32_t box = h / 4;
+        uint32_t bx = (uint32_t)(vi.frame_index * 8) % (w > box ? w - box : 1);
+        for (uint32_t y = h / 2 - box / 2; y < h / 2 + box / 2; y++)
+            memset(dst + (size_t)y * w + bx, 235, box);
+        memset(dst + (size_t)w * h, 128, (size_t)w * h / 2);
+    }
+
+    int SimMPIBackend::viGetChnFrame(VI_PIPE pipe, VI_CHN chn, VIDEO_FRAME_INFO_S &frame, int timeout)
+    {
+        std::unique_lock<std::mutex> lock(vi_mutex_);
+        auto it = vi_chns_.find((pipe << 16) | chn);
+        if (it == vi_chns_.end() || !it->second.enabled)
+            return RK_ERR_VI_NOT_CONFIG;
+        ViChn &vi = it->second;
+
+        // 按sensor帧率节拍出帧
+        uint64_t now = infra::TEST_COMM_GetNowUs();
+        if (config_.fps > 0)
+        {
+            uint64_t due = vi.next_due_us;
+            if (due > now)
+            {
+                uint64_t wait_us = due - now;
+                if (timeout >= 0 && wait_us > (uint64_t)timeout * 1000)
+                {
+                    lock.unlock();
+                    std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
+                    return RK_ERR_VI_BUF_EMPTY;
+                }
+                lock.unlock();
+                std::this_thread::sleep_for(std::chrono::microseconds(wait_us));
+                lock.lock();
+                now = due;
+            }
+            uint64_t period = 1000000 / config_.fps;
+            vi.next_due_us = std::max(vi.next_due_us + period, now);
+        }
+
+        uint32_t w = vi.attr.stSize.u32Width;
+        uint32_t h = vi.attr.stSize.u32Height;
+        SimBlock *blk = allocBlock((size_t)w * h * 3 / 2);
+        fillViFrame(vi, blk->data.data());
+
+        memset(&frame, 0, sizeof(frame));
+        frame.stVFrame.pMbBlk = blk;
+        frame.stVFrame.u32Width = w;
+        frame.stVFrame.u32Height = h;
+        frame.stVFrame.u32VirWidth = w;
+        frame.stVFrame.u32VirHeight = h;
+        frame.stVFrame.enPixelFormat = RK_FMT_YUV420SP;
+        frame.stVFrame.u64PTS = now;
+        frame.stVFrame.u32TimeRef = (uint32_t)vi.frame_index * 2;
+        vi.frame_index++;
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::viReleaseChnFrame(VI_PIPE, VI_CHN, const VIDEO_FRAME_INFO_S &frame)
+    {
+        freeBlock(frame.stVFrame.pMbBlk);
+        return RK_SUCCESS;
+    }
+
+    // VPSS
+    int SimMPIBackend::vpssCreateGrp(VPSS_GRP grp, const VPSS_GRP_ATTR_S &attr)
+    {
+        std::lock_guard<std::mutex> lock(vpss_mutex_);
+        vpss_grps_[grp].attr = attr;
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::vpssDestroyGrp(VPSS_GRP grp)
+    {
+        std::lock_guard<std::mutex> lock(vpss_mutex_);
+        auto it = vpss_grps_.find(grp);
+        if (it == vpss_grps_.end())
+            return RK_ERR_VPSS_UNEXIST;
+        for (auto &chn : it->second.chns)
+        {
+            for (auto &f : chn.second.frames)
+                freeBlock(f.stVFrame.pMbBlk);
+            sws_freeContext(chn.second.sws);
+        }
+        vpss_grps_.erase(it);
+        vpss_cv_.notify_all();
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::vpssStartGrp(VPSS_GRP grp)
+    {
+        std::lock_guard<std::mutex> lock(vpss_mutex_);
+        auto it = vpss_grps_.find(grp);
+        if (it == vpss_grps_.end())
+            return RK_ERR_VPSS_UNEXIST;
+        it->second.started = true;
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::vpssStopGrp(VPSS_GRP grp)
+    {
+        std::lock_guard<std::mutex> lock(vpss_mutex_);
+        auto it = vpss_grps_.find(grp);
+        if (it == vpss_grps_.end())
+            return RK_ERR_VPSS_UNEXIST;
+        it->second.started = false;
+        vpss_cv_.notify_all();
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::vpssSetChnAttr(VPSS_GRP grp, VPSS_CHN chn, const VPSS_CHN_ATTR_S &attr)
+    {
+        std::lock_guard<std::mutex> lock(vpss_mutex_);
+        auto it = vpss_grps_.find(grp);
+        if (it == vpss_grps_.end())
+            return RK_ERR_VPSS_UNEXIST;
+        if (toAVPixelFormat(attr.enPixelFormat) == AV_PIX_FMT_NONE)
+        {
+            LOGE("SimMPIBackend - VPSS unsupported pixel format %d", attr.enPixelFormat);
+            return -1;
+        }
+        it->second.chns[chn].attr = attr;
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::vpssEnableChn(VPSS_GRP grp, VPSS_CHN chn)
+    {
+        std::lock_guard<std::mutex> lock(vpss_mutex_);
+        auto it = vpss_grps_.find(grp);
+        if (it == vpss_grps_.end() || !it->second.chns.count(chn))
+            return RK_ERR_VPSS_UNEXIST;
+        it->second.chns[chn].enabled = true;
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::vpssDisableChn(VPSS_GRP grp, VPSS_CHN chn)
+    {
+        std::lock_guard<std::mutex> lock(vpss_mutex_);
+        auto it = vpss_grps_.find(grp);
+        if (it == vpss_grps_.end() || !it->second.chns.count(chn))
+            return RK_ERR_VPSS_UNEXIST;
+        it->second.chns[chn].enabled = false;
+        vpss_cv_.notify_all();
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::vpssEnableBackupFrame(VPSS_GRP) { return RK_SUCCESS; }
+    int SimMPIBackend::vpssDisableBackupFrame(VPSS_GRP) { return RK_SUCCESS; }
+
+    int SimMPIBackend::vpssSendFrame(VPSS_GRP grp, const VIDEO_FRAME_INFO_S &frame, int)
+    {
+        const VIDEO_FRAME_S &in = frame.stVFrame;
+        uint8_t *src_data[4];
+        int src_linesize[4];
+        framePlanes(in, (uint8_t *)mbHandle2VirAddr(in.pMbBlk), src_data, src_linesize);
+
+        std::lock_guard<std::mutex> lock(vpss_mutex_);
+        auto it = vpss_grps_.find(grp);
+        if (it == vpss_grps_.end() || !it->second.started)
+            return RK_ERR_VPSS_UNEXIST;
+
+        for (auto &item : it->second.chns)
+        {
+            VpssChn &chn = item.second;
+            if (!chn.enabled)
+                continue;
+
+            // 帧率控制：src→dst 均匀抽帧
+            int src_fps = chn.attr.stFrameRate.s32SrcFrameRate;
+            int dst_fps = chn.attr.stFrameRate.s32DstFrameRate;
+            if (src_fps > 0 && dst_fps > 0 && dst_fps < src_fps)
+            {
+                chn.fps_acc += dst_fps;
+                if (chn.fps_acc < src_fps)
+                    continue;
+                chn.fps_acc -= src_fps;
+            }
+
+            uint32_t w = chn.attr.u32Width;
+            uint32_t h = chn.attr.u32Height;
+            chn.sws = sws_getCachedContext(chn.sws,
+                                           in.u32Width, in.u32Height, toAVPixelFormat(in.enPixelFormat),
+                                           w, h, toAVPixelFormat(chn.attr.enPixelFormat),
+                                           SWS_BILINEAR, nullptr, nullptr, nullptr);
+            if (!chn.sws)
+            {
+                LOGE("SimMPIBackend - VPSS sws_getCachedContext failed");
+                continue;
+            }
+
+            VIDEO_FRAME_INFO_S out;
+            memset(&out, 0, sizeof(out));
+            out.stVFrame = in;
+            out.stVFrame.u32Width = w;
+            out.stVFrame.u32Height = h;
+            out.stVFrame.u32VirWidth = w;
+            out.stVFrame.u32VirHeight = h;
+            out.stVFrame.enPixelFormat = chn.attr.enPixelFormat;
+            SimBlock *blk = allocBlock(frameBytes(chn.attr.enPixelFormat, w, h));
+            out.stVFrame.pMbBlk = blk;
+
+            uint8_t *dst_data[4];
+            int dst_linesize[4];
+            framePlanes(out.stVFrame, blk->data.data(), dst_data, dst_linesize);
+            sws_scale(chn.sws, src_data, src_linesize, 0, in.u32Height, dst_data, dst_linesize);
+
+            // 输出队列深度受 u32Depth 限制，满则丢最旧帧
+            size_t depth = chn.attr.u32Depth > 0 ? chn.attr.u32Depth : 1;
+            while (chn.frames.size() >= depth)
+            {
+                freeBlock(chn.frames.front().stVFrame.pMbBlk);
+                chn.frames.pop_front();
+            }
+            chn.frames.push_back(out);
+        }
+        vpss_cv_.notify_all();
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::vpssGetChnFrame(VPSS_GRP grp, VPSS_CHN chn, VIDEO_FRAME_INFO_S &frame, int timeout)
+    {
+        std::unique_lock<std::mutex> lock(vpss_mutex_);
+        auto ready = [&]()
+        {
+            auto git = vpss_grps_.find(grp);
+            if (git == vpss_grps_.end() || !git->second.started)
+                return true;
+            auto cit = git->second.chns.find(chn);
+            return cit == git->second.chns.end() || !cit->second.enabled || !cit->second.frames.empty();
+        };
+        if (!waitFor(vpss_cv_, lock, timeout, ready))
+            return RK_ERR_VPSS_BUF_EMPTY;
+
+        auto git = vpss_grps_.find(grp);
+        if (git == vpss_grps_.end() || !git->second.started)
+            return RK_ERR_VPSS_UNEXIST;
+        auto cit = git->second.chns.find(chn);
+        if (cit == git->second.chns.end() || !cit->second.enabled)
+            return RK_ERR_VPSS_UNEXIST;
+
+        frame = cit->second.frames.front();
+        cit->second.frames.pop_front();
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::vpssReleaseChnFrame(VPSS_GRP, VPSS_CHN, const VIDEO_FRAME_INFO_S &frame)
+    {
+        freeBlock(frame.stVFrame.pMbBlk);
+        return RK_SUCCESS;
+    }
+
+    // VENC
+    // 相对QP区域转为 AVRegionOfInterest（qoffset × 51 即QP偏移，H.264/H.265 相同）
+    // 硬件上索引大的区域覆盖索引小的，libavcodec 以数组中靠前的为准，因此倒序填入
+    void SimMPIBackend::setFrameRoi(AVFrame *frame, const VENC_ROI_ATTR_S *roi, RK_CODEC_ID_E type)
+    {
+        av_frame_remove_side_data(frame, AV_FRAME_DATA_REGIONS_OF_INTEREST);
+        if (type != RK_VIDEO_ID_AVC && type != RK_VIDEO_ID_HEVC)
+            return;
+        int count = 0;
+        for (int i = 0; i < kSimMaxRoi; i++)
+            count += roi[i].bEnable && !roi[i].bAbsQp ? 1 : 0;
+        if (count == 0)
+            return;
+        AVFrameSideData *sd = av_frame_new_side_data(frame, AV_FRAME_DATA_REGIONS_OF_INTEREST,
+                                                     sizeof(AVRegionOfInterest) * count);
+        if (!sd)
+            return;
+        AVRegionOfInterest *out = (AVRegionOfInterest *)sd->data;
+        for (int i = kSimMaxRoi - 1; i >= 0; i--)
+        {
+            if (!roi[i].bEnable || roi[i].bAbsQp)
+                continue;
+            const RECT_S &rect = roi[i].stRect;
+            out->self_size = sizeof(AVRegionOfInterest);
+            out->left = rect.s32X;
+            out->top = rect.s32Y;
+            out->right = rect.s32X + (int)rect.u32Width;
+            out->bottom = rect.s32Y + (int)rect.u32Height;
+            out->qoffset = av_make_q(roi[i].s32Qp, 51);
+            out++;
+        }
+    }
+
+    int SimMPIBackend::openCodec(VencChn &venc, const VENC_CHN_ATTR_S &attr, const VENC_RC_PARAM_S &param)
+    {
+        const VENC_ATTR_S &va = attr.stVencAttr;
+        const AVCodec *codec = nullptr;
+        switch (va.enType)
+        {
+        case RK_VIDEO_ID_HEVC:
+            codec = avcodec_find_encoder_by_name("libx265");
+            if (!codec)
+                codec = avcodec_find_encoder(AV_CODEC_ID_HEVC);
+            break;
+        case RK_VIDEO_ID_AVC:
+            codec = avcodec_find_encoder_by_name("libx264");
+            if (!codec)
+                codec = avcodec_find_encoder(AV_CODEC_ID_H264);
+            break;
+        case RK_VIDEO_ID_MJPEG:
+            codec = avcodec_find_encoder(AV_CODEC_ID_MJPEG);
+            break;
+        default:
+            break;
+        }
+        if (!codec)
+        {
+            LOGE("SimMPIBackend - no libavcodec encoder for type %d", va.enType);
+            return -1;
+        }
+
+        SimRcSettings rc;
+        parseRcAttr(attr.stRcAttr, rc);
+
+        venc.ctx = avcodec_alloc_context3(codec);
+        if (!venc.ctx)
+            return -1;
+        venc.ctx->width = va.u32PicWidth;
+        venc.ctx->height = va.u32PicHeight;
+        venc.ctx->pix_fmt = va.enType == RK_VIDEO_ID_MJPEG ? AV_PIX_FMT_YUVJ420P : AV_PIX_FMT_YUV420P;
+        venc.ctx->time_base = (AVRational){1, 1000000}; // u64PTS 为微秒
+        venc.ctx->framerate = (AVRational){rc.fps, 1};
+        // 智能P帧：IDR间隔取 u32Gop；libavcodec 无法指定长期参考帧，虚拟I帧按普通P帧编码
+        // （板端虚拟I帧比P帧大，模拟结果是智能P帧节省码率的上限）
+        venc.ctx->gop_size = rc.gop;
+        venc.ctx->max_b_frames = 0; // 与硬件一致：无B帧、无重排
+        if (rc.fix_qp > 0)
+        {
+            av_opt_set_int(venc.ctx->priv_data, "qp", rc.fix_qp, 0);
+        }
+        else
+        {
+            venc.ctx->bit_rate = (int64_t)rc.bitrate_kbps * 1000;
+            venc.ctx->rc_max_rate = (int64_t)rc.max_kbps * 1000;
+            venc.ctx->rc_buffer_size = (int)(venc.ctx->rc_max_rate * rc.stat_time_s);
+        }
+        // QP上下限与I帧QP差（H.264/H.265 参数结构相同；QP差6对应码率约2倍）
+        const VENC_PARAM_H265_S &qp = va.enType == RK_VIDEO_ID_AVC ? param.stParamH264 : param.stParamH265;
+        if (qp.u32MinQp > 0)
+            venc.ctx->qmin = qp.u32MinQp;
+        if (qp.u32MaxQp > 0)
+            venc.ctx->qmax = qp.u32MaxQp;
+        // ultrafast 预设关闭了自适应量化，libx264/libx265 随之忽略 ROI，这里重新打开
+        char x265_params[64] = "aq-mode=1";
+        av_opt_set_int(venc.ctx->priv_data, "aq-mode", 1, 0); // libx264
+        if (qp.s32DeltIpQp != 0)
+        {
+            double ip_ratio = pow(2.0, -qp.s32DeltIpQp / 6.0);
+            venc.ctx->i_quant_factor = (float)(1.0 / ip_ratio); // libx264
+            snprintf(x265_params, sizeof(x265_params), "aq-mode=1:ipratio=%.2f", ip_ratio);
+        }
+        av_opt_set(venc.ctx->priv_data, "x265-params", x265_params, 0);
+        av_opt_set(venc.ctx->priv_data, "preset", "ultrafast", 0);
+        av_opt_set(venc.ctx->priv_data, "tune", "zerolatency", 0);
+        av_opt_set(venc.ctx->priv_data, "forced-idr", "1", 0); // 强制I帧编码为IDR（RequestIDR）
+
+        int ret = avcodec_open2(venc.ctx, codec, nullptr);
+        if (ret < 0)
+        {
+            char errbuf[AV_ERROR_MAX_STRING_SIZE] = {0};
+            av_strerror(ret, errbuf, sizeof(errbuf));
+            LOGE("SimMPIBackend - avcodec_open2(%s) failed: %s", codec->name, errbuf);
+            avcodec_free_context(&venc.ctx);
+            return -1;
+        }
+        venc.src_fps = rc.src_fps;
+        venc.dst_fps = rc.fps;
+        venc.fps_acc = 0;
+
+        LOGI("SimMPIBackend - encoder %s %dx%d gop=%d%s bitrate=%dkbps fixqp=%d fps=%d/%d",
+             codec->name, venc.ctx->width, venc.ctx->height, rc.gop,
+             attr.stGopAttr.enGopMode == VENC_GOPMODE_SMARTP ? "(smartp)" : "", rc.bitrate_kbps, rc.fix_qp, rc.fps, rc.src_fps);
+        return 0;
+    }
+
+    int SimMPIBackend::openEncoder(VencChn &venc)
+    {
+        if (openCodec(venc, venc.attr, venc.rc_param) != 0)
+            return -1;
+
+        venc.frame = av_frame_alloc();
+        venc.frame->format = venc.ctx->pix_fmt;
+        venc.frame->width = venc.ctx->width;
+        venc.frame->height = venc.ctx->height;
+        if (av_frame_get_buffer(venc.frame, 0) < 0)
+        {
+            closeEncoder(venc);
+            return -1;
+        }
+        return 0;
+    }
+
+    void SimMPIBackend::closeEncoder(VencChn &venc)
+    {
+        for (auto &s : venc.streams)
+            freeBlock(s.blk);
+        venc.streams.clear();
+        if (venc.efd >= 0)
+        {
+            close(venc.efd);
+            venc.efd = -1;
+        }
+        if (venc.frame)
+            av_frame_free(&venc.frame);
+        if (venc.ctx)
+            avcodec_free_context(&venc.ctx);
+        sws_freeContext(venc.sws);
+        venc.sws = nullptr;
+    }
+
+    int SimMPIBackend::vencCreateChn(VENC_CHN chn, const VENC_CHN_ATTR_S &attr)
+    {
+        std::unique_ptr<VencChn> venc(new VencChn());
+        venc->attr = attr;
+        memset(&venc->rc_param, 0, sizeof(venc->rc_param));
+        memset(venc->roi, 0, sizeof(venc->roi));
+        if (openEncoder(*venc) != 0)
+            return -1;
+        venc->efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        std::lock_guard<std::mutex> lock(venc_mutex_);
+        if (venc_chns_.count(chn))
+        {
+            closeEncoder(*venc);
+            return RK_ERR_VENC_NOT_PERM;
+        }
+        venc_chns_[chn] = std::move(venc);
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::vencDestroyChn(VENC_CHN chn)
+    {
+        std::unique_ptr<VencChn> venc;
+        {
+            std::lock_guard<std::mutex> lock(venc_mutex_);
+            auto it = venc_chns_.find(chn);
+            if (it == venc_chns_.end())
+                return RK_ERR_VENC_UNEXIST;
+            venc = std::move(it->second);
+            venc_chns_.erase(it);
+            venc->recv = false;
+            venc_cv_.notify_all();
+        }
+
+        // 先移出通道表再等待进行中的编码结束，避免与 vencSendFrame 的加锁顺序相反
+        std::lock_guard<std::mutex> encode_lock(venc->encode_mutex);
+        closeEncoder(*venc);
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::vencStartRecvFrame(VENC_CHN chn, const VENC_RECV_PIC_PARAM_S &)
+    {
+        std::lock_guard<std::mutex> lock(venc_mutex_);
+        auto it = venc_chns_.find(chn);
+        if (it == venc_chns_.end())
+            return RK_ERR_VENC_UNEXIST;
+        it->second->recv = true;
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::vencStopRecvFrame(VENC_CHN chn)
+    {
+        std::lock_guard<std::mutex> lock(venc_mutex_);
+        auto it = venc_chns_.find(chn);
+        if (it == venc_chns_.end())
+            return RK_ERR_VENC_UNEXIST;
+        it->second->recv = false;
+        venc_cv_.notify_all();
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::vencSendFrame(VENC_CHN chn, const VIDEO_FRAME_INFO_S &frame, int timeout)
+    {
+        std::unique_lock<std::mutex> lock(venc_mutex_);
+        auto it = venc_chns_.find(chn);
+        if (it == venc_chns_.end())
+            return RK_ERR_VENC_UNEXIST;
+        VencChn &venc = *it->second;
+        if (!venc.recv)
+            return RK_ERR_VENC_NOT_PERM;
+
+        // 码流缓冲耗尽时阻塞，等价于硬件的 u32StreamBufCnt 反压
+        uint32_t buf_cnt = venc.attr.stVencAttr.u32StreamBufCnt > 0 ? venc.attr.stVencAttr.u32StreamBufCnt : 1;
+        if (!waitFor(venc_cv_, lock, timeout, [&]()
+                     { return !venc.recv || venc.outstanding + venc.streams.size() < buf_cnt; }))
+            return RK_ERR_VENC_BUF_FULL;
+        if (!venc.recv)
+            return RK_ERR_VENC_NOT_PERM;
+
+        std::lock_guard<std::mutex> encode_lock(venc.encode_mutex);
+        bool force_idr = venc.force_idr;
+        venc.force_idr = false;
+        bool reconfigure = venc.reconfigure;
+        venc.reconfigure = false;
+        VENC_CHN_ATTR_S attr = venc.attr;
+        VENC_RC_PARAM_S rc_param = venc.rc_param;
+        bool roi_changed = venc.roi_changed;
+        venc.roi_changed = false;
+        VENC_ROI_ATTR_S roi[kSimMaxRoi];
+        memcpy(roi, venc.roi, sizeof(roi));
+        lock.unlock();
+
+        // 码率控制参数已修改：按新参数重建编码器（输入帧缓冲不变）；新编码器打开失败时保留旧的继续编码
+        if (reconfigure)
+        {
+            AVCodecContext *old_ctx = venc.ctx;
+            venc.ctx = nullptr;
+            if (openCodec(venc, attr, rc_param) != 0)
+            {
+                LOGW("SimMPIBackend - VENC chn%d reconfigure failed, keep previous encoder", chn);
+                venc.ctx = old_ctx;
+            }
+            else
+            {
+                avcodec_free_context(&old_ctx);
+            }
+        }
+
+        // 输出帧率低于输入帧率时按比例丢帧（重建后的帧率生效）；
+        // 丢弃的帧上取出的 IDR 请求与 ROI 修改留给下一个编码帧，不能随丢帧丢失
+        if (venc.dst_fps < venc.src_fps)
+        {
+            venc.fps_acc += venc.dst_fps;
+            if (venc.fps_acc < venc.src_fps)
+            {
+                lock.lock();
+                venc.force_idr = venc.force_idr || force_idr;
+                venc.roi_changed = venc.roi_changed || roi_changed || reconfigure;
+                return RK_SUCCESS;
+            }
+            venc.fps_acc -= venc.src_fps;
+        }
+
+        const VIDEO_FRAME_S &in = frame.stVFrame;
+        uint8_t *src_data[4];
+        int src_linesize[4];
+        framePlanes(in, (uint8_t *)mbHandle2VirAddr(in.pMbBlk), src_data, src_linesize);
+
+        venc.sws = sws_getCachedContext(venc.sws,
+                                        in.u32Width, in.u32Height, toAVPixelFormat(in.enPixelFormat),
+                                        venc.ctx->width, venc.ctx->height, venc.ctx->pix_fmt,
+                                        SWS_BILINEAR, nullptr, nullptr, nullptr);
+        if (!venc.sws || av_frame_make_writable(venc.frame) < 0)
+            return -1;
+        sws_scale(venc.sws, src_data, src_linesize, 0, in.u32Height, venc.frame->data, venc.frame->linesize);
+        venc.frame->pts = (int64_t)in.u64PTS;
+        venc.frame->pict_type = force_idr ? AV_PICTURE_TYPE_I : AV_PICTURE_TYPE_NONE;
+        // 编码输入帧复用，ROI side data 保留到下一次修改；重建编码器后重新设置
+        if (roi_changed || reconfigure)
+            setFrameRoi(venc.frame, roi, attr.stVencAttr.enType);
+
+        int ret = avcodec_send_frame(venc.ctx, venc.frame);
+        if (ret < 0)
+            return ret;
+
+        AVPacket *pkt = av_packet_alloc();
+        std::vector<uint32_t> nal_starts;
+        while (avcodec_receive_packet(venc.ctx, pkt) == 0)
+        {
+            VencStream s;
+            s.blk = allocBlock(pkt->size);
+            memcpy(s.blk->data.data(), pkt->data, pkt->size);
+            s.len = pkt->size;
+            s.pts = pkt->pts;
+            s.key = (pkt->flags & AV_PKT_FLAG_KEY) != 0;
+            // 与硬件一致按NAL分包，每个包从起始码开始、到下一个起始码为止
+            RK_CODEC_ID_E codec = venc.attr.stVencAttr.enType;
+            const uint8_t *data = s.blk->data.data();
+            splitNalUnits(codec, data, s.len, nal_starts);
+            for (size_t i = 0; i < nal_starts.size(); i++)
+            {
+                VencPackDesc pack;
+                pack.offset = nal_starts[i];
+                pack.end = i + 1 < nal_starts.size() ? nal_starts[i + 1] : s.len;
+                uint32_t header = pack.offset;
+                while (header < pack.end && data[header] == 0)
+                    header++;
+                header++; // 跳过起始码末尾的 0x01
+                pack.type = nalDataType(codec, header < pack.end ? data[header] : 0, s.key);
+                s.packs.push_back(pack);
+            }
+            av_packet_unref(pkt);
+
+            std::lock_guard<std::mutex> stream_lock(venc_mutex_);
+            venc.streams.push_back(s);
+            uint64_t one = 1;
+            if (venc.efd >= 0 && write(venc.efd, &one, sizeof(one)) < 0)
+                LOGW("SimMPIBackend - VENC fd notify failed");
+            venc_cv_.notify_all();
+        }
+        av_packet_free(&pkt);
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::vencGetStream(VENC_CHN chn, VENC_STREAM_S &stream, int timeout)
+    {
+        if (!stream.pstPack)
+            return RK_ERR_VENC_NULL_PTR;
+
+        std::unique_lock<std::mutex> lock(venc_mutex_);
+        auto it = venc_chns_.find(chn);
+        if (it == venc_chns_.end())
+            return RK_ERR_VENC_UNEXIST;
+        VencChn &venc = *it->second;
+
+        if (!waitFor(venc_cv_, lock, timeout, [&]()
+                     { return !venc.recv || !venc.streams.empty(); }))
+            return RK_ERR_VENC_BUF_EMPTY;
+        if (venc.streams.empty())
+            return RK_ERR_VENC_BUF_EMPTY;
+
+        // 与硬件一致：pstPack 的个数由调用方按 u32CurPacks 准备，不足时不取出码流
+        if (stream.u32PackCount < venc.streams.front().packs.size())
+            return RK_ERR_VENC_ILLEGAL_PARAM;
+
+        VencStream s = venc.streams.front();
+        venc.streams.pop_front();
+        venc.outstanding++;
+        if (venc.streams.empty() && venc.efd >= 0)
+        {
+            uint64_t count;
+            if (read(venc.efd, &count, sizeof(count)) < 0)
+                count = 0; // 计数已为0
+        }
+
+        // 各包共用同一内存块，与 Rockit 一致：u32Offset 为包在块内的起始位置，u32Len 为包的数据长度
+        for (size_t i = 0; i < s.packs.size(); i++)
+        {
+            VENC_PACK_S &pack = stream.pstPack[i];
+            memset(&pack, 0, sizeof(pack));
+            pack.pMbBlk = s.blk;
+            pack.u32Offset = s.packs[i].offset;
+            pack.u32Len = s.packs[i].end - s.packs[i].offset;
+            pack.u64PTS = s.pts;
+            pack.bFrameEnd = i + 1 == s.packs.size() ? RK_TRUE : RK_FALSE;
+            pack.DataType = s.packs[i].type;
+        }
+        stream.u32PackCount = s.packs.size();
+        stream.u32Seq = venc.seq++;
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::vencReleaseStream(VENC_CHN chn, VENC_STREAM_S &stream)
+    {
+        std::lock_guard<std::mutex> lock(venc_mutex_);
+        for (uint32_t i = 0; i < stream.u32PackCount; i++)
+        {
+            // 同一帧的各包共用内存块，只释放一次
+            if (i == 0 || stream.pstPack[i].pMbBlk != stream.pstPack[i - 1].pMbBlk)
+                freeBlock(stream.pstPack[i].pMbBlk);
+        }
+
+        auto it = venc_chns_.find(chn);
+        if (it == venc_chns_.end())
+            return RK_ERR_VENC_UNEXIST;
+        if (it->second->outstanding > 0)
+            it->second->outstanding--;
+        venc_cv_.notify_all();
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::vencGetChnAttr(VENC_CHN chn, VENC_CHN_ATTR_S &attr)
+    {
+        std::lock_guard<std::mutex> lock(venc_mutex_);
+        auto it = venc_chns_.find(chn);
+        if (it == venc_chns_.end())
+            return RK_ERR_VENC_UNEXIST;
+        attr = it->second->attr;
+        return RK_SUCCESS;
+    }
+
+    // 与硬件一致，运行中只能修改码率控制参数，分辨率/编码格式变化需重建通道
+    int SimMPIBackend::vencSetChnAttr(VENC_CHN chn, const VENC_CHN_ATTR_S &attr)
+    {
+        std::lock_guard<std::mutex> lock(venc_mutex_);
+        auto it = venc_chns_.find(chn);
+        if (it == venc_chns_.end())
+            return RK_ERR_VENC_UNEXIST;
+        VencChn &venc = *it->second;
+        const VENC_ATTR_S &cur = venc.attr.stVencAttr;
+        if (attr.stVencAttr.enType != cur.enType || attr.stVencAttr.u32PicWidth != cur.u32PicWidth ||
+            attr.stVencAttr.u32PicHeight != cur.u32PicHeight)
+            return RK_ERR_VENC_NOT_PERM;
+        venc.attr.stRcAttr = attr.stRcAttr;
+        venc.attr.stGopAttr = attr.stGopAttr;
+        venc.reconfigure = true;
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::vencGetRcParam(VENC_CHN chn, VENC_RC_PARAM_S &param)
+    {
+        std::lock_guard<std::mutex> lock(venc_mutex_);
+        auto it = venc_chns_.find(chn);
+        if (it == venc_chns_.end())
+            return RK_ERR_VENC_UNEXIST;
+        param = it->second->rc_param;
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::vencSetRcParam(VENC_CHN chn, const VENC_RC_PARAM_S &param)
+    {
+        std::lock_guard<std::mutex> lock(venc_mutex_);
+        auto it = venc_chns_.find(chn);
+        if (it == venc_chns_.end())
+            return RK_ERR_VENC_UNEXIST;
+        it->second->rc_param = param;
+        it->second->reconfigure = true;
+        return RK_SUCCESS;
+    }
+
+    // 绝对QP与强制帧内在 libavcodec 中没有对应参数：保存但不影响编码
+    int SimMPIBackend::vencSetRoiAttr(VENC_CHN chn, const VENC_ROI_ATTR_S &attr)
+    {
+        if (attr.u32Index >= (RK_U32)kSimMaxRoi)
+            return RK_ERR_VENC_ILLEGAL_PARAM;
+        std::lock_guard<std::mutex> lock(venc_mutex_);
+        auto it = venc_chns_.find(chn);
+        if (it == venc_chns_.end())
+            return RK_ERR_VENC_UNEXIST;
+        it->second->roi[attr.u32Index] = attr;
+        it->second->roi_changed = true;
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::vencGetRoiAttr(VENC_CHN chn, RK_U32 index, VENC_ROI_ATTR_S &attr)
+    {
+        if (index >= (RK_U32)kSimMaxRoi)
+            return RK_ERR_VENC_ILLEGAL_PARAM;
+        std::lock_guard<std::mutex> lock(venc_mutex_);
+        auto it = venc_chns_.find(chn);
+        if (it == venc_chns_.end())
+            return RK_ERR_VENC_UNEXIST;
+        attr = it->second->roi[index];
+        attr.u32Index = index;
+        return RK_SUCCESS;
+    }
+
+    // 模拟后端按帧编码，instant 与否都在下一次送帧时生效
+    int SimMPIBackend::vencRequestIDR(VENC_CHN chn, bool)
+    {
+        std::lock_guard<std::mutex> lock(venc_mutex_);
+        auto it = venc_chns_.find(chn);
+        if (it == venc_chns_.end())
+            return RK_ERR_VENC_UNEXIST;
+        it->second->force_idr = true;
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::vencQueryStatus(VENC_CHN chn, VENC_CHN_STATUS_S &status)
+    {
+        std::lock_guard<std::mutex> lock(venc_mutex_);
+        auto it = venc_chns_.find(chn);
+        if (it == venc_chns_.end())
+            return RK_ERR_VENC_UNEXIST;
+        const VencChn &venc = *it->second;
+        memset(&status, 0, sizeof(status));
+        status.u32LeftStreamFrames = venc.streams.size();
+        for (const VencStream &s : venc.streams)
+            status.u32LeftStreamBytes += s.len;
+        status.u32CurPacks = venc.streams.empty() ? 0 : venc.streams.front().packs.size();
+        return RK_SUCCESS;
+    }
+
+    int SimMPIBackend::vencGetFd(VENC_CHN chn)
+    {
+        std::lock_guard<std::mutex> lock(venc_mutex_);
+        auto it = venc_chns_.find(chn);
+        if (it == venc_chns_.end())
+            return -1;
+        return it->second->efd;
+    }
+
+    // fd 随通道销毁关闭
+    int SimMPIBackend::vencCloseFd(VENC_CHN)
+    {
+        return RK_SUCCESS;
+    }
+
+} // namespace driver
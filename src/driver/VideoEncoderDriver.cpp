@@ -1,4 +1,6 @@
 #include "driver/VideoEncoderDriver.hpp"
+#include "driver/MPIBackend.hpp"
+#include <algorithm>
 #include <cstring>
 
 extern "C"
@@ -11,7 +13,7 @@ namespace driver
 {
 
     // 构造函数：初始化配置参数（必选参数通过构造函数传入，避免硬编码）
-    VideoEncoderDriver::VideoEncoderDriver()
+    VideoEncoderDriver::VideoEncoderDriver() : mpi_(MPIBackend::instance())
     {
         // 初始化结构体（避免野值）
         memset(&st_attr_, 0, sizeof(VENC_CHN_ATTR_S));
@@ -22,94 +24,413 @@ namespace driver
     VideoEncoderDriver::~VideoEncoderDriver()
     {
         // 停止帧接收 + 销毁编码通道（逆初始化）
-        RK_MPI_VENC_StopRecvFrame(venc_config_.chn_id);
-        RK_MPI_VENC_DestroyChn(venc_config_.chn_id);
+        mpi_.vencStopRecvFrame(venc_config_.chn_id);
+        mpi_.vencDestroyChn(venc_config_.chn_id);
     }
 
     // 对外初始化接口：按顺序执行配置→创建通道→启动接收
     int VideoEncoderDriver::init(driver::VideoEncoderConfig &config)
     {
+        venc_config_ = config;
+
         // 1. 配置编码参数
         configRcParams();
         configCommonAttr();
 
         // 2. 创建编码通道
-        int ret = RK_MPI_VENC_CreateChn(venc_config_.chn_id, &st_attr_);
+        int ret = mpi_.vencCreateChn(venc_config_.chn_id, st_attr_);
         if (ret != RK_SUCCESS)
         {
             LOGE("createVencChn\n", ret);
             return ret;
         }
 
-        LOGI("VideoEncoderDriver::init - VENC chn%d init success (type=%d, %dx%d)",
-             venc_config_.chn_id, venc_config_.en_type, venc_config_.width, venc_config_.height);
+        ret = applyRcParam(rc_);
+        if (ret != RK_SUCCESS)
+            LOGW("VideoEncoderDriver::init - VENC chn%d set qp range failed, ret=%#x", venc_config_.chn_id, ret);
+
+        LOGI("VideoEncoderDriver::init - VENC chn%d init success (type=%d, %dx%d, fmt=%d, rc=%s, gop=%s)",
+             venc_config_.chn_id, venc_config_.en_type, venc_config_.width, venc_config_.height,
+             venc_config_.pixel_format, rcModeName(rc_.mode), gopModeName(rc_.gop_mode));
         return RK_SUCCESS;
     }
 
     int VideoEncoderDriver::start()
     {
         recv_param_.s32RecvPicNum = -1; // 无限接收帧
-        return RK_MPI_VENC_StartRecvFrame(venc_config_.chn_id, &recv_param_);
+        return mpi_.vencStartRecvFrame(venc_config_.chn_id, recv_param_);
     }
 
     int VideoEncoderDriver::stop()
     {
-        return RK_MPI_VENC_StopRecvFrame(venc_config_.chn_id);
+        return mpi_.vencStopRecvFrame(venc_config_.chn_id);
     }
 
     // 向VENC发送原始帧（封装 RK_MPI_VENC_SendFrame）
     int VideoEncoderDriver::sendFrame(const VIDEO_FRAME_INFO_S &frame, int timeout)
     {
-        return RK_MPI_VENC_SendFrame(venc_config_.chn_id, &frame, timeout);
+        return mpi_.vencSendFrame(venc_config_.chn_id, frame, timeout);
     }
 
     // 从VENC获取编码流（封装 RK_MPI_VENC_GetStream）
     int VideoEncoderDriver::getStream(VENC_STREAM_S &stream, int timeout)
     {
-        return RK_MPI_VENC_GetStream(venc_config_.chn_id, &stream, timeout);
+        return mpi_.vencGetStream(venc_config_.chn_id, stream, timeout);
     }
 
     // 释放VENC编码流（封装 RK_MPI_VENC_ReleaseStream）
     void VideoEncoderDriver::releaseStream(const VENC_STREAM_S &stream)
     {
-        RK_MPI_VENC_ReleaseStream(venc_config_.chn_id, const_cast<VENC_STREAM_S *>(&stream));
+        mpi_.vencReleaseStream(venc_config_.chn_id, const_cast<VENC_STREAM_S &>(stream));
     }
 
-    // 私有辅助函数：按编码格式配置码率控制参数（原venc_init的分支逻辑）
-    void VideoEncoderDriver::configRcParams()
+    int VideoEncoderDriver::requestIDR(bool instant)
     {
-        if (venc_config_.en_type == RK_VIDEO_ID_AVC)
-        { // H264
-            st_attr_.stRcAttr.enRcMode = VENC_RC_MODE_H264VBR;
-            st_attr_.stRcAttr.stH264Vbr.u32Gop = 30;
-            st_attr_.stRcAttr.stH264Vbr.u32BitRate = 5 * 1024;    // 目标5Mbps
-            st_attr_.stRcAttr.stH264Vbr.u32MaxBitRate = 8 * 1024; // 最大8Mbps
-            st_attr_.stRcAttr.stH264Vbr.u32MinBitRate = 2 * 1024; // 最小2Mbps
+        int ret = mpi_.vencRequestIDR(venc_config_.chn_id, instant);
+        if (ret != RK_SUCCESS)
+        {
+            LOGE("VideoEncoderDriver::requestIDR - VENC chn%d failed, ret=%#x", venc_config_.chn_id, ret);
+            return -1;
+        }
+        return 0;
+    }
+
+    int VideoEncoderDriver::queryStatus(VENC_CHN_STATUS_S &status)
+    {
+        return mpi_.vencQueryStatus(venc_config_.chn_id, status);
+    }
+
+    int VideoEncoderDriver::getFd()
+    {
+        int fd = mpi_.vencGetFd(venc_config_.chn_id);
+        if (fd < 0)
+        {
+            LOGE("VideoEncoderDriver::getFd - VENC chn%d GetFd failed", venc_config_.chn_id);
+            return -1;
+        }
+        return fd;
+    }
+
+    void VideoEncoderDriver::closeFd()
+    {
+        mpi_.vencCloseFd(venc_config_.chn_id);
+    }
+
+    namespace
+    {
+        const uint64_t kStreamBufDivisor = 2; // 码流缓冲按峰值码率的 1/2 秒码流估算
+
+        // 当前码率控制模式下的码率/帧率字段（该模式没有的字段为 nullptr）
+        struct RcFields
+        {
+            RK_U32 *bitrate = nullptr;
+            RK_U32 *max_bitrate = nullptr;
+            RK_U32 *min_bitrate = nullptr;
+            RK_U32 *src_fps = nullptr;
+            RK_U32 *dst_fps = nullptr;
+        };
+
+        RcFields rcFields(VENC_RC_ATTR_S &rc)
+        {
+            RcFields f;
+            switch (rc.enRcMode)
+            {
+            case VENC_RC_MODE_H264CBR:
+                f.bitrate = &rc.stH264Cbr.u32BitRate;
+                f.src_fps = &rc.stH264Cbr.u32SrcFrameRateNum;
+                f.dst_fps = &rc.stH264Cbr.fr32DstFrameRateNum;
+                break;
+            case VENC_RC_MODE_H264VBR:
+                f.bitrate = &rc.stH264Vbr.u32BitRate;
+                f.max_bitrate = &rc.stH264Vbr.u32MaxBitRate;
+                f.min_bitrate = &rc.stH264Vbr.u32MinBitRate;
+                f.src_fps = &rc.stH264Vbr.u32SrcFrameRateNum;
+                f.dst_fps = &rc.stH264Vbr.fr32DstFrameRateNum;
+                break;
+            case VENC_RC_MODE_H265CBR:
+                f.bitrate = &rc.stH265Cbr.u32BitRate;
+                f.src_fps = &rc.stH265Cbr.u32SrcFrameRateNum;
+                f.dst_fps = &rc.stH265Cbr.fr32DstFrameRateNum;
+                break;
+            case VENC_RC_MODE_H265VBR:
+                f.bitrate = &rc.stH265Vbr.u32BitRate;
+                f.max_bitrate = &rc.stH265Vbr.u32MaxBitRate;
+                f.min_bitrate = &rc.stH265Vbr.u32MinBitRate;
+                f.src_fps = &rc.stH265Vbr.u32SrcFrameRateNum;
+                f.dst_fps = &rc.stH265Vbr.fr32DstFrameRateNum;
+                break;
+            case VENC_RC_MODE_H264AVBR:
+                f.bitrate = &rc.stH264Avbr.u32BitRate;
+                f.max_bitrate = &rc.stH264Avbr.u32MaxBitRate;
+                f.min_bitrate = &rc.stH264Avbr.u32MinBitRate;
+                f.src_fps = &rc.stH264Avbr.u32SrcFrameRateNum;
+                f.dst_fps = &rc.stH264Avbr.fr32DstFrameRateNum;
+                break;
+            case VENC_RC_MODE_H265AVBR:
+                f.bitrate = &rc.stH265Avbr.u32BitRate;
+                f.max_bitrate = &rc.stH265Avbr.u32MaxBitRate;
+                f.min_bitrate = &rc.stH265Avbr.u32MinBitRate;
+                f.src_fps = &rc.stH265Avbr.u32SrcFrameRateNum;
+                f.dst_fps = &rc.stH265Avbr.fr32DstFrameRateNum;
+                break;
+            case VENC_RC_MODE_H264FIXQP: // 固定QP没有码率字段
+                f.src_fps = &rc.stH264FixQp.u32SrcFrameRateNum;
+                f.dst_fps = &rc.stH264FixQp.fr32DstFrameRateNum;
+                break;
+            case VENC_RC_MODE_H265FIXQP:
+                f.src_fps = &rc.stH265FixQp.u32SrcFrameRateNum;
+                f.dst_fps = &rc.stH265FixQp.fr32DstFrameRateNum;
+                break;
+            case VENC_RC_MODE_MJPEGCBR:
+                f.bitrate = &rc.stMjpegCbr.u32BitRate;
+                f.src_fps = &rc.stMjpegCbr.u32SrcFrameRateNum;
+                f.dst_fps = &rc.stMjpegCbr.fr32DstFrameRateNum;
+                break;
+            default:
+                break;
+            }
+            return f;
+        }
+    }
+
+    int VideoEncoderDriver::setBitrate(int bitrate_kbps)
+    {
+        if (bitrate_kbps <= 0)
+            return -1;
+        std::lock_guard<std::mutex> lock(attr_mutex_);
+        VENC_CHN_ATTR_S attr = st_attr_;
+        RcFields f = rcFields(attr.stRcAttr);
+        if (f.bitrate == nullptr || *f.bitrate == 0)
+            return -1;
+        RK_U32 old_kbps = *f.bitrate;
+        if (f.max_bitrate)
+            *f.max_bitrate = (RK_U32)((uint64_t)*f.max_bitrate * bitrate_kbps / old_kbps);
+        if (f.min_bitrate)
+            *f.min_bitrate = (RK_U32)((uint64_t)*f.min_bitrate * bitrate_kbps / old_kbps);
+        *f.bitrate = bitrate_kbps;
+
+        int ret = mpi_.vencSetChnAttr(venc_config_.chn_id, attr);
+        if (ret != RK_SUCCESS)
+        {
+            LOGE("VideoEncoderDriver::setBitrate - VENC chn%d %dkbps failed, ret=%#x", venc_config_.chn_id, bitrate_kbps, ret);
+            return -1;
+        }
+        st_attr_ = attr;
+        return 0;
+    }
+
+    int VideoEncoderDriver::setRcProfile(const RcProfile &profile)
+    {
+        std::lock_guard<std::mutex> lock(attr_mutex_);
+        VENC_CHN_ATTR_S attr = st_attr_;
+        RcFields f = rcFields(attr.stRcAttr);
+        int src_fps = f.src_fps ? (int)*f.src_fps : venc_config_.fps;
+        int dst_fps = f.dst_fps ? (int)*f.dst_fps : venc_config_.fps;
+        buildRcAttr(venc_config_.en_type, profile, src_fps, dst_fps, attr.stRcAttr);
+        buildGopAttr(venc_config_.en_type, profile, attr.stGopAttr);
+
+        int ret = mpi_.vencSetChnAttr(venc_config_.chn_id, attr);
+        if (ret != RK_SUCCESS)
+        {
+            LOGE("VideoEncoderDriver::setRcProfile - VENC chn%d %s failed, ret=%#x", venc_config_.chn_id,
+                 rcModeName(profile.mode), ret);
+            return -1;
+        }
+        st_attr_ = attr;
+        rc_ = profile;
+        ret = applyRcParam(profile);
+        if (ret != RK_SUCCESS)
+            LOGW("VideoEncoderDriver::setRcProfile - VENC chn%d set qp range failed, ret=%#x", venc_config_.chn_id, ret);
+        LOGI("VideoEncoderDriver::setRcProfile - VENC chn%d -> %s %s gop=%d vir_idr=%d bitrate=%dkbps", venc_config_.chn_id,
+             rcModeName(profile.mode), gopModeName(profile.gop_mode), profile.gop, attr.stGopAttr.s32VirIdrLen,
+             profile.bitrate_kbps);
+        return 0;
+    }
+
+    RcProfile VideoEncoderDriver::rcProfile() const
+    {
+        std::lock_guard<std::mutex> lock(attr_mutex_);
+        return rc_;
+    }
+
+    int VideoEncoderDriver::setFrameRate(int fps)
+    {
+        if (fps <= 0)
+            return -1;
+        std::lock_guard<std::mutex> lock(attr_mutex_);
+        VENC_CHN_ATTR_S attr = st_attr_;
+        RcFields f = rcFields(attr.stRcAttr);
+        if (f.dst_fps == nullptr)
+            return -1;
+        *f.dst_fps = f.src_fps && *f.src_fps > 0 && (RK_U32)fps > *f.src_fps ? *f.src_fps : (RK_U32)fps;
+
+        int ret = mpi_.vencSetChnAttr(venc_config_.chn_id, attr);
+        if (ret != RK_SUCCESS)
+        {
+            LOGE("VideoEncoderDriver::setFrameRate - VENC chn%d %dfps failed, ret=%#x", venc_config_.chn_id, fps, ret);
+            return -1;
         }
-        else if (venc_config_.en_type == RK_VIDEO_ID_HEVC)
-        { // H265
-            // st_attr_.stRcAttr.enRcMode = VENC_RC_MODE_H265CBR;
-            // st_attr_.stRcAttr.stH265Cbr.u32BitRate = 10 * 1024; // 固定10Mbps
-            // st_attr_.stRcAttr.stH265Cbr.u32Gop = 60;
-
-            st_attr_.stRcAttr.enRcMode = VENC_RC_MODE_H265VBR;    // VBR模式
-            st_attr_.stRcAttr.stH265Vbr.u32Gop = 60;              // GOP大小
-            st_attr_.stRcAttr.stH265Vbr.u32BitRate = 5 * 1024;    // 目标比特率
-            st_attr_.stRcAttr.stH265Vbr.u32MaxBitRate = 10 * 1024; // 最大比特率
-            st_attr_.stRcAttr.stH265Vbr.u32MinBitRate = 1 * 1024; // 最小比特率
+        st_attr_ = attr;
+        return 0;
+    }
+
+    int VideoEncoderDriver::setQpRange(int min_qp, int max_qp)
+    {
+        if (min_qp < 0 || max_qp < min_qp)
+            return -1;
+        if (venc_config_.en_type != RK_VIDEO_ID_AVC && venc_config_.en_type != RK_VIDEO_ID_HEVC)
+            return -1;
+        // 与 setRcProfile 的 applyRcParam 串行（两者都是读-改-写整个 RC 参数）
+        std::lock_guard<std::mutex> lock(attr_mutex_);
+        VENC_RC_PARAM_S param;
+        memset(&param, 0, sizeof(param));
+        int ret = mpi_.vencGetRcParam(venc_config_.chn_id, param);
+        if (ret == RK_SUCCESS)
+        {
+            // H.264/H.265 参数结构相同；I帧QP范围保持码率控制配置的设置
+            VENC_PARAM_H265_S &qp = venc_config_.en_type == RK_VIDEO_ID_AVC ? param.stParamH264 : param.stParamH265;
+            qp.u32MinQp = min_qp;
+            qp.u32MaxQp = max_qp;
+            ret = mpi_.vencSetRcParam(venc_config_.chn_id, param);
         }
-        else if (venc_config_.en_type == RK_VIDEO_ID_MJPEG)
-        { // MJPEG
-            st_attr_.stRcAttr.enRcMode = VENC_RC_MODE_MJPEGCBR;
-            st_attr_.stRcAttr.stMjpegCbr.u32BitRate = 10 * 1024; // 固定10Mbps
+        if (ret != RK_SUCCESS)
+        {
+            LOGE("VideoEncoderDriver::setQpRange - VENC chn%d [%d,%d] failed, ret=%#x", venc_config_.chn_id, min_qp, max_qp, ret);
+            return -1;
+        }
+        return 0;
+    }
+
+    int VideoEncoderDriver::bitrateKbps() const
+    {
+        std::lock_guard<std::mutex> lock(attr_mutex_);
+        RcFields f = rcFields(const_cast<VENC_RC_ATTR_S &>(st_attr_.stRcAttr));
+        return f.bitrate ? (int)*f.bitrate : 0;
+    }
+
+    int VideoEncoderDriver::frameRate() const
+    {
+        std::lock_guard<std::mutex> lock(attr_mutex_);
+        RcFields f = rcFields(const_cast<VENC_RC_ATTR_S &>(st_attr_.stRcAttr));
+        return f.dst_fps ? (int)*f.dst_fps : 0;
+    }
+
+    int VideoEncoderDriver::setRoiRegions(const std::vector<RoiRegion> &regions)
+    {
+        if (venc_config_.en_type != RK_VIDEO_ID_AVC && venc_config_.en_type != RK_VIDEO_ID_HEVC)
+            return -1;
+        std::lock_guard<std::mutex> lock(roi_mutex_);
+        int count = std::min((int)regions.size(), kMaxRoiRegions);
+        int enabled = 0;
+        int ret = RK_SUCCESS;
+        // 新区域依次占用索引 0 ~ count-1，上次多出的索引关闭
+        for (int i = 0; i < std::max(count, roi_count_); i++)
+        {
+            VENC_ROI_ATTR_S attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.u32Index = i;
+            if (i < count)
+            {
+                const RoiRegion &r = regions[i];
+                int x0 = std::max(0, r.x) & ~15;
+                int y0 = std::max(0, r.y) & ~15;
+                int x1 = std::min(venc_config_.width, (r.x + r.width + 15) & ~15);
+                int y1 = std::min(venc_config_.height, (r.y + r.height + 15) & ~15);
+                if (x1 > x0 && y1 > y0)
+                {
+                    attr.bEnable = RK_TRUE;
+                    attr.bAbsQp = r.abs_qp ? RK_TRUE : RK_FALSE;
+                    attr.s32Qp = r.qp;
+                    attr.bIntra = r.intra ? RK_TRUE : RK_FALSE;
+                    attr.stRect.s32X = x0;
+                    attr.stRect.s32Y = y0;
+                    attr.stRect.u32Width = x1 - x0;
+                    attr.stRect.u32Height = y1 - y0;
+                    enabled = i + 1;
+                }
+            }
+            int r = mpi_.vencSetRoiAttr(venc_config_.chn_id, attr);
+            if (r != RK_SUCCESS)
+                ret = r;
+        }
+        // 下发失败时无法确定哪些索引仍在生效，下次全部重写
+        roi_count_ = ret == RK_SUCCESS ? enabled : std::max(count, roi_count_);
+        if (ret != RK_SUCCESS)
+        {
+            LOGE("VideoEncoderDriver::setRoiRegions - VENC chn%d %d regions failed, ret=%#x", venc_config_.chn_id, count, ret);
+            return -1;
+        }
+        return 0;
+    }
+
+    int VideoEncoderDriver::roiRegionCount() const
+    {
+        std::lock_guard<std::mutex> lock(roi_mutex_);
+        return roi_count_;
+    }
+
+    // 私有辅助函数：按编码格式配置码率控制参数（模式、GOP长度与结构、码率取自 venc_config_.rc）
+    void VideoEncoderDriver::configRcParams()
+    {
+        rc_ = venc_config_.rc;
+        buildRcAttr(venc_config_.en_type, rc_, venc_config_.fps, venc_config_.fps, st_attr_.stRcAttr);
+        buildGopAttr(venc_config_.en_type, rc_, st_attr_.stGopAttr);
+    }
+
+    int VideoEncoderDriver::applyRcParam(const RcProfile &profile)
+    {
+        if (venc_config_.en_type != RK_VIDEO_ID_AVC && venc_config_.en_type != RK_VIDEO_ID_HEVC)
+            return 0;
+        if (profile.mode == RcMode::kFixQp || (profile.min_qp <= 0 && profile.max_qp <= 0 && profile.i_qp_delta == 0))
+            return 0;
+        VENC_RC_PARAM_S param;
+        memset(&param, 0, sizeof(param));
+        int ret = mpi_.vencGetRcParam(venc_config_.chn_id, param);
+        if (ret != RK_SUCCESS)
+            return ret;
+        // H.264/H.265 参数结构相同
+        VENC_PARAM_H265_S &qp = venc_config_.en_type == RK_VIDEO_ID_AVC ? param.stParamH264 : param.stParamH265;
+        if (profile.min_qp > 0)
+            qp.u32MinQp = qp.u32MinIQp = profile.min_qp;
+        if (profile.max_qp > 0)
+            qp.u32MaxQp = qp.u32MaxIQp = profile.max_qp;
+        qp.s32DeltIpQp = profile.i_qp_delta;
+        return mpi_.vencSetRcParam(venc_config_.chn_id, param);
+    }
+
+    /**
+     * 单个码流缓冲大小：缓冲个数按零拷贝在途包数配置（kVideoStreamBufCnt），每个缓冲只需容纳一帧码流，
+     * 不必按一帧原始图像（1080p 约3MB）分配。按峰值码率留半秒的码流（足够容纳IDR），
+     * 下限为原始图像的 1/12（低码率时的IDR），上限为一帧原始图像；FixQP 没有码率，取原始图像的 1/4。
+     * 默认的 1080p H.265 VBR（峰值10Mbps）：628KB × 11 ≈ 6.7MB；640x360 子码流（峰值1Mbps）：64KB × 11 ≈ 0.7MB
+     */
+    RK_U32 VideoEncoderDriver::streamBufSize()
+    {
+        const uint64_t raw = (uint64_t)venc_config_.width * venc_config_.height * 3 / 2;
+        uint64_t size;
+        if (venc_config_.stream_buf_size > 0)
+        {
+            size = (uint64_t)venc_config_.stream_buf_size;
+        }
+        else
+        {
+            RcFields f = rcFields(st_attr_.stRcAttr);
+            uint64_t peak_kbps = f.bitrate ? *f.bitrate : 0;
+            if (f.max_bitrate)
+                peak_kbps = std::max<uint64_t>(peak_kbps, *f.max_bitrate);
+            if (peak_kbps > 0)
+                size = std::min(raw, std::max(raw / 12, peak_kbps * 1000 / 8 / kStreamBufDivisor));
+            else
+                size = raw / 4;
         }
+        return (RK_U32)((size + 4095) & ~(uint64_t)4095);
     }
 
     // 私有辅助函数：配置通用编码属性（分辨率、像素格式等）
     void VideoEncoderDriver::configCommonAttr()
     {
         st_attr_.stVencAttr.enType = venc_config_.en_type; // 编码格式
-        st_attr_.stVencAttr.enPixelFormat = RK_FMT_RGB888;
+        st_attr_.stVencAttr.enPixelFormat = venc_config_.pixel_format; // 默认NV12，与VPSS编码通道一致
 
         // H264专属：高清档次
         if (venc_config_.en_type == RK_VIDEO_ID_AVC)
@@ -124,8 +445,11 @@ namespace driver
         st_attr_.stVencAttr.u32VirHeight = venc_config_.height; // 虚拟高度
 
         // 缓冲区配置
-        st_attr_.stVencAttr.u32StreamBufCnt = 2;                                           // 双缓冲（避免阻塞）
-        st_attr_.stVencAttr.u32BufSize = venc_config_.width * venc_config_.height * 3 / 2; // YUV420SP大小
+        st_attr_.stVencAttr.u32StreamBufCnt = venc_config_.stream_buf_cnt; // 需覆盖队列中零拷贝引用的码流
+        st_attr_.stVencAttr.u32BufSize = streamBufSize();
+        LOGI("VideoEncoderDriver - VENC chn%d stream buffers %d x %uKB = %.1fMB", venc_config_.chn_id,
+             venc_config_.stream_buf_cnt, st_attr_.stVencAttr.u32BufSize / 1024,
+             venc_config_.stream_buf_cnt * (double)st_attr_.stVencAttr.u32BufSize / (1024 * 1024));
 
         st_attr_.stVencAttr.enMirror = MIRROR_NONE; // 关闭镜像
     }
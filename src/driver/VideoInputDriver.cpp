@@ -1,4 +1,5 @@
 #include "driver/VideoInputDriver.hpp"
+#include "driver/MPIBackend.hpp"
 #include "cstring"
 extern "C"
 {
@@ -10,7 +11,7 @@ extern "C"
 namespace driver
 {
 
-    VideoInputDriver::VideoInputDriver(){}
+    VideoInputDriver::VideoInputDriver() : mpi_(MPIBackend::instance()) {}
 
     VideoInputDriver::~VideoInputDriver() {}
 
@@ -26,23 +27,23 @@ namespace driver
 
     int VideoInputDriver::start()
     {
-        return RK_MPI_VI_EnableChn(vi_config_.dev_id, vi_config_.chn_id);
+        return mpi_.viEnableChn(vi_config_.dev_id, vi_config_.chn_id);
     }
 
     int VideoInputDriver::stop()
     {
-        return RK_MPI_VI_DisableChn(vi_config_.dev_id, vi_config_.chn_id);
+        return mpi_.viDisableChn(vi_config_.dev_id, vi_config_.chn_id);
     }
 
     int VideoInputDriver::getFrame(VIDEO_FRAME_INFO_S &frame, int timeout)
     {
 
-        return RK_MPI_VI_GetChnFrame(vi_config_.dev_id, vi_config_.chn_id, &frame, timeout);
+        return mpi_.viGetChnFrame(vi_config_.dev_id, vi_config_.chn_id, frame, timeout);
     }
     
     void VideoInputDriver::releaseFrame(const VIDEO_FRAME_INFO_S &frame)
     {
-        RK_MPI_VI_ReleaseChnFrame(vi_config_.dev_id, vi_config_.chn_id, &frame);
+        mpi_.viReleaseChnFrame(vi_config_.dev_id, vi_config_.chn_id, frame);
     }
     
     int VideoInputDriver::vi_dev_init()
@@ -55,11 +56,11 @@ namespace driver
         memset(&stBindPipe, 0, sizeof(stBindPipe));
 
         // 0. get dev config status
-        int ret = RK_MPI_VI_GetDevAttr(vi_config_.dev_id, &stDevAttr);
+        int ret = mpi_.viGetDevAttr(vi_config_.dev_id, stDevAttr);
         if (ret == RK_ERR_VI_NOT_CONFIG)
         {
             // 0-1.config dev
-            ret = RK_MPI_VI_SetDevAttr(vi_config_.dev_id, &stDevAttr);
+            ret = mpi_.viSetDevAttr(vi_config_.dev_id, stDevAttr);
             if (ret != RK_SUCCESS)
             {
                 LOGE("RK_MPI_VI_SetDevAttr");
@@ -71,11 +72,11 @@ namespace driver
             LOGI("RK_MPI_VI_SetDevAttr already\n");
         }
         // 1.get dev enable status
-        ret = RK_MPI_VI_GetDevIsEnable(vi_config_.chn_id);
+        ret = mpi_.viGetDevIsEnable(vi_config_.chn_id);
         if (ret != RK_SUCCESS)
         {
             // 1-2.enable dev
-            ret = RK_MPI_VI_EnableDev(vi_config_.chn_id);
+            ret = mpi_.viEnableDev(vi_config_.chn_id);
             if (ret != RK_SUCCESS)
             {
                 LOGE("RK_MPI_VI_EnableDev %x", ret);
@@ -84,7 +85,7 @@ namespace driver
             // 1-3.bind dev/pipe
             stBindPipe.u32Num = 1;
             stBindPipe.PipeId[0] = pipeId;
-            ret = RK_MPI_VI_SetDevBindPipe(vi_config_.dev_id, &stBindPipe);
+            ret = mpi_.viSetDevBindPipe(vi_config_.dev_id, stBindPipe);
             if (ret != RK_SUCCESS)
             {
                 LOGE("RK_MPI_VI_SetDevBindPipe %x\n", ret);
@@ -120,7 +121,7 @@ namespace driver
         vi_chn_attr.stSize.u32Width = config.width;
         vi_chn_attr.u32Depth = 3;
 
-        int ret = RK_MPI_VI_SetChnAttr(vi_config_.dev_id, vi_config_.chn_id, &vi_chn_attr);
+        int ret = mpi_.viSetChnAttr(vi_config_.dev_id, vi_config_.chn_id, vi_chn_attr);
         if (ret != 0)
         {
             LOGE("create VI error! ret=%d\n", ret);
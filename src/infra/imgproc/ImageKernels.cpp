@@ -0,0 +1,903 @@
+#include "infra/imgproc/ImageKernels.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define IMGPROC_HAVE_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define IMGPROC_HAVE_SSE2 1
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define IMGPROC_HAVE_SSSE3 1
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define IMGPROC_HAVE_AVX2 1
+#endif
+#endif
+
+namespace infra
+{
+    namespace imgproc
+    {
+        namespace
+        {
+            std::atomic<bool> g_force_scalar{false};
+
+            inline bool useSimd()
+            {
+                return !g_force_scalar.load(std::memory_order_relaxed);
+            }
+
+            // BT.601 limited range → RGB，6位定点：
+            //   y' = (Y-16)*74 + 32（含舍入）  R = (y' + 102V') >> 6  G = (y' - 25U' - 52V') >> 6  B = (y' + 129U') >> 6
+            // SIMD 在16位有符号数上做饱和加减，只有 B 会饱和，而饱和后的结果同样被截到255，与标量一致
+            const int kYScale = 74;
+            const int kRV = 102;
+            const int kGU = 25;
+            const int kGV = 52;
+            const int kBU = 129;
+
+            inline uint8_t clampU8(int v)
+            {
+                return (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+            }
+
+            // 四舍五入除以255，与 NEON vraddhn_u16(v, vrshrq_n_u16(v, 8)) 按位一致
+            inline uint8_t div255(uint32_t v)
+            {
+                return (uint8_t)((v + ((v + 128) >> 8) + 128) >> 8);
+            }
+
+            // ---------------- 标量参考实现 ----------------
+
+            void splitUVRowScalar(const uint8_t *uv, uint8_t *u, uint8_t *v, int n)
+            {
+                for (int i = 0; i < n; i++)
+                {
+                    u[i] = uv[2 * i];
+                    v[i] = uv[2 * i + 1];
+                }
+            }
+
+            void mergeUVRowScalar(const uint8_t *u, const uint8_t *v, uint8_t *uv, int n)
+            {
+                for (int i = 0; i < n; i++)
+                {
+                    uv[2 * i] = u[i];
+                    uv[2 * i + 1] = v[i];
+                }
+            }
+
+            // width 为偶数；c0/c2 为输出像素的第1/3个字节对应 R 还是 B
+            void nv12ToRgbRowScalar(const uint8_t *y, const uint8_t *uv, uint8_t *dst, int width, bool bgr)
+            {
+                for (int i = 0; i < width; i++)
+                {
+                    int u = uv[i & ~1] - 128;
+                    int v = uv[(i & ~1) + 1] - 128;
+                    int yy = (y[i] - 16) * kYScale + 32;
+                    uint8_t r = clampU8((yy + kRV * v) >> 6);
+                    uint8_t g = clampU8((yy - kGU * u - kGV * v) >> 6);
+                    uint8_t b = clampU8((yy + kBU * u) >> 6);
+                    dst[3 * i] = bgr ? b : r;
+                    dst[3 * i + 1] = g;
+                    dst[3 * i + 2] = bgr ? r : b;
+                }
+            }
+
+            // f 为 b 行的权重（1~255）
+            void interpolateRowScalar(uint8_t *dst, const uint8_t *a, const uint8_t *b, int n, int f)
+            {
+                int f0 = 256 - f;
+                for (int i = 0; i < n; i++)
+                    dst[i] = (uint8_t)((a[i] * f0 + b[i] * f + 128) >> 8);
+            }
+
+            // pairs 为 true 时按UV交织行处理：字节 j 使用 alpha[j & ~1]
+            void blendRowScalar(uint8_t *dst, const uint8_t *src, const uint8_t *alpha, int n, bool pairs)
+            {
+                for (int i = 0; i < n; i++)
+                {
+                    uint32_t a = alpha[pairs ? (i & ~1) : i];
+                    dst[i] = div255(src[i] * a + dst[i] * (255 - a));
+                }
+            }
+
+            void accumulateRowScalar(uint16_t *sum, const uint8_t *src, int n)
+            {
+                for (int i = 0; i < n; i++)
+                    sum[i] = (uint16_t)(sum[i] + src[i]);
+            }
+
+            // ---------------- NEON ----------------
+#ifdef IMGPROC_HAVE_NEON
+            void splitUVRowNeon(const uint8_t *uv, uint8_t *u, uint8_t *v, int n)
+            {
+                int i = 0;
+                for (; i + 16 <= n; i += 16)
+                {
+                    uint8x16x2_t c = vld2q_u8(uv + 2 * i);
+                    vst1q_u8(u + i, c.val[0]);
+                    vst1q_u8(v + i, c.val[1]);
+                }
+                splitUVRowScalar(uv + 2 * i, u + i, v + i, n - i);
+            }
+
+            void mergeUVRowNeon(const uint8_t *u, const uint8_t *v, uint8_t *uv, int n)
+            {
+                int i = 0;
+                for (; i + 16 <= n; i += 16)
+                {
+                    uint8x16x2_t c;
+                    c.val[0] = vld1q_u8(u + i);
+                    c.val[1] = vld1q_u8(v + i);
+                    vst2q_u8(uv + 2 * i, c);
+                }
+                mergeUVRowScalar(u + i, v + i, uv + 2 * i, n - i);
+            }
+
+            void nv12ToRgbRowNeon(const uint8_t *y, const uint8_t *uv, uint8_t *dst, int width, bool bgr)
+            {
+                const uint8x8_t k16 = vdup_n_u8(16);
+                const uint8x8_t k128 = vdup_n_u8(128);
+                const int16x8_t round = vdupq_n_s16(32);
+                int i = 0;
+                for (; i + 16 <= width; i += 16)
+                {
+                    uint8x16_t yv = vld1q_u8(y + i);
+                    uint8x8x2_t c = vld2_u8(uv + i); // 8对UV
+                    int16x8_t u = vreinterpretq_s16_u16(vsubl_u8(c.val[0], k128));
+                    int16x8_t v = vreinterpretq_s16_u16(vsubl_u8(c.val[1], k128));
+                    int16x8x2_t rv = vzipq_s16(vmulq_n_s16(v, kRV), vmulq_n_s16(v, kRV)); // 每个色度值复制给2个像素
+                    int16x8_t guv = vmlaq_n_s16(vmulq_n_s16(u, kGU), v, kGV);
+                    int16x8x2_t gv = vzipq_s16(guv, guv);
+                    int16x8x2_t bu = vzipq_s16(vmulq_n_s16(u, kBU), vmulq_n_s16(u, kBU));
+
+                    int16x8_t ylo = vaddq_s16(vmulq_n_s16(vreinterpretq_s16_u16(vsubl_u8(vget_low_u8(yv), k16)), kYScale), round);
+                    int16x8_t yhi = vaddq_s16(vmulq_n_s16(vreinterpretq_s16_u16(vsubl_u8(vget_high_u8(yv), k16)), kYScale), round);
+
+                    uint8x16_t r = vcombine_u8(vqshrun_n_s16(vqaddq_s16(ylo, rv.val[0]), 6), vqshrun_n_s16(vqaddq_s16(yhi, rv.val[1]), 6));
+                    uint8x16_t g = vcombine_u8(vqshrun_n_s16(vqsubq_s16(ylo, gv.val[0]), 6), vqshrun_n_s16(vqsubq_s16(yhi, gv.val[1]), 6));
+                    uint8x16_t b = vcombine_u8(vqshrun_n_s16(vqaddq_s16(ylo, bu.val[0]), 6), vqshrun_n_s16(vqaddq_s16(yhi, bu.val[1]), 6));
+                    uint8x16x3_t out;
+                    out.val[0] = bgr ? b : r;
+                    out.val[1] = g;
+                    out.val[2] = bgr ? r : b;
+                    vst3q_u8(dst + 3 * i, out);
+                }
+                nv12ToRgbRowScalar(y + i, uv + i, dst + 3 * i, width - i, bgr);
+            }
+
+            void interpolateRowNeon(uint8_t *dst, const uint8_t *a, const uint8_t *b, int n, int f)
+            {
+                const uint8x8_t w0 = vdup_n_u8((uint8_t)(256 - f));
+                const uint8x8_t w1 = vdup_n_u8((uint8_t)f);
+                int i = 0;
+                for (; i + 16 <= n; i += 16)
+                {
+                    uint8x16_t va = vld1q_u8(a + i);
+                    uint8x16_t vb = vld1q_u8(b + i);
+                    uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(va), w0), vget_low_u8(vb), w1);
+                    uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(va), w0), vget_high_u8(vb), w1);
+                    vst1q_u8(dst + i, vcombine_u8(vrshrn_n_u16(lo, 8), vrshrn_n_u16(hi, 8)));
+                }
+                interpolateRowScalar(dst + i, a + i, b + i, n - i, f);
+            }
+
+            void blendRowNeon(uint8_t *dst, const uint8_t *src, const uint8_t *alpha, int n, bool pairs)
+            {
+                int i = 0;
+                for (; i + 16 <= n; i += 16)
+                {
+                    uint8x16_t a = vld1q_u8(alpha + i);
+                    if (pairs)
+                    {
+                        uint16x8_t t = vandq_u16(vreinterpretq_u16_u8(a), vdupq_n_u16(0x00FF));
+                        a = vreinterpretq_u8_u16(vorrq_u16(t, vshlq_n_u16(t, 8)));
+                    }
+                    uint8x16_t s = vld1q_u8(src + i);
+                    uint8x16_t d = vld1q_u8(dst + i);
+                    uint8x16_t ia = vmvnq_u8(a);
+                    uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(s), vget_low_u8(a)), vget_low_u8(d), vget_low_u8(ia));
+                    uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(s), vget_high_u8(a)), vget_high_u8(d), vget_high_u8(ia));
+                    vst1q_u8(dst + i, vcombine_u8(vraddhn_u16(lo, vrshrq_n_u16(lo, 8)), vraddhn_u16(hi, vrshrq_n_u16(hi, 8))));
+                }
+                blendRowScalar(dst + i, src + i, alpha + i, n - i, pairs);
+            }
+
+            void accumulateRowNeon(uint16_t *sum, const uint8_t *src, int n)
+            {
+                int i = 0;
+                for (; i + 16 <= n; i += 16)
+                {
+                    uint8x16_t s = vld1q_u8(src + i);
+                    vst1q_u16(sum + i, vaddw_u8(vld1q_u16(sum + i), vget_low_u8(s)));
+                    vst1q_u16(sum + i + 8, vaddw_u8(vld1q_u16(sum + i + 8), vget_high_u8(s)));
+                }
+                accumulateRowScalar(sum + i, src + i, n - i);
+            }
+#endif
+
+            // ---------------- SSE2 ----------------
+#ifdef IMGPROC_HAVE_SSE2
+            void splitUVRowSse2(const uint8_t *uv, uint8_t *u, uint8_t *v, int n)
+            {
+                const __m128i mask = _mm_set1_epi16(0x00FF);
+                int i = 0;
+                for (; i + 16 <= n; i += 16)
+                {
+                    __m128i a = _mm_loadu_si128((const __m128i *)(uv + 2 * i));
+                    __m128i b = _mm_loadu_si128((const __m128i *)(uv + 2 * i + 16));
+                    _mm_storeu_si128((__m128i *)(u + i), _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask)));
+                    _mm_storeu_si128((__m128i *)(v + i), _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8)));
+                }
+                splitUVRowScalar(uv + 2 * i, u + i, v + i, n - i);
+            }
+
+            void mergeUVRowSse2(const uint8_t *u, const uint8_t *v, uint8_t *uv, int n)
+            {
+                int i = 0;
+                for (; i + 16 <= n; i += 16)
+                {
+                    __m128i a = _mm_loadu_si128((const __m128i *)(u + i));
+                    __m128i b = _mm_loadu_si128((const __m128i *)(v + i));
+                    _mm_storeu_si128((__m128i *)(uv + 2 * i), _mm_unpacklo_epi8(a, b));
+                    _mm_storeu_si128((__m128i *)(uv + 2 * i + 16), _mm_unpackhi_epi8(a, b));
+                }
+                mergeUVRowScalar(u + i, v + i, uv + 2 * i, n - i);
+            }
+
+            // 16个像素的三个通道交织为48字节输出
+            inline void store3(uint8_t *dst, __m128i c0, __m128i c1, __m128i c2)
+            {
+                const __m128i zero = _mm_setzero_si128();
+                __m128i c01_lo = _mm_unpacklo_epi8(c0, c1);
+                __m128i c01_hi = _mm_unpackhi_epi8(c0, c1);
+                __m128i c2z_lo = _mm_unpacklo_epi8(c2, zero);
+                __m128i c2z_hi = _mm_unpackhi_epi8(c2, zero);
+                __m128i p0 = _mm_unpacklo_epi16(c01_lo, c2z_lo); // 像素0~3，每像素4字节
+                __m128i p1 = _mm_unpackhi_epi16(c01_lo, c2z_lo);
+                __m128i p2 = _mm_unpacklo_epi16(c01_hi, c2z_hi);
+                __m128i p3 = _mm_unpackhi_epi16(c01_hi, c2z_hi);
+#ifdef IMGPROC_HAVE_SSSE3
+                const __m128i pack = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+                p0 = _mm_shuffle_epi8(p0, pack); // 每个向量压成12字节
+                p1 = _mm_shuffle_epi8(p1, pack);
+                p2 = _mm_shuffle_epi8(p2, pack);
+                p3 = _mm_shuffle_epi8(p3, pack);
+                _mm_storeu_si128((__m128i *)dst, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+                _mm_storeu_si128((__m128i *)(dst + 16), _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+                _mm_storeu_si128((__m128i *)(dst + 32), _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+#else
+                // SSE2 没有字节重排指令，经栈上缓冲逐像素去掉第4字节
+                alignas(16) uint8_t tmp[64];
+                _mm_store_si128((__m128i *)tmp, p0);
+                _mm_store_si128((__m128i *)(tmp + 16), p1);
+                _mm_store_si128((__m128i *)(tmp + 32), p2);
+                _mm_store_si128((__m128i *)(tmp + 48), p3);
+                for (int k = 0; k < 16; k++)
+                {
+                    dst[3 * k] = tmp[4 * k];
+                    dst[3 * k + 1] = tmp[4 * k + 1];
+                    dst[3 * k + 2] = tmp[4 * k + 2];
+                }
+#endif
+            }
+
+            void nv12ToRgbRowSse2(const uint8_t *y, const uint8_t *uv, uint8_t *dst, int width, bool bgr)
+            {
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i mask = _mm_set1_epi16(0x00FF);
+                const __m128i k16 = _mm_set1_epi16(16);
+                const __m128i k128 = _mm_set1_epi16(128);
+                const __m128i round = _mm_set1_epi16(32);
+                const __m128i ky = _mm_set1_epi16(kYScale);
+                int i = 0;
+                for (; i + 16 <= width; i += 16)
+                {
+                    __m128i yv = _mm_loadu_si128((const __m128i *)(y + i));
+                    __m128i c = _mm_loadu_si128((const __m128i *)(uv + i)); // 8对UV
+                    __m128i u = _mm_sub_epi16(_mm_and_si128(c, mask), k128);
+                    __m128i v = _mm_sub_epi16(_mm_srli_epi16(c, 8), k128);
+                    __m128i rv = _mm_mullo_epi16(v, _mm_set1_epi16(kRV));
+                    __m128i guv = _mm_add_epi16(_mm_mullo_epi16(u, _mm_set1_epi16(kGU)), _mm_mullo_epi16(v, _mm_set1_epi16(kGV)));
+                    __m128i bu = _mm_mullo_epi16(u, _mm_set1_epi16(kBU));
+
+                    __m128i ylo = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(yv, zero), k16), ky), round);
+                    __m128i yhi = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(_mm_unpackhi_epi8(yv, zero), k16), ky), round);
+
+                    // 每个色度值复制给2个像素
+                    __m128i r = _mm_packus_epi16(_mm_srai_epi16(_mm_adds_epi16(ylo, _mm_unpacklo_epi16(rv, rv)), 6),
+                                                 _mm_srai_epi16(_mm_adds_epi16(yhi, _mm_unpackhi_epi16(rv, rv)), 6));
+                    __m128i g = _mm_packus_epi16(_mm_srai_epi16(_mm_subs_epi16(ylo, _mm_unpacklo_epi16(guv, guv)), 6),
+                                                 _mm_srai_epi16(_mm_subs_epi16(yhi, _mm_unpackhi_epi16(guv, guv)), 6));
+                    __m128i b = _mm_packus_epi16(_mm_srai_epi16(_mm_adds_epi16(ylo, _mm_unpacklo_epi16(bu, bu)), 6),
+                                                 _mm_srai_epi16(_mm_adds_epi16(yhi, _mm_unpackhi_epi16(bu, bu)), 6));
+                    if (bgr)
+                        store3(dst + 3 * i, b, g, r);
+                    else
+                        store3(dst + 3 * i, r, g, b);
+                }
+                nv12ToRgbRowScalar(y + i, uv + i, dst + 3 * i, width - i, bgr);
+            }
+
+            void interpolateRowSse2(uint8_t *dst, const uint8_t *a, const uint8_t *b, int n, int f)
+            {
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i w0 = _mm_set1_epi16((short)(256 - f));
+                const __m128i w1 = _mm_set1_epi16((short)f);
+                const __m128i round = _mm_set1_epi16(128);
+                int i = 0;
+                for (; i + 16 <= n; i += 16)
+                {
+                    __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+                    __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+                    // 乘积与和不超过 255*256+128，按无符号16位处理不会溢出
+                    __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(va, zero), w0), _mm_mullo_epi16(_mm_unpacklo_epi8(vb, zero), w1));
+                    __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(va, zero), w0), _mm_mullo_epi16(_mm_unpackhi_epi8(vb, zero), w1));
+                    lo = _mm_srli_epi16(_mm_add_epi16(lo, round), 8);
+                    hi = _mm_srli_epi16(_mm_add_epi16(hi, round), 8);
+                    _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(lo, hi));
+                }
+                interpolateRowScalar(dst + i, a + i, b + i, n - i, f);
+            }
+
+            inline __m128i div255Sse2(__m128i v)
+            {
+                const __m128i round = _mm_set1_epi16(128);
+                __m128i t = _mm_srli_epi16(_mm_add_epi16(v, round), 8);
+                return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(v, t), round), 8);
+            }
+
+            void blendRowSse2(uint8_t *dst, const uint8_t *src, const uint8_t *alpha, int n, bool pairs)
+            {
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i mask = _mm_set1_epi16(0x00FF);
+                const __m128i ones = _mm_set1_epi8((char)0xFF);
+                int i = 0;
+                for (; i + 16 <= n; i += 16)
+                {
+                    __m128i a = _mm_loadu_si128((const __m128i *)(alpha + i));
+                    if (pairs)
+                    {
+                        __m128i t = _mm_and_si128(a, mask);
+                        a = _mm_or_si128(t, _mm_slli_epi16(t, 8));
+                    }
+                    __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+                    __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+                    __m128i ia = _mm_xor_si128(a, ones);
+                    __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(a, zero)),
+                                               _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(ia, zero)));
+                    __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(a, zero)),
+                                               _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(ia, zero)));
+                    _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(div255Sse2(lo), div255Sse2(hi)));
+                }
+                blendRowScalar(dst + i, src + i, alpha + i, n - i, pairs);
+            }
+
+            void accumulateRowSse2(uint16_t *sum, const uint8_t *src, int n)
+            {
+                const __m128i zero = _mm_setzero_si128();
+                int i = 0;
+                for (; i + 16 <= n; i += 16)
+                {
+                    __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+                    __m128i lo = _mm_loadu_si128((const __m128i *)(sum + i));
+                    __m128i hi = _mm_loadu_si128((const __m128i *)(sum + i + 8));
+                    _mm_storeu_si128((__m128i *)(sum + i), _mm_add_epi16(lo, _mm_unpacklo_epi8(s, zero)));
+                    _mm_storeu_si128((__m128i *)(sum + i + 8), _mm_add_epi16(hi, _mm_unpackhi_epi8(s, zero)));
+                }
+                accumulateRowScalar(sum + i, src + i, n - i);
+            }
+#endif
+
+            // ---------------- AVX2（按行独立、无跨像素依赖的内核） ----------------
+#ifdef IMGPROC_HAVE_AVX2
+            void splitUVRowAvx2(const uint8_t *uv, uint8_t *u, uint8_t *v, int n)
+            {
+                const __m256i mask = _mm256_set1_epi16(0x00FF);
+                int i = 0;
+                for (; i + 32 <= n; i += 32)
+                {
+                    __m256i a = _mm256_loadu_si256((const __m256i *)(uv + 2 * i));
+                    __m256i b = _mm256_loadu_si256((const __m256i *)(uv + 2 * i + 32));
+                    // packus 按128位通道交错，0xD8 把4个64位块恢复为顺序
+                    __m256i uu = _mm256_packus_epi16(_mm256_and_si256(a, mask), _mm256_and_si256(b, mask));
+                    __m256i vv = _mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+                    _mm256_storeu_si256((__m256i *)(u + i), _mm256_permute4x64_epi64(uu, 0xD8));
+                    _mm256_storeu_si256((__m256i *)(v + i), _mm256_permute4x64_epi64(vv, 0xD8));
+                }
+                splitUVRowSse2(uv + 2 * i, u + i, v + i, n - i);
+            }
+
+            void mergeUVRowAvx2(const uint8_t *u, const uint8_t *v, uint8_t *uv, int n)
+            {
+                int i = 0;
+                for (; i + 32 <= n; i += 32)
+                {
+                    __m256i a = _mm256_loadu_si256((const __m256i *)(u + i));
+                    __m256i b = _mm256_loadu_si256((const __m256i *)(v + i));
+                    __m256i lo = _mm256_unpacklo_epi8(a, b);
+                    __m256i hi = _mm256_unpackhi_epi8(a, b);
+                    _mm256_storeu_si256((__m256i *)(uv + 2 * i), _mm256_permute2x128_si256(lo, hi, 0x20));
+                    _mm256_storeu_si256((__m256i *)(uv + 2 * i + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+                }
+                mergeUVRowSse2(u + i, v + i, uv + 2 * i, n - i);
+            }
+
+            void interpolateRowAvx2(uint8_t *dst, const uint8_t *a, const uint8_t *b, int n, int f)
+            {
+                const __m256i zero = _mm256_setzero_si256();
+                const __m256i w0 = _mm256_set1_epi16((short)(256 - f));
+                const __m256i w1 = _mm256_set1_epi16((short)f);
+                const __m256i round = _mm256_set1_epi16(128);
+                int i = 0;
+                for (; i + 32 <= n; i += 32)
+                {
+                    __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+                    __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+                    // unpack 与 packus 同样按128位通道进行，一进一出顺序不变
+                    __m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(va, zero), w0), _mm256_mullo_epi16(_mm256_unpacklo_epi8(vb, zero), w1));
+                    __m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(va, zero), w0), _mm256_mullo_epi16(_mm256_unpackhi_epi8(vb, zero), w1));
+                    lo = _mm256_srli_epi16(_mm256_add_epi16(lo, round), 8);
+                    hi = _mm256_srli_epi16(_mm256_add_epi16(hi, round), 8);
+                    _mm256_storeu_si256((__m256i *)(dst + i), _mm256_packus_epi16(lo, hi));
+                }
+                interpolateRowSse2(dst + i, a + i, b + i, n - i, f);
+            }
+
+            inline __m256i div255Avx2(__m256i v)
+            {
+                const __m256i round = _mm256_set1_epi16(128);
+                __m256i t = _mm256_srli_epi16(_mm256_add_epi16(v, round), 8);
+                return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(v, t), round), 8);
+            }
+
+            void blendRowAvx2(uint8_t *dst, const uint8_t *src, const uint8_t *alpha, int n, bool pairs)
+            {
+                const __m256i zero = _mm256_setzero_si256();
+                const __m256i mask = _mm256_set1_epi16(0x00FF);
+                const __m256i ones = _mm256_set1_epi8((char)0xFF);
+                int i = 0;
+                for (; i + 32 <= n; i += 32)
+                {
+                    __m256i a = _mm256_loadu_si256((const __m256i *)(alpha + i));
+                    if (pairs)
+                    {
+                        __m256i t = _mm256_and_si256(a, mask);
+                        a = _mm256_or_si256(t, _mm256_slli_epi16(t, 8));
+                    }
+                    __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+                    __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+                    __m256i ia = _mm256_xor_si256(a, ones);
+                    __m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(a, zero)),
+                                                  _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi8(ia, zero)));
+                    __m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(a, zero)),
+                                                  _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi8(ia, zero)));
+                    _mm256_storeu_si256((__m256i *)(dst + i), _mm256_packus_epi16(div255Avx2(lo), div255Avx2(hi)));
+                }
+                blendRowSse2(dst + i, src + i, alpha + i, n - i, pairs);
+            }
+#endif
+
+            // ---------------- 按编译目标分派 ----------------
+
+            void splitUVRow(const uint8_t *uv, uint8_t *u, uint8_t *v, int n)
+            {
+#if defined(IMGPROC_HAVE_NEON)
+                if (useSimd())
+                    return splitUVRowNeon(uv, u, v, n);
+#elif defined(IMGPROC_HAVE_AVX2)
+                if (useSimd())
+                    return splitUVRowAvx2(uv, u, v, n);
+#elif defined(IMGPROC_HAVE_SSE2)
+                if (useSimd())
+                    return splitUVRowSse2(uv, u, v, n);
+#endif
+                splitUVRowScalar(uv, u, v, n);
+            }
+
+            void mergeUVRow(const uint8_t *u, const uint8_t *v, uint8_t *uv, int n)
+            {
+#if defined(IMGPROC_HAVE_NEON)
+                if (useSimd())
+                    return mergeUVRowNeon(u, v, uv, n);
+#elif defined(IMGPROC_HAVE_AVX2)
+                if (useSimd())
+                    return mergeUVRowAvx2(u, v, uv, n);
+#elif defined(IMGPROC_HAVE_SSE2)
+                if (useSimd())
+                    return mergeUVRowSse2(u, v, uv, n);
+#endif
+                mergeUVRowScalar(u, v, uv, n);
+            }
+
+            void nv12ToRgbRow(const uint8_t *y, const uint8_t *uv, uint8_t *dst, int width, bool bgr)
+            {
+#if defined(IMGPROC_HAVE_NEON)
+                if (useSimd())
+                    return nv12ToRgbRowNeon(y, uv, dst, width, bgr);
+#elif defined(IMGPROC_HAVE_SSE2)
+                if (useSimd())
+                    return nv12ToRgbRowSse2(y, uv, dst, width, bgr);
+#endif
+                nv12ToRgbRowScalar(y, uv, dst, width, bgr);
+            }
+
+            // 水平双线性取样（按预计算的列表），C 为每像素字节数（Y 1，UV 2）
+            template <int C>
+            void horizontalRow(uint8_t *out, const uint8_t *line, const int *index, const uint16_t *frac, int n)
+            {
+                for (int i = 0; i < n; i++)
+                {
+                    const uint8_t *p = line + index[i] * C;
+                    int fx = frac[i];
+                    int fx0 = 256 - fx;
+                    for (int c = 0; c < C; c++)
+                        out[i * C + c] = (uint8_t)((p[c] * fx0 + p[c + C] * fx + 128) >> 8);
+                }
+            }
+
+            void horizontalRow(uint8_t *out, const uint8_t *line, const int *index, const uint16_t *frac, int n, int channels)
+            {
+                if (channels == 1)
+                    horizontalRow<1>(out, line, index, frac, n);
+                else
+                    horizontalRow<2>(out, line, index, frac, n);
+            }
+
+            void interpolateRow(uint8_t *dst, const uint8_t *a, const uint8_t *b, int n, int f)
+            {
+#if defined(IMGPROC_HAVE_NEON)
+                if (useSimd())
+                    return interpolateRowNeon(dst, a, b, n, f);
+#elif defined(IMGPROC_HAVE_AVX2)
+                if (useSimd())
+                    return interpolateRowAvx2(dst, a, b, n, f);
+#elif defined(IMGPROC_HAVE_SSE2)
+                if (useSimd())
+                    return interpolateRowSse2(dst, a, b, n, f);
+#endif
+                interpolateRowScalar(dst, a, b, n, f);
+            }
+
+            void blendRow(uint8_t *dst, const uint8_t *src, const uint8_t *alpha, int n, bool pairs)
+            {
+#if defined(IMGPROC_HAVE_NEON)
+                if (useSimd())
+                    return blendRowNeon(dst, src, alpha, n, pairs);
+#elif defined(IMGPROC_HAVE_AVX2)
+                if (useSimd())
+                    return blendRowAvx2(dst, src, alpha, n, pairs);
+#elif defined(IMGPROC_HAVE_SSE2)
+                if (useSimd())
+                    return blendRowSse2(dst, src, alpha, n, pairs);
+#endif
+                blendRowScalar(dst, src, alpha, n, pairs);
+            }
+
+            void accumulateRow(uint16_t *sum, const uint8_t *src, int n)
+            {
+#if defined(IMGPROC_HAVE_NEON)
+                if (useSimd())
+                    return accumulateRowNeon(sum, src, n);
+#elif defined(IMGPROC_HAVE_SSE2)
+                if (useSimd())
+                    return accumulateRowSse2(sum, src, n);
+#endif
+                accumulateRowScalar(sum, src, n);
+            }
+
+            bool validNV12(const NV12Image &image)
+            {
+                return image.y != nullptr && image.uv != nullptr && image.width > 0 && image.height > 0 &&
+                       (image.width & 1) == 0 && (image.height & 1) == 0 && image.y_stride >= image.width &&
+                       image.uv_stride >= image.width;
+            }
+
+            /**
+             * 一个平面上的块平均：rows 行、cols 列（字节），channels 个交织通道（Y为1，UV为2），
+             * 每块 block_w x block_h 个样本；sums 至少 cols 个元素
+             */
+            void mosaicPlane(uint8_t *plane, int stride, int cols, int rows, int channels, int block_w, int block_h,
+                             uint16_t *sums)
+            {
+                for (int by = 0; by < rows; by += block_h)
+                {
+                    int bh = std::min(block_h, rows - by);
+                    memset(sums, 0, (size_t)cols * sizeof(uint16_t));
+                    for (int r = 0; r < bh; r++)
+                        accumulateRow(sums, plane + (size_t)(by + r) * stride, cols);
+
+                    for (int bx = 0; bx < cols; bx += block_w * channels)
+                    {
+                        int bw = std::min(block_w * channels, cols - bx); // 字节数
+                        uint8_t avg[2];
+                        int count = (bw / channels) * bh;
+                        for (int c = 0; c < channels; c++)
+                        {
+                            uint32_t total = 0;
+                            for (int k = c; k < bw; k += channels)
+                                total += sums[bx + k];
+                            avg[c] = (uint8_t)((total + count / 2) / count);
+                        }
+                        for (int r = 0; r < bh; r++)
+                        {
+                            uint8_t *dst = plane + (size_t)(by + r) * stride + bx;
+                            if (channels == 1)
+                            {
+                                memset(dst, avg[0], bw);
+                                continue;
+                            }
+                            for (int k = 0; k < bw; k += 2)
+                            {
+                                dst[k] = avg[0];
+                                dst[k + 1] = avg[1];
+                            }
+                        }
+                    }
+                }
+            }
+        } // namespace
+
+        NV12Image nv12View(void *base, int width, int height, int stride, int vir_height)
+        {
+            NV12Image image;
+            if (base == nullptr)
+                return image;
+            int plane_rows = vir_height > 0 ? vir_height : height;
+            image.y = (uint8_t *)base;
+            image.uv = image.y + (size_t)stride * plane_rows;
+            image.width = width;
+            image.height = height;
+            image.y_stride = stride;
+            image.uv_stride = stride;
+            return image;
+        }
+
+        NV12Image cropNV12(const NV12Image &src, int x, int y, int width, int height)
+        {
+            NV12Image view;
+            x = std::max(0, x) & ~1;
+            y = std::max(0, y) & ~1;
+            width = std::min(width, src.width - x) & ~1;
+            height = std::min(height, src.height - y) & ~1;
+            if (src.y == nullptr || width <= 0 || height <= 0)
+                return view;
+            view.y = src.y + (size_t)y * src.y_stride + x;
+            view.uv = src.uv + (size_t)(y / 2) * src.uv_stride + x;
+            view.width = width;
+            view.height = height;
+            view.y_stride = src.y_stride;
+            view.uv_stride = src.uv_stride;
+            return view;
+        }
+
+        int copyNV12(const NV12Image &src, const NV12Image &dst)
+        {
+            if (!validNV12(src) || !validNV12(dst))
+                return -1;
+            int width = std::min(src.width, dst.width);
+            int height = std::min(src.height, dst.height);
+            for (int r = 0; r < height; r++)
+                memcpy(dst.y + (size_t)r * dst.y_stride, src.y + (size_t)r * src.y_stride, width);
+            for (int r = 0; r < height / 2; r++)
+                memcpy(dst.uv + (size_t)r * dst.uv_stride, src.uv + (size_t)r * src.uv_stride, width);
+            return 0;
+        }
+
+        int nv12ToI420(const NV12Image &src, const I420Image &dst)
+        {
+            if (!validNV12(src) || dst.y == nullptr || dst.u == nullptr || dst.v == nullptr ||
+                dst.width != src.width || dst.height != src.height)
+                return -1;
+            for (int r = 0; r < src.height; r++)
+                memcpy(dst.y + (size_t)r * dst.y_stride, src.y + (size_t)r * src.y_stride, src.width);
+            for (int r = 0; r < src.height / 2; r++)
+                splitUVRow(src.uv + (size_t)r * src.uv_stride, dst.u + (size_t)r * dst.u_stride,
+                           dst.v + (size_t)r * dst.v_stride, src.width / 2);
+            return 0;
+        }
+
+        int i420ToNV12(const I420Image &src, const NV12Image &dst)
+        {
+            if (!validNV12(dst) || src.y == nullptr || src.u == nullptr || src.v == nullptr ||
+                src.width != dst.width || src.height != dst.height)
+                return -1;
+            for (int r = 0; r < dst.height; r++)
+                memcpy(dst.y + (size_t)r * dst.y_stride, src.y + (size_t)r * src.y_stride, dst.width);
+            for (int r = 0; r < dst.height / 2; r++)
+                mergeUVRow(src.u + (size_t)r * src.u_stride, src.v + (size_t)r * src.v_stride,
+                           dst.uv + (size_t)r * dst.uv_stride, dst.width / 2);
+            return 0;
+        }
+
+        int nv12ToRgb(const NV12Image &src, uint8_t *rgb, int rgb_stride, RgbOrder order)
+        {
+            if (!validNV12(src) || rgb == nullptr || rgb_stride < src.width * 3)
+                return -1;
+            bool bgr = order == RgbOrder::kBGR;
+            for (int r = 0; r < src.height; r++)
+                nv12ToRgbRow(src.y + (size_t)r * src.y_stride, src.uv + (size_t)(r / 2) * src.uv_stride,
+                             rgb + (size_t)r * rgb_stride, src.width, bgr);
+            return 0;
+        }
+
+        int blendNV12(const NV12Image &dst, int x, int y, const NV12Image &src, const uint8_t *alpha, int alpha_stride)
+        {
+            if (!validNV12(dst) || !validNV12(src) || alpha == nullptr)
+                return -1;
+            x &= ~1;
+            y &= ~1;
+            // 裁掉超出 dst 的部分
+            int sx = std::max(0, -x);
+            int sy = std::max(0, -y);
+            int width = std::min(src.width - sx, dst.width - std::max(0, x));
+            int height = std::min(src.height - sy, dst.height - std::max(0, y));
+            if (width <= 0 || height <= 0)
+                return 0;
+            int dx = std::max(0, x);
+            int dy = std::max(0, y);
+            for (int r = 0; r < height; r++)
+                blendRow(dst.y + (size_t)(dy + r) * dst.y_stride + dx, src.y + (size_t)(sy + r) * src.y_stride + sx,
+                         alpha + (size_t)(sy + r) * alpha_stride + sx, width, false);
+            for (int r = 0; r < height / 2; r++)
+                blendRow(dst.uv + (size_t)(dy / 2 + r) * dst.uv_stride + dx, src.uv + (size_t)(sy / 2 + r) * src.uv_stride + sx,
+                         alpha + (size_t)(sy + 2 * r) * alpha_stride + sx, width, true);
+            return 0;
+        }
+
+        int mosaicNV12(const NV12Image &image, int x, int y, int width, int height, int block)
+        {
+            if (!validNV12(image) || block < 2 || block > 256 || (block & 1))
+                return -1;
+            NV12Image region = cropNV12(image, x, y, width, height);
+            if (region.y == nullptr)
+                return 0;
+            // 列和按行累加，每块最多 256 行 x 255，16位不会溢出；栈上放得下 4K 宽度
+            uint16_t sums[4096];
+            if (region.width > 4096)
+                return -1;
+            mosaicPlane(region.y, region.y_stride, region.width, region.height, 1, block, block, sums);
+            mosaicPlane(region.uv, region.uv_stride, region.width, region.height / 2, 2, block / 2, block / 2, sums);
+            return 0;
+        }
+
+        void BilinearScaler::buildAxis(int src_size, int dst_size, Axis &axis)
+        {
+            axis.index.resize(dst_size);
+            axis.frac.resize(dst_size);
+            // 16位定点，像素中心对齐：目标像素 i 的中心映射到源坐标 (i + 0.5) * step - 0.5
+            int64_t step = ((int64_t)src_size << 16) / dst_size;
+            int64_t pos = step / 2 - 32768;
+            for (int i = 0; i < dst_size; i++, pos += step)
+            {
+                int64_t p = std::max<int64_t>(0, pos);
+                int index = (int)(p >> 16);
+                int frac = (int)((p >> 8) & 0xFF);
+                if (index >= src_size - 1)
+                {
+                    // 右/下边缘：取最后一个样本（下一个样本权重为256），不越界读
+                    index = src_size - 2;
+                    frac = 256;
+                }
+                axis.index[i] = index;
+                axis.frac[i] = (uint16_t)frac;
+            }
+        }
+
+        int BilinearScaler::configure(int src_width, int src_height, int dst_width, int dst_height)
+        {
+            if (src_width < 4 || src_height < 4 || dst_width < 2 || dst_height < 2 || ((src_width | src_height | dst_width | dst_height) & 1))
+                return -1;
+            src_width_ = src_width;
+            src_height_ = src_height;
+            dst_width_ = dst_width;
+            dst_height_ = dst_height;
+            buildAxis(src_width, dst_width, luma_x_);
+            buildAxis(src_height, dst_height, luma_y_);
+            buildAxis(src_width / 2, dst_width / 2, chroma_x_);
+            buildAxis(src_height / 2, dst_height / 2, chroma_y_);
+            row_.resize(src_width);
+            hrow_[0].resize(dst_width);
+            hrow_[1].resize(dst_width);
+            return 0;
+        }
+
+        void BilinearScaler::scalePlane(const uint8_t *src, int src_stride, uint8_t *dst, int dst_stride, const Axis &xs,
+                                        const Axis &ys, int channels, bool horizontal_first)
+        {
+            int n = (int)xs.index.size();
+            if (horizontal_first)
+            {
+                // 放大：每个源行只做一次水平取样（缓存相邻两行），目标行由两行整行SIMD插值
+                int cached[2] = {-1, -1};
+                size_t out_bytes = (size_t)n * channels;
+                for (size_t r = 0; r < ys.index.size(); r++)
+                {
+                    int top = ys.index[r];
+                    if (cached[0] != top)
+                    {
+                        if (cached[1] == top)
+                        {
+                            hrow_[0].swap(hrow_[1]);
+                            std::swap(cached[0], cached[1]);
+                        }
+                        else
+                        {
+                            horizontalRow(hrow_[0].data(), src + (size_t)top * src_stride, xs.index.data(), xs.frac.data(), n, channels);
+                            cached[0] = top;
+                        }
+                    }
+                    if (cached[1] != top + 1)
+                    {
+                        horizontalRow(hrow_[1].data(), src + (size_t)(top + 1) * src_stride, xs.index.data(), xs.frac.data(), n, channels);
+                        cached[1] = top + 1;
+                    }
+                    uint8_t *out = dst + r * dst_stride;
+                    int fy = ys.frac[r];
+                    if (fy == 0)
+                        memcpy(out, hrow_[0].data(), out_bytes);
+                    else if (fy == 256)
+                        memcpy(out, hrow_[1].data(), out_bytes);
+                    else
+                        interpolateRow(out, hrow_[0].data(), hrow_[1].data(), (int)out_bytes, fy);
+                }
+                return;
+            }
+
+            int row_bytes = (xs.index.back() + 2) * channels; // 水平取样用到的最右字节
+            for (size_t r = 0; r < ys.index.size(); r++)
+            {
+                // 缩小：垂直方向权重为0或256时直接使用源行，否则整行SIMD插值，再水平取样
+                const uint8_t *a = src + (size_t)ys.index[r] * src_stride;
+                int fy = ys.frac[r];
+                const uint8_t *line = a;
+                if (fy == 256)
+                    line = a + src_stride;
+                else if (fy != 0)
+                {
+                    interpolateRow(row_.data(), a, a + src_stride, row_bytes, fy);
+                    line = row_.data();
+                }
+                horizontalRow(dst + r * dst_stride, line, xs.index.data(), xs.frac.data(), n, channels);
+            }
+        }
+
+        int BilinearScaler::scaleNV12(const NV12Image &src, const NV12Image &dst)
+        {
+            if (!validNV12(src) || !validNV12(dst) || src.width != src_width_ || src.height != src_height_ ||
+                dst.width != dst_width_ || dst.height != dst_height_)
+                return -1;
+            bool horizontal_first = dst_height_ > src_height_;
+            scalePlane(src.y, src.y_stride, dst.y, dst.y_stride, luma_x_, luma_y_, 1, horizontal_first);
+            scalePlane(src.uv, src.uv_stride, dst.uv, dst.uv_stride, chroma_x_, chroma_y_, 2, horizontal_first);
+            return 0;
+        }
+
+        const char *simdName()
+        {
+            if (!useSimd())
+                return "scalar";
+#if defined(IMGPROC_HAVE_NEON)
+            return "neon";
+#elif defined(IMGPROC_HAVE_AVX2)
+            return "avx2";
+#elif defined(IMGPROC_HAVE_SSE2)
+            return "sse2";
+#else
+            return "scalar";
+#endif
+        }
+
+        void setForceScalar(bool force)
+        {
+            g_force_scalar.store(force, std::memory_order_relaxed);
+        }
+
+    } // namespace imgproc
+} // namespace infra
@@ -0,0 +1,140 @@
+#include "infra/time/FramePacer.h"
+#include <cstdlib>
+
+extern "C"
+{
+#include "infra/logging/logger.h"
+}
+
+namespace infra
+{
+    namespace
+    {
+        const int64_t kFpsWindowUs = 1000000; // 实际帧率统计窗口
+    }
+
+    FramePacer::FramePacer(const std::string &name, int target_fps)
+        : name_(name), target_fps_(0), period_us_(0)
+    {
+        setTargetFps(target_fps);
+    }
+
+    void FramePacer::setTargetFps(int fps)
+    {
+        target_fps_ = fps > 0 ? fps : 0;
+        period_us_ = target_fps_ > 0 ? 1000000 / target_fps_ : 0;
+        next_due_us_ = -1;
+    }
+
+    bool FramePacer::admit(int64_t capture_us)
+    {
+        int64_t interval = last_input_us_ >= 0 ? capture_us - last_input_us_ : 0;
+        last_input_us_ = capture_us;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_.input++;
+        }
+
+        if (period_us_ > 0)
+        {
+            // 首帧、时间戳回退，或输入帧率足够却错过了整个输出周期（采集断流）：以当前帧重新对齐网格
+            bool behind = next_due_us_ >= 0 && capture_us - next_due_us_ >= period_us_ && interval <= period_us_;
+            if (next_due_us_ < 0 || capture_us < next_due_us_ - 2 * period_us_ || behind)
+            {
+                if (next_due_us_ >= 0)
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stats_.resyncs++;
+                }
+                next_due_us_ = capture_us;
+            }
+
+            // 离理想时刻最近的帧放行：早于理想时刻超过半个输入帧间隔的帧留给下一帧
+            int64_t half = interval > 0 ? interval / 2 : period_us_ / 2;
+            if (capture_us < next_due_us_ - half)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stats_.decimated++;
+                return false;
+            }
+            next_due_us_ += period_us_;
+            if (next_due_us_ <= capture_us - half)
+                next_due_us_ = capture_us + period_us_; // 目标帧率高于输入帧率：每帧都放行
+        }
+
+        onOutput(capture_us);
+        return true;
+    }
+
+    void FramePacer::observe(int64_t capture_us)
+    {
+        last_input_us_ = capture_us;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_.input++;
+        }
+        onOutput(capture_us);
+    }
+
+    void FramePacer::onOutput(int64_t capture_us)
+    {
+        bool print = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_.output++;
+
+            // 抖动：输出帧间隔相对目标周期的偏差（未设目标时相对平均间隔）
+            if (last_output_us_ >= 0)
+            {
+                int64_t interval = capture_us - last_output_us_;
+                double expected = period_us_ > 0 ? (double)period_us_ : avg_interval_us_;
+                if (expected > 0)
+                {
+                    double dev_ms = std::abs(interval - expected) / 1000.0;
+                    jitter_total_ms_ += dev_ms;
+                    jitter_samples_++;
+                    stats_.jitter_avg_ms = jitter_total_ms_ / jitter_samples_;
+                    if (dev_ms > stats_.jitter_max_ms)
+                        stats_.jitter_max_ms = dev_ms;
+                }
+                avg_interval_us_ = avg_interval_us_ > 0 ? avg_interval_us_ * 0.9 + interval * 0.1 : interval;
+            }
+            last_output_us_ = capture_us;
+
+            if (window_start_us_ < 0)
+                window_start_us_ = last_print_us_ = capture_us;
+            window_frames_++;
+            if (capture_us - window_start_us_ >= kFpsWindowUs)
+            {
+                stats_.achieved_fps = (window_frames_ - 1) * 1000000.0 / (capture_us - window_start_us_);
+                window_start_us_ = capture_us;
+                window_frames_ = 1;
+            }
+
+            if (stats_interval_s_ > 0 && capture_us - last_print_us_ >= (int64_t)stats_interval_s_ * 1000000)
+            {
+                last_print_us_ = capture_us;
+                print = true;
+            }
+        }
+        if (print)
+            printStats();
+    }
+
+    FramePacerStats FramePacer::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    void FramePacer::printStats() const
+    {
+        FramePacerStats st = getStats();
+        LOGI("[pacer] %s: target=%d achieved=%.2ffps in=%llu out=%llu decimated=%llu resync=%llu "
+             "jitter avg=%.2fms max=%.2fms",
+             name_.c_str(), target_fps_, st.achieved_fps, (unsigned long long)st.input,
+             (unsigned long long)st.output, (unsigned long long)st.decimated, (unsigned long long)st.resyncs,
+             st.jitter_avg_ms, st.jitter_max_ms);
+    }
+
+} // namespace infra
@@ -0,0 +1,86 @@
+#include "infra/time/MediaClock.h"
+#include <cstdlib>
+#include <time.h>
+
+namespace infra
+{
+    MediaClock &MediaClock::instance()
+    {
+        static MediaClock clock;
+        return clock;
+    }
+
+    int64_t MediaClock::nowUs()
+    {
+        struct timespec ts = {0, 0};
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+    }
+
+    void MediaClock::start()
+    {
+        epoch_us_.store(nowUs(), std::memory_order_release);
+        last_pts_[kVideo].store(kUnset, std::memory_order_relaxed);
+        last_pts_[kAudio].store(kUnset, std::memory_order_relaxed);
+        max_abs_skew_us_.store(0, std::memory_order_relaxed);
+    }
+
+    int64_t MediaClock::toMediaTime(int64_t capture_us)
+    {
+        int64_t epoch = epoch_us_.load(std::memory_order_acquire);
+        if (epoch == kUnset)
+        {
+            // 未显式 start()：第一次打戳的采集时刻作为 epoch（多个线程同时打戳时以先到者为准）
+            if (!epoch_us_.compare_exchange_strong(epoch, capture_us, std::memory_order_acq_rel))
+                return capture_us > epoch ? capture_us - epoch : 0;
+            return 0;
+        }
+        return capture_us > epoch ? capture_us - epoch : 0;
+    }
+
+    void MediaClock::notePresented(MediaKind kind, int64_t pts)
+    {
+        last_pts_[kind].store(pts, std::memory_order_relaxed);
+        int64_t skew = avSkewUs();
+        int64_t abs_skew = skew < 0 ? -skew : skew;
+        int64_t max_skew = max_abs_skew_us_.load(std::memory_order_relaxed);
+        while (abs_skew > max_skew &&
+               !max_abs_skew_us_.compare_exchange_weak(max_skew, abs_skew, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    int64_t MediaClock::avSkewUs() const
+    {
+        int64_t video = last_pts_[kVideo].load(std::memory_order_relaxed);
+        int64_t audio = last_pts_[kAudio].load(std::memory_order_relaxed);
+        if (video == kUnset || audio == kUnset)
+            return 0;
+        return video - audio;
+    }
+
+    void AudioTimestamper::onCapture(int64_t capture_end_us, int64_t pending_samples)
+    {
+        // 按实际采集时刻推算的、下一帧第一个样本的媒体时间
+        int64_t measured = MediaClock::instance().toMediaTime(
+            capture_end_us - pending_samples * 1000000 / sample_rate_);
+        int64_t predicted = anchor_us_ + (next_sample_ - anchor_sample_) * 1000000 / sample_rate_;
+
+        if (!anchored_ || std::llabs(predicted - measured) > resync_threshold_us_)
+        {
+            if (anchored_)
+                resync_count_++;
+            anchored_ = true;
+            anchor_us_ = measured;
+            anchor_sample_ = next_sample_;
+        }
+    }
+
+    int64_t AudioTimestamper::next(int nb_samples)
+    {
+        int64_t pts = anchor_us_ + (next_sample_ - anchor_sample_) * 1000000 / sample_rate_;
+        next_sample_ += nb_samples;
+        return pts;
+    }
+
+} // namespace infra
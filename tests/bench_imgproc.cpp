@@ -0,0 +1,299 @@
+// 图像内核基准：NV12 上各内核（SIMD / 标量）与 OpenCV、libswscale 同类操作的吞吐，按输入帧字节计 MB/s
+// 用法: camera_bench_imgproc [每项次数=200] [宽=1920] [高=1080]
+//   SIMD 与标量结果逐字节比较；OpenCV / swscale 的舍入与色度取样方式不同，只作性能参考
+//   scale  : 双线性缩小到 1/3（1080p → 640x360）
+//   crop   : 中央 1/2 x 1/2 区域拷贝为独立图像
+//   blend  : 整帧叠加一帧同尺寸图像（逐像素 alpha）
+//   mosaic : 整帧 16x16 块平均
+#include "infra/imgproc/ImageKernels.h"
+#include "infra/time/TimeUtils.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+extern "C"
+{
+#include "infra/logging/logger.h"
+#include <libavutil/pixfmt.h>
+#include <libswscale/swscale.h>
+}
+
+namespace
+{
+    using infra::imgproc::I420Image;
+    using infra::imgproc::NV12Image;
+
+    typedef std::function<void()> Kernel;
+
+    struct BenchCase
+    {
+        const char *name;
+        size_t bytes;      // 每次处理的输入字节数
+        Kernel ours;
+        Kernel opencv;     // 为空表示没有对应操作
+        Kernel swscale;
+        std::function<const std::vector<uint8_t> &()> output; // SIMD/标量对比的输出缓冲
+        Kernel reset;      // 原地修改的内核每次运行前恢复输入
+    };
+
+    double throughput(const Kernel &kernel, const Kernel &reset, size_t bytes, int iterations)
+    {
+        kernel(); // 预热（缓存、swscale 内部缓冲）
+        uint64_t total_us = 0;
+        for (int i = 0; i < iterations; i++)
+        {
+            if (reset)
+                reset();
+            uint64_t start = infra::now_us();
+            kernel();
+            total_us += infra::now_us() - start;
+        }
+        return total_us > 0 ? (double)bytes * iterations / total_us : 0; // 字节/微秒 = MB/s
+    }
+
+    void fillFrame(std::vector<uint8_t> &buf, int width, int height)
+    {
+        unsigned seed = 1;
+        for (int y = 0; y < height * 3 / 2; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                seed = seed * 1103515245 + 12345;
+                buf[(size_t)y * width + x] = (uint8_t)((x + y) / 4 + ((seed >> 16) & 31));
+            }
+        }
+    }
+
+    void printRow(const char *name, const char *impl, double mbps, double base_mbps, const char *note = "")
+    {
+        if (mbps <= 0)
+        {
+            printf("%-10s %-8s %10s %8s\n", name, impl, "-", "");
+            return;
+        }
+        printf("%-10s %-8s %10.1f %7.2fx %s\n", name, impl, mbps, base_mbps > 0 ? mbps / base_mbps : 0, note);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : 200;
+    int width = argc > 2 ? atoi(argv[2]) & ~1 : 1920;
+    int height = argc > 3 ? atoi(argv[3]) & ~1 : 1080;
+    int dst_w = (width / 3) & ~1;
+    int dst_h = (height / 3) & ~1;
+    int crop_w = (width / 2) & ~1;
+    int crop_h = (height / 2) & ~1;
+    log_init("bench_imgproc.log", LOG_LEVEL_INFO);
+
+    size_t frame_bytes = (size_t)width * height * 3 / 2;
+    std::vector<uint8_t> src(frame_bytes), overlay(frame_bytes), alpha((size_t)width * height);
+    fillFrame(src, width, height);
+    fillFrame(overlay, width, height);
+    std::reverse(overlay.begin(), overlay.end());
+    for (size_t i = 0; i < alpha.size(); i++)
+        alpha[i] = (uint8_t)((i % width) * 255 / width); // 水平渐变，覆盖 0~255 全部取值
+    NV12Image src_img = infra::imgproc::nv12View(src.data(), width, height, width);
+    NV12Image overlay_img = infra::imgproc::nv12View(overlay.data(), width, height, width);
+
+    std::vector<uint8_t> i420(frame_bytes), nv12(frame_bytes), rgb((size_t)width * height * 3);
+    std::vector<uint8_t> scaled((size_t)dst_w * dst_h * 3 / 2), cropped((size_t)crop_w * crop_h * 3 / 2);
+    std::vector<uint8_t> work(frame_bytes); // 原地内核（blend/mosaic）的工作帧
+    I420Image i420_img;
+    i420_img.y = i420.data();
+    i420_img.u = i420.data() + (size_t)width * height;
+    i420_img.v = i420_img.u + (size_t)width * height / 4;
+    i420_img.width = width;
+    i420_img.height = height;
+    i420_img.y_stride = width;
+    i420_img.u_stride = i420_img.v_stride = width / 2;
+    NV12Image nv12_img = infra::imgproc::nv12View(nv12.data(), width, height, width);
+    NV12Image scaled_img = infra::imgproc::nv12View(scaled.data(), dst_w, dst_h, dst_w);
+    NV12Image cropped_img = infra::imgproc::nv12View(cropped.data(), crop_w, crop_h, crop_w);
+    NV12Image work_img = infra::imgproc::nv12View(work.data(), width, height, width);
+    infra::imgproc::BilinearScaler scaler;
+    if (scaler.configure(width, height, dst_w, dst_h) != 0)
+    {
+        printf("bad size %dx%d\n", width, height);
+        return -1;
+    }
+
+    // OpenCV：Y 与 UV 分别作为单通道/双通道 Mat（不拷贝）
+    cv::Mat cv_nv12(height * 3 / 2, width, CV_8UC1, src.data());
+    cv::Mat cv_y(height, width, CV_8UC1, src.data());
+    cv::Mat cv_uv(height / 2, width / 2, CV_8UC2, src.data() + (size_t)width * height);
+    cv::Mat cv_work_y(height, width, CV_8UC1, work.data());
+    cv::Mat cv_work_uv(height / 2, width / 2, CV_8UC2, work.data() + (size_t)width * height);
+    cv::Mat cv_over_y(height, width, CV_8UC1, overlay.data());
+    cv::Mat cv_over_uv(height / 2, width / 2, CV_8UC2, overlay.data() + (size_t)width * height);
+    cv::Mat cv_bgr(height, width, CV_8UC3, rgb.data());
+    cv::Mat cv_scaled_y(dst_h, dst_w, CV_8UC1, scaled.data());
+    cv::Mat cv_scaled_uv(dst_h / 2, dst_w / 2, CV_8UC2, scaled.data() + (size_t)dst_w * dst_h);
+    cv::Mat cv_crop_y(crop_h, crop_w, CV_8UC1, cropped.data());
+    cv::Mat cv_crop_uv(crop_h / 2, crop_w / 2, CV_8UC2, cropped.data() + (size_t)crop_w * crop_h);
+    cv::Rect crop_y_rect(width / 4 & ~1, height / 4 & ~1, crop_w, crop_h);
+    cv::Rect crop_uv_rect(crop_y_rect.x / 2, crop_y_rect.y / 2, crop_w / 2, crop_h / 2);
+    // blendLinear 需要浮点权重（预先转换，不计入耗时）
+    cv::Mat w_over_y, w_over_uv, w_work_y, w_work_uv;
+    cv::Mat(height, width, CV_8UC1, alpha.data()).convertTo(w_over_y, CV_32F, 1.0 / 255);
+    w_work_y = 1.0 - w_over_y;
+    cv::resize(w_over_y, w_over_uv, cv::Size(width / 2, height / 2), 0, 0, cv::INTER_NEAREST);
+    w_work_uv = 1.0 - w_over_uv;
+    cv::Mat cv_blend_y, cv_blend_uv, cv_small_y, cv_small_uv;
+
+    // swscale：上下文预先创建
+    SwsContext *sws_i420 = sws_getContext(width, height, AV_PIX_FMT_NV12, width, height, AV_PIX_FMT_YUV420P, SWS_POINT, nullptr, nullptr, nullptr);
+    SwsContext *sws_nv12 = sws_getContext(width, height, AV_PIX_FMT_YUV420P, width, height, AV_PIX_FMT_NV12, SWS_POINT, nullptr, nullptr, nullptr);
+    SwsContext *sws_bgr = sws_getContext(width, height, AV_PIX_FMT_NV12, width, height, AV_PIX_FMT_BGR24, SWS_POINT, nullptr, nullptr, nullptr);
+    SwsContext *sws_scale_ctx = sws_getContext(width, height, AV_PIX_FMT_NV12, dst_w, dst_h, AV_PIX_FMT_NV12, SWS_BILINEAR, nullptr, nullptr, nullptr);
+    const uint8_t *nv12_src[4] = {src.data(), src.data() + (size_t)width * height, nullptr, nullptr};
+    int nv12_src_stride[4] = {width, width, 0, 0};
+    uint8_t *i420_dst[4] = {i420_img.y, i420_img.u, i420_img.v, nullptr};
+    int i420_stride[4] = {width, width / 2, width / 2, 0};
+    const uint8_t *i420_src[4] = {i420_img.y, i420_img.u, i420_img.v, nullptr};
+    uint8_t *nv12_dst[4] = {nv12.data(), nv12.data() + (size_t)width * height, nullptr, nullptr};
+    uint8_t *bgr_dst[4] = {rgb.data(), nullptr, nullptr, nullptr};
+    int bgr_stride[4] = {width * 3, 0, 0, 0};
+    uint8_t *scaled_dst[4] = {scaled.data(), scaled.data() + (size_t)dst_w * dst_h, nullptr, nullptr};
+    int scaled_stride[4] = {dst_w, dst_w, 0, 0};
+    // i420→nv12 的输入先由 nv12ToI420 生成
+    infra::imgproc::nv12ToI420(src_img, i420_img);
+
+    Kernel reset_work = [&]()
+    { memcpy(work.data(), src.data(), frame_bytes); };
+
+    std::vector<BenchCase> cases = {
+        {"nv12>i420", frame_bytes,
+         [&]()
+         { infra::imgproc::nv12ToI420(src_img, i420_img); },
+         nullptr,
+         [&]()
+         { sws_scale(sws_i420, nv12_src, nv12_src_stride, 0, height, i420_dst, i420_stride); },
+         [&]() -> const std::vector<uint8_t> &
+         { return i420; },
+         nullptr},
+        {"i420>nv12", frame_bytes,
+         [&]()
+         { infra::imgproc::i420ToNV12(i420_img, nv12_img); },
+         nullptr,
+         [&]()
+         { sws_scale(sws_nv12, i420_src, i420_stride, 0, height, nv12_dst, nv12_src_stride); },
+         [&]() -> const std::vector<uint8_t> &
+         { return nv12; },
+         nullptr},
+        {"nv12>bgr", frame_bytes,
+         [&]()
+         { infra::imgproc::nv12ToRgb(src_img, rgb.data(), width * 3, infra::imgproc::RgbOrder::kBGR); },
+         [&]()
+         { cv::cvtColor(cv_nv12, cv_bgr, cv::COLOR_YUV2BGR_NV12); },
+         [&]()
+         { sws_scale(sws_bgr, nv12_src, nv12_src_stride, 0, height, bgr_dst, bgr_stride); },
+         [&]() -> const std::vector<uint8_t> &
+         { return rgb; },
+         nullptr},
+        {"scale", frame_bytes,
+         [&]()
+         { scaler.scaleNV12(src_img, scaled_img); },
+         [&]()
+         {
+             cv::resize(cv_y, cv_scaled_y, cv_scaled_y.size(), 0, 0, cv::INTER_LINEAR);
+             cv::resize(cv_uv, cv_scaled_uv, cv_scaled_uv.size(), 0, 0, cv::INTER_LINEAR);
+         },
+         [&]()
+         { sws_scale(sws_scale_ctx, nv12_src, nv12_src_stride, 0, height, scaled_dst, scaled_stride); },
+         [&]() -> const std::vector<uint8_t> &
+         { return scaled; },
+         nullptr},
+        {"crop", (size_t)crop_w * crop_h * 3 / 2,
+         [&]()
+         {
+             NV12Image view = infra::imgproc::cropNV12(src_img, crop_y_rect.x, crop_y_rect.y, crop_w, crop_h);
+             infra::imgproc::copyNV12(view, cropped_img);
+         },
+         [&]()
+         {
+             cv_y(crop_y_rect).copyTo(cv_crop_y);
+             cv_uv(crop_uv_rect).copyTo(cv_crop_uv);
+         },
+         nullptr,
+         [&]() -> const std::vector<uint8_t> &
+         { return cropped; },
+         nullptr},
+        {"blend", frame_bytes,
+         [&]()
+         { infra::imgproc::blendNV12(work_img, 0, 0, overlay_img, alpha.data(), width); },
+         [&]()
+         {
+             cv::blendLinear(cv_over_y, cv_work_y, w_over_y, w_work_y, cv_blend_y);
+             cv::blendLinear(cv_over_uv, cv_work_uv, w_over_uv, w_work_uv, cv_blend_uv);
+             cv_blend_y.copyTo(cv_work_y); // 写回工作帧，与原地叠加的输出一致
+             cv_blend_uv.copyTo(cv_work_uv);
+         },
+         nullptr,
+         [&]() -> const std::vector<uint8_t> &
+         { return work; },
+         reset_work},
+        {"mosaic", frame_bytes,
+         [&]()
+         { infra::imgproc::mosaicNV12(work_img, 0, 0, width, height, 16); },
+         [&]()
+         {
+             // 面积平均缩小再最近邻放大，等价于块平均（整除时）
+             cv::resize(cv_work_y, cv_small_y, cv::Size(width / 16, height / 16), 0, 0, cv::INTER_AREA);
+             cv::resize(cv_small_y, cv_work_y, cv_work_y.size(), 0, 0, cv::INTER_NEAREST);
+             cv::resize(cv_work_uv, cv_small_uv, cv::Size(width / 16, height / 16), 0, 0, cv::INTER_AREA);
+             cv::resize(cv_small_uv, cv_work_uv, cv_work_uv.size(), 0, 0, cv::INTER_NEAREST);
+         },
+         nullptr,
+         [&]() -> const std::vector<uint8_t> &
+         { return work; },
+         reset_work},
+    };
+
+    printf("%dx%d NV12, %d iterations per kernel, simd=%s (MB/s of input, speedup vs scalar)\n", width, height,
+           iterations, infra::imgproc::simdName());
+    printf("%-10s %-8s %10s %8s\n", "kernel", "impl", "MB/s", "speedup");
+    bool all_match = true;
+    for (const BenchCase &bench : cases)
+    {
+        // 标量与SIMD各跑一次比较输出
+        infra::imgproc::setForceScalar(true);
+        if (bench.reset)
+            bench.reset();
+        bench.ours();
+        std::vector<uint8_t> scalar_out = bench.output();
+        infra::imgproc::setForceScalar(false);
+        if (bench.reset)
+            bench.reset();
+        bench.ours();
+        bool match = bench.output() == scalar_out;
+        all_match = all_match && match;
+
+        infra::imgproc::setForceScalar(true);
+        double scalar = throughput(bench.ours, bench.reset, bench.bytes, iterations);
+        infra::imgproc::setForceScalar(false);
+        double simd = throughput(bench.ours, bench.reset, bench.bytes, iterations);
+        double opencv = bench.opencv ? throughput(bench.opencv, bench.reset, bench.bytes, iterations) : 0;
+        double sws = bench.swscale ? throughput(bench.swscale, bench.reset, bench.bytes, iterations) : 0;
+
+        printRow(bench.name, "scalar", scalar, scalar);
+        printRow(bench.name, infra::imgproc::simdName(), simd, scalar, match ? "bit-exact" : "MISMATCH");
+        printRow(bench.name, "opencv", opencv, scalar);
+        printRow(bench.name, "swscale", sws, scalar);
+    }
+    printf("simd vs scalar: %s\n", all_match ? "all bit-exact" : "MISMATCH");
+
+    sws_freeContext(sws_i420);
+    sws_freeContext(sws_nv12);
+    sws_freeContext(sws_bgr);
+    sws_freeContext(sws_scale_ctx);
+    log_close();
+    return all_match ? 0 : -1;
+}
@@ -0,0 +1,100 @@
+// 隐私遮挡基准：1080p NV12 上各模式、不同遮挡面积的每帧耗时（应随遮挡面积线性增长，与整帧大小无关）
+// 用法: camera_bench_privacy [帧数=300]
+//   rect    : 一个矩形（马赛克走 imgproc::mosaicNV12）
+//   polygon : 一个同等面积的四边形（按扫描线处理）
+//   8 masks : 8个矩形铺满对应面积（区域数上限）
+#include "core/PrivacyMasker.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+extern "C"
+{
+#include "infra/logging/logger.h"
+}
+
+namespace
+{
+    const int kWidth = 1920;
+    const int kHeight = 1080;
+
+    // 给定面积占比的遮挡区域：shape 0 矩形，1 平行四边形，2 八个矩形
+    std::vector<core::PrivacyMask> makeMasks(int shape, double fraction, core::PrivacyMaskMode mode)
+    {
+        std::vector<core::PrivacyMask> masks;
+        int w = (int)(kWidth * std::sqrt(fraction));
+        int h = (int)(kHeight * std::sqrt(fraction));
+        if (shape == 0)
+            masks.push_back(core::PrivacyMask::rect(0, 0, w, h, mode));
+        else if (shape == 1)
+        {
+            core::PrivacyMask mask;
+            mask.mode = mode;
+            int skew = w / 4; // 平行四边形面积与同宽高的矩形相同
+            mask.polygon = {{skew, 0}, {w + skew, 0}, {w, h}, {0, h}};
+            masks.push_back(mask);
+        }
+        else
+        {
+            int cell_w = w / 4, cell_h = h / 2;
+            for (int i = 0; i < core::kMaxPrivacyMasks; i++)
+                masks.push_back(core::PrivacyMask::rect((i % 4) * cell_w, (i / 4) * cell_h, cell_w, cell_h, mode));
+        }
+        return masks;
+    }
+
+    core::PrivacyMaskStats run(const std::vector<core::PrivacyMask> &masks, std::vector<uint8_t> &frame,
+                               const std::vector<uint8_t> &source, int frames)
+    {
+        core::PrivacyMasker masker("bench");
+        masker.setMasks(masks);
+        for (int i = 0; i < frames; i++)
+        {
+            memcpy(frame.data(), source.data(), frame.size()); // 每帧从原图开始，不计入耗时
+            masker.maskNV12(frame.data(), frame.data() + (size_t)kWidth * kHeight, kWidth, kWidth, kHeight);
+        }
+        return masker.getStats();
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int frames = argc > 1 ? atoi(argv[1]) : 300;
+    log_init("bench_privacy.log", LOG_LEVEL_INFO);
+
+    std::vector<uint8_t> source((size_t)kWidth * kHeight * 3 / 2), frame(source.size());
+    unsigned seed = 1;
+    for (uint8_t &v : source)
+    {
+        seed = seed * 1103515245 + 12345;
+        v = (uint8_t)(seed >> 16);
+    }
+
+    const char *mode_names[] = {"solid", "pixelate", "blur"};
+    const core::PrivacyMaskMode modes[] = {core::PrivacyMaskMode::kSolid, core::PrivacyMaskMode::kPixelate,
+                                           core::PrivacyMaskMode::kBlur};
+    const char *shape_names[] = {"rect", "polygon", "8 masks"};
+    const double fractions[] = {0.01, 0.05, 0.25, 1.0};
+
+    printf("%dx%d NV12, %d frames per run, block 16\n", kWidth, kHeight, frames);
+    printf("%-9s %-8s %7s %10s %10s %12s\n", "mode", "shape", "area", "avg us", "max us", "ns/px");
+    for (int m = 0; m < 3; m++)
+    {
+        for (int shape = 0; shape < 3; shape++)
+        {
+            for (double fraction : fractions)
+            {
+                core::PrivacyMaskStats st = run(makeMasks(shape, fraction, modes[m]), frame, source, frames);
+                double area = st.frame_pixels ? st.masked_pixels * 100.0 / st.frame_pixels : 0;
+                printf("%-9s %-8s %6.1f%% %10.1f %10llu %12.2f\n", mode_names[m], shape_names[shape], area,
+                       st.apply_us_avg, (unsigned long long)st.apply_us_max,
+                       st.masked_pixels ? st.apply_us_avg * 1000.0 / st.masked_pixels : 0.0);
+            }
+        }
+    }
+
+    log_close();
+    return 0;
+}
@@ -0,0 +1,247 @@
+// 码率控制基准：同一段输入依次按各码率控制配置编码（模拟MPI后端），对比码率波动与每帧大小
+// 用法: camera_bench_rc_profiles [每种配置帧数=600] [NV12录制文件] [宽=1280] [高=720]
+//   每种配置都从片头开始编码同一段画面；vbr->cbr 在运行中途由VBR切到CBR（不重建通道）
+//   普通P帧与智能P帧的对比建议使用固定机位的静止场景录像，帧数不少于智能P帧的IDR间隔（默认600帧）；
+//   模拟后端的虚拟I帧按普通P帧编码，得到的是节省比例的上限，板端数值需在设备上复测
+#include "driver/MPIManager.hpp"
+#include "driver/RcProfile.hpp"
+#include "driver/SimMPIBackend.hpp"
+#include "driver/VideoEncoderDriver.hpp"
+#include "driver/VideoInputDriver.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+extern "C"
+{
+#include "infra/logging/logger.h"
+}
+
+namespace
+{
+    const int kFps = 30;
+    const uint32_t kMaxPacks = 16; // 一帧码流的最大包数（参数集/SEI/slice 各一包）
+
+    struct BenchCase
+    {
+        const char *name;
+        const char *profile;        // parseRcProfile 格式
+        const char *switch_profile; // 非空时在中途切换到该配置
+        const char *baseline;       // 非空时在汇总中与该项对比码率
+    };
+
+    struct BenchResult
+    {
+        std::vector<uint32_t> frame_bytes;
+        std::vector<bool> key;
+    };
+
+    // 汇总对比用
+    struct BenchSummary
+    {
+        double mean_kbps = 0;
+        int i_count = 0;
+        double i_kbytes = 0; // I帧合计
+    };
+
+    uint32_t streamBytes(const VENC_STREAM_S &stream)
+    {
+        uint32_t bytes = 0;
+        for (uint32_t i = 0; i < stream.u32PackCount; i++)
+            bytes += stream.pstPack[i].u32Len;
+        return bytes;
+    }
+
+    bool isKey(const VENC_STREAM_S &stream)
+    {
+        for (uint32_t i = 0; i < stream.u32PackCount; i++)
+        {
+            if (stream.pstPack[i].DataType.enH265EType == H265E_NALU_IDRSLICE)
+                return true;
+        }
+        return false;
+    }
+
+    int runCase(const BenchCase &bench, driver::VideoInputDriver &vi_driver, int width, int height, int frame_count,
+                BenchResult &result)
+    {
+        driver::VideoEncoderConfig venc_config;
+        venc_config.width = width;
+        venc_config.height = height;
+        venc_config.fps = kFps;
+        if (driver::parseRcProfile(bench.profile, venc_config.rc) != 0)
+            return -1;
+        std::unique_ptr<driver::VideoEncoderDriver> venc(new driver::VideoEncoderDriver());
+        if (venc->init(venc_config) != 0)
+            return -1;
+        venc->start();
+
+        VENC_PACK_S packs[kMaxPacks];
+        VENC_STREAM_S stream;
+        memset(&stream, 0, sizeof(stream));
+        stream.pstPack = packs;
+
+        // 每轮从片头开始
+        vi_driver.start();
+        for (int i = 0; i < frame_count; i++)
+        {
+            if (bench.switch_profile && i == frame_count / 2)
+            {
+                driver::RcProfile profile;
+                driver::parseRcProfile(bench.switch_profile, profile);
+                venc->setRcProfile(profile);
+            }
+
+            VIDEO_FRAME_INFO_S frame;
+            if (vi_driver.getFrame(frame, -1) != RK_SUCCESS)
+                continue;
+            // 按标称帧率的媒体时间送帧，编码器的码率控制与主机速度无关
+            frame.stVFrame.u64PTS = (uint64_t)i * 1000000 / kFps;
+            int ret = venc->sendFrame(frame, -1);
+            vi_driver.releaseFrame(frame);
+            if (ret != RK_SUCCESS)
+                continue;
+            stream.u32PackCount = kMaxPacks;
+            if (venc->getStream(stream, 1000) != RK_SUCCESS)
+                continue;
+            result.frame_bytes.push_back(streamBytes(stream));
+            result.key.push_back(isKey(stream));
+            venc->releaseStream(stream);
+        }
+        vi_driver.stop();
+        venc->stop();
+        return 0;
+    }
+
+    // 每秒码率（kbps）的均值/标准差，以及I/P帧平均大小
+    BenchSummary report(const BenchCase &bench, const BenchResult &result)
+    {
+        std::vector<double> window_kbps;
+        for (size_t start = 0; start + kFps <= result.frame_bytes.size(); start += kFps)
+        {
+            uint64_t bytes = 0;
+            for (size_t i = start; i < start + kFps; i++)
+                bytes += result.frame_bytes[i];
+            window_kbps.push_back(bytes * 8 / 1000.0);
+        }
+        double mean = 0;
+        for (double kbps : window_kbps)
+            mean += kbps;
+        mean = window_kbps.empty() ? 0 : mean / window_kbps.size();
+        double variance = 0;
+        for (double kbps : window_kbps)
+            variance += (kbps - mean) * (kbps - mean);
+        variance = window_kbps.empty() ? 0 : variance / window_kbps.size();
+
+        uint64_t i_bytes = 0, p_bytes = 0;
+        int i_count = 0, p_count = 0;
+        uint32_t max_bytes = 0;
+        for (size_t i = 0; i < result.frame_bytes.size(); i++)
+        {
+            if (result.key[i])
+            {
+                i_bytes += result.frame_bytes[i];
+                i_count++;
+            }
+            else
+            {
+                p_bytes += result.frame_bytes[i];
+                p_count++;
+            }
+            max_bytes = std::max(max_bytes, result.frame_bytes[i]);
+        }
+        size_t frames = result.frame_bytes.size();
+        printf("%-14s %7zu %10.1f %10.1f %7.1f%% %10.1f %10.1f %10.1f %10.1f\n", bench.name, frames, mean,
+               std::sqrt(variance), mean > 0 ? std::sqrt(variance) * 100 / mean : 0,
+               frames ? (i_bytes + p_bytes) / 1024.0 / frames : 0, max_bytes / 1024.0,
+               i_count ? i_bytes / 1024.0 / i_count : 0, p_count ? p_bytes / 1024.0 / p_count : 0);
+
+        BenchSummary summary;
+        summary.mean_kbps = mean;
+        summary.i_count = i_count;
+        summary.i_kbytes = i_bytes / 1024.0;
+        return summary;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int frame_count = argc > 1 ? atoi(argv[1]) : 600;
+    int width = argc > 3 ? atoi(argv[3]) : 1280;
+    int height = argc > 4 ? atoi(argv[4]) : 720;
+
+    driver::SimBackendConfig sim_config;
+    sim_config.source_file = argc > 2 ? argv[2] : "";
+    sim_config.fps = 0;
+    driver::SimMPIBackend::instance().setConfig(sim_config);
+
+    log_init("bench_rc_profiles.log", LOG_LEVEL_INFO);
+
+    driver::MPIManager mpi_manager;
+    driver::VideoInputDriver vi_driver;
+    driver::VideoInputConfig vi_config;
+    vi_config.width = width;
+    vi_config.height = height;
+    if (mpi_manager.init() != 0 || vi_driver.init(vi_config) != 0)
+    {
+        printf("VI init failed, see bench_rc_profiles.log\n");
+        return -1;
+    }
+
+    const BenchCase cases[] = {
+        {"cbr", "mode=cbr,gop=60,bitrate=2048,stat=2", nullptr, nullptr},
+        {"vbr", "mode=vbr,gop=60,bitrate=2048,max=4096,min=512,stat=2", nullptr, nullptr},
+        {"avbr", "mode=avbr,gop=60,bitrate=2048,max=4096,min=256,stat=2", nullptr, nullptr},
+        {"vbr-qp24-40", "mode=vbr,gop=60,bitrate=2048,max=4096,min=512,qp=24-40,iqp_delta=-2", nullptr, nullptr},
+        {"fixqp", "mode=fixqp,gop=60,fixqp=26/28", nullptr, nullptr},
+        {"vbr->cbr", "mode=vbr,gop=60,bitrate=2048,max=4096,min=512,stat=2", "mode=cbr,gop=60,bitrate=1024,stat=2", nullptr},
+        // 智能P帧：IDR间隔600帧，每60帧一个虚拟I帧（随机接入间隔与普通P帧相同）
+        {"vbr-smartp", "mode=vbr,gop=600,bitrate=2048,max=4096,min=512,stat=2,gopmode=smartp,viridr=60", nullptr, "vbr"},
+        {"avbr-smartp", "mode=avbr,gop=600,bitrate=2048,max=4096,min=256,stat=2,gopmode=smartp,viridr=60", nullptr, "avbr"},
+        {"fixqp-smartp", "mode=fixqp,gop=600,fixqp=26/28,gopmode=smartp,viridr=60", nullptr, "fixqp"},
+    };
+    const size_t case_count = sizeof(cases) / sizeof(cases[0]);
+    std::vector<BenchSummary> summaries(case_count);
+    std::vector<bool> done(case_count, false);
+
+    printf("%dx%d, %d frames per profile @%dfps\n", width, height, frame_count, kFps);
+    printf("%-14s %7s %10s %10s %8s %10s %10s %10s %10s\n", "profile", "frames", "kbps/s", "stddev", "cv",
+           "KB/frame", "max KB", "I KB", "P KB");
+    for (size_t i = 0; i < case_count; i++)
+    {
+        BenchResult result;
+        if (runCase(cases[i], vi_driver, width, height, frame_count, result) != 0 || result.frame_bytes.empty())
+        {
+            printf("%-14s failed, see bench_rc_profiles.log\n", cases[i].name);
+            continue;
+        }
+        summaries[i] = report(cases[i], result);
+        done[i] = true;
+    }
+
+    // 与基准项对比：码率变化、I帧个数与I帧合计大小
+    printf("\n%-14s %-10s %10s %10s %8s %10s %12s\n", "profile", "baseline", "kbps/s", "base", "delta", "I frames",
+           "I KB total");
+    for (size_t i = 0; i < case_count; i++)
+    {
+        if (!cases[i].baseline || !done[i])
+            continue;
+        for (size_t j = 0; j < case_count; j++)
+        {
+            if (!done[j] || strcmp(cases[j].name, cases[i].baseline) != 0)
+                continue;
+            const BenchSummary &cur = summaries[i];
+            const BenchSummary &base = summaries[j];
+            printf("%-14s %-10s %10.1f %10.1f %7.1f%% %4d/%-5d %5.0f/%-6.0f\n", cases[i].name, cases[j].name,
+                   cur.mean_kbps, base.mean_kbps, base.mean_kbps > 0 ? (cur.mean_kbps - base.mean_kbps) * 100 / base.mean_kbps : 0,
+                   cur.i_count, base.i_count, cur.i_kbytes, base.i_kbytes);
+        }
+    }
+
+    log_close();
+    return 0;
+}
@@ -0,0 +1,222 @@
+// OsdRenderer 单元测试：已知 ARGB tile 叠加到 NV12 后的 Y/UV 值
+//   - 不透明/透明/半透明像素与 2x2 色度块的混合结果（BT.601 limited range）
+//   - 靠近右下边缘时裁剪，不写出帧外（行跨度填充与帧后内存不变）；坐标越界的区域跳过
+//   - osdBlendRow 的 SIMD 与标量实现按位一致，且等于 (src*a + dst*(255-a)) / 255 四舍五入
+// 用法: camera_test_osd_renderer（全部通过返回0）
+#include "core/OsdRenderer.hpp"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+extern "C"
+{
+#include "infra/logging/logger.h"
+}
+
+namespace
+{
+    int g_failures = 0;
+
+#define EXPECT(cond)                                                                  \
+    do                                                                                \
+    {                                                                                 \
+        if (!(cond))                                                                  \
+        {                                                                             \
+            fprintf(stderr, "%s:%d: EXPECT(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                             \
+        }                                                                             \
+    } while (0)
+
+    const uint8_t kBgY = 100; // 帧底色
+    const uint8_t kBgU = 60;
+    const uint8_t kBgV = 200;
+    const uint8_t kGuard = 0xEE; // 行跨度填充与帧后保护区
+
+    // NV12 帧，行跨度大于宽度，帧后多出一行保护区
+    struct Frame
+    {
+        int width;
+        int height;
+        int stride;
+        std::vector<uint8_t> mem;
+
+        Frame(int w, int h, int s) : width(w), height(h), stride(s), mem((size_t)s * (h + h / 2 + 1), kGuard)
+        {
+            for (int r = 0; r < h; r++)
+                memset(y() + (size_t)r * s, kBgY, w);
+            for (int r = 0; r < h / 2; r++)
+            {
+                for (int c = 0; c < w; c += 2)
+                {
+                    uv()[(size_t)r * s + c] = kBgU;
+                    uv()[(size_t)r * s + c + 1] = kBgV;
+                }
+            }
+        }
+
+        uint8_t *y() { return mem.data(); }
+        uint8_t *uv() { return mem.data() + (size_t)stride * height; }
+        uint8_t Y(int x, int row) { return y()[(size_t)row * stride + x]; }
+        uint8_t U(int x, int row) { return uv()[(size_t)(row / 2) * stride + (x & ~1)]; }
+        uint8_t V(int x, int row) { return uv()[(size_t)(row / 2) * stride + (x & ~1) + 1]; }
+    };
+
+    // 4x4 tile：左上 2x2 不透明白，右上全透明，左下不透明红，右下 alpha=128 的黑
+    std::vector<uint32_t> makeTile()
+    {
+        const uint32_t white = 0xFFFFFFFF, clear = 0x00000000, red = 0xFFFF0000, half_black = 0x80000000;
+        return {white, white, clear, clear,
+                white, white, clear, clear,
+                red, red, half_black, half_black,
+                red, red, half_black, half_black};
+    }
+
+    core::OsdRegionConfig tileConfig(int x, int y)
+    {
+        core::OsdRegionConfig config;
+        config.x = x;
+        config.y = y;
+        return config;
+    }
+
+    // 期望值（BT.601 limited range，混合按 /255 四舍五入）：
+    //   白 Y=235 UV=128/128；红 Y=82 U=90 V=240；
+    //   半透明黑 Y=round((16*128 + 100*127)/255)=58，U=round((128*128 + 60*127)/255)=94，V=round((128*128 + 200*127)/255)=164
+    void testComposite(bool force_scalar)
+    {
+        core::OsdRenderer::setForceScalar(force_scalar);
+        Frame frame(16, 8, 24);
+        core::OsdRenderer osd;
+        int id = osd.addRegion(tileConfig(5, 2)); // x 向下对齐到 4
+        std::vector<uint32_t> tile = makeTile();
+        EXPECT(osd.setTile(id, tile.data(), 4, 4) == 0);
+        EXPECT(osd.renderCount() == 1);
+        EXPECT(osd.drawNV12(frame.y(), frame.uv(), frame.stride, frame.width, frame.height) == 0);
+
+        // Y
+        EXPECT(frame.Y(4, 2) == 235 && frame.Y(5, 3) == 235);
+        EXPECT(frame.Y(6, 2) == kBgY && frame.Y(7, 3) == kBgY);
+        EXPECT(frame.Y(4, 4) == 82 && frame.Y(5, 5) == 82);
+        EXPECT(frame.Y(6, 4) == 58 && frame.Y(7, 5) == 58);
+        // tile 外不变
+        EXPECT(frame.Y(3, 2) == kBgY && frame.Y(8, 4) == kBgY && frame.Y(4, 1) == kBgY && frame.Y(4, 6) == kBgY);
+
+        // UV（每个2x2块一对）
+        EXPECT(frame.U(4, 2) == 128 && frame.V(4, 2) == 128);
+        EXPECT(frame.U(6, 2) == kBgU && frame.V(6, 2) == kBgV);
+        EXPECT(frame.U(4, 4) == 90 && frame.V(4, 4) == 240);
+        EXPECT(frame.U(6, 4) == 94 && frame.V(6, 4) == 164);
+        EXPECT(frame.U(2, 2) == kBgU && frame.U(8, 4) == kBgU && frame.U(4, 0) == kBgU && frame.U(4, 6) == kBgU);
+
+        core::OsdRenderer::setForceScalar(false);
+    }
+
+    // 右下角只剩 2x2 可见：只混合可见部分，填充与保护区不变
+    void testEdgeClipping()
+    {
+        Frame frame(16, 8, 24);
+        core::OsdRenderer osd;
+        std::vector<uint32_t> tile = makeTile();
+        int corner = osd.addRegion(tileConfig(14, 6));
+        int outside = osd.addRegion(tileConfig(16, 0)); // x == width，整块跳过
+        int negative = osd.addRegion(tileConfig(-2, 0)); // 负坐标，整块跳过
+        EXPECT(osd.setTile(corner, tile.data(), 4, 4) == 0);
+        EXPECT(osd.setTile(outside, tile.data(), 4, 4) == 0);
+        EXPECT(osd.setTile(negative, tile.data(), 4, 4) == 0);
+        std::vector<uint8_t> before = frame.mem;
+        EXPECT(osd.drawNV12(frame.y(), frame.uv(), frame.stride, frame.width, frame.height) == 0);
+
+        EXPECT(frame.Y(14, 6) == 235 && frame.Y(15, 7) == 235);
+        EXPECT(frame.U(14, 6) == 128 && frame.V(14, 6) == 128);
+
+        // 除右下角 2x2 的 Y 和对应的一对 UV 外，其余字节（含行跨度填充、帧后保护区）都不变
+        int changed = 0;
+        for (size_t i = 0; i < frame.mem.size(); i++)
+        {
+            if (frame.mem[i] != before[i])
+                changed++;
+        }
+        EXPECT(changed == 4 + 2);
+        for (int r = 0; r < frame.height + frame.height / 2 + 1; r++)
+        {
+            for (int c = frame.width; c < frame.stride; c++)
+                EXPECT(frame.mem[(size_t)r * frame.stride + c] == kGuard);
+        }
+    }
+
+    // 任意长度（覆盖 SIMD 主循环与尾部）、任意 src/dst/alpha 的组合，SIMD 与标量按位一致且等于参考公式
+    void testBlendRowEquivalence()
+    {
+        std::vector<uint8_t> src(256), alpha(256), dst_simd(256), dst_scalar(256);
+        int mismatches = 0;
+        for (int a = 0; a < 256; a++)
+        {
+            for (int d = 0; d < 256; d++)
+            {
+                for (int s = 0; s < 256; s++)
+                {
+                    src[s] = (uint8_t)s;
+                    alpha[s] = (uint8_t)a;
+                    dst_simd[s] = dst_scalar[s] = (uint8_t)d;
+                }
+                core::OsdRenderer::setForceScalar(false);
+                core::osdBlendRow(dst_simd.data(), src.data(), alpha.data(), 256);
+                core::OsdRenderer::setForceScalar(true);
+                core::osdBlendRow(dst_scalar.data(), src.data(), alpha.data(), 256);
+                for (int s = 0; s < 256; s++)
+                {
+                    int expect = (s * a + d * (255 - a) + 127) / 255;
+                    if (dst_simd[s] != expect || dst_scalar[s] != expect)
+                        mismatches++;
+                }
+            }
+        }
+        EXPECT(mismatches == 0);
+
+        // 混合透明/不透明的不规则长度
+        unsigned seed = 1;
+        for (int n = 1; n <= 67; n++)
+        {
+            for (int i = 0; i < n; i++)
+            {
+                seed = seed * 1103515245 + 12345;
+                src[i] = (uint8_t)(seed >> 8);
+                alpha[i] = (seed >> 20) % 3 == 0 ? 0 : (uint8_t)(seed >> 16);
+                dst_simd[i] = dst_scalar[i] = (uint8_t)(seed >> 24);
+            }
+            core::OsdRenderer::setForceScalar(false);
+            core::osdBlendRow(dst_simd.data(), src.data(), alpha.data(), n);
+            core::OsdRenderer::setForceScalar(true);
+            core::osdBlendRow(dst_scalar.data(), src.data(), alpha.data(), n);
+            EXPECT(memcmp(dst_simd.data(), dst_scalar.data(), n) == 0);
+        }
+        core::OsdRenderer::setForceScalar(false);
+    }
+
+    void testInvalidArgs()
+    {
+        core::OsdRenderer osd;
+        std::vector<uint32_t> tile = makeTile();
+        EXPECT(osd.setTile(0, tile.data(), 4, 4) == -1); // 区域不存在
+        int id = osd.addRegion(tileConfig(0, 0));
+        EXPECT(osd.setTile(id, nullptr, 4, 4) == -1);
+        EXPECT(osd.setTile(id, tile.data(), 1, 4) == -1); // 宽度向下取偶后为0
+        Frame frame(16, 8, 16);
+        EXPECT(osd.drawNV12(frame.y(), frame.uv(), 8, frame.width, frame.height) == -1); // stride < width
+    }
+}
+
+int main()
+{
+    log_init("test_osd_renderer.log", LOG_LEVEL_INFO);
+
+    testComposite(false);
+    testComposite(true);
+    testEdgeClipping();
+    testBlendRowEquivalence();
+    testInvalidArgs();
+
+    log_close();
+    printf("test_osd_renderer: %s (%d failures)\n", g_failures ? "FAILED" : "OK", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,235 @@
+// VencPacketWrapper 单元测试：码流归还回调的调用时机与次数
+//   - 各段相接（零拷贝）：av_packet_ref / move_ref / unref 过程中不归还，最后一个引用释放时恰好归还一次
+//   - 各段不相接（合并拷贝）：wrap 内立即归还一次，之后释放引用不再归还
+//   - 包装器先于包析构：最后一个引用释放时仍归还一次
+// 码流使用模拟后端分配的MB块和手工填写的 VENC_STREAM_S，不经过编码器
+// 用法: camera_test_venc_packet_wrapper（全部通过返回0）
+#include "core/VencPacketWrapper.hpp"
+#include "driver/MPIBackend.hpp"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+extern "C"
+{
+#include "infra/logging/logger.h"
+}
+
+namespace
+{
+    int g_failures = 0;
+
+#define EXPECT(cond)                                                                  \
+    do                                                                                \
+    {                                                                                 \
+        if (!(cond))                                                                  \
+        {                                                                             \
+            fprintf(stderr, "%s:%d: EXPECT(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                             \
+        }                                                                             \
+    } while (0)
+
+    // 记录每次归还的码流序号和第一个包的MB块
+    struct ReleaseLog
+    {
+        std::vector<uint32_t> seqs;
+        std::vector<MB_BLK> blks;
+
+        core::VencReleaseHook hook()
+        {
+            return [this](VENC_STREAM_S &stream)
+            {
+                seqs.push_back(stream.u32Seq);
+                blks.push_back(stream.u32PackCount > 0 ? stream.pstPack[0].pMbBlk : nullptr);
+            };
+        }
+    };
+
+    // 在 blk 的 offset 处写入 len 字节（内容为 tag），返回对应的包描述
+    VENC_PACK_S makePack(MB_BLK blk, uint32_t offset, uint32_t len, uint8_t tag)
+    {
+        uint8_t *base = (uint8_t *)driver::MPIBackend::instance().mbHandle2VirAddr(blk);
+        memset(base + offset, tag, len);
+        VENC_PACK_S pack;
+        memset(&pack, 0, sizeof(pack));
+        pack.pMbBlk = blk;
+        pack.u32Offset = offset;
+        pack.u32Len = len; // 与VENC一致：有效数据为 [u32Offset, u32Offset + u32Len)
+        pack.u64PTS = 1000;
+        return pack;
+    }
+
+    VENC_STREAM_S makeStream(VENC_PACK_S *packs, uint32_t count, uint32_t seq)
+    {
+        VENC_STREAM_S stream;
+        memset(&stream, 0, sizeof(stream));
+        stream.pstPack = packs;
+        stream.u32PackCount = count;
+        stream.u32Seq = seq;
+        return stream;
+    }
+
+    // 零拷贝：三段在同一MB块中首尾相接
+    void testContiguous()
+    {
+        driver::MPIBackend &mpi = driver::MPIBackend::instance();
+        MB_BLK blk = mpi.mbGetMB(MB_INVALID_POOLID, 4096, true);
+        EXPECT(blk != nullptr);
+
+        VENC_PACK_S packs[3] = {makePack(blk, 0, 24, 0xA0), makePack(blk, 24, 8, 0xA1), makePack(blk, 32, 1000, 0xA2)};
+        VENC_STREAM_S stream = makeStream(packs, 3, 7);
+
+        ReleaseLog log;
+        core::VencPacketWrapper wrapper(log.hook());
+        AVPacket *pkt = av_packet_alloc();
+        EXPECT(wrapper.wrap(stream, pkt) == 0);
+        // 调用方复用 pstPack 不影响归还时的包描述
+        memset(packs, 0, sizeof(packs));
+
+        EXPECT(pkt->size == 1032);
+        EXPECT(pkt->data == (uint8_t *)mpi.mbHandle2VirAddr(blk));
+        EXPECT(pkt->pts == 1000);
+        EXPECT(wrapper.outstanding() == 1);
+        EXPECT(wrapper.gatheredCount() == 0);
+        EXPECT(log.seqs.empty());
+
+        const struct iovec *iov = nullptr;
+        EXPECT(core::VencPacketWrapper::segments(pkt, &iov) == 3);
+        EXPECT(iov[1].iov_base == pkt->data + 24 && iov[1].iov_len == 8);
+
+        // 多个引用（队列、GOP缓存、复用器）依次释放，只有最后一个触发归还
+        AVPacket *ref1 = av_packet_alloc();
+        AVPacket *ref2 = av_packet_alloc();
+        AVPacket *moved = av_packet_alloc();
+        EXPECT(av_packet_ref(ref1, pkt) == 0);
+        EXPECT(av_packet_ref(ref2, pkt) == 0);
+        EXPECT(core::VencPacketWrapper::segments(ref2, &iov) == 3);
+        av_packet_unref(pkt);
+        EXPECT(log.seqs.empty());
+        av_packet_move_ref(moved, ref1);
+        av_packet_unref(ref1); // move 之后为空引用
+        EXPECT(log.seqs.empty());
+        av_packet_unref(ref2);
+        EXPECT(log.seqs.empty());
+        EXPECT(wrapper.outstanding() == 1);
+        av_packet_unref(moved);
+        EXPECT(log.seqs.size() == 1 && log.seqs[0] == 7 && log.blks[0] == blk);
+        EXPECT(wrapper.outstanding() == 0);
+
+        // 重复释放空包不再归还
+        av_packet_unref(moved);
+        EXPECT(log.seqs.size() == 1);
+
+        av_packet_free(&pkt);
+        av_packet_free(&ref1);
+        av_packet_free(&ref2);
+        av_packet_free(&moved);
+        mpi.mbReleaseMB(blk);
+    }
+
+    // 合并拷贝：两段位于不同MB块，wrap 内立即归还
+    void testGathered()
+    {
+        driver::MPIBackend &mpi = driver::MPIBackend::instance();
+        MB_BLK blk0 = mpi.mbGetMB(MB_INVALID_POOLID, 256, true);
+        MB_BLK blk1 = mpi.mbGetMB(MB_INVALID_POOLID, 256, true);
+
+        VENC_PACK_S packs[2] = {makePack(blk0, 16, 40, 0xB0), makePack(blk1, 0, 100, 0xB1)};
+        VENC_STREAM_S stream = makeStream(packs, 2, 9);
+
+        ReleaseLog log;
+        core::VencPacketWrapper wrapper(log.hook());
+        AVPacket *pkt = av_packet_alloc();
+        EXPECT(wrapper.wrap(stream, pkt) == 0);
+        EXPECT(log.seqs.size() == 1 && log.seqs[0] == 9 && log.blks[0] == blk0);
+        EXPECT(wrapper.outstanding() == 0);
+        EXPECT(wrapper.gatheredCount() == 1);
+
+        // 合并后的数据与原各段一致，段信息指向新缓冲
+        EXPECT(pkt->size == 140);
+        EXPECT(pkt->data[0] == 0xB0 && pkt->data[39] == 0xB0 && pkt->data[40] == 0xB1 && pkt->data[139] == 0xB1);
+        const struct iovec *iov = nullptr;
+        EXPECT(core::VencPacketWrapper::segments(pkt, &iov) == 2);
+        EXPECT(iov[1].iov_base == pkt->data + 40 && iov[1].iov_len == 100);
+
+        AVPacket *ref = av_packet_alloc();
+        EXPECT(av_packet_ref(ref, pkt) == 0);
+        av_packet_unref(pkt);
+        av_packet_unref(ref);
+        EXPECT(log.seqs.size() == 1);
+
+        av_packet_free(&pkt);
+        av_packet_free(&ref);
+        mpi.mbReleaseMB(blk0);
+        mpi.mbReleaseMB(blk1);
+    }
+
+    // 包装器先析构：在途码流在最后一个引用释放时照常归还
+    void testWrapperDestroyedFirst()
+    {
+        driver::MPIBackend &mpi = driver::MPIBackend::instance();
+        MB_BLK blk = mpi.mbGetMB(MB_INVALID_POOLID, 256, true);
+        VENC_PACK_S pack = makePack(blk, 0, 64, 0xC0);
+        VENC_STREAM_S stream = makeStream(&pack, 1, 11);
+
+        ReleaseLog log;
+        AVPacket *pkt = av_packet_alloc();
+        {
+            core::VencPacketWrapper wrapper(log.hook());
+            EXPECT(wrapper.wrap(stream, pkt) == 0);
+        }
+        EXPECT(log.seqs.empty());
+        av_packet_unref(pkt);
+        EXPECT(log.seqs.size() == 1 && log.seqs[0] == 11);
+
+        av_packet_free(&pkt);
+        mpi.mbReleaseMB(blk);
+    }
+
+    void foreignFree(void *opaque, uint8_t *data)
+    {
+        (void)opaque;
+        (void)data;
+    }
+
+    // 非本类封装的包没有段信息；空码流包装失败且不归还
+    void testForeignAndEmpty()
+    {
+        AVPacket *pkt = av_packet_alloc();
+        EXPECT(av_new_packet(pkt, 32) == 0);
+        const struct iovec *iov = nullptr;
+        EXPECT(core::VencPacketWrapper::segments(pkt, &iov) == -1);
+        av_packet_unref(pkt);
+
+        // 其他模块带 opaque 的缓冲：不能被当作本类的码流描述
+        static uint8_t foreign_data[32];
+        int foreign_opaque = 0;
+        pkt->buf = av_buffer_create(foreign_data, sizeof(foreign_data), foreignFree, &foreign_opaque, 0);
+        EXPECT(pkt->buf != nullptr);
+        pkt->data = foreign_data;
+        pkt->size = sizeof(foreign_data);
+        EXPECT(core::VencPacketWrapper::segments(pkt, &iov) == -1);
+        av_packet_unref(pkt);
+
+        ReleaseLog log;
+        core::VencPacketWrapper wrapper(log.hook());
+        VENC_STREAM_S empty = makeStream(nullptr, 0, 1);
+        EXPECT(wrapper.wrap(empty, pkt) == -1);
+        EXPECT(log.seqs.empty());
+        av_packet_free(&pkt);
+    }
+}
+
+int main()
+{
+    log_init("test_venc_packet_wrapper.log", LOG_LEVEL_INFO);
+
+    testContiguous();
+    testGathered();
+    testWrapperDestroyedFirst();
+    testForeignAndEmpty();
+
+    log_close();
+    printf("test_venc_packet_wrapper: %s (%d failures)\n", g_failures ? "FAILED" : "OK", g_failures);
+    return g_failures ? 1 : 0;
+}
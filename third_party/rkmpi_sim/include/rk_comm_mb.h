@@ -0,0 +1,34 @@
+/* 模拟后端：媒体缓冲（MB）类型（见 rk_type.h 说明） */
+#ifndef RKMPI_SIM_RK_COMM_MB_H
+#define RKMPI_SIM_RK_COMM_MB_H
+
+#include "rk_common.h"
+
+typedef void *MB_BLK;
+typedef RK_U32 MB_POOL;
+
+#define MB_INVALID_POOLID ((MB_POOL)-1)
+#define MB_INVALID_HANDLE NULL
+
+typedef enum
+{
+    MB_ALLOC_TYPE_DMA = 0,
+    MB_ALLOC_TYPE_MALLOC,
+} MB_ALLOC_TYPE_E;
+
+typedef enum
+{
+    MB_REMAP_MODE_NONE = 0,
+    MB_REMAP_MODE_CACHED,
+} MB_REMAP_MODE_E;
+
+typedef struct
+{
+    RK_U64 u64MBSize;
+    RK_U32 u32MBCnt;
+    MB_REMAP_MODE_E enRemapMode;
+    MB_ALLOC_TYPE_E enAllocType;
+    RK_BOOL bPreAlloc;
+} MB_POOL_CONFIG_S;
+
+#endif
@@ -0,0 +1,236 @@
+/* 模拟后端：VENC 类型（见 rk_type.h 说明） */
+#ifndef RKMPI_SIM_RK_COMM_VENC_H
+#define RKMPI_SIM_RK_COMM_VENC_H
+
+#include "rk_comm_video.h"
+
+typedef RK_S32 VENC_CHN;
+
+typedef enum
+{
+    H264E_NALU_BSLICE = 0,
+    H264E_NALU_PSLICE = 1,
+    H264E_NALU_ISLICE = 2,
+    H264E_NALU_IDRSLICE = 5,
+    H264E_NALU_SEI = 6,
+    H264E_NALU_SPS = 7,
+    H264E_NALU_PPS = 8,
+} H264E_NALU_TYPE_E;
+
+typedef enum
+{
+    H265E_NALU_BSLICE = 0,
+    H265E_NALU_PSLICE = 1,
+    H265E_NALU_ISLICE = 2,
+    H265E_NALU_IDRSLICE = 19,
+    H265E_NALU_VPS = 32,
+    H265E_NALU_SPS = 33,
+    H265E_NALU_PPS = 34,
+    H265E_NALU_SEI = 39,
+} H265E_NALU_TYPE_E;
+
+typedef union
+{
+    H264E_NALU_TYPE_E enH264EType;
+    H265E_NALU_TYPE_E enH265EType;
+} VENC_DATA_TYPE_U;
+
+typedef struct
+{
+    MB_BLK pMbBlk;
+    RK_U32 u32Len;
+    RK_U64 u64PTS;
+    RK_BOOL bFrameEnd;
+    RK_BOOL bStreamEnd;
+    VENC_DATA_TYPE_U DataType;
+    RK_U32 u32Offset;
+    RK_U32 u32DataNum;
+} VENC_PACK_S;
+
+typedef struct
+{
+    VENC_PACK_S *pstPack;
+    RK_U32 u32PackCount;
+    RK_U32 u32Seq;
+} VENC_STREAM_S;
+
+typedef enum
+{
+    VENC_RC_MODE_H264CBR = 1,
+    VENC_RC_MODE_H264VBR,
+    VENC_RC_MODE_H264AVBR,
+    VENC_RC_MODE_H264FIXQP,
+    VENC_RC_MODE_MJPEGCBR,
+    VENC_RC_MODE_MJPEGVBR,
+    VENC_RC_MODE_MJPEGFIXQP,
+    VENC_RC_MODE_H265CBR,
+    VENC_RC_MODE_H265VBR,
+    VENC_RC_MODE_H265AVBR,
+    VENC_RC_MODE_H265FIXQP,
+} VENC_RC_MODE_E;
+
+typedef struct
+{
+    RK_U32 u32Gop;
+    RK_U32 u32SrcFrameRateNum;
+    RK_U32 u32SrcFrameRateDen;
+    RK_U32 fr32DstFrameRateNum;
+    RK_U32 fr32DstFrameRateDen;
+    RK_U32 u32BitRate;
+    RK_U32 u32StatTime;
+} VENC_H264_CBR_S;
+
+typedef struct
+{
+    RK_U32 u32Gop;
+    RK_U32 u32SrcFrameRateNum;
+    RK_U32 u32SrcFrameRateDen;
+    RK_U32 fr32DstFrameRateNum;
+    RK_U32 fr32DstFrameRateDen;
+    RK_U32 u32BitRate;
+    RK_U32 u32MaxBitRate;
+    RK_U32 u32MinBitRate;
+    RK_U32 u32StatTime;
+} VENC_H264_VBR_S;
+
+typedef VENC_H264_VBR_S VENC_H264_AVBR_S;
+
+typedef struct
+{
+    RK_U32 u32Gop;
+    RK_U32 u32SrcFrameRateNum;
+    RK_U32 u32SrcFrameRateDen;
+    RK_U32 fr32DstFrameRateNum;
+    RK_U32 fr32DstFrameRateDen;
+    RK_U32 u32IQp;
+    RK_U32 u32PQp;
+    RK_U32 u32BQp;
+} VENC_H264_FIXQP_S;
+
+typedef VENC_H264_CBR_S VENC_H265_CBR_S;
+typedef VENC_H264_VBR_S VENC_H265_VBR_S;
+typedef VENC_H264_AVBR_S VENC_H265_AVBR_S;
+typedef VENC_H264_FIXQP_S VENC_H265_FIXQP_S;
+
+typedef struct
+{
+    RK_U32 u32SrcFrameRateNum;
+    RK_U32 u32SrcFrameRateDen;
+    RK_U32 fr32DstFrameRateNum;
+    RK_U32 fr32DstFrameRateDen;
+    RK_U32 u32BitRate;
+    RK_U32 u32StatTime;
+} VENC_MJPEG_CBR_S;
+
+typedef struct
+{
+    VENC_RC_MODE_E enRcMode;
+    union
+    {
+        VENC_H264_CBR_S stH264Cbr;
+        VENC_H264_VBR_S stH264Vbr;
+        VENC_H264_AVBR_S stH264Avbr;
+        VENC_H264_FIXQP_S stH264FixQp;
+        VENC_MJPEG_CBR_S stMjpegCbr;
+        VENC_H265_CBR_S stH265Cbr;
+        VENC_H265_VBR_S stH265Vbr;
+        VENC_H265_AVBR_S stH265Avbr;
+        VENC_H265_FIXQP_S stH265FixQp;
+    };
+} VENC_RC_ATTR_S;
+
+typedef enum
+{
+    H264E_PROFILE_BASELINE = 66,
+    H264E_PROFILE_MAIN = 77,
+    H264E_PROFILE_HIGH = 100,
+} H264E_PROFILE_E;
+
+typedef struct
+{
+    RK_CODEC_ID_E enType;
+    PIXEL_FORMAT_E enPixelFormat;
+    RK_U32 u32Profile;
+    RK_U32 u32PicWidth;
+    RK_U32 u32PicHeight;
+    RK_U32 u32VirWidth;
+    RK_U32 u32VirHeight;
+    RK_U32 u32StreamBufCnt;
+    RK_U32 u32BufSize;
+    MIRROR_E enMirror;
+} VENC_ATTR_S;
+
+typedef enum
+{
+    VENC_GOPMODE_INIT = 0,
+    VENC_GOPMODE_NORMALP,
+    VENC_GOPMODE_TSVC2,
+    VENC_GOPMODE_TSVC3,
+    VENC_GOPMODE_TSVC4,
+    VENC_GOPMODE_SMARTP,
+} VENC_GOP_MODE_E;
+
+typedef struct
+{
+    VENC_GOP_MODE_E enGopMode;
+    RK_S32 s32VirIdrLen;
+    RK_U32 u32MaxLtrCount;
+    RK_U32 u32TsvcPreload;
+} VENC_GOP_ATTR_S;
+
+typedef struct
+{
+    VENC_ATTR_S stVencAttr;
+    VENC_RC_ATTR_S stRcAttr;
+    VENC_GOP_ATTR_S stGopAttr;
+} VENC_CHN_ATTR_S;
+
+typedef struct
+{
+    RK_S32 s32RecvPicNum;
+} VENC_RECV_PIC_PARAM_S;
+
+typedef struct
+{
+    RK_U32 u32LeftPics;
+    RK_U32 u32LeftStreamBytes;
+    RK_U32 u32LeftStreamFrames;
+    RK_U32 u32CurPacks;
+    RK_U32 u32LeftRecvPics;
+    RK_U32 u32LeftEncPics;
+} VENC_CHN_STATUS_S;
+
+typedef struct
+{
+    RK_U32 u32StepQp;
+    RK_U32 u32MaxQp;
+    RK_U32 u32MinQp;
+    RK_U32 u32MaxIQp;
+    RK_U32 u32MinIQp;
+    RK_S32 s32DeltIpQp;
+    RK_S32 s32MaxReEncodeTimes;
+} VENC_PARAM_H265_S;
+
+typedef VENC_PARAM_H265_S VENC_PARAM_H264_S;
+
+typedef struct
+{
+    RK_U32 s32FirstFrameStartQp;
+    union
+    {
+        VENC_PARAM_H264_S stParamH264;
+        VENC_PARAM_H265_S stParamH265;
+    };
+} VENC_RC_PARAM_S;
+
+typedef struct
+{
+    RK_U32 u32Index;
+    RK_BOOL bEnable;
+    RK_BOOL bAbsQp;
+    RK_S32 s32Qp;
+    RK_BOOL bIntra;
+    RECT_S stRect;
+} VENC_ROI_ATTR_S;
+
+#endif
@@ -0,0 +1,61 @@
+/* 模拟后端：VI 类型（见 rk_type.h 说明） */
+#ifndef RKMPI_SIM_RK_COMM_VI_H
+#define RKMPI_SIM_RK_COMM_VI_H
+
+#include "rk_comm_video.h"
+
+typedef RK_S32 VI_DEV;
+typedef RK_S32 VI_PIPE;
+typedef RK_S32 VI_CHN;
+
+typedef struct
+{
+    RK_U32 u32MaxW;
+} VI_DEV_ATTR_S;
+
+typedef struct
+{
+    RK_U32 u32Num;
+    VI_PIPE PipeId[4];
+} VI_DEV_BIND_PIPE_S;
+
+typedef enum
+{
+    VI_ALLOC_BUF_TYPE_INTERNAL = 0,
+} VI_ALLOC_BUF_TYPE_E;
+
+typedef enum
+{
+    VI_V4L2_CAPTURE_TYPE_VIDEO_CAPTURE = 0,
+} VI_V4L2_CAPTURE_TYPE;
+
+typedef enum
+{
+    VI_V4L2_MEMORY_TYPE_DMABUF = 0,
+} VI_V4L2_MEMORY_TYPE;
+
+typedef struct
+{
+    RK_U32 u32BufCount;
+    RK_U32 u32BufSize;
+    VI_V4L2_CAPTURE_TYPE enCaptureType;
+    VI_V4L2_MEMORY_TYPE enMemoryType;
+    SIZE_S stMaxSize;
+    RECT_S stWindow;
+} VI_ISP_OPT_S;
+
+typedef struct
+{
+    VI_ISP_OPT_S stIspOpt;
+    SIZE_S stSize;
+    PIXEL_FORMAT_E enPixelFormat;
+    DYNAMIC_RANGE_E enDynamicRange;
+    COMPRESS_MODE_E enCompressMode;
+    VI_ALLOC_BUF_TYPE_E enAllocBufType;
+    RK_BOOL bMirror;
+    RK_BOOL bFlip;
+    RK_U32 u32Depth;
+    FRAME_RATE_CTRL_S stFrameRate;
+} VI_CHN_ATTR_S;
+
+#endif
@@ -0,0 +1,68 @@
+/* 模拟后端：视频帧类型（见 rk_type.h 说明） */
+#ifndef RKMPI_SIM_RK_COMM_VIDEO_H
+#define RKMPI_SIM_RK_COMM_VIDEO_H
+
+#include "rk_comm_mb.h"
+
+typedef enum
+{
+    RK_FMT_YUV420SP = 0,
+    RK_FMT_YUV420P = 2,
+    RK_FMT_YUV422SP = 3,
+    RK_FMT_RGB888 = 0x10000,
+    RK_FMT_BGR888,
+    RK_FMT_ARGB8888,
+    RK_FMT_BGRA8888,
+    RK_FMT_BUTT,
+} PIXEL_FORMAT_E;
+
+typedef enum
+{
+    COMPRESS_MODE_NONE = 0,
+} COMPRESS_MODE_E;
+
+typedef enum
+{
+    DYNAMIC_RANGE_SDR8 = 0,
+    DYNAMIC_RANGE_SDR10,
+} DYNAMIC_RANGE_E;
+
+typedef enum
+{
+    VIDEO_FORMAT_LINEAR = 0,
+} VIDEO_FORMAT_E;
+
+typedef enum
+{
+    VIDEO_FIELD_FRAME = 0,
+} VIDEO_FIELD_E;
+
+typedef enum
+{
+    MIRROR_NONE = 0,
+} MIRROR_E;
+
+typedef struct
+{
+    MB_BLK pMbBlk;
+    RK_U32 u32Width;
+    RK_U32 u32Height;
+    RK_U32 u32VirWidth;
+    RK_U32 u32VirHeight;
+    VIDEO_FIELD_E enField;
+    PIXEL_FORMAT_E enPixelFormat;
+    VIDEO_FORMAT_E enVideoFormat;
+    COMPRESS_MODE_E enCompressMode;
+    DYNAMIC_RANGE_E enDynamicRange;
+    RK_U64 u64PTS;
+    RK_U32 u32TimeRef;
+    RK_U64 u64PrivateData;
+    RK_U32 u32FrameFlag;
+} VIDEO_FRAME_S;
+
+typedef struct
+{
+    VIDEO_FRAME_S stVFrame;
+} VIDEO_FRAME_INFO_S;
+
+#endif
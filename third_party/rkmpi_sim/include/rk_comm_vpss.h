@@ -0,0 +1,56 @@
+/* 模拟后端：VPSS 类型（见 rk_type.h 说明） */
+#ifndef RKMPI_SIM_RK_COMM_VPSS_H
+#define RKMPI_SIM_RK_COMM_VPSS_H
+
+#include "rk_comm_video.h"
+
+typedef RK_S32 VPSS_GRP;
+typedef RK_S32 VPSS_CHN;
+
+typedef struct
+{
+    RK_U32 u32MaxW;
+    RK_U32 u32MaxH;
+    PIXEL_FORMAT_E enPixelFormat;
+    DYNAMIC_RANGE_E enDynamicRange;
+    COMPRESS_MODE_E enCompressMode;
+    FRAME_RATE_CTRL_S stFrameRate;
+} VPSS_GRP_ATTR_S;
+
+typedef enum
+{
+    VPSS_CHN_MODE_USER = 0,
+    VPSS_CHN_MODE_AUTO,
+    VPSS_CHN_MODE_PASSTHROUGH,
+} VPSS_CHN_MODE_E;
+
+typedef enum
+{
+    ASPECT_RATIO_NONE = 0,
+} ASPECT_RATIO_E;
+
+typedef struct
+{
+    ASPECT_RATIO_E enMode;
+    RK_U32 u32BgColor;
+    RECT_S stVideoRect;
+} ASPECT_RATIO_S;
+
+typedef struct
+{
+    VPSS_CHN_MODE_E enChnMode;
+    RK_U32 u32Width;
+    RK_U32 u32Height;
+    VIDEO_FORMAT_E enVideoFormat;
+    PIXEL_FORMAT_E enPixelFormat;
+    DYNAMIC_RANGE_E enDynamicRange;
+    COMPRESS_MODE_E enCompressMode;
+    FRAME_RATE_CTRL_S stFrameRate;
+    RK_BOOL bMirror;
+    RK_BOOL bFlip;
+    RK_U32 u32Depth;
+    ASPECT_RATIO_S stAspectRatio;
+    RK_U32 u32FrameBufCnt;
+} VPSS_CHN_ATTR_S;
+
+#endif
@@ -0,0 +1,62 @@
+/* 模拟后端：通用类型与错误码（见 rk_type.h 说明） */
+#ifndef RKMPI_SIM_RK_COMMON_H
+#define RKMPI_SIM_RK_COMMON_H
+
+#include "rk_type.h"
+
+typedef enum
+{
+    RK_ID_VI = 0,
+    RK_ID_VPSS,
+    RK_ID_VENC,
+} MOD_ID_E;
+
+typedef struct
+{
+    MOD_ID_E enModId;
+    RK_S32 s32DevId;
+    RK_S32 s32ChnId;
+} MPP_CHN_S;
+
+typedef struct
+{
+    RK_U32 u32Width;
+    RK_U32 u32Height;
+} SIZE_S;
+
+typedef struct
+{
+    RK_S32 s32X;
+    RK_S32 s32Y;
+    RK_U32 u32Width;
+    RK_U32 u32Height;
+} RECT_S;
+
+typedef struct
+{
+    RK_S32 s32SrcFrameRate;
+    RK_S32 s32DstFrameRate;
+} FRAME_RATE_CTRL_S;
+
+typedef enum
+{
+    RK_VIDEO_ID_Unused = 0,
+    RK_VIDEO_ID_AVC = 8,
+    RK_VIDEO_ID_MJPEG = 9,
+    RK_VIDEO_ID_JPEG = 10,
+    RK_VIDEO_ID_HEVC = 16777220,
+} RK_CODEC_ID_E;
+
+/* 错误码：模拟后端按 SDK 语义返回，取值只需在本工程内一致 */
+#define RK_ERR_VI_NOT_CONFIG 0xa0010001
+#define RK_ERR_VI_BUF_EMPTY 0xa0010002
+#define RK_ERR_VPSS_BUF_EMPTY 0xa0020002
+#define RK_ERR_VPSS_UNEXIST 0xa0020007
+#define RK_ERR_VENC_BUF_EMPTY 0xa0040002
+#define RK_ERR_VENC_BUF_FULL 0xa0040003
+#define RK_ERR_VENC_NOT_PERM 0xa0040004
+#define RK_ERR_VENC_NULL_PTR 0xa0040005
+#define RK_ERR_VENC_ILLEGAL_PARAM 0xa0040006
+#define RK_ERR_VENC_UNEXIST 0xa0040007
+
+#endif
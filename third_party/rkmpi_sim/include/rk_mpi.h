@@ -0,0 +1,12 @@
+/* 模拟后端：汇总各模块类型（见 rk_type.h 说明） */
+#ifndef RKMPI_SIM_RK_MPI_H
+#define RKMPI_SIM_RK_MPI_H
+
+#include "rk_common.h"
+#include "rk_comm_mb.h"
+#include "rk_comm_video.h"
+#include "rk_comm_vi.h"
+#include "rk_comm_vpss.h"
+#include "rk_comm_venc.h"
+
+#endif
@@ -0,0 +1,7 @@
+/* 模拟后端：只提供类型，不声明 RK_MPI_SYS_* 函数（见 rk_type.h 说明） */
+#ifndef RKMPI_SIM_RK_MPI_SYS_H
+#define RKMPI_SIM_RK_MPI_SYS_H
+
+#include "rk_mpi.h"
+
+#endif
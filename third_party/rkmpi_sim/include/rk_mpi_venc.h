@@ -0,0 +1,7 @@
+/* 模拟后端：只提供类型，不声明 RK_MPI_VENC_* 函数（见 rk_type.h 说明） */
+#ifndef RKMPI_SIM_RK_MPI_VENC_H
+#define RKMPI_SIM_RK_MPI_VENC_H
+
+#include "rk_comm_venc.h"
+
+#endif
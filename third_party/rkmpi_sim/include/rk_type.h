@@ -0,0 +1,34 @@
+/*
+ * 主机端模拟后端（CAMERA_SIM_BACKEND）使用的 Rockit MPI 类型头文件
+ * 只包含本工程用到的基本类型、枚举、结构体和错误码，字段名与 SDK 一致，不声明任何 RK_MPI_* 函数：
+ * 模拟构建中对 MPI 的调用全部经过 driver::MPIBackend，直接调用 RK_MPI_* 会在编译期报错。
+ * 结构体布局不保证与 SDK 二进制兼容，板端构建必须使用 SDK 自带的头文件。
+ */
+#ifndef RKMPI_SIM_RK_TYPE_H
+#define RKMPI_SIM_RK_TYPE_H
+
+#include <stdint.h>
+
+typedef unsigned char RK_U8;
+typedef unsigned short RK_U16;
+typedef unsigned int RK_U32;
+typedef unsigned long long RK_U64;
+typedef signed char RK_S8;
+typedef short RK_S16;
+typedef int RK_S32;
+typedef long long RK_S64;
+typedef char RK_CHAR;
+typedef float RK_FLOAT;
+typedef double RK_DOUBLE;
+typedef void RK_VOID;
+
+typedef enum
+{
+    RK_FALSE = 0,
+    RK_TRUE = 1,
+} RK_BOOL;
+
+#define RK_SUCCESS 0
+#define RK_FAILURE (-1)
+
+#endif
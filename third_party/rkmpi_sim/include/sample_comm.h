@@ -0,0 +1,14 @@
+/* 模拟后端：ISP 工作模式（模拟后端没有 sensor/ISP，不声明 SAMPLE_COMM_* 函数，见 rk_type.h 说明） */
+#ifndef RKMPI_SIM_SAMPLE_COMM_H
+#define RKMPI_SIM_SAMPLE_COMM_H
+
+#include "rk_mpi.h"
+
+typedef enum
+{
+    RK_AIQ_WORKING_MODE_NORMAL = 0,
+    RK_AIQ_WORKING_MODE_ISP_HDR2 = 0x10,
+    RK_AIQ_WORKING_MODE_ISP_HDR3 = 0x20,
+} rk_aiq_working_mode_t;
+
+#endif